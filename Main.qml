@@ -12,6 +12,8 @@ import EvolveUI
 
 // 主应用程序窗口 - 作为整个应用的根容器，包含所有UI元素
 ApplicationWindow {
+    id: root
+
     // 窗口初始宽度：
     width: 1020
 
@@ -33,6 +35,36 @@ ApplicationWindow {
     // 分步运行模式状态 - 与首页功率设置互斥
     property bool stepRunActive: false
 
+    // 首帧显示后是否在后台预热其余页面（关闭时页面在首次切换到时加载）
+    property bool prewarmEnabled: true
+    readonly property bool pagesPrewarm: prewarmEnabled && StartupTrace.firstFrameShown
+
+    // 按需加载的页面数，全部加载后结束启动跟踪
+    readonly property int lazyPageCount: 3
+    property int loadedPageCount: 0
+
+    // 页面加载完成：加载后保持，不随切换卸载
+    function pageLoaded(loader, name) {
+        loader.active = true
+        StartupTrace.markPhase("page loaded: " + name)
+        loadedPageCount++
+        if (loadedPageCount === lazyPageCount) {
+            StartupTrace.markPhase("pages prewarmed")
+            StartupTrace.finish()
+        }
+    }
+
+    // 首页不经Loader、随主界面同步创建，首帧即为可交互；其余页面的预热单独计时
+    Connections {
+        target: StartupTrace
+        function onFirstFrameShownChanged() {
+            StartupTrace.markInteractive()
+            if (!root.prewarmEnabled) {
+                StartupTrace.finish()
+            }
+        }
+    }
+
     // 字体加载器 - 用于加载Font Awesome图标字体
     FontLoader {
         id: iconFont  // 字体加载器的唯一标识符
@@ -44,7 +76,23 @@ ApplicationWindow {
     ETheme { id: theme }
 
     // 波形数据管理器 - 全局共享，用于存储电压/电流/功率历史数据
-    WaveformDataManager { id: waveformDataManager }
+    WaveformDataManager {
+        id: waveformDataManager
+        view: waveformPageLoader
+    }
+
+    // 性能浮层 - Ctrl+Shift+P切换，现场可导出快照附在问题报告中
+    Shortcut {
+        sequence: "Ctrl+Shift+P"
+        context: Qt.ApplicationShortcut
+        onActivated: Metrics.enabled = !Metrics.enabled
+    }
+
+    EPerformanceHud {
+        anchors.top: parent.top
+        anchors.right: parent.right
+        anchors.margins: 12
+    }
 
     // 分割视图 - 将窗口分为多个可调整大小的区域
     SplitView {
@@ -247,11 +295,16 @@ ApplicationWindow {
                     }
                 }
 
-                // 分步运行页组件 - 填充整个容器
-                StepRunPage {
-                    id: stepRunPage
+                // 分步运行页 - 首次显示或首帧后预热时加载，之后保持
+                Loader {
+                    id: stepRunPageLoader
                     anchors.fill: parent
-                    homePage: homePage
+                    asynchronous: true
+                    active: visible || root.pagesPrewarm
+                    sourceComponent: Component {
+                        StepRunPage { homePage: homePage }
+                    }
+                    onLoaded: root.pageLoaded(stepRunPageLoader, "StepRunPage")
                 }
             }
 
@@ -285,8 +338,17 @@ ApplicationWindow {
                     }
                 }
 
-                // 波形图页组件 - 填充整个容器
-                WaveformPage { anchors.fill: parent }
+                // 波形图页 - 按需加载，传递Modbus管理器引用（用于触发捕获）
+                Loader {
+                    id: waveformPageLoader
+                    anchors.fill: parent
+                    asynchronous: true
+                    active: visible || root.pagesPrewarm
+                    sourceComponent: Component {
+                        WaveformPage { modbusManager: homePage.modbusManager }
+                    }
+                    onLoaded: root.pageLoaded(waveformPageLoader, "WaveformPage")
+                }
             }
 
             // 设置页容器 - 包含SettingsPage组件
@@ -319,10 +381,16 @@ ApplicationWindow {
                     }
                 }
                 
-                // 设置页组件 - 填充整个容器，并传递动画窗口引用
-                SettingsPage { 
-                    anchors.fill: parent 
-                    animWindowRef: homePage.animatedWindow 
+                // 设置页 - 按需加载，并传递动画窗口引用
+                Loader {
+                    id: settingsPageLoader
+                    anchors.fill: parent
+                    asynchronous: true
+                    active: visible || root.pagesPrewarm
+                    sourceComponent: Component {
+                        SettingsPage { animWindowRef: homePage.animatedWindow; busPool: homePage.busPool; livePublisher: homePage.livePublisher }
+                    }
+                    onLoaded: root.pageLoaded(settingsPageLoader, "SettingsPage")
                 }
             }
         }
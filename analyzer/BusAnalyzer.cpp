@@ -0,0 +1,666 @@
+#include "BusAnalyzer.h"
+#include "BusCapture.h"
+#include "../core/Logger.h"
+#include "../serial/ModbusCrc.h"
+#include <QDateTime>
+#include <QFile>
+#include <QJsonArray>
+#include <QTextStream>
+#include <QtEndian>
+#include <algorithm>
+
+namespace {
+
+/**
+ * @brief 往返时间分布的分档上限（毫秒），最后一档为其余全部
+ */
+constexpr int BucketEdgesMs[] = { 1, 2, 5, 10, 20, 50, 100, 200, 500, 1000 };
+constexpr int BucketCount = sizeof(BucketEdgesMs) / sizeof(BucketEdgesMs[0]) + 1;
+
+constexpr qint64 MinGapNs = 100 * 1000000LL;
+
+inline quint8 byteAt(const QByteArray &data, int index)
+{
+    return static_cast<quint8>(data.at(index));
+}
+
+inline int wordAt(const QByteArray &data, int index)
+{
+    return (byteAt(data, index) << 8) | byteAt(data, index + 1);
+}
+
+/**
+ * @brief 帧内从站地址的位置
+ * @details Modbus TCP帧前有7字节MBAP报文头，单元标识符在第6字节
+ */
+inline int unitOffset(quint8 format)
+{
+    return format == Log::TcpFrame ? 6 : 0;
+}
+
+/**
+ * @brief 由RTU请求推算正常应答的长度
+ * @return 字节数，未知功能码返回-1
+ */
+int expectedResponseLength(const QByteArray &request)
+{
+    if (request.size() < 6) {
+        return -1;
+    }
+    const int count = wordAt(request, 4);
+    switch (byteAt(request, 1)) {
+    case 0x01:
+    case 0x02:
+        return 5 + (count + 7) / 8;
+    case 0x03:
+    case 0x04:
+    case 0x17:
+        return 5 + 2 * count;
+    case 0x05:
+    case 0x06:
+    case 0x0F:
+    case 0x10:
+        return 8;
+    default:
+        return -1;
+    }
+}
+
+QString formatMs(qint64 ns)
+{
+    return QString::number(static_cast<double>(ns) / 1e6, 'f', 3);
+}
+
+QString formatTime(qint64 ns)
+{
+    return QDateTime::fromMSecsSinceEpoch(ns / 1000000).toString("yyyy-MM-dd HH:mm:ss.zzz");
+}
+
+/**
+ * @brief 往返时间分档计数
+ */
+QVector<int> histogram(const QVector<qint64> &latenciesNs)
+{
+    QVector<int> counts(BucketCount, 0);
+    for (qint64 ns : latenciesNs) {
+        int bucket = 0;
+        while (bucket < BucketCount - 1 && ns >= BucketEdgesMs[bucket] * 1000000LL) {
+            ++bucket;
+        }
+        ++counts[bucket];
+    }
+    return counts;
+}
+
+QString bucketLabel(int bucket)
+{
+    if (bucket == 0) {
+        return QStringLiteral("<%1ms").arg(BucketEdgesMs[0]);
+    }
+    if (bucket == BucketCount - 1) {
+        return QStringLiteral(">=%1ms").arg(BucketEdgesMs[bucket - 1]);
+    }
+    return QStringLiteral("%1-%2ms").arg(BucketEdgesMs[bucket - 1]).arg(BucketEdgesMs[bucket]);
+}
+
+const char *const OutcomeKeys[] = { "ok", "exception", "timeout", "crc", "truncated", "mismatch", "broadcast", "open" };
+
+} // namespace
+
+qint64 SlaveStats::percentileNs(double q) const
+{
+    if (latenciesNs.isEmpty()) {
+        return 0;
+    }
+    const int index = static_cast<int>(q * (latenciesNs.size() - 1) + 0.5);
+    return latenciesNs.at(qBound(0, index, static_cast<int>(latenciesNs.size()) - 1));
+}
+
+BusAnalyzer::BusAnalyzer()
+    : m_slaveFilter(-1)
+    , m_gapThresholdNs(0)
+    , m_effectiveGapNs(0)
+    , m_lastRtu(-1)
+    , m_strayFrames(0)
+    , m_malformedFrames(0)
+    , m_firstNs(0)
+    , m_lastNs(0)
+    , m_frameCount(0)
+    , m_hasRebuilt(false)
+{
+}
+
+void BusAnalyzer::analyze(const BusCapture &capture)
+{
+    m_transactions.clear();
+    for (QVector<int> &open : m_open) {
+        open.clear();
+    }
+    m_lastRtu = -1;
+    m_strayFrames = 0;
+    m_malformedFrames = 0;
+    m_hasRebuilt = false;
+
+    const QVector<CapturedFrame> &frames = capture.frames();
+    m_frameCount = frames.size();
+    m_firstNs = frames.isEmpty() ? 0 : frames.first().timeNs;
+    m_lastNs = frames.isEmpty() ? 0 : frames.last().timeNs;
+    m_transactions.reserve(frames.size() / 2 + 1);
+
+    for (const CapturedFrame &frame : frames) {
+        if (frame.format > Log::RebuiltRtuFrame) {
+            ++m_malformedFrames;
+            continue;
+        }
+        m_hasRebuilt = m_hasRebuilt || frame.format == Log::RebuiltRtuFrame;
+        if (frame.direction == Log::Tx) {
+            onRequest(frame.data, frame.timeNs, frame.format);
+        } else {
+            onResponse(frame.data, frame.timeNs, frame.format);
+        }
+    }
+
+    // 捕获结束时仍未应答的事务保持Open，不计入超时
+    for (QVector<int> &open : m_open) {
+        open.clear();
+    }
+
+    if (m_slaveFilter >= 0) {
+        const int slave = m_slaveFilter;
+        m_transactions.erase(std::remove_if(m_transactions.begin(), m_transactions.end(),
+                                            [slave](const BusTransaction &t) { return t.slave != slave; }),
+                             m_transactions.end());
+    }
+    collectStatistics();
+}
+
+void BusAnalyzer::onRequest(const QByteArray &frame, qint64 timeNs, quint8 format)
+{
+    const int offset = unitOffset(format);
+    if (frame.size() < offset + 2) {
+        ++m_malformedFrames;
+        return;
+    }
+
+    BusTransaction t;
+    t.requestNs = timeNs;
+    t.slave = byteAt(frame, offset);
+    t.functionCode = byteAt(frame, offset + 1);
+    t.format = format;
+    t.request = frame;
+
+    QVector<int> &open = m_open[format];
+    switch (format) {
+    case Log::RtuFrame:
+        // 串口同一时刻只有一个事务，新请求发出说明上一请求已放弃等待
+        if (!open.isEmpty()) {
+            close(open.takeFirst(), BusTransaction::Timeout);
+        }
+        t.retry = m_lastRtu >= 0 && m_transactions.at(m_lastRtu).failed() && m_transactions.at(m_lastRtu).request == frame;
+        m_lastRtu = m_transactions.size();
+        break;
+    case Log::TcpFrame:
+        // 重发使用新的事务标识符，内容相同的未应答请求即为被重发的那一次
+        for (int i = 0; i < open.size(); ++i) {
+            const BusTransaction &pending = m_transactions.at(open.at(i));
+            if (pending.request.size() == frame.size()
+                    && std::equal(frame.cbegin() + offset, frame.cend(), pending.request.cbegin() + offset)) {
+                close(open.takeAt(i), BusTransaction::Timeout);
+                t.retry = true;
+                break;
+            }
+        }
+        break;
+    default:
+        break;
+    }
+
+    if (t.slave == 0) {
+        t.outcome = BusTransaction::Broadcast;
+        m_transactions.append(t);
+        return;
+    }
+    open.append(m_transactions.size());
+    m_transactions.append(t);
+}
+
+void BusAnalyzer::onResponse(const QByteArray &frame, qint64 timeNs, quint8 format)
+{
+    QVector<int> &open = m_open[format];
+    const int offset = unitOffset(format);
+    if (frame.isEmpty() || (format != Log::RtuFrame && frame.size() < offset + 2)) {
+        ++m_malformedFrames;
+        return;
+    }
+
+    int match = -1;
+    switch (format) {
+    case Log::RtuFrame:
+        match = open.isEmpty() ? -1 : 0;
+        break;
+    case Log::TcpFrame: {
+        const int transactionId = wordAt(frame, 0);
+        for (int i = 0; i < open.size(); ++i) {
+            const QByteArray &request = m_transactions.at(open.at(i)).request;
+            if (request.size() >= 2 && wordAt(request, 0) == transactionId) {
+                match = i;
+                break;
+            }
+        }
+        break;
+    }
+    default: {
+        // Qt主站按提交顺序逐个处理，匹配到的请求之前仍未应答的都已超时
+        const int slave = byteAt(frame, 0);
+        const int functionCode = byteAt(frame, 1) & 0x7F;
+        for (int i = 0; i < open.size(); ++i) {
+            const BusTransaction &pending = m_transactions.at(open.at(i));
+            if (pending.slave == slave && pending.functionCode == functionCode) {
+                match = i;
+                break;
+            }
+        }
+        for (int i = 0; i < match; ++i) {
+            close(open.at(i), BusTransaction::Timeout);
+        }
+        if (match > 0) {
+            open.remove(0, match);
+            match = 0;
+        }
+        break;
+    }
+    }
+
+    if (match < 0) {
+        ++m_strayFrames;
+        return;
+    }
+    resolve(m_transactions[open.takeAt(match)], frame, timeNs);
+}
+
+void BusAnalyzer::close(int index, BusTransaction::Outcome outcome)
+{
+    m_transactions[index].outcome = outcome;
+}
+
+void BusAnalyzer::resolve(BusTransaction &t, const QByteArray &frame, qint64 timeNs)
+{
+    t.responseNs = timeNs;
+    t.response = frame;
+
+    const int offset = unitOffset(t.format);
+    if (t.format != Log::TcpFrame) {
+        // 异常应答固定5字节
+        const bool exception = frame.size() >= 2 && (byteAt(frame, 1) & 0x80) != 0;
+        const int expected = exception ? 5 : expectedResponseLength(t.request);
+        if (frame.size() < 4) {
+            t.outcome = BusTransaction::Truncated;
+            return;
+        }
+        const quint16 crc = ModbusCrc::compute(reinterpret_cast<const quint8 *>(frame.constData()),
+                                               static_cast<std::size_t>(frame.size() - 2));
+        const quint16 received = qFromLittleEndian<quint16>(frame.constData() + frame.size() - 2);
+        if (crc != received) {
+            t.outcome = expected > 0 && frame.size() < expected ? BusTransaction::Truncated : BusTransaction::CrcError;
+            return;
+        }
+    }
+
+    const int slave = byteAt(frame, offset);
+    const quint8 functionCode = byteAt(frame, offset + 1);
+    if (slave != t.slave || (functionCode & 0x7F) != t.functionCode) {
+        t.outcome = BusTransaction::Mismatch;
+        return;
+    }
+    if (functionCode & 0x80) {
+        t.outcome = BusTransaction::Exception;
+        t.exceptionCode = frame.size() > offset + 2 ? byteAt(frame, offset + 2) : 0;
+        return;
+    }
+    t.outcome = BusTransaction::Ok;
+}
+
+void BusAnalyzer::collectStatistics()
+{
+    m_slaves.clear();
+    m_functionCodes.clear();
+    m_exceptionCodes.clear();
+    m_gaps.clear();
+
+    QVector<qint64> intervals;
+    intervals.reserve(m_transactions.size());
+    for (int i = 0; i < m_transactions.size(); ++i) {
+        const BusTransaction &t = m_transactions.at(i);
+        SlaveStats &stats = m_slaves[t.slave];
+        ++stats.requests;
+        ++stats.functionCodes[t.functionCode];
+        ++m_functionCodes[t.functionCode];
+        if (t.retry) {
+            ++stats.retries;
+        }
+        switch (t.outcome) {
+        case BusTransaction::Ok: ++stats.ok; break;
+        case BusTransaction::Exception:
+            ++stats.exceptions;
+            ++m_exceptionCodes[t.exceptionCode];
+            break;
+        case BusTransaction::Timeout: ++stats.timeouts; break;
+        case BusTransaction::CrcError: ++stats.crcErrors; break;
+        case BusTransaction::Truncated: ++stats.truncated; break;
+        case BusTransaction::Mismatch: ++stats.mismatches; break;
+        default: break;
+        }
+        if (t.outcome == BusTransaction::Ok || t.outcome == BusTransaction::Exception) {
+            stats.latenciesNs.append(t.latencyNs());
+        }
+        if (i > 0) {
+            intervals.append(t.requestNs - m_transactions.at(i - 1).requestNs);
+        }
+    }
+    for (SlaveStats &stats : m_slaves) {
+        std::sort(stats.latenciesNs.begin(), stats.latenciesNs.end());
+    }
+
+    m_effectiveGapNs = m_gapThresholdNs;
+    if (m_effectiveGapNs <= 0) {
+        QVector<qint64> sorted = intervals;
+        std::nth_element(sorted.begin(), sorted.begin() + sorted.size() / 2, sorted.end());
+        const qint64 median = sorted.isEmpty() ? 0 : sorted.at(sorted.size() / 2);
+        m_effectiveGapNs = qMax(MinGapNs, median * 5);
+    }
+    for (int i = 0; i < intervals.size(); ++i) {
+        if (intervals.at(i) > m_effectiveGapNs) {
+            BusGap gap;
+            gap.startNs = m_transactions.at(i).requestNs;
+            gap.durationNs = intervals.at(i);
+            m_gaps.append(gap);
+        }
+    }
+}
+
+QString BusAnalyzer::functionName(int functionCode)
+{
+    switch (functionCode) {
+    case 0x01: return QStringLiteral("读线圈");
+    case 0x02: return QStringLiteral("读离散输入");
+    case 0x03: return QStringLiteral("读保持寄存器");
+    case 0x04: return QStringLiteral("读输入寄存器");
+    case 0x05: return QStringLiteral("写单个线圈");
+    case 0x06: return QStringLiteral("写单个寄存器");
+    case 0x0F: return QStringLiteral("写多个线圈");
+    case 0x10: return QStringLiteral("写多个寄存器");
+    case 0x17: return QStringLiteral("读写多个寄存器");
+    default: return QStringLiteral("未知功能码");
+    }
+}
+
+QString BusAnalyzer::exceptionName(int exceptionCode)
+{
+    switch (exceptionCode) {
+    case 0x01: return QStringLiteral("非法功能");
+    case 0x02: return QStringLiteral("非法数据地址");
+    case 0x03: return QStringLiteral("非法数据值");
+    case 0x04: return QStringLiteral("从站设备故障");
+    case 0x05: return QStringLiteral("确认");
+    case 0x06: return QStringLiteral("从站忙");
+    case 0x08: return QStringLiteral("存储奇偶校验错误");
+    case 0x0A: return QStringLiteral("网关路径不可用");
+    case 0x0B: return QStringLiteral("网关目标无响应");
+    default: return QStringLiteral("未知异常码");
+    }
+}
+
+QString BusAnalyzer::outcomeName(BusTransaction::Outcome outcome)
+{
+    switch (outcome) {
+    case BusTransaction::Ok: return QStringLiteral("成功");
+    case BusTransaction::Exception: return QStringLiteral("异常应答");
+    case BusTransaction::Timeout: return QStringLiteral("超时");
+    case BusTransaction::CrcError: return QStringLiteral("CRC错误");
+    case BusTransaction::Truncated: return QStringLiteral("应答不完整");
+    case BusTransaction::Mismatch: return QStringLiteral("应答不匹配");
+    case BusTransaction::Broadcast: return QStringLiteral("广播");
+    case BusTransaction::Open: return QStringLiteral("未结束");
+    }
+    return QString();
+}
+
+/**
+ * @brief 请求摘要，如"读保持寄存器 地址=0 数量=1"
+ */
+QString BusAnalyzer::describeRequest(const BusTransaction &t)
+{
+    const QString name = functionName(t.functionCode);
+    const QByteArray &r = t.request;
+    // 功能码之后的字段起始位置
+    const int p = unitOffset(t.format) + 2;
+    if (r.size() < p + 4) {
+        return name;
+    }
+    switch (t.functionCode) {
+    case 0x01:
+    case 0x02:
+    case 0x03:
+    case 0x04:
+    case 0x0F:
+    case 0x10:
+        return QStringLiteral("%1 地址=%2 数量=%3").arg(name).arg(wordAt(r, p)).arg(wordAt(r, p + 2));
+    case 0x05:
+    case 0x06:
+        return QStringLiteral("%1 地址=%2 值=%3").arg(name).arg(wordAt(r, p)).arg(wordAt(r, p + 2));
+    case 0x17:
+        if (r.size() >= p + 8) {
+            return QStringLiteral("%1 读%2/%3 写%4/%5").arg(name).arg(wordAt(r, p)).arg(wordAt(r, p + 2))
+                    .arg(wordAt(r, p + 4)).arg(wordAt(r, p + 6));
+        }
+        return name;
+    default:
+        return name;
+    }
+}
+
+void BusAnalyzer::writeReport(QTextStream &out) const
+{
+    int totals[8] = {};
+    int retries = 0;
+    for (const BusTransaction &t : m_transactions) {
+        ++totals[t.outcome];
+        retries += t.retry ? 1 : 0;
+    }
+
+    out << "捕获: " << m_frameCount << " 帧";
+    if (m_frameCount > 0) {
+        out << "，" << formatTime(m_firstNs) << " ~ " << formatTime(m_lastNs)
+            << "（" << QString::number(static_cast<double>(m_lastNs - m_firstNs) / 1e9, 'f', 1) << " 秒）";
+    }
+    out << "\n";
+    out << "事务: " << m_transactions.size()
+        << "，成功 " << totals[BusTransaction::Ok]
+        << "，异常应答 " << totals[BusTransaction::Exception]
+        << "，超时 " << totals[BusTransaction::Timeout]
+        << "，CRC错误 " << totals[BusTransaction::CrcError]
+        << "，应答不完整 " << totals[BusTransaction::Truncated]
+        << "，应答不匹配 " << totals[BusTransaction::Mismatch]
+        << "，广播 " << totals[BusTransaction::Broadcast]
+        << "，重发 " << retries
+        << "，未结束 " << totals[BusTransaction::Open] << "\n";
+    if (m_strayFrames > 0 || m_malformedFrames > 0) {
+        out << "无法匹配请求的应答帧: " << m_strayFrames << "，无效帧: " << m_malformedFrames << "\n";
+    }
+    if (m_hasRebuilt) {
+        out << "注意: 包含Qt主站的重建帧，时间戳为提交/完成时刻且看不到Qt内部重发与CRC错误；"
+               "精确诊断请启用自有传输层（nativeTransport）后重新捕获\n";
+    }
+
+    out << "\n功能码:\n";
+    for (auto it = m_functionCodes.cbegin(); it != m_functionCodes.cend(); ++it) {
+        out << QStringLiteral("  %1 ").arg(it.key(), 2, 16, QLatin1Char('0')).toUpper()
+            << functionName(it.key()) << ": " << it.value() << "\n";
+    }
+    if (!m_exceptionCodes.isEmpty()) {
+        out << "异常码:\n";
+        for (auto it = m_exceptionCodes.cbegin(); it != m_exceptionCodes.cend(); ++it) {
+            out << QStringLiteral("  %1 ").arg(it.key(), 2, 16, QLatin1Char('0')).toUpper()
+                << exceptionName(it.key()) << ": " << it.value() << "\n";
+        }
+    }
+
+    for (auto it = m_slaves.cbegin(); it != m_slaves.cend(); ++it) {
+        const SlaveStats &s = it.value();
+        out << "\n从站 " << it.key() << ": 请求 " << s.requests << "，成功 " << s.ok
+            << "，异常 " << s.exceptions << "，超时 " << s.timeouts << "，CRC错误 " << s.crcErrors
+            << "，不完整 " << s.truncated << "，不匹配 " << s.mismatches << "，重发 " << s.retries << "\n";
+        if (s.latenciesNs.isEmpty()) {
+            continue;
+        }
+        qint64 sum = 0;
+        for (qint64 ns : s.latenciesNs) {
+            sum += ns;
+        }
+        out << "  往返(ms): 最小 " << formatMs(s.latenciesNs.first())
+            << "  中位 " << formatMs(s.percentileNs(0.5))
+            << "  P90 " << formatMs(s.percentileNs(0.9))
+            << "  P99 " << formatMs(s.percentileNs(0.99))
+            << "  最大 " << formatMs(s.latenciesNs.last())
+            << "  平均 " << formatMs(sum / s.latenciesNs.size()) << "\n";
+        const QVector<int> counts = histogram(s.latenciesNs);
+        out << "  分布:";
+        for (int b = 0; b < BucketCount; ++b) {
+            if (counts.at(b) > 0) {
+                out << " " << bucketLabel(b) << "=" << counts.at(b);
+            }
+        }
+        out << "\n";
+    }
+
+    out << "\n空闲间隙（请求间隔超过 " << formatMs(m_effectiveGapNs) << " ms）: " << m_gaps.size() << " 处\n";
+    const int shown = qMin(static_cast<int>(m_gaps.size()), 20);
+    for (int i = 0; i < shown; ++i) {
+        out << "  " << formatTime(m_gaps.at(i).startNs) << "  " << formatMs(m_gaps.at(i).durationNs) << " ms\n";
+    }
+    if (m_gaps.size() > shown) {
+        out << "  ……其余 " << m_gaps.size() - shown << " 处见 --json 输出\n";
+    }
+}
+
+QJsonObject BusAnalyzer::toJson() const
+{
+    QJsonObject root;
+    root["frames"] = m_frameCount;
+    root["firstTime"] = formatTime(m_firstNs);
+    root["lastTime"] = formatTime(m_lastNs);
+    root["durationMs"] = static_cast<double>(m_lastNs - m_firstNs) / 1e6;
+    root["transactions"] = static_cast<int>(m_transactions.size());
+    root["strayFrames"] = m_strayFrames;
+    root["malformedFrames"] = m_malformedFrames;
+    root["rebuiltFrames"] = m_hasRebuilt;
+
+    QJsonObject outcomes;
+    int retries = 0;
+    for (const BusTransaction &t : m_transactions) {
+        const QString key = QString::fromLatin1(OutcomeKeys[t.outcome]);
+        outcomes[key] = outcomes.value(key).toInt() + 1;
+        retries += t.retry ? 1 : 0;
+    }
+    outcomes["retries"] = retries;
+    root["outcomes"] = outcomes;
+
+    QJsonObject functions;
+    for (auto it = m_functionCodes.cbegin(); it != m_functionCodes.cend(); ++it) {
+        functions[QString::number(it.key())] = it.value();
+    }
+    root["functionCodes"] = functions;
+    QJsonObject exceptions;
+    for (auto it = m_exceptionCodes.cbegin(); it != m_exceptionCodes.cend(); ++it) {
+        exceptions[QString::number(it.key())] = it.value();
+    }
+    root["exceptionCodes"] = exceptions;
+
+    QJsonArray slaves;
+    for (auto it = m_slaves.cbegin(); it != m_slaves.cend(); ++it) {
+        const SlaveStats &s = it.value();
+        QJsonObject slave;
+        slave["slave"] = it.key();
+        slave["requests"] = s.requests;
+        slave["ok"] = s.ok;
+        slave["exceptions"] = s.exceptions;
+        slave["timeouts"] = s.timeouts;
+        slave["crcErrors"] = s.crcErrors;
+        slave["truncated"] = s.truncated;
+        slave["mismatches"] = s.mismatches;
+        slave["retries"] = s.retries;
+        if (!s.latenciesNs.isEmpty()) {
+            QJsonObject latency;
+            latency["minMs"] = s.latenciesNs.first() / 1e6;
+            latency["p50Ms"] = s.percentileNs(0.5) / 1e6;
+            latency["p90Ms"] = s.percentileNs(0.9) / 1e6;
+            latency["p99Ms"] = s.percentileNs(0.99) / 1e6;
+            latency["maxMs"] = s.latenciesNs.last() / 1e6;
+            QJsonArray buckets;
+            const QVector<int> counts = histogram(s.latenciesNs);
+            for (int b = 0; b < BucketCount; ++b) {
+                buckets.append(QJsonObject{ { "range", bucketLabel(b) }, { "count", counts.at(b) } });
+            }
+            latency["histogram"] = buckets;
+            slave["latency"] = latency;
+        }
+        slaves.append(slave);
+    }
+    root["slaves"] = slaves;
+
+    QJsonArray gaps;
+    for (const BusGap &gap : m_gaps) {
+        gaps.append(QJsonObject{ { "start", formatTime(gap.startNs) }, { "durationMs", gap.durationNs / 1e6 } });
+    }
+    root["gapThresholdMs"] = m_effectiveGapNs / 1e6;
+    root["gaps"] = gaps;
+    return root;
+}
+
+bool BusAnalyzer::exportTimeline(const QString &path, QString &error) const
+{
+    QFile file(path);
+    if (!file.open(QIODevice::WriteOnly | QIODevice::Truncate)) {
+        error = file.errorString();
+        return false;
+    }
+
+    file.write("\xEF\xBB\xBF");
+    file.write(QStringLiteral("时间,偏移(ms),从站,功能码,请求,结果,异常码,往返(ms),重发,请求帧,应答帧\n").toUtf8());
+    for (const BusTransaction &t : m_transactions) {
+        QByteArray line;
+        line.reserve(160);
+        line += '\'';
+        line += formatTime(t.requestNs).toLatin1();
+        line += ',';
+        line += formatMs(t.requestNs - m_firstNs).toLatin1();
+        line += ',';
+        line += QByteArray::number(t.slave);
+        line += ',';
+        line += QByteArray::number(t.functionCode);
+        line += ',';
+        line += describeRequest(t).toUtf8();
+        line += ',';
+        line += outcomeName(t.outcome).toUtf8();
+        line += ',';
+        if (t.outcome == BusTransaction::Exception) {
+            line += QByteArray::number(t.exceptionCode);
+        }
+        line += ',';
+        if (t.latencyNs() >= 0) {
+            line += formatMs(t.latencyNs()).toLatin1();
+        }
+        line += ',';
+        line += t.retry ? '1' : '0';
+        line += ',';
+        line += t.request.toHex(' ').toUpper();
+        line += ',';
+        line += t.response.toHex(' ').toUpper();
+        line += '\n';
+        if (file.write(line) != line.size()) {
+            error = file.errorString();
+            return false;
+        }
+    }
+    return true;
+}
@@ -0,0 +1,155 @@
+#ifndef BUSANALYZER_H
+#define BUSANALYZER_H
+
+#include <QByteArray>
+#include <QJsonObject>
+#include <QMap>
+#include <QString>
+#include <QVector>
+
+class BusCapture;
+class QTextStream;
+
+/**
+ * @brief 一次总线事务（请求及其应答）
+ */
+struct BusTransaction {
+    /**
+     * @brief 事务结果
+     */
+    enum Outcome {
+        Ok,
+        Exception,      ///< 从站异常应答
+        Timeout,        ///< 下一请求发出前没有应答
+        CrcError,       ///< 应答完整但CRC校验失败
+        Truncated,      ///< 应答不完整（超时时只收到部分字节）
+        Mismatch,       ///< 应答地址或功能码与请求不符
+        Broadcast,      ///< 广播，不需要应答
+        Open            ///< 捕获结束时尚未应答
+    };
+
+    qint64 requestNs = 0;
+    qint64 responseNs = -1;
+    int slave = 0;
+    quint8 functionCode = 0;
+    quint8 exceptionCode = 0;
+    quint8 format = 0;
+    bool retry = false;             ///< 上一次相同请求失败后的重发
+    Outcome outcome = Open;
+    QByteArray request;
+    QByteArray response;
+
+    qint64 latencyNs() const { return responseNs >= 0 ? responseNs - requestNs : -1; }
+    bool failed() const { return outcome != Ok && outcome != Broadcast && outcome != Open; }
+};
+
+/**
+ * @brief 单个从站的统计
+ */
+struct SlaveStats {
+    int requests = 0;
+    int ok = 0;
+    int exceptions = 0;
+    int timeouts = 0;
+    int crcErrors = 0;
+    int truncated = 0;
+    int mismatches = 0;
+    int retries = 0;
+    QVector<qint64> latenciesNs;    ///< 成功与异常应答的往返时间，分析结束后已排序
+    QMap<int, int> functionCodes;
+
+    qint64 percentileNs(double q) const;
+};
+
+/**
+ * @brief 总线空闲间隙
+ */
+struct BusGap {
+    qint64 startNs = 0;
+    qint64 durationNs = 0;
+};
+
+/**
+ * @brief 总线捕获离线分析
+ * @details - 把发送帧与应答帧配成事务：串口RTU同一时刻只有一个事务，下一请求发出时上一请求视为超时；
+ *            Modbus TCP按事务标识符匹配；Qt主站的重建帧按提交顺序（先进先出）匹配
+ *          - 识别CRC错误、截断应答、异常应答、地址/功能码不符与重发
+ *          - 按从站统计往返时间分布，找出请求间隔超过阈值的总线空闲间隙
+ *          - 导出逐事务时间线（CSV）
+ */
+class BusAnalyzer
+{
+public:
+    BusAnalyzer();
+
+    /**
+     * @brief 只分析指定从站
+     * @param slave 从站地址，-1表示全部
+     */
+    void setSlaveFilter(int slave) { m_slaveFilter = slave; }
+
+    /**
+     * @brief 设置空闲间隙阈值
+     * @param ns 纳秒，<=0时取请求间隔中位数的5倍（至少100ms）
+     */
+    void setGapThresholdNs(qint64 ns) { m_gapThresholdNs = ns; }
+
+    /**
+     * @brief 分析捕获
+     */
+    void analyze(const BusCapture &capture);
+
+    const QVector<BusTransaction> &transactions() const { return m_transactions; }
+    const QMap<int, SlaveStats> &slaves() const { return m_slaves; }
+    const QVector<BusGap> &gaps() const { return m_gaps; }
+
+    /**
+     * @brief 输出文本报告
+     */
+    void writeReport(QTextStream &out) const;
+
+    /**
+     * @brief 报告的JSON形式
+     */
+    QJsonObject toJson() const;
+
+    /**
+     * @brief 导出逐事务时间线
+     * @param path CSV文件路径（UTF-8 with BOM）
+     * @param error 失败原因
+     */
+    bool exportTimeline(const QString &path, QString &error) const;
+
+    static QString functionName(int functionCode);
+    static QString exceptionName(int exceptionCode);
+    static QString outcomeName(BusTransaction::Outcome outcome);
+
+private:
+    void onRequest(const QByteArray &frame, qint64 timeNs, quint8 format);
+    void onResponse(const QByteArray &frame, qint64 timeNs, quint8 format);
+    void close(int index, BusTransaction::Outcome outcome);
+    void resolve(BusTransaction &t, const QByteArray &frame, qint64 timeNs);
+    void collectStatistics();
+    static QString describeRequest(const BusTransaction &t);
+
+    int m_slaveFilter;
+    qint64 m_gapThresholdNs;
+    qint64 m_effectiveGapNs;
+
+    QVector<BusTransaction> m_transactions;
+    QVector<int> m_open[3];         ///< 按帧格式分别保存未结束的事务
+    int m_lastRtu;                  ///< 串口RTU最近一个事务，用于识别重发
+    int m_strayFrames;              ///< 无法匹配请求的应答帧
+    int m_malformedFrames;
+
+    QMap<int, SlaveStats> m_slaves;
+    QMap<int, int> m_functionCodes;
+    QMap<int, int> m_exceptionCodes;
+    QVector<BusGap> m_gaps;
+    qint64 m_firstNs;
+    qint64 m_lastNs;
+    int m_frameCount;
+    bool m_hasRebuilt;
+};
+
+#endif
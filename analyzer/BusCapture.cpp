@@ -0,0 +1,95 @@
+#include "BusCapture.h"
+#include "../core/Logger.h"
+#include <QFile>
+#include <QtEndian>
+#include <algorithm>
+
+namespace {
+
+constexpr quint32 FrameFileMagic = 0x4C424652;
+constexpr int FileHeaderSize = 16;
+constexpr int RecordHeaderSize = 16;
+
+/**
+ * @brief 版本1文件中判断是否为Modbus TCP帧
+ * @details 协议标识符为0且长度字段与帧长一致
+ */
+bool looksLikeMbap(const uchar *data, int length)
+{
+    return length >= 8 && data[2] == 0 && data[3] == 0 && qFromBigEndian<quint16>(data + 4) == length - 6;
+}
+
+} // namespace
+
+BusCapture::BusCapture()
+    : m_fileCount(0)
+    , m_bytes(0)
+    , m_truncatedRecords(0)
+{
+}
+
+bool BusCapture::load(const QString &path, QString &error)
+{
+    QFile file(path);
+    if (!file.open(QIODevice::ReadOnly)) {
+        error = QStringLiteral("%1: %2").arg(path, file.errorString());
+        return false;
+    }
+    const qint64 size = file.size();
+    if (size < FileHeaderSize) {
+        error = QStringLiteral("%1: 文件过短").arg(path);
+        return false;
+    }
+    const uchar *base = file.map(0, size);
+    if (!base) {
+        error = QStringLiteral("%1: %2").arg(path, file.errorString());
+        return false;
+    }
+
+    const quint32 magic = qFromLittleEndian<quint32>(base);
+    const quint16 version = qFromLittleEndian<quint16>(base + 4);
+    if (magic != FrameFileMagic || version < 1 || version > 2) {
+        error = QStringLiteral("%1: 不是总线帧捕获文件（魔数或版本不符）").arg(path);
+        file.unmap(const_cast<uchar *>(base));
+        return false;
+    }
+    const qint64 startNs = qFromLittleEndian<qint64>(base + 8) * 1000000LL;
+
+    // 记录数未知，按最短帧估算预留
+    m_frames.reserve(m_frames.size() + static_cast<int>(size / (RecordHeaderSize + 8)));
+    const uchar *p = base + FileHeaderSize;
+    const uchar *end = base + size;
+    while (p < end) {
+        if (end - p < RecordHeaderSize) {
+            ++m_truncatedRecords;
+            break;
+        }
+        const int length = qFromLittleEndian<quint16>(p + 14);
+        if (end - p < RecordHeaderSize + length) {
+            ++m_truncatedRecords;
+            break;
+        }
+
+        CapturedFrame frame;
+        frame.timeNs = startNs + qFromLittleEndian<qint64>(p);
+        frame.category = qFromLittleEndian<quint32>(p + 8);
+        frame.direction = p[12];
+        frame.format = version >= 2 ? p[13]
+                                    : (looksLikeMbap(p + RecordHeaderSize, length) ? Log::TcpFrame : Log::RtuFrame);
+        frame.data = QByteArray(reinterpret_cast<const char *>(p + RecordHeaderSize), length);
+        m_frames.append(frame);
+        p += RecordHeaderSize + length;
+    }
+
+    file.unmap(const_cast<uchar *>(base));
+    ++m_fileCount;
+    m_bytes += size;
+    return true;
+}
+
+void BusCapture::finish()
+{
+    std::stable_sort(m_frames.begin(), m_frames.end(), [](const CapturedFrame &a, const CapturedFrame &b) {
+        return a.timeNs < b.timeNs;
+    });
+}
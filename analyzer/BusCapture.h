@@ -0,0 +1,55 @@
+#ifndef BUSCAPTURE_H
+#define BUSCAPTURE_H
+
+#include <QByteArray>
+#include <QString>
+#include <QVector>
+
+/**
+ * @brief 捕获文件中的一帧
+ */
+struct CapturedFrame {
+    qint64 timeNs = 0;          ///< 纪元起的纳秒（文件头起始时刻 + 单调时钟偏移）
+    quint32 category = 0;       ///< 日志类别：Transport为自有传输层，Modbus为Qt主站
+    quint8 direction = 0;       ///< Log::FrameDirection
+    quint8 format = 0;          ///< Log::FrameFormat
+    QByteArray data;
+};
+
+/**
+ * @brief 总线帧捕获文件读取器
+ * @details 读取Logger写出的bus-frames*.bin（版本1、2）。文件以内存映射方式读取；
+ *          滚动产生的多个文件或多次运行的文件可一并加载，按绝对时间合并排序。
+ *          版本1没有帧格式字段，按MBAP报文头特征区分Modbus TCP帧
+ */
+class BusCapture
+{
+public:
+    BusCapture();
+
+    /**
+     * @brief 加载一个捕获文件
+     * @param path 文件路径
+     * @param error 失败原因
+     * @return 文件头是否有效；末尾不完整的记录（进程异常退出）计入truncatedRecords
+     */
+    bool load(const QString &path, QString &error);
+
+    /**
+     * @brief 按时间排序全部已加载的帧
+     */
+    void finish();
+
+    const QVector<CapturedFrame> &frames() const { return m_frames; }
+    int fileCount() const { return m_fileCount; }
+    qint64 bytes() const { return m_bytes; }
+    int truncatedRecords() const { return m_truncatedRecords; }
+
+private:
+    QVector<CapturedFrame> m_frames;
+    int m_fileCount;
+    qint64 m_bytes;
+    int m_truncatedRecords;
+};
+
+#endif
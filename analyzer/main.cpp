@@ -0,0 +1,87 @@
+#include <QCoreApplication>
+#include <QCommandLineParser>
+#include <QStandardPaths>
+#include <QDir>
+#include <QJsonDocument>
+#include <QTextStream>
+#include <cstdio>
+#include "BusCapture.h"
+#include "BusAnalyzer.h"
+
+int main(int argc, char *argv[]) {
+    QCoreApplication app(argc, argv);
+    // 与界面版共用应用数据目录，未指定文件时读取本机日志目录下的捕获
+    QCoreApplication::setApplicationName("demo3");
+
+    QCommandLineParser parser;
+    parser.setApplicationDescription("Modbus总线捕获离线分析：功能码解码、各从站往返时间分布、超时/重发/CRC错误与空闲间隙");
+    parser.addHelpOption();
+    parser.addPositionalArgument("files", "bus-frames*.bin捕获文件，默认读取日志目录下的全部捕获", "[files...]");
+    const QCommandLineOption timelineOption("timeline", "导出逐事务时间线CSV", "file");
+    const QCommandLineOption jsonOption("json", "以JSON输出报告");
+    const QCommandLineOption gapOption("gap-ms", "空闲间隙阈值（毫秒），默认取请求间隔中位数的5倍", "ms");
+    const QCommandLineOption slaveOption("slave", "只分析指定从站", "address");
+    parser.addOptions({ timelineOption, jsonOption, gapOption, slaveOption });
+    parser.process(app);
+
+    QStringList files = parser.positionalArguments();
+    if (files.isEmpty()) {
+        // 滚动文件编号越大越旧，加载后统一按时间排序
+        const QDir logs(QDir(QStandardPaths::writableLocation(QStandardPaths::AppLocalDataLocation)).filePath("logs"));
+        for (const QString &name : logs.entryList({ "bus-frames*.bin" }, QDir::Files)) {
+            files.append(logs.filePath(name));
+        }
+        if (files.isEmpty()) {
+            std::fprintf(stderr, "未找到捕获文件（%s）\n\n%s", qPrintable(logs.path()), qPrintable(parser.helpText()));
+            return 1;
+        }
+    }
+
+    BusCapture capture;
+    for (const QString &file : files) {
+        QString error;
+        if (!capture.load(file, error)) {
+            std::fprintf(stderr, "%s\n", qPrintable(error));
+            return 1;
+        }
+    }
+    capture.finish();
+    if (capture.truncatedRecords() > 0) {
+        std::fprintf(stderr, "警告: %d 个文件末尾记录不完整，已忽略\n", capture.truncatedRecords());
+    }
+
+    BusAnalyzer analyzer;
+    if (parser.isSet(gapOption)) {
+        analyzer.setGapThresholdNs(static_cast<qint64>(parser.value(gapOption).toDouble() * 1e6));
+    }
+    if (parser.isSet(slaveOption)) {
+        bool ok = false;
+        const int slave = parser.value(slaveOption).toInt(&ok);
+        if (!ok || slave < 0 || slave > 247) {
+            std::fprintf(stderr, "无效的从站地址: %s\n", qPrintable(parser.value(slaveOption)));
+            return 1;
+        }
+        analyzer.setSlaveFilter(slave);
+    }
+    analyzer.analyze(capture);
+
+    QTextStream out(stdout);
+    if (parser.isSet(jsonOption)) {
+        out << QJsonDocument(analyzer.toJson()).toJson(QJsonDocument::Indented);
+    } else {
+        out << "文件: " << capture.fileCount() << " 个，" << capture.bytes() / 1024 << " KB\n";
+        analyzer.writeReport(out);
+    }
+    out.flush();
+
+    if (parser.isSet(timelineOption)) {
+        QString error;
+        if (!analyzer.exportTimeline(parser.value(timelineOption), error)) {
+            std::fprintf(stderr, "导出时间线失败: %s\n", qPrintable(error));
+            return 1;
+        }
+        std::fprintf(stderr, "时间线已导出到 %s（%d 个事务）\n", qPrintable(parser.value(timelineOption)),
+                     static_cast<int>(analyzer.transactions().size()));
+    }
+    return 0;
+}
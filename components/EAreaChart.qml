@@ -3,6 +3,7 @@ import QtQuick
 import QtQuick.Layouts
 import QtQuick.Controls
 import QtQuick.Effects
+import EvolveUI
 
 Rectangle {
     id: root
@@ -378,6 +379,13 @@ Rectangle {
             }
             
             onPaint: {
+                // 性能浮层打开时统计绘制耗时
+                var started = Metrics.enabled ? Metrics.beginSpan() : 0;
+                paintChart();
+                if (started > 0) Metrics.endSpan(Metrics.ChartPaint, started);
+            }
+
+            function paintChart() {
                 var ctx = getContext("2d");
                 ctx.clearRect(0, 0, width, height);
                 
@@ -455,11 +463,11 @@ Rectangle {
             // 当数据改变时重新绘制
             Connections {
                 target: root
-                function onDataPointsChanged() { chartCanvas.requestPaint(); }
-                function onDataSeriesChanged() { chartCanvas.requestPaint(); }
-                function onAreaColorChanged() { chartCanvas.requestPaint(); }
-                function onLineColorChanged() { chartCanvas.requestPaint(); }
-                function onHoveredIndexChanged() { chartCanvas.requestPaint(); }
+                function onDataPointsChanged() { UpdateScheduler.requestPaint(chartCanvas); }
+                function onDataSeriesChanged() { UpdateScheduler.requestPaint(chartCanvas); }
+                function onAreaColorChanged() { UpdateScheduler.requestPaint(chartCanvas); }
+                function onLineColorChanged() { UpdateScheduler.requestPaint(chartCanvas); }
+                function onHoveredIndexChanged() { UpdateScheduler.requestPaint(chartCanvas); }
             }
         }
 
@@ -685,7 +693,7 @@ Rectangle {
     Connections {
         target: root
         function onLineStyleChanged() {
-            chartCanvas.requestPaint();
+            UpdateScheduler.requestPaint(chartCanvas);
         }
     }
 }
@@ -8,7 +8,8 @@ Item {
     width: 80
     height: 80
 
-    property url avatarSource: "qrc:/new/prefix1/fonts/pic/avatar.png"
+    // 经scaled图片源按显示尺寸解码，避免每次启动解码原始大图
+    property url avatarSource: "image://scaled/new/prefix1/fonts/pic/avatar.png"
 
     // 原始图像，隐藏
     Image {
@@ -17,6 +18,8 @@ Item {
         anchors.centerIn: parent
         width: root.width
         height: root.height
+        sourceSize: Qt.size(root.width, root.height)
+        asynchronous: true
         fillMode: Image.PreserveAspectCrop
         visible: false
     }
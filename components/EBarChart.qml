@@ -3,6 +3,7 @@ import QtQuick
 import QtQuick.Layouts
 import QtQuick.Controls
 import QtQuick.Effects
+import EvolveUI
 
 Rectangle {
     id: root
@@ -149,6 +150,13 @@ Rectangle {
             property var barRects: [] // 存储柱子的区域用于鼠标检测
 
             onPaint: {
+                // 性能浮层打开时统计绘制耗时
+                var started = Metrics.enabled ? Metrics.beginSpan() : 0;
+                paintChart();
+                if (started > 0) Metrics.endSpan(Metrics.ChartPaint, started);
+            }
+
+            function paintChart() {
                 var ctx = getContext("2d");
                 ctx.clearRect(0, 0, width, height);
                 
@@ -238,12 +246,12 @@ Rectangle {
             // 当数据改变时重新绘制
             Connections {
                 target: root
-                function onDataPointsChanged() { chartCanvas.requestPaint(); }
-                function onDataSeriesChanged() { chartCanvas.requestPaint(); }
-                function onEffectiveDataSeriesChanged() { chartCanvas.requestPaint(); }
-                function onTextColorChanged() { chartCanvas.requestPaint(); }
-                function onHoveredSeriesIndexChanged() { chartCanvas.requestPaint(); }
-                function onHoveredDataIndexChanged() { chartCanvas.requestPaint(); }
+                function onDataPointsChanged() { UpdateScheduler.requestPaint(chartCanvas); }
+                function onDataSeriesChanged() { UpdateScheduler.requestPaint(chartCanvas); }
+                function onEffectiveDataSeriesChanged() { UpdateScheduler.requestPaint(chartCanvas); }
+                function onTextColorChanged() { UpdateScheduler.requestPaint(chartCanvas); }
+                function onHoveredSeriesIndexChanged() { UpdateScheduler.requestPaint(chartCanvas); }
+                function onHoveredDataIndexChanged() { UpdateScheduler.requestPaint(chartCanvas); }
             }
         }
 
@@ -117,18 +117,11 @@ Item {
         }
     }
 
-    Timer {
-        interval: 100
-        running: true
-        repeat: true
-        onTriggered: {
-            if (root.modbusManager) {
-                dataRecorder.addData(
-                    root.modbusManager.voltage,
-                    root.modbusManager.current,
-                    root.modbusManager.power
-                )
-            }
+    // 每个采样点直接送入记录器
+    Connections {
+        target: root.modbusManager
+        function onSampleReady(voltage, current, power, timestampNs) {
+            dataRecorder.addData(voltage, current, power, timestampNs)
         }
     }
 }
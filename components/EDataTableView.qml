@@ -0,0 +1,275 @@
+// EDataTableView.qml
+// 面向C++表格模型（如RecordTableModel）的虚拟化数据表：
+// 基于TableView复用委托，只创建可见行；全选、计数、排序均由模型在C++中完成
+import QtQuick
+import QtQuick.Layouts
+import QtQuick.Controls
+import QtQuick.Effects
+
+Rectangle {
+    id: root
+
+    width: 600
+    height: 400
+    color: "transparent"
+    clip: false
+
+    // === 接口属性 & 信号 ===
+    // headers: [{ label: "时间", sample: "0000-00-00 00:00:00" }, ...]，sample用于估算列宽
+    property var headers: []
+    property var model: null
+    property bool selectable: false
+    property bool sortable: true
+    signal rowClicked(int row, int sourceRow)
+    signal checkStateChanged(int row, int sourceRow, bool isChecked)
+
+    // === 样式属性 ===
+    property bool backgroundVisible: true
+    property real radius: 20
+    property int headerHeight: 42
+    property int rowHeight: 36
+    property int fontSize: 14
+    property int cellPadding: 12
+    property color headerColor: theme.secondaryColor
+    property color rowColor: theme.secondaryColor
+    property color hoverColor: Qt.darker(rowColor, 1.15)
+    property color textColor: theme.textColor
+    property color headerTextColor: theme.textColor
+    property bool shadowEnabled: true
+    property color shadowColor: theme.shadowColor
+    property color checkmarkColor: theme.focusColor
+    property int boxSize: 20
+
+    // === 动态列宽数组（只按表头与样例文本计算，不遍历数据行）===
+    property var columnWidths: []
+    readonly property int checkColumnWidth: selectable ? 40 : 0
+    property int hoveredRow: -1
+
+    TextMetrics {
+        id: textMetrics
+        font.pixelSize: root.fontSize
+    }
+
+    function calculateColumnWidths() {
+        var widths = [];
+        for (var i = 0; i < headers.length; i++) {
+            textMetrics.text = headers[i].label;
+            var w = Math.max(80, textMetrics.width + cellPadding * 2 + 16);
+            if (headers[i].sample !== undefined) {
+                textMetrics.text = headers[i].sample;
+                w = Math.max(w, textMetrics.width + cellPadding * 2);
+            }
+            widths.push(w);
+        }
+        columnWidths = widths;
+        tableView.forceLayout();
+    }
+
+    Component.onCompleted: calculateColumnWidths();
+    onHeadersChanged: calculateColumnWidths();
+
+    // === 背景与阴影===
+    Rectangle {
+        id: background
+        anchors.fill: parent
+        radius: root.radius
+        color: root.backgroundVisible ? root.rowColor : "transparent"
+
+        layer.enabled: root.shadowEnabled && root.backgroundVisible
+        layer.effect: MultiEffect {
+            shadowEnabled: root.shadowEnabled
+            shadowColor: root.shadowColor
+            shadowBlur: theme.shadowBlur
+            shadowHorizontalOffset: theme.shadowXOffset
+            shadowVerticalOffset: theme.shadowYOffset
+        }
+
+        Item {
+            anchors.fill: parent
+            anchors.margins: 10
+            clip: true
+
+            // === 表头（随表格水平滚动）===
+            Row {
+                id: headerRow
+                x: -tableView.contentX
+                height: root.headerHeight
+                spacing: 0
+
+                // 全选复选框列
+                Rectangle {
+                    visible: root.selectable
+                    width: root.checkColumnWidth
+                    height: parent.height
+                    color: root.backgroundVisible ? root.headerColor : "transparent"
+
+                    Rectangle {
+                        anchors.centerIn: parent
+                        width: root.boxSize
+                        height: root.boxSize
+                        radius: root.boxSize * 0.25
+                        border.color: root.checkmarkColor
+                        border.width: 2
+
+                        readonly property string checkState: root.model ? root.model.headerCheckState : "none"
+                        color: checkState !== "none" ? root.checkmarkColor : "transparent"
+
+                        Behavior on color { ColorAnimation { duration: 150 } }
+
+                        Text {
+                            anchors.centerIn: parent
+                            visible: parent.checkState === "all"
+                            text: "\u2713"
+                            color: root.rowColor
+                            font.pixelSize: 16
+                        }
+
+                        Text {
+                            anchors.centerIn: parent
+                            visible: parent.checkState === "partial"
+                            text: "\u2212"
+                            color: root.rowColor
+                            font.pixelSize: 18
+                            font.bold: true
+                        }
+
+                        MouseArea {
+                            anchors.fill: parent
+                            cursorShape: Qt.PointingHandCursor
+                            onClicked: {
+                                if (root.model) {
+                                    root.model.setAllChecked(parent.checkState !== "all");
+                                }
+                            }
+                        }
+                    }
+                }
+
+                // 数据列头（点击切换排序：升序 → 降序 → 记录顺序）
+                Repeater {
+                    model: root.headers
+                    delegate: Rectangle {
+                        width: root.columnWidths[index] !== undefined ? root.columnWidths[index] : 80
+                        height: parent.height
+                        color: root.backgroundVisible ? root.headerColor : "transparent"
+
+                        readonly property bool sorted: root.model && root.model.sortColumn === index
+
+                        Text {
+                            anchors.centerIn: parent
+                            text: modelData.label + (parent.sorted ? (root.model.sortDescending ? " \u25BC" : " \u25B2") : "")
+                            font.pixelSize: root.fontSize
+                            font.bold: true
+                            color: root.headerTextColor
+                            elide: Text.ElideRight
+                        }
+
+                        MouseArea {
+                            anchors.fill: parent
+                            enabled: root.sortable && root.model
+                            cursorShape: Qt.PointingHandCursor
+                            onClicked: {
+                                if (!parent.sorted) {
+                                    root.model.sortByColumn(index, false);
+                                } else if (!root.model.sortDescending) {
+                                    root.model.sortByColumn(index, true);
+                                } else {
+                                    root.model.sortByColumn(-1, false);
+                                }
+                            }
+                        }
+                    }
+                }
+            }
+
+            // === 数据区（委托复用，只实例化可见单元格）===
+            TableView {
+                id: tableView
+                anchors.top: headerRow.bottom
+                anchors.left: parent.left
+                anchors.right: parent.right
+                anchors.bottom: parent.bottom
+                model: root.model
+                clip: true
+                reuseItems: true
+                rowSpacing: 2
+                boundsBehavior: Flickable.StopAtBounds
+
+                columnWidthProvider: function(column) {
+                    var w = root.columnWidths[column] !== undefined ? root.columnWidths[column] : 80;
+                    return column === 0 ? w + root.checkColumnWidth : w;
+                }
+                rowHeightProvider: function(row) { return root.rowHeight; }
+
+                ScrollBar.vertical: ScrollBar { policy: ScrollBar.AsNeeded }
+
+                delegate: Rectangle {
+                    id: cell
+                    required property int row
+                    required property int column
+                    required property string display
+                    required property bool checked
+
+                    implicitHeight: root.rowHeight
+                    color: root.backgroundVisible ? (root.hoveredRow === row ? root.hoverColor : root.rowColor) : "transparent"
+
+                    // 行复选框（位于第一列前部）
+                    Rectangle {
+                        visible: root.selectable && cell.column === 0
+                        width: root.checkColumnWidth
+                        height: parent.height
+                        color: "transparent"
+
+                        Rectangle {
+                            anchors.centerIn: parent
+                            width: root.boxSize
+                            height: root.boxSize
+                            radius: root.boxSize * 0.25
+                            border.color: root.checkmarkColor
+                            border.width: 2
+                            color: cell.checked ? root.checkmarkColor : "transparent"
+
+                            Text {
+                                anchors.centerIn: parent
+                                visible: cell.checked
+                                text: "\u2713"
+                                color: root.rowColor
+                                font.pixelSize: 16
+                            }
+                        }
+                    }
+
+                    Text {
+                        anchors.fill: parent
+                        anchors.leftMargin: cell.column === 0 ? root.checkColumnWidth : 0
+                        horizontalAlignment: Text.AlignHCenter
+                        verticalAlignment: Text.AlignVCenter
+                        text: cell.display
+                        color: root.textColor
+                        font.pixelSize: root.fontSize
+                        elide: Text.ElideRight
+                    }
+
+                    MouseArea {
+                        anchors.fill: parent
+                        hoverEnabled: true
+                        cursorShape: Qt.PointingHandCursor
+
+                        onEntered: root.hoveredRow = cell.row
+                        onExited: if (root.hoveredRow === cell.row) root.hoveredRow = -1
+
+                        onClicked: {
+                            var source = root.model.sourceRow(cell.row);
+                            if (root.selectable) {
+                                var newCheckedState = !cell.checked;
+                                root.model.toggleChecked(cell.row);
+                                root.checkStateChanged(cell.row, source, newCheckedState);
+                            }
+                            root.rowClicked(cell.row, source);
+                        }
+                    }
+                }
+            }
+        }
+    }
+}
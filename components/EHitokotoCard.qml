@@ -1,6 +1,7 @@
 import QtQuick
 import QtQuick.Controls
 import QtQuick.Effects
+import EvolveUI
 
 Item {
     id: root
@@ -27,8 +28,20 @@ Item {
     property string acgApiUrl: "https://www.loliapi.com/acg/"
     property string bingImageUrl: "" // 实际使用 acgApiUrl 返回的图片
     property string imageDirectUrl: "" // 记录最终解析出的直链，用于外部跳转
+    // Bing 每日壁纸接口（随机图无法解码时回退使用）
+    property string bingApiUrl: "https://www.bing.com/HPImageArchive.aspx?format=js&idx=0&n=1&mkt=en-US"
     // 每天刷新一次背景（单位：毫秒）
     property int bingRefreshIntervalMs: 24 * 60 * 60 * 1000
+    // 背景预先模糊半径（像素），0 表示不模糊
+    property int imageBlurRadius: 0
+
+    // === FetchCache 请求编号 ===
+    // 有缓存时立即显示缓存内容，网络请求只在后台进行
+    property int quoteRequestId: -1
+    property int imageRequestId: -1
+    property int bingRequestId: -1
+    // 当前背景是否为 Bing 回退图
+    property bool usingBingFallback: false
 
     // 阴影（仅作用于背景容器）
     layer.enabled: shadowEnabled && backgroundVisible
@@ -56,7 +69,7 @@ Item {
             antialiasing: true
         }
 
-        // 原始 Bing 图像，隐藏，仅作为 MultiEffect 的 source
+        // 背景图像（FetchCache 处理后的本地小图），隐藏，仅作为 MultiEffect 的 source
         Image {
             id: bingSource
             anchors.fill: parent
@@ -70,7 +83,7 @@ Item {
             mipmap: true
             sourceSize: Qt.size(Math.round(width), Math.round(height))
 
-            // 当随机图为 WebP 且当前环境不支持解码时，自动回退到 Bing 壁纸
+            // 缓存文件损坏等无法加载时，回退到 Bing 壁纸
             onStatusChanged: {
                 if (status === Image.Error) {
                     fetchBingImageFallback()
@@ -183,8 +196,8 @@ Item {
             cursorShape: Qt.PointingHandCursor
             onClicked: {
                 // 同时刷新文案与背景图片
-                fetchQuote()
-                fetchBingImage()
+                fetchQuote(true)
+                fetchBingImage(true)
             }
         }
 
@@ -215,94 +228,72 @@ Item {
     }
 
     // === Hitokoto 拉取 ===
-    function fetchQuote() {
+    function fetchQuote(force) {
         if (!useNetworkQuote) return
-        try {
-            const xhr = new XMLHttpRequest()
-            xhr.open("GET", quoteApiUrl + "&_=" + Date.now())
-            xhr.onreadystatechange = function() {
-                if (xhr.readyState === XMLHttpRequest.DONE) {
-                    if (xhr.status === 200) {
-                        try {
-                            const payload = JSON.parse(xhr.responseText)
-                            root.quoteText = payload.hitokoto || "(无内容)"
-                            root.quoteFrom = payload.from || ""
-                            root.quoteFromWho = payload.from_who || ""
-                        } catch (e) {
-                            console.error("[Hitokoto] Parse error:", e)
-                        }
-                    } else {
-                        console.warn("[Hitokoto] Request failed:", xhr.status)
-                    }
-                }
-            }
-            xhr.send()
-        } catch (err) {
-            console.error("[Hitokoto] Fetch error:", err)
-        }
+        root.quoteRequestId = FetchCache.fetchText(root.quoteApiUrl, root.quoteRefreshIntervalMs / 1000, force === true)
     }
 
-    // === Bing 背景拉取 ===
-    function fetchBingImage() {
-        // 先尝试获取最终跳转后的直链，确保外部打开与当前显示一致
-        try {
-            const xhr = new XMLHttpRequest()
-            xhr.open("GET", root.acgApiUrl + "?_=" + Date.now())
-            xhr.onreadystatechange = function() {
-                if (xhr.readyState === XMLHttpRequest.DONE) {
-                    if (xhr.status === 200) {
-                        const finalUrl = xhr.responseURL || ""
-                        if (finalUrl && finalUrl.length > 0) {
-                            root.bingImageUrl = finalUrl
-                            root.imageDirectUrl = finalUrl
-                        } else {
-                            // 无法获取直链则仍使用随机端点
-                            const url = root.acgApiUrl + "?_=" + Date.now()
-                            root.bingImageUrl = url
-                            root.imageDirectUrl = url
-                        }
-                    } else {
-                        console.warn("[ACG] Request failed:", xhr.status)
-                    }
-                }
-            }
-            xhr.send()
-        } catch (err) {
-            console.error("[ACG] XHR error:", err)
-            const url = root.acgApiUrl + "?_=" + Date.now()
-            root.bingImageUrl = url
-            root.imageDirectUrl = url
-        }
+    // === 背景拉取 ===
+    // 按卡片显示尺寸请求，缓存中保存的是裁剪缩放（及模糊）后的小图
+    function fetchBingImage(force) {
+        root.usingBingFallback = false
+        root.imageRequestId = FetchCache.fetchImage(root.acgApiUrl,
+                                                    Math.round(root.width * Screen.devicePixelRatio),
+                                                    Math.round(root.height * Screen.devicePixelRatio),
+                                                    root.imageBlurRadius,
+                                                    root.bingRefreshIntervalMs / 1000,
+                                                    force === true)
     }
 
     // Bing 回退：当 loliapi 返回 WebP 且环境未部署解码插件时触发
     function fetchBingImageFallback() {
-        try {
-            const xhr = new XMLHttpRequest()
-            const url = "https://www.bing.com/HPImageArchive.aspx?format=js&idx=0&n=1&mkt=en-US&_=" + Date.now()
-            xhr.open("GET", url)
-            xhr.onreadystatechange = function() {
-                if (xhr.readyState === XMLHttpRequest.DONE) {
-                    if (xhr.status === 200) {
-                        try {
-                            const res = JSON.parse(xhr.responseText)
-                            if (res && res.images && res.images.length > 0) {
-                                const rel = res.images[0].url
-                                const direct = "https://www.bing.com" + rel
-                                root.bingImageUrl = direct
-                                root.imageDirectUrl = direct
-                            }
-                        } catch (e) {
-                            console.error("[Bing Fallback] Parse error:", e)
-                        }
-                    } else {
-                        console.warn("[Bing Fallback] Request failed:", xhr.status)
+        if (root.usingBingFallback) return
+        root.usingBingFallback = true
+        root.bingRequestId = FetchCache.fetchText(root.bingApiUrl, root.bingRefreshIntervalMs / 1000, false)
+    }
+
+    Connections {
+        target: FetchCache
+
+        function onTextReady(requestId, text, fromCache) {
+            if (requestId === root.quoteRequestId) {
+                try {
+                    const payload = JSON.parse(text)
+                    root.quoteText = payload.hitokoto || "(无内容)"
+                    root.quoteFrom = payload.from || ""
+                    root.quoteFromWho = payload.from_who || ""
+                } catch (e) {
+                    console.error("[Hitokoto] Parse error:", e)
+                }
+            } else if (requestId === root.bingRequestId) {
+                try {
+                    const res = JSON.parse(text)
+                    if (res && res.images && res.images.length > 0) {
+                        root.imageRequestId = FetchCache.fetchImage("https://www.bing.com" + res.images[0].url,
+                                                                    Math.round(root.width * Screen.devicePixelRatio),
+                                                                    Math.round(root.height * Screen.devicePixelRatio),
+                                                                    root.imageBlurRadius,
+                                                                    root.bingRefreshIntervalMs / 1000,
+                                                                    false)
                     }
+                } catch (e) {
+                    console.error("[Bing Fallback] Parse error:", e)
                 }
             }
-            xhr.send()
-        } catch (err) {
-            console.error("[Bing Fallback] Fetch error:", err)
+        }
+
+        function onImageReady(requestId, localUrl, sourceUrl, fromCache) {
+            if (requestId === root.imageRequestId) {
+                root.bingImageUrl = localUrl
+                root.imageDirectUrl = sourceUrl
+            }
+        }
+
+        // 离线时保留缓存内容；随机图无法解码且没有缓存时改用 Bing 壁纸
+        function onFetchFailed(requestId, error, served) {
+            if (requestId === root.imageRequestId && !served && !root.usingBingFallback) {
+                fetchBingImageFallback()
+            }
         }
     }
 
@@ -311,7 +302,7 @@ Item {
         interval: quoteRefreshIntervalMs
         running: useNetworkQuote
         repeat: true
-        onTriggered: fetchQuote()
+        onTriggered: fetchQuote(true)
     }
 
     // 每天刷新背景
@@ -319,7 +310,7 @@ Item {
         interval: bingRefreshIntervalMs
         running: true
         repeat: true
-        onTriggered: fetchBingImage()
+        onTriggered: fetchBingImage(true)
     }
 
     // 生命周期
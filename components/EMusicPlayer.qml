@@ -91,7 +91,9 @@ Rectangle {
         property int playMode: 0
     
     // 音乐显色（用于主题动态强调色）
-    property color coverProminentColor: theme.defaultFocusColor // 采样得到的不透明主色（初始为默认强调色）
+    property color coverProminentColor: theme.defaultFocusColor // 封面主色（初始为默认强调色）
+    property color coverMutedColor: theme.secondaryColor          // 封面柔和色
+    property color coverDarkColor: theme.primaryColor             // 封面暗色
     property color previousFocusColor: theme.focusColor   // 播放前的主题强调色
     
     // 自动读取元数据
@@ -155,6 +157,13 @@ Rectangle {
         onDurationChanged: {
             root.duration = duration
         }
+
+        // 色板在C++中解析标签时计算并随索引缓存
+        onPaletteChanged: {
+            root.coverProminentColor = hasPalette ? prominentColor : theme.defaultFocusColor
+            root.coverMutedColor = hasPalette ? mutedColor : theme.secondaryColor
+            root.coverDarkColor = hasPalette ? darkColor : theme.primaryColor
+        }
     }
 
     
@@ -271,7 +280,7 @@ Rectangle {
             source: root.coverImageIsDefault ? "" : root.coverImage
             fillMode: Image.PreserveAspectCrop
             cache: false
-            asynchronous: false
+            asynchronous: true
             sourceSize: Qt.size(Math.round(width * 0.5), Math.round(height * 0.5))
             visible: false
             antialiasing: true
@@ -311,107 +320,6 @@ Rectangle {
             opacity: 1.0
         }
 
-        // 从专辑封面取色（柔和浅色）
-        Canvas {
-            id: coverColorSampler
-            width: 32; height: 32
-            visible: false
-            contextType: "2d"
-
-            onPaint: {
-                var ctx = getContext("2d")
-                ctx.clearRect(0, 0, width, height)
-                if (root.coverImage !== "" && coverSource.status === Image.Ready) {
-                    // 将封面绘制到 Canvas
-                    ctx.drawImage(coverSource, 0, 0, width, height)
-                    var data = ctx.getImageData(0, 0, width, height).data
-
-                    // 构建色相直方图，选取高饱和度中等亮度的主色
-                    var bins = 36 // 10° 为一档
-                    var counts = new Array(bins)
-                    var sumR = new Array(bins)
-                    var sumG = new Array(bins)
-                    var sumB = new Array(bins)
-                    for (var bIndex = 0; bIndex < bins; bIndex++) {
-                        counts[bIndex] = 0; sumR[bIndex] = 0; sumG[bIndex] = 0; sumB[bIndex] = 0
-                    }
-
-                    for (var i = 0; i < data.length; i += 4) {
-                        var a = data[i + 3]
-                        if (a === 0) continue
-                        var r = data[i], g = data[i + 1], b = data[i + 2]
-                        var hsv = rgbToHsv(r, g, b)
-                        // 放宽筛选条件，让更多颜色进入候选，最后再统一调整亮度
-                        if (hsv.s > 0.15 && hsv.v > 0.15 && hsv.v < 0.95) {
-                            var bin = Math.floor((hsv.h / 360.0) * bins)
-                            if (bin < 0) bin = 0
-                            if (bin >= bins) bin = bins - 1
-                            counts[bin]++
-                            sumR[bin] += r
-                            sumG[bin] += g
-                            sumB[bin] += b
-                        }
-                    }
-
-                    var bestBin = -1
-                    var bestCount = 0
-                    for (var j = 0; j < bins; j++) {
-                        if (counts[j] > bestCount) { bestCount = counts[j]; bestBin = j }
-                    }
-
-                    var outR, outG, outB
-                    if (bestBin >= 0 && bestCount > 0) {
-                        outR = sumR[bestBin] / bestCount
-                        outG = sumG[bestBin] / bestCount
-                        outB = sumB[bestBin] / bestCount
-                    } else {
-                        // 回退：取整体平均色
-                        var totalR = 0, totalG = 0, totalB = 0, totalN = 0
-                        for (var k = 0; k < data.length; k += 4) {
-                            var aa = data[k + 3]
-                            if (aa > 0) {
-                                totalR += data[k]
-                                totalG += data[k + 1]
-                                totalB += data[k + 2]
-                                totalN++
-                            }
-                        }
-                        if (totalN > 0) {
-                            outR = totalR / totalN
-                            outG = totalG / totalN
-                            outB = totalB / totalN
-                        } else {
-                            // 都失败时退回主题色
-                            outR = theme.focusColor.r * 255
-                            outG = theme.focusColor.g * 255
-                            outB = theme.focusColor.b * 255
-                        }
-                    }
-
-                    // === 优化：基于 HSL 调整亮度，避免过暗或过亮 ===
-                    var hsl = rgbToHsl(outR, outG, outB)
-                    
-                    // 目标亮度范围：0.35 - 0.75
-                    var targetL = Math.max(0.35, Math.min(0.75, hsl.l))
-                    
-                    // 如果原色有一定饱和度但被调亮了，可能变灰，适当补一点饱和度
-                    if (hsl.s > 0.1) {
-                         // 保持至少 0.3 的饱和度，防止颜色太灰
-                         hsl.s = Math.max(hsl.s, 0.3)
-                    }
-                    
-                    hsl.l = targetL
-                    var finalRgb = hslToRgb(hsl.h, hsl.s, hsl.l)
-
-                    // 设置波纹颜色（半透明）与主题显色（不透明）
-                    var accent = Qt.rgba(finalRgb.r / 255.0, finalRgb.g / 255.0, finalRgb.b / 255.0, 1.0)
-                    root.coverProminentColor = accent
-                }
-            }
-        }
-
-        
-
         // 圆角遮罩
         Item {
             id: backgroundMask
@@ -501,7 +409,7 @@ Rectangle {
                 anchors.fill: parent
                 fillMode: Image.PreserveAspectCrop
                 cache: false
-                asynchronous: false
+                asynchronous: true
                 sourceSize: Qt.size(Math.round(width * 0.6), Math.round(height * 0.6))
                 visible: false
                 antialiasing: true
@@ -993,73 +901,6 @@ Rectangle {
         var secs = seconds % 60
         return mins + ":" + (secs < 10 ? "0" : "") + secs
     }
-
-    // 辅助函数：RGB -> HSV（h:0-360, s/v:0-1）
-    function rgbToHsv(r, g, b) {
-        r /= 255; g /= 255; b /= 255
-        var max = Math.max(r, g, b), min = Math.min(r, g, b)
-        var h, s, v = max
-        var d = max - min
-        s = max === 0 ? 0 : d / max
-        if (max === min) {
-            h = 0
-        } else {
-            switch (max) {
-            case r: h = (g - b) / d + (g < b ? 6 : 0); break
-            case g: h = (b - r) / d + 2; break
-            case b: h = (r - g) / d + 4; break
-            }
-            h *= 60
-        }
-        return { h: h, s: s, v: v }
-    }
-
-    // 辅助函数：RGB -> HSL
-    function rgbToHsl(r, g, b) {
-        r /= 255; g /= 255; b /= 255
-        var max = Math.max(r, g, b), min = Math.min(r, g, b)
-        var h, s, l = (max + min) / 2
-
-        if (max === min) {
-            h = s = 0 // achromatic
-        } else {
-            var d = max - min
-            s = l > 0.5 ? d / (2 - max - min) : d / (max + min)
-            switch (max) {
-                case r: h = (g - b) / d + (g < b ? 6 : 0); break
-                case g: h = (b - r) / d + 2; break
-                case b: h = (r - g) / d + 4; break
-            }
-            h /= 6
-        }
-        return { h: h, s: s, l: l }
-    }
-
-    // 辅助函数：HSL -> RGB
-    function hslToRgb(h, s, l) {
-        var r, g, b
-
-        if (s === 0) {
-            r = g = b = l // achromatic
-        } else {
-            var hue2rgb = function(p, q, t) {
-                if (t < 0) t += 1
-                if (t > 1) t -= 1
-                if (t < 1/6) return p + (q - p) * 6 * t
-                if (t < 1/2) return q
-                if (t < 2/3) return p + (q - p) * (2/3 - t) * 6
-                return p
-            }
-
-            var q = l < 0.5 ? l * (1 + s) : l + s - l * s
-            var p = 2 * l - q
-            r = hue2rgb(p, q, h + 1/3)
-            g = hue2rgb(p, q, h)
-            b = hue2rgb(p, q, h - 1/3)
-        }
-
-        return { r: Math.round(r * 255), g: Math.round(g * 255), b: Math.round(b * 255) }
-    }
     
     // 自动播放列表管理
     property int currentIndex: 0
@@ -1195,8 +1036,6 @@ Rectangle {
 
     Component.onCompleted: {
         loadProjectPlaylist()
-        // 初始化/更新取色
-        coverColorSampler.requestPaint()
     }
 
     
@@ -1204,27 +1043,6 @@ Rectangle {
     onNextClicked: playNext()
     onPreviousClicked: playPrev()
 
-    // 当封面变更时，重新取色
-    onCoverImageChanged: colorSampleTimer.restart()
-
-    // 延迟触发取色，保证资源已加载
-    Timer {
-        id: colorSampleTimer
-        interval: 200
-        repeat: false
-        onTriggered: coverColorSampler.requestPaint()
-    }
-
-    // 当封面图加载完成时，触发重绘取色
-    Connections {
-        target: coverSource
-        function onStatusChanged() {
-            if (coverSource.status === Image.Ready) {
-                coverColorSampler.requestPaint()
-            }
-        }
-    }
-
     // 播放时应用封面主色到主题；暂停/停止时回到默认强调色
     onIsPlayingChanged: function() {
         if (root.isPlaying) {
@@ -0,0 +1,113 @@
+// EPerformanceHud.qml
+import QtQuick
+import QtQuick.Layouts
+import EvolveUI
+
+// 性能浮层 - 显示Metrics单例的每秒快照：帧时间、各阶段速率、脚本耗时、队列深度与内存
+Rectangle {
+    id: root
+    readonly property var snap: Metrics.snapshot
+    property string exportMessage: ""
+
+    width: 300
+    height: content.implicitHeight + 24
+    radius: 12
+    color: "#CC000000"
+    visible: Metrics.enabled
+    z: 3000
+
+    function fixed(value, digits) {
+        return value === undefined ? "-" : Number(value).toFixed(digits)
+    }
+
+    function spanText(span) {
+        if (!span) return "-"
+        return fixed(span.perSec, 0) + "/s  " + fixed(span.avgMs, 2) + " / " + fixed(span.maxMs, 2) + " ms  "
+               + fixed(span.msPerSec, 1) + " ms/s"
+    }
+
+    // 帧时间超过1.5个刷新周期、出现掉帧或总线错误时以警告色显示
+    readonly property color warnColor: "#FF9800"
+    readonly property color textColor: "#E0E0E0"
+
+    ColumnLayout {
+        id: content
+        anchors.left: parent.left
+        anchors.right: parent.right
+        anchors.top: parent.top
+        anchors.margins: 12
+        spacing: 2
+
+        Text {
+            text: "性能  (Ctrl+Shift+P 关闭)"
+            color: theme.focusColor
+            font.pixelSize: 13
+            font.bold: true
+        }
+
+        Repeater {
+            model: [
+                { label: "帧", value: root.fixed(root.snap.fps, 0) + " fps  " + root.fixed(root.snap.frameAvgMs, 1)
+                         + " / " + root.fixed(root.snap.frameMaxMs, 1) + " ms",
+                  warn: root.snap.frameMaxMs > root.snap.framePeriodMs * 1.5 },
+                { label: "掉帧", value: root.fixed(root.snap.droppedFrames, 0) + "  (累计 " + root.fixed(root.snap.droppedTotal, 0) + ")",
+                  warn: root.snap.droppedFrames > 0 },
+                { label: "采集", value: root.fixed(root.snap.acquiredPerSec, 1) + " /s" },
+                { label: "历史", value: root.fixed(root.snap.historyPerSec, 1) + " /s" },
+                { label: "记录", value: root.fixed(root.snap.recordedPerSec, 1) + " /s" },
+                { label: "落盘", value: root.fixed(root.snap.writtenPerSec, 1) + " /s  " + root.fixed(root.snap.writtenKBps, 1) + " KB/s" },
+                { label: "总线", value: root.fixed(root.snap.busPerSec, 1) + " /s  错误 " + root.fixed(root.snap.busErrorsPerSec, 1) + " /s",
+                  warn: root.snap.busErrorsPerSec > 0 },
+                { label: "addDataPoint", value: root.spanText(root.snap.addDataPoint) },
+                { label: "updateChart", value: root.spanText(root.snap.chartUpdate) },
+                { label: "onPaint", value: root.spanText(root.snap.chartPaint) },
+                { label: "队列", value: "传输 " + root.fixed(root.snap.transportQueue, 0) + "  读取 " + root.fixed(root.snap.pendingReads, 0)
+                         + "  调度 " + root.fixed(root.snap.schedulerTasks, 0) },
+                { label: "内存", value: (root.snap.rssMB >= 0 ? root.fixed(root.snap.rssMB, 1) + " MB" : "-")
+                         + "  线程 " + root.fixed(root.snap.threads, 0) }
+            ]
+            delegate: RowLayout {
+                required property var modelData
+                Layout.fillWidth: true
+                spacing: 8
+                Text {
+                    Layout.preferredWidth: 84
+                    text: modelData.label
+                    color: "#9E9E9E"
+                    font.pixelSize: 11
+                    elide: Text.ElideRight
+                }
+                Text {
+                    Layout.fillWidth: true
+                    text: modelData.value
+                    color: modelData.warn ? root.warnColor : root.textColor
+                    font.pixelSize: 11
+                    font.family: "monospace"
+                    elide: Text.ElideRight
+                }
+            }
+        }
+
+        RowLayout {
+            Layout.fillWidth: true
+            Layout.topMargin: 6
+            spacing: 8
+            EButton {
+                text: "导出快照"
+                size: "xs"
+                shadowEnabled: false
+                onClicked: {
+                    var path = Metrics.exportSnapshot()
+                    root.exportMessage = path !== "" ? path : "导出失败"
+                }
+            }
+            Text {
+                Layout.fillWidth: true
+                text: root.exportMessage
+                color: root.textColor
+                font.pixelSize: 10
+                elide: Text.ElideLeft
+            }
+        }
+    }
+}
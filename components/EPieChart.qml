@@ -3,6 +3,7 @@ import QtQuick
 import QtQuick.Layouts
 import QtQuick.Controls
 import QtQuick.Effects
+import EvolveUI
 
 Rectangle {
     id: root
@@ -268,11 +269,11 @@ Rectangle {
             // 当数据改变时重新绘制
             Connections {
                 target: root
-                function onDataPointsChanged() { chartCanvas.requestPaint(); }
-                function onDataSeriesChanged() { chartCanvas.requestPaint(); }
-                function onEffectiveDataChanged() { chartCanvas.requestPaint(); }
-                function onBackgroundColorChanged() { chartCanvas.requestPaint(); }
-                function onHoveredIndexChanged() { chartCanvas.requestPaint(); }
+                function onDataPointsChanged() { UpdateScheduler.requestPaint(chartCanvas); }
+                function onDataSeriesChanged() { UpdateScheduler.requestPaint(chartCanvas); }
+                function onEffectiveDataChanged() { UpdateScheduler.requestPaint(chartCanvas); }
+                function onBackgroundColorChanged() { UpdateScheduler.requestPaint(chartCanvas); }
+                function onHoveredIndexChanged() { UpdateScheduler.requestPaint(chartCanvas); }
             }
         }
 
@@ -15,27 +15,20 @@ Item {
     property int currentIndex: playerRef && typeof playerRef.currentIndex === "number" ? playerRef.currentIndex : -1
     property var metaCache: ({})
     MusicLibrary { id: musicLib }
-    ListModel { id: fileModel }
-    property var prefetchQueue: []
+    ListModel {
+        id: fileModel
+        onCountChanged: root.sourceRows = null
+    }
     property bool singleFolderMode: false
     property bool initialPrefetchDone: false
     property var removedSources: []
-    Timer {
-        id: sequentialPrefetchTimer
-        interval: 280
-        repeat: true
-        running: false
-        onTriggered: {
-            if (prefetchQueue.length === 0) { running = false; return }
-            var next = prefetchQueue.shift()
-            if (next) musicLib.prefetchMetadata([next])
-        }
-    }
+    // 来源 -> 行号，行数变化时重建，元数据回调不再逐行查找
+    property var sourceRows: null
+    // 元数据在C++线程池中并行解析，结果持久化在索引中
     function schedulePrefetch(srcs) {
         if (!srcs || srcs.length === 0) return
-        for (var i = 0; i < srcs.length; i++) prefetchQueue.push(srcs[i])
         initialPrefetchDone = true
-        if (!sequentialPrefetchTimer.running) sequentialPrefetchTimer.start()
+        musicLib.prefetchMetadata(srcs)
     }
     function scheduleVisiblePrefetch() {
         var rowH = 56
@@ -47,7 +40,19 @@ Item {
             var it = fileModel.get(i)
             if (it && (!it.artist || it.artist.length === 0)) batch.push(it.source)
         }
-        schedulePrefetch(batch)
+        // 可见行插到解析队列首部
+        if (batch.length > 0) musicLib.prioritize(batch)
+    }
+    function rowOfSource(src) {
+        if (!sourceRows) {
+            var rows = {}
+            for (var i = 0; i < fileModel.count; i++) rows[fileModel.get(i).source] = i
+            sourceRows = rows
+        }
+        var row = sourceRows[src]
+        // 导入的行保存本地路径，请求可能使用URL
+        if (row === undefined) row = sourceRows[toLocalPath(src)]
+        return row === undefined ? -1 : row
     }
     function toLocalPath(s) {
         if (!s) return ""
@@ -331,17 +336,14 @@ Item {
         Connections {
             target: musicLib
             function onMetadataReady(src, meta) {
-                for (var i = 0; i < fileModel.count; i++) {
-                    var it = fileModel.get(i)
-                    if (it && it.source === src) {
-                        fileModel.set(i, {
-                            source: it.source,
-                            title: (meta && meta.title) ? meta.title : it.title,
-                            artist: (meta && meta.artist) ? meta.artist : it.artist
-                        })
-                        break
-                    }
-                }
+                var i = rowOfSource(src)
+                if (i < 0) return
+                var it = fileModel.get(i)
+                fileModel.set(i, {
+                    source: it.source,
+                    title: (meta && meta.title) ? meta.title : it.title,
+                    artist: (meta && meta.artist) ? meta.artist : it.artist
+                })
             }
         }
     }
@@ -351,14 +353,16 @@ Item {
         if (model && model.count && model.count > 0) {
             for (var i = 0; i < model.count; i++) {
                 var s = model.get(i).source
-                fileModel.append({ source: s, title: baseName(s), artist: "" })
+                var m = musicLib.getMetadata(s)
+                fileModel.append({ source: s, title: (m && m.title) ? m.title : baseName(s), artist: (m && m.artist) ? m.artist : "" })
                 srcs.push(s)
             }
         } else {
             var files2 = musicLib.scanAllAvailableMusic(true)
             for (var k = 0; k < files2.length; k++) {
                 var ss = files2[k]
-                fileModel.append({ source: ss, title: baseName(ss), artist: "" })
+                var mm = musicLib.getMetadata(ss)
+                fileModel.append({ source: ss, title: (mm && mm.title) ? mm.title : baseName(ss), artist: (mm && mm.artist) ? mm.artist : "" })
                 srcs.push(ss)
             }
             musicLib.startWatching()
@@ -390,7 +394,7 @@ Item {
             removedSources = []
             fileModel.clear()
             appendUniqueSources(list)
-            musicLib.prefetchMetadata(list)
+            schedulePrefetch(list)
             scheduleVisiblePrefetch()
             if (playerRef && typeof playerRef.resetSources === 'function') playerRef.resetSources(list)
             singleFolderMode = true
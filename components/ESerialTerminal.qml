@@ -0,0 +1,174 @@
+// ESerialTerminal.qml
+import QtQuick
+import QtQuick.Controls
+import QtQuick.Layouts
+import EvolveUI
+
+// 串口终端 - 以SerialTerminalModel为数据源的虚拟化列表，只创建可见行的委托
+Rectangle {
+    id: root
+    property var terminal: null          // SerialTerminalModel
+    property bool follow: true           // 是否跟随最新数据
+    property int matchRow: -1            // 当前查找结果所在行
+    property int fontSize: 13
+
+    radius: 16
+    color: theme.secondaryColor
+
+    function search(backward) {
+        if (!root.terminal || searchInput.text === "") return
+        var row = root.terminal.find(searchInput.text, root.matchRow, backward)
+        root.matchRow = row
+        if (row >= 0) {
+            root.follow = false
+            listView.positionViewAtIndex(row, ListView.Center)
+        }
+    }
+
+    function formatBytes(bytes) {
+        if (bytes >= 1048576) return (bytes / 1048576).toFixed(1) + " MB"
+        if (bytes >= 1024) return (bytes / 1024).toFixed(1) + " KB"
+        return bytes + " B"
+    }
+
+    ColumnLayout {
+        anchors.fill: parent
+        anchors.margins: 12
+        spacing: 8
+
+        // 工具栏：显示模式、查找、清空
+        RowLayout {
+            Layout.fillWidth: true
+            spacing: 8
+
+            ESwitchButton {
+                text: "HEX"
+                size: "xs"
+                shadowEnabled: false
+                checked: root.terminal ? root.terminal.hexMode : false
+                onToggled: function(checked) {
+                    if (root.terminal) root.terminal.hexMode = checked
+                    root.matchRow = -1
+                }
+            }
+
+            EInput {
+                id: searchInput
+                Layout.fillWidth: true
+                Layout.preferredHeight: 36
+                fontSize: 13
+                placeholderText: root.terminal && root.terminal.hexMode ? "查找字节，如 01 03" : "查找文本"
+                onAccepted: root.search(false)
+            }
+
+            EButton {
+                size: "xs"
+                iconCharacter: "\uf077"
+                shadowEnabled: false
+                onClicked: root.search(true)
+            }
+
+            EButton {
+                size: "xs"
+                iconCharacter: "\uf078"
+                shadowEnabled: false
+                onClicked: root.search(false)
+            }
+
+            EButton {
+                text: "清空"
+                size: "xs"
+                shadowEnabled: false
+                onClicked: {
+                    if (root.terminal) root.terminal.clear()
+                    root.matchRow = -1
+                    root.follow = true
+                }
+            }
+        }
+
+        ListView {
+            id: listView
+            Layout.fillWidth: true
+            Layout.fillHeight: true
+            clip: true
+            model: root.terminal
+            reuseItems: true
+            boundsBehavior: Flickable.StopAtBounds
+            ScrollBar.vertical: ScrollBar {}
+
+            // 行数变化每帧最多通知一次，跟随模式下随之滚动到末尾
+            onCountChanged: {
+                if (root.follow) positionViewAtEnd()
+            }
+            onMovementStarted: root.follow = false
+            onAtYEndChanged: {
+                if (atYEnd) root.follow = true
+            }
+
+            delegate: Rectangle {
+                id: line
+                required property int index
+                required property string text
+                required property string ascii
+                required property string time
+                required property int direction
+
+                width: ListView.view.width
+                height: rowLayout.implicitHeight + 2
+                color: line.index === root.matchRow ? Qt.rgba(theme.focusColor.r, theme.focusColor.g, theme.focusColor.b, 0.3)
+                                               : "transparent"
+
+                RowLayout {
+                    id: rowLayout
+                    anchors.left: parent.left
+                    anchors.right: parent.right
+                    anchors.verticalCenter: parent.verticalCenter
+                    spacing: 8
+
+                    Text {
+                        text: line.time
+                        color: "#9E9E9E"
+                        font.pixelSize: root.fontSize - 2
+                        font.family: "monospace"
+                    }
+                    Text {
+                        text: line.direction === SerialTerminalModel.Sent ? ">" : "<"
+                        color: line.direction === SerialTerminalModel.Sent ? "#FF9800" : theme.focusColor
+                        font.pixelSize: root.fontSize
+                        font.family: "monospace"
+                    }
+                    Text {
+                        Layout.fillWidth: !root.terminal || !root.terminal.hexMode
+                        text: line.text
+                        color: theme.textColor
+                        font.pixelSize: root.fontSize
+                        font.family: "monospace"
+                        elide: Text.ElideRight
+                    }
+                    Text {
+                        Layout.fillWidth: true
+                        visible: root.terminal ? root.terminal.hexMode : false
+                        text: line.ascii
+                        color: "#9E9E9E"
+                        font.pixelSize: root.fontSize
+                        font.family: "monospace"
+                        elide: Text.ElideRight
+                    }
+                }
+            }
+        }
+
+        // 统计：收发字节、行数与缓冲区占用
+        Text {
+            Layout.fillWidth: true
+            color: "#9E9E9E"
+            font.pixelSize: 12
+            text: root.terminal
+                  ? "接收 " + root.formatBytes(root.terminal.bytesReceived) + "  发送 " + root.formatBytes(root.terminal.bytesSent)
+                    + "  行 " + root.terminal.count + "  缓冲 " + root.formatBytes(root.terminal.bufferedBytes)
+                    + " / " + root.formatBytes(root.terminal.capacity)
+                  : ""
+        }
+    }
+}
@@ -32,7 +32,8 @@ QtObject {
     property int shadowYOffset: 2
 
     // === 背景图片===
-    property url backgroundImage: isDark ? "qrc:/new/prefix1/fonts/pic/02.jpg" : "qrc:/new/prefix1/fonts/pic/01.jpg"
+    // 使用时设置Image.sourceSize为显示尺寸，由scaled图片源提供缩放后的缓存图
+    property url backgroundImage: isDark ? "image://scaled/new/prefix1/fonts/pic/02.jpg" : "image://scaled/new/prefix1/fonts/pic/01.jpg"
 
 
     // === 方法 ===
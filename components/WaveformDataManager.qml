@@ -1,10 +1,15 @@
 import QtQuick
+import EvolveUI
 
 Item {
     id: root
 
+    // 图表数据已重新生成
     signal dataUpdated()
 
+    // 显示图表的视图，不可见时暂缓重新生成图表数据，为空时每个采样点立即生成
+    property Item view: null
+
     property int maxDataPoints: 60
     property int updateInterval: 1000
 
@@ -12,6 +17,16 @@ Item {
     property var currentHistory: []
     property var powerHistory: []
     property var timeLabels: []
+    // 最新数据点的采样时刻（ModbusManager.sampleTimeUs()，相对SampleClock时间原点的微秒），未知时为0
+    property real latestSampleUs: 0
+    // 为true时首页把100ms内的采样合并为一个数据点；会话回放时关闭，每个采样单独送入
+    property bool mergeInput: true
+
+    // 导入会话的对比曲线（按maxDataPoints降采样，与实时曲线从起点对齐）
+    property var comparisonVoltage: []
+    property var comparisonCurrent: []
+    property var comparisonPower: []
+    property var comparisonOffsets: []
 
     property var voltageChartData: [{ name: "电压", color: "#2196F3", data: [] }]
     property var currentChartData: [{ name: "电流", color: "#4CAF50", data: [] }]
@@ -29,25 +44,61 @@ Item {
         return result
     }
 
+    // 对比曲线取与实时曲线相同的点数；无实时数据时显示完整对比曲线
+    function generateComparisonData(values, unit) {
+        var count = root.voltageHistory.length > 0 ? Math.min(values.length, root.voltageHistory.length) : values.length
+        var result = []
+        for (var i = 0; i < count; i++) {
+            var offset = (root.comparisonOffsets[i] / 1000).toFixed(0) + "s"
+            result.push({
+                month: offset,
+                value: values[i],
+                label: "对比 " + offset + " " + values[i].toFixed(1) + unit
+            })
+        }
+        return result
+    }
+
+    function buildSeries(name, color, history, comparison, comparisonColor, unit) {
+        var series = []
+        if (history.length > 0 || comparison.length === 0) {
+            series.push({ name: name, color: color, data: root.generateChartData(history, unit) })
+        }
+        if (comparison.length > 0) {
+            series.push({ name: name + "(对比)", color: comparisonColor, data: root.generateComparisonData(comparison, unit) })
+        }
+        return series
+    }
+
     function updateChartData() {
-        root.voltageChartData = [{
-            name: "电压",
-            color: "#2196F3",
-            data: root.generateChartData(root.voltageHistory, "V")
-        }]
-        root.currentChartData = [{
-            name: "电流",
-            color: "#4CAF50",
-            data: root.generateChartData(root.currentHistory, "A")
-        }]
-        root.powerChartData = [{
-            name: "功率",
-            color: "#FF9800",
-            data: root.generateChartData(root.powerHistory, "kW")
-        }]
+        var started = Metrics.enabled ? Metrics.beginSpan() : 0
+        root.voltageChartData = root.buildSeries("电压", "#2196F3", root.voltageHistory, root.comparisonVoltage, "#90CAF9", "V")
+        root.currentChartData = root.buildSeries("电流", "#4CAF50", root.currentHistory, root.comparisonCurrent, "#A5D6A7", "A")
+        root.powerChartData = root.buildSeries("功率", "#FF9800", root.powerHistory, root.comparisonPower, "#FFCC80", "kW")
+        root.dataUpdated()
+        if (started > 0) Metrics.endSpan(Metrics.ChartUpdate, started)
+    }
+
+    // 从SessionImporter载入对比曲线，按列名对应通道，文件中没有的通道不显示对比
+    function setComparison(importer) {
+        root.comparisonVoltage = importer.values(importer.channelIndex("电压"), root.maxDataPoints)
+        root.comparisonCurrent = importer.values(importer.channelIndex("电流"), root.maxDataPoints)
+        root.comparisonPower = importer.values(importer.channelIndex("功率"), root.maxDataPoints)
+        root.comparisonOffsets = importer.timeOffsets(root.maxDataPoints)
+        root.updateChartData()
+    }
+
+    function clearComparison() {
+        root.comparisonVoltage = []
+        root.comparisonCurrent = []
+        root.comparisonPower = []
+        root.comparisonOffsets = []
+        root.updateChartData()
     }
 
-    function addDataPoint(voltage, current, power) {
+    function addDataPoint(voltage, current, power, sampleTimeUs) {
+        var started = Metrics.enabled ? Metrics.beginSpan() : 0
+        root.latestSampleUs = sampleTimeUs || 0
         var now = new Date()
         var timeLabel = String(now.getHours()).padStart(2, '0') + ":" +
                         String(now.getMinutes()).padStart(2, '0') + ":" +
@@ -65,8 +116,13 @@ Item {
             root.timeLabels.shift()
         }
 
-        root.updateChartData()
-        root.dataUpdated()
+        // 同一帧内的多个采样点只重新生成一次图表数据
+        if (root.view) {
+            UpdateScheduler.schedule(root.view, root, "updateChartData")
+        } else {
+            root.updateChartData()
+        }
+        if (started > 0) Metrics.endSpan(Metrics.AddDataPoint, started)
     }
 
     function clearData() {
@@ -75,6 +131,5 @@ Item {
         root.powerHistory = []
         root.timeLabels = []
         root.updateChartData()
-        root.dataUpdated()
     }
 }
@@ -0,0 +1,454 @@
+#include "FetchCache.h"
+#include "Logger.h"
+#include <QNetworkAccessManager>
+#include <QNetworkDiskCache>
+#include <QNetworkReply>
+#include <QNetworkRequest>
+#include <QCryptographicHash>
+#include <QImageReader>
+#include <QImage>
+#include <QBuffer>
+#include <QDateTime>
+#include <QDir>
+#include <QFile>
+#include <QSaveFile>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <algorithm>
+
+namespace {
+
+/**
+ * @brief 文本缓存（QNetworkDiskCache）上限
+ */
+constexpr qint64 MAX_TEXT_CACHE_BYTES = 8 * 1024 * 1024;
+
+/**
+ * @brief 保留的图片处理结果数
+ */
+constexpr int MAX_CACHED_IMAGES = 32;
+
+/**
+ * @brief 单次请求超时（毫秒）
+ * @details 厂区网络经常不通，超时后使用缓存内容
+ */
+constexpr int TRANSFER_TIMEOUT_MS = 10000;
+
+constexpr int CACHE_JPEG_QUALITY = 88;
+
+const QString INDEX_FILE = QStringLiteral("index.json");
+
+QString imageKey(const QString &url, const QSize &size, int blurRadius)
+{
+    QCryptographicHash hash(QCryptographicHash::Sha1);
+    hash.addData(url.toUtf8());
+    hash.addData(QByteArray::number(size.width()) + 'x' + QByteArray::number(size.height()) + '/' + QByteArray::number(blurRadius));
+    return QStringLiteral("image:") + QString::fromLatin1(hash.result().toHex().left(20));
+}
+
+/**
+ * @brief 三次盒式模糊近似高斯模糊
+ */
+void boxBlur(QImage &image, int radius)
+{
+    const int w = image.width();
+    const int h = image.height();
+    const int window = radius * 2 + 1;
+    QVector<QRgb> line(qMax(w, h));
+
+    auto blurLine = [&](int length, auto get, auto set) {
+        for (int i = 0; i < length; ++i) {
+            line[i] = get(i);
+        }
+        int sr = 0, sg = 0, sb = 0;
+        for (int i = -radius; i <= radius; ++i) {
+            const QRgb p = line[qBound(0, i, length - 1)];
+            sr += qRed(p);
+            sg += qGreen(p);
+            sb += qBlue(p);
+        }
+        for (int i = 0; i < length; ++i) {
+            set(i, qRgb(sr / window, sg / window, sb / window));
+            const QRgb add = line[qMin(i + radius + 1, length - 1)];
+            const QRgb sub = line[qMax(i - radius, 0)];
+            sr += qRed(add) - qRed(sub);
+            sg += qGreen(add) - qGreen(sub);
+            sb += qBlue(add) - qBlue(sub);
+        }
+    };
+
+    for (int pass = 0; pass < 3; ++pass) {
+        for (int y = 0; y < h; ++y) {
+            QRgb *row = reinterpret_cast<QRgb *>(image.scanLine(y));
+            blurLine(w, [row](int i) { return row[i]; }, [row](int i, QRgb v) { row[i] = v; });
+        }
+        for (int x = 0; x < w; ++x) {
+            blurLine(h,
+                     [&image, x](int i) { return reinterpret_cast<const QRgb *>(image.constScanLine(i))[x]; },
+                     [&image, x](int i, QRgb v) { reinterpret_cast<QRgb *>(image.scanLine(i))[x] = v; });
+        }
+    }
+}
+
+/**
+ * @brief 解码并处理图片（线程池中执行）
+ * @details 缩小时在解码阶段按比例缩放，再居中裁剪到显示尺寸
+ */
+QImage processImage(const QByteArray &data, const QSize &size, int blurRadius, QString *error)
+{
+    QBuffer buffer;
+    buffer.setData(data);
+    buffer.open(QIODevice::ReadOnly);
+    QImageReader reader(&buffer);
+    reader.setAutoTransform(true);
+
+    const QSize source = reader.size();
+    if (source.isValid() && size.isValid()) {
+        const QSize covered = source.scaled(size, Qt::KeepAspectRatioByExpanding);
+        if (covered.width() < source.width()) {
+            reader.setScaledSize(covered);
+        }
+    }
+    QImage image = reader.read();
+    if (image.isNull()) {
+        *error = reader.errorString();
+        return image;
+    }
+
+    if (size.isValid() && image.size() != size) {
+        if (image.width() < size.width() || image.height() < size.height()) {
+            image = image.scaled(size, Qt::KeepAspectRatioByExpanding, Qt::SmoothTransformation);
+        }
+        image = image.copy((image.width() - size.width()) / 2, (image.height() - size.height()) / 2,
+                           size.width(), size.height());
+    }
+    image = image.convertToFormat(QImage::Format_RGB32);
+    if (blurRadius > 0) {
+        boxBlur(image, blurRadius);
+    }
+    return image;
+}
+
+bool isNetworkFailure(QNetworkReply::NetworkError error)
+{
+    return error == QNetworkReply::HostNotFoundError || error == QNetworkReply::TimeoutError
+            || error == QNetworkReply::ConnectionRefusedError || error == QNetworkReply::OperationCanceledError
+            || error == QNetworkReply::TemporaryNetworkFailureError || error == QNetworkReply::NetworkSessionFailedError
+            || error == QNetworkReply::UnknownNetworkError;
+}
+
+} // namespace
+
+FetchCache::FetchCache(const QString &cacheDirectory, QObject *parent)
+    : QObject(parent)
+    , m_cacheDirectory(cacheDirectory)
+    , m_imageDirectory(QDir(cacheDirectory).filePath(QStringLiteral("images")))
+    , m_network(nullptr)
+    , m_diskCache(nullptr)
+    , m_nextRequestId(1)
+    , m_online(true)
+{
+    QDir().mkpath(m_imageDirectory);
+
+    m_network = new QNetworkAccessManager(this);
+    m_network->setTransferTimeout(TRANSFER_TIMEOUT_MS);
+    m_diskCache = new QNetworkDiskCache(this);
+    m_diskCache->setCacheDirectory(QDir(cacheDirectory).filePath(QStringLiteral("http")));
+    m_diskCache->setMaximumCacheSize(MAX_TEXT_CACHE_BYTES);
+    m_network->setCache(m_diskCache);
+
+    // 图片解码与模糊不占满CPU，避免影响采集与界面
+    m_pool.setMaxThreadCount(1);
+    loadIndex();
+}
+
+FetchCache::~FetchCache()
+{
+    // 等待线程池中的图片处理结束，之后的回调不会再访问本对象
+    m_pool.clear();
+    m_pool.waitForDone();
+}
+
+int FetchCache::fetchText(const QString &url, int ttlSeconds, bool force)
+{
+    const int requestId = m_nextRequestId++;
+    const QUrl requestUrl(url);
+    const QString key = QStringLiteral("text:") + url;
+    const Entry entry = m_index.value(key);
+
+    const QString cached = readCachedText(requestUrl);
+    const bool served = !cached.isNull();
+    if (served) {
+        QMetaObject::invokeMethod(this, [this, requestId, cached]() {
+            emit textReady(requestId, cached, true);
+        }, Qt::QueuedConnection);
+    }
+
+    const qint64 ageMs = QDateTime::currentMSecsSinceEpoch() - entry.fetchedMs;
+    if (served && !force && ageMs < ttlSeconds * 1000LL) {
+        return requestId;
+    }
+
+    // PreferNetwork时QNetworkAccessManager自动带上缓存项的条件头
+    QNetworkRequest request(requestUrl);
+    request.setAttribute(QNetworkRequest::CacheLoadControlAttribute,
+                         force ? QNetworkRequest::AlwaysNetwork : QNetworkRequest::PreferNetwork);
+    QNetworkReply *reply = m_network->get(request);
+    connect(reply, &QNetworkReply::finished, this, [this, reply, requestId, url, served]() {
+        onTextFinished(reply, requestId, url, served);
+    });
+    return requestId;
+}
+
+int FetchCache::fetchImage(const QString &url, int width, int height, int blurRadius, int ttlSeconds, bool force)
+{
+    const int requestId = m_nextRequestId++;
+    const QSize size(qMax(0, width), qMax(0, height));
+    blurRadius = qBound(0, blurRadius, 64);
+    const QString key = imageKey(url, size, blurRadius);
+    const Entry entry = m_index.value(key);
+
+    const QString filePath = entry.file.isEmpty() ? QString() : QDir(m_imageDirectory).filePath(entry.file);
+    const bool served = !filePath.isEmpty() && QFile::exists(filePath);
+    if (served) {
+        const QUrl localUrl = QUrl::fromLocalFile(filePath);
+        const QString sourceUrl = entry.sourceUrl;
+        QMetaObject::invokeMethod(this, [this, requestId, localUrl, sourceUrl]() {
+            emit imageReady(requestId, localUrl, sourceUrl, true);
+        }, Qt::QueuedConnection);
+    }
+
+    const qint64 ageMs = QDateTime::currentMSecsSinceEpoch() - entry.fetchedMs;
+    if (served && !force && ageMs < ttlSeconds * 1000LL) {
+        return requestId;
+    }
+
+    // 原始图片不进入文本缓存，只保留处理结果，条件头取自索引
+    QNetworkRequest request{QUrl(url)};
+    request.setAttribute(QNetworkRequest::CacheLoadControlAttribute, QNetworkRequest::AlwaysNetwork);
+    request.setAttribute(QNetworkRequest::CacheSaveControlAttribute, false);
+    if (served && !force) {
+        applyValidators(request, entry);
+    }
+    QNetworkReply *reply = m_network->get(request);
+    connect(reply, &QNetworkReply::finished, this, [this, reply, requestId, key, size, blurRadius, served]() {
+        onImageFinished(reply, requestId, key, size, blurRadius, served);
+    });
+    return requestId;
+}
+
+void FetchCache::clear()
+{
+    m_diskCache->clear();
+    for (const Entry &entry : std::as_const(m_index)) {
+        if (!entry.file.isEmpty()) {
+            QFile::remove(QDir(m_imageDirectory).filePath(entry.file));
+        }
+    }
+    m_index.clear();
+    saveIndex();
+}
+
+void FetchCache::onTextFinished(QNetworkReply *reply, int requestId, const QString &url, bool served)
+{
+    reply->deleteLater();
+    updateOnline(reply);
+    if (reply->error() != QNetworkReply::NoError) {
+        LOG_WARNING(Log::General, "fetch {} failed: {}", url, reply->errorString());
+        emit fetchFailed(requestId, reply->errorString(), served);
+        return;
+    }
+
+    const QByteArray data = reply->readAll();
+    const bool fromCache = reply->attribute(QNetworkRequest::SourceIsFromCacheAttribute).toBool();
+    if (!fromCache) {
+        storeText(QUrl(url), reply, data);
+    }
+    m_index[QStringLiteral("text:") + url].fetchedMs = QDateTime::currentMSecsSinceEpoch();
+    saveIndex();
+
+    // 304重新验证后的内容与已返回的缓存相同，不再重复发出
+    if (!(fromCache && served)) {
+        emit textReady(requestId, QString::fromUtf8(data), fromCache);
+    }
+}
+
+void FetchCache::onImageFinished(QNetworkReply *reply, int requestId, const QString &key, QSize size, int blurRadius, bool served)
+{
+    reply->deleteLater();
+    updateOnline(reply);
+    const QString sourceUrl = reply->url().toString();
+    if (reply->error() != QNetworkReply::NoError) {
+        LOG_WARNING(Log::General, "fetch image {} failed: {}", sourceUrl, reply->errorString());
+        emit fetchFailed(requestId, reply->errorString(), served);
+        return;
+    }
+
+    const int status = reply->attribute(QNetworkRequest::HttpStatusCodeAttribute).toInt();
+    if (status == 304) {
+        m_index[key].fetchedMs = QDateTime::currentMSecsSinceEpoch();
+        saveIndex();
+        return;
+    }
+
+    const QByteArray data = reply->readAll();
+    const QByteArray etag = reply->rawHeader("ETag");
+    const QByteArray lastModified = reply->rawHeader("Last-Modified");
+    // 每次获取使用新文件名，界面的Image地址随之变化才会重新加载
+    const QString fileName = QStringLiteral("%1-%2.jpg").arg(key.mid(key.indexOf(':') + 1)).arg(QDateTime::currentMSecsSinceEpoch());
+    const QString filePath = QDir(m_imageDirectory).filePath(fileName);
+
+    m_pool.start([this, data, size, blurRadius, requestId, key, fileName, filePath, sourceUrl, etag, lastModified, served]() {
+        QString error;
+        const QImage image = processImage(data, size, blurRadius, &error);
+        bool saved = false;
+        if (!image.isNull()) {
+            QSaveFile file(filePath);
+            saved = file.open(QIODevice::WriteOnly) && image.save(&file, "jpg", CACHE_JPEG_QUALITY) && file.commit();
+            if (!saved) {
+                error = file.errorString();
+            }
+        }
+
+        QMetaObject::invokeMethod(this, [this, saved, error, requestId, key, fileName, filePath, sourceUrl, etag, lastModified, served]() {
+            if (!saved) {
+                LOG_WARNING(Log::General, "cannot process image {}: {}", sourceUrl, error);
+                emit fetchFailed(requestId, error, served);
+                return;
+            }
+            Entry &entry = m_index[key];
+            if (!entry.file.isEmpty() && entry.file != fileName) {
+                QFile::remove(QDir(m_imageDirectory).filePath(entry.file));
+            }
+            entry.fetchedMs = QDateTime::currentMSecsSinceEpoch();
+            entry.file = fileName;
+            entry.sourceUrl = sourceUrl;
+            entry.etag = etag;
+            entry.lastModified = lastModified;
+            pruneImages();
+            saveIndex();
+            emit imageReady(requestId, QUrl::fromLocalFile(filePath), sourceUrl, false);
+        }, Qt::QueuedConnection);
+    });
+}
+
+/**
+ * @brief 保证文本进入磁盘缓存
+ * @details 服务器返回no-store等头时QNetworkAccessManager不会缓存，
+ *          这里补写一份，使离线时仍有内容可用
+ */
+void FetchCache::storeText(const QUrl &url, QNetworkReply *reply, const QByteArray &data)
+{
+    if (m_diskCache->metaData(url).isValid()) {
+        return;
+    }
+    QNetworkCacheMetaData meta;
+    meta.setUrl(url);
+    meta.setSaveToDisk(true);
+    meta.setRawHeaders(reply->rawHeaderPairs());
+    QNetworkCacheMetaData::AttributesMap attributes;
+    attributes.insert(QNetworkRequest::HttpStatusCodeAttribute, reply->attribute(QNetworkRequest::HttpStatusCodeAttribute));
+    meta.setAttributes(attributes);
+    QIODevice *device = m_diskCache->prepare(meta);
+    if (!device) {
+        return;
+    }
+    device->write(data);
+    m_diskCache->insert(device);
+}
+
+QString FetchCache::readCachedText(const QUrl &url) const
+{
+    QIODevice *device = m_diskCache->data(url);
+    if (!device) {
+        return QString();
+    }
+    const QString text = QString::fromUtf8(device->readAll());
+    delete device;
+    return text;
+}
+
+void FetchCache::applyValidators(QNetworkRequest &request, const Entry &entry) const
+{
+    if (!entry.etag.isEmpty()) {
+        request.setRawHeader("If-None-Match", entry.etag);
+    }
+    if (!entry.lastModified.isEmpty()) {
+        request.setRawHeader("If-Modified-Since", entry.lastModified);
+    }
+}
+
+void FetchCache::updateOnline(QNetworkReply *reply)
+{
+    const bool online = !isNetworkFailure(reply->error());
+    if (m_online != online) {
+        m_online = online;
+        LOG_INFO(Log::General, "fetch cache is now {}", online ? "online" : "offline");
+        emit onlineChanged();
+    }
+}
+
+/**
+ * @brief 只保留最近获取的图片
+ */
+void FetchCache::pruneImages()
+{
+    QVector<QPair<qint64, QString>> images;
+    for (auto it = m_index.cbegin(); it != m_index.cend(); ++it) {
+        if (!it.value().file.isEmpty()) {
+            images.append({it.value().fetchedMs, it.key()});
+        }
+    }
+    if (images.size() <= MAX_CACHED_IMAGES) {
+        return;
+    }
+    std::sort(images.begin(), images.end());
+    for (int i = 0; i < images.size() - MAX_CACHED_IMAGES; ++i) {
+        QFile::remove(QDir(m_imageDirectory).filePath(m_index.value(images.at(i).second).file));
+        m_index.remove(images.at(i).second);
+    }
+}
+
+void FetchCache::loadIndex()
+{
+    QFile file(QDir(m_cacheDirectory).filePath(INDEX_FILE));
+    if (!file.open(QIODevice::ReadOnly)) {
+        return;
+    }
+    const QJsonObject root = QJsonDocument::fromJson(file.readAll()).object();
+    for (auto it = root.constBegin(); it != root.constEnd(); ++it) {
+        const QJsonObject object = it.value().toObject();
+        Entry entry;
+        entry.fetchedMs = static_cast<qint64>(object.value("fetchedMs").toDouble());
+        entry.file = object.value("file").toString();
+        entry.sourceUrl = object.value("sourceUrl").toString();
+        entry.etag = object.value("etag").toString().toLatin1();
+        entry.lastModified = object.value("lastModified").toString().toLatin1();
+        m_index.insert(it.key(), entry);
+    }
+}
+
+void FetchCache::saveIndex() const
+{
+    QJsonObject root;
+    for (auto it = m_index.cbegin(); it != m_index.cend(); ++it) {
+        QJsonObject object;
+        object["fetchedMs"] = static_cast<double>(it.value().fetchedMs);
+        if (!it.value().file.isEmpty()) {
+            object["file"] = it.value().file;
+            object["sourceUrl"] = it.value().sourceUrl;
+        }
+        if (!it.value().etag.isEmpty()) {
+            object["etag"] = QString::fromLatin1(it.value().etag);
+        }
+        if (!it.value().lastModified.isEmpty()) {
+            object["lastModified"] = QString::fromLatin1(it.value().lastModified);
+        }
+        root.insert(it.key(), object);
+    }
+    QSaveFile file(QDir(m_cacheDirectory).filePath(INDEX_FILE));
+    if (file.open(QIODevice::WriteOnly)) {
+        file.write(QJsonDocument(root).toJson(QJsonDocument::Compact));
+        file.commit();
+    }
+}
@@ -0,0 +1,123 @@
+#ifndef FETCHCACHE_H
+#define FETCHCACHE_H
+
+#include <QObject>
+#include <QHash>
+#include <QUrl>
+#include <QThreadPool>
+
+class QNetworkAccessManager;
+class QNetworkDiskCache;
+class QNetworkReply;
+
+/**
+ * @brief 带磁盘缓存的网络获取服务
+ * @details 为界面卡片提供文本与图片的获取：
+ *          - 有缓存时立即返回缓存内容，超过有效期（TTL）才在后台请求网络，
+ *            网络请求带If-None-Match/If-Modified-Since条件头，304时只刷新有效期
+ *          - 文本经QNetworkDiskCache缓存，服务器禁止缓存时也保留一份供离线使用
+ *          - 图片在线程池中按显示尺寸解码、裁剪并可预先模糊，处理结果写入磁盘，
+ *            界面直接加载小图，不再下载后全尺寸解码
+ *          - 离线或请求失败时保留已返回的缓存内容，并通过fetchFailed告知
+ *          以QML单例FetchCache提供，请求地址可指向本地HTTP服务进行测试
+ */
+class FetchCache : public QObject
+{
+    Q_OBJECT
+    /**
+     * @brief 最近一次网络请求是否成功
+     */
+    Q_PROPERTY(bool online READ online NOTIFY onlineChanged)
+
+public:
+    /**
+     * @param cacheDirectory 缓存目录，文本与图片分别存放在子目录中
+     */
+    explicit FetchCache(const QString &cacheDirectory, QObject *parent = nullptr);
+    ~FetchCache();
+
+    bool online() const { return m_online; }
+
+    /**
+     * @brief 获取文本
+     * @param url 地址
+     * @param ttlSeconds 缓存有效期（秒），有效期内不访问网络
+     * @param force 忽略有效期立即请求网络（缓存仍先返回）
+     * @return 请求编号，对应textReady/fetchFailed中的requestId
+     */
+    Q_INVOKABLE int fetchText(const QString &url, int ttlSeconds, bool force = false);
+
+    /**
+     * @brief 获取图片
+     * @param url 地址（跟随重定向）
+     * @param width 显示宽度（像素），图片按此裁剪缩放
+     * @param height 显示高度（像素）
+     * @param blurRadius 预先模糊半径（像素），0表示不模糊
+     * @param ttlSeconds 缓存有效期（秒）
+     * @param force 忽略有效期立即请求网络
+     * @return 请求编号，对应imageReady/fetchFailed中的requestId
+     */
+    Q_INVOKABLE int fetchImage(const QString &url, int width, int height, int blurRadius = 0,
+                               int ttlSeconds = 86400, bool force = false);
+
+    /**
+     * @brief 清空全部缓存
+     */
+    Q_INVOKABLE void clear();
+
+signals:
+    void onlineChanged();
+
+    /**
+     * @brief 文本可用
+     * @param fromCache 是否来自缓存（网络结果随后可能再次发出）
+     */
+    void textReady(int requestId, const QString &text, bool fromCache);
+
+    /**
+     * @brief 处理后的图片可用
+     * @param localUrl 本地缓存文件地址
+     * @param sourceUrl 图片的最终地址（重定向之后）
+     * @param fromCache 是否来自缓存
+     */
+    void imageReady(int requestId, const QUrl &localUrl, const QString &sourceUrl, bool fromCache);
+
+    /**
+     * @brief 请求失败
+     * @param served 之前是否已返回缓存内容
+     */
+    void fetchFailed(int requestId, const QString &error, bool served);
+
+private:
+    /**
+     * @brief 缓存索引项
+     */
+    struct Entry {
+        qint64 fetchedMs = 0;       ///< 最近一次成功获取的时刻
+        QString file;               ///< 图片处理结果文件名
+        QString sourceUrl;          ///< 图片最终地址
+        QByteArray etag;
+        QByteArray lastModified;
+    };
+
+    void onTextFinished(QNetworkReply *reply, int requestId, const QString &url, bool served);
+    void onImageFinished(QNetworkReply *reply, int requestId, const QString &key, QSize size, int blurRadius, bool served);
+    void storeText(const QUrl &url, QNetworkReply *reply, const QByteArray &data);
+    QString readCachedText(const QUrl &url) const;
+    void applyValidators(QNetworkRequest &request, const Entry &entry) const;
+    void updateOnline(QNetworkReply *reply);
+    void pruneImages();
+    void loadIndex();
+    void saveIndex() const;
+
+    QString m_cacheDirectory;
+    QString m_imageDirectory;
+    QNetworkAccessManager *m_network;
+    QNetworkDiskCache *m_diskCache;
+    QHash<QString, Entry> m_index;
+    QThreadPool m_pool;
+    int m_nextRequestId;
+    bool m_online;
+};
+
+#endif
@@ -0,0 +1,578 @@
+#include "Logger.h"
+#include <QDateTime>
+#include <QDebug>
+#include <QDir>
+#include <QFile>
+#include <QtEndian>
+#include <chrono>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace Log {
+
+namespace {
+
+/**
+ * @brief 每个线程的环形缓冲容量（2的幂）
+ */
+constexpr uint64_t RingCapacity = 64 * 1024;
+
+/**
+ * @brief 总线帧日志文件魔数（"LBFR"）
+ */
+constexpr quint32 FrameFileMagic = 0x4C424652;
+constexpr quint16 FrameFileVersion = 2;
+
+/**
+ * @brief 单生产者/单消费者字节环形缓冲
+ * @details 生产者只写head，消费者只写tail，二者以acquire/release配对，无锁无等待；
+ *          记录以RecordHeader::size开头，可跨越缓冲区末尾回绕
+ */
+struct ThreadBuffer {
+    alignas(64) std::atomic<uint64_t> head{0};
+    alignas(64) std::atomic<uint64_t> tail{0};
+    std::atomic<bool> retired{false};
+    uint8_t data[RingCapacity];
+
+    bool push(const uint8_t *record, int size)
+    {
+        const uint64_t h = head.load(std::memory_order_relaxed);
+        const uint64_t t = tail.load(std::memory_order_acquire);
+        if (RingCapacity - (h - t) < static_cast<uint64_t>(size)) {
+            return false;
+        }
+        const uint64_t pos = h & (RingCapacity - 1);
+        const uint64_t first = std::min<uint64_t>(static_cast<uint64_t>(size), RingCapacity - pos);
+        std::memcpy(data + pos, record, first);
+        std::memcpy(data, record + first, static_cast<size_t>(size) - first);
+        head.store(h + static_cast<uint64_t>(size), std::memory_order_release);
+        return true;
+    }
+
+    void copyOut(uint64_t from, void *out, uint64_t size) const
+    {
+        const uint64_t pos = from & (RingCapacity - 1);
+        const uint64_t first = std::min(size, RingCapacity - pos);
+        std::memcpy(out, data + pos, first);
+        std::memcpy(static_cast<uint8_t *>(out) + first, data, size - first);
+    }
+
+    /**
+     * @brief 取出全部记录追加到out
+     */
+    void drainTo(std::vector<uint8_t> &out)
+    {
+        uint64_t t = tail.load(std::memory_order_relaxed);
+        const uint64_t h = head.load(std::memory_order_acquire);
+        while (t < h) {
+            uint16_t size = 0;
+            copyOut(t, &size, sizeof(size));
+            const size_t offset = out.size();
+            out.resize(offset + size);
+            copyOut(t, out.data() + offset, size);
+            t += size;
+        }
+        tail.store(t, std::memory_order_release);
+    }
+
+    bool empty() const
+    {
+        return head.load(std::memory_order_acquire) == tail.load(std::memory_order_relaxed);
+    }
+};
+
+/**
+ * @brief 线程退出时标记缓冲可回收
+ */
+struct ThreadHandle {
+    ThreadBuffer *buffer = nullptr;
+    ~ThreadHandle()
+    {
+        if (buffer) {
+            buffer->retired.store(true, std::memory_order_release);
+        }
+    }
+};
+
+/**
+ * @brief 按大小滚动的日志文件
+ */
+class RotatingFile
+{
+public:
+    void open(const QString &directory, const QString &baseName, const QString &suffix,
+              qint64 maxBytes, int maxFiles, const QByteArray &fileHeader)
+    {
+        m_directory = directory;
+        m_baseName = baseName;
+        m_suffix = suffix;
+        m_maxBytes = maxBytes;
+        m_maxFiles = qMax(1, maxFiles);
+        m_fileHeader = fileHeader;
+        reopen(false);
+    }
+
+    void close()
+    {
+        m_file.close();
+    }
+
+    bool isOpen() const
+    {
+        return m_file.isOpen();
+    }
+
+    void write(const QByteArray &data)
+    {
+        if (!m_file.isOpen()) {
+            return;
+        }
+        if (m_file.size() + data.size() > m_maxBytes && m_file.size() > m_fileHeader.size()) {
+            reopen(true);
+        }
+        m_file.write(data);
+    }
+
+    void flush()
+    {
+        m_file.flush();
+    }
+
+private:
+    QString path(int index) const
+    {
+        const QString name = index == 0 ? QStringLiteral("%1.%2").arg(m_baseName, m_suffix)
+                                         : QStringLiteral("%1.%2.%3").arg(m_baseName).arg(index).arg(m_suffix);
+        return QDir(m_directory).filePath(name);
+    }
+
+    void reopen(bool rotate)
+    {
+        m_file.close();
+        if (rotate) {
+            QFile::remove(path(m_maxFiles - 1));
+            for (int i = m_maxFiles - 2; i >= 0; --i) {
+                QFile::rename(path(i), path(i + 1));
+            }
+        }
+        m_file.setFileName(path(0));
+        const bool fresh = rotate || !m_file.exists();
+        if (!m_file.open(fresh ? QIODevice::WriteOnly : QIODevice::Append)) {
+            return;
+        }
+        if (m_file.size() == 0) {
+            m_file.write(m_fileHeader);
+        }
+    }
+
+    QFile m_file;
+    QString m_directory;
+    QString m_baseName;
+    QString m_suffix;
+    qint64 m_maxBytes = 0;
+    int m_maxFiles = 1;
+    QByteArray m_fileHeader;
+};
+
+/**
+ * @brief 日志全局状态
+ * @details 有意不释放，避免静态对象析构顺序与线程退出交错
+ */
+struct State {
+    std::mutex registryMutex;
+    std::vector<ThreadBuffer *> buffers;
+
+    std::mutex wakeMutex;
+    std::condition_variable wake;
+    std::thread flusher;
+    bool running = false;
+    bool stopRequested = false;
+    std::atomic<bool> urgent{false};
+
+    std::atomic<quint64> dropped{0};
+    quint64 reportedDropped = 0;
+    std::atomic<bool> consoleEcho{
+#ifdef NDEBUG
+        false
+#else
+        true
+#endif
+    };
+
+    std::chrono::steady_clock::time_point steadyStart = std::chrono::steady_clock::now();
+    qint64 wallStartMs = QDateTime::currentMSecsSinceEpoch();
+
+    QString directory;
+    RotatingFile textFile;
+    RotatingFile frameFile;
+
+    qint64 cachedSecond = -1;
+    QString cachedPrefix;
+};
+
+State &state()
+{
+    static State *s = new State;
+    return *s;
+}
+
+thread_local ThreadHandle t_handle;
+
+ThreadBuffer *threadBuffer()
+{
+    if (!t_handle.buffer) {
+        auto *buffer = new ThreadBuffer;
+        State &s = state();
+        std::lock_guard<std::mutex> lock(s.registryMutex);
+        s.buffers.push_back(buffer);
+        t_handle.buffer = buffer;
+    }
+    return t_handle.buffer;
+}
+
+const char *levelName(uint8_t level)
+{
+    static const char *names[] = {"T", "D", "I", "W", "E"};
+    return level <= Error ? names[level] : "?";
+}
+
+const char *categoryName(uint32_t category)
+{
+    if (category & General) return "app";
+    if (category & Modbus) return "modbus";
+    if (category & Transport) return "transport";
+    if (category & Recorder) return "recorder";
+    if (category & Serial) return "serial";
+    if (category & Ui) return "ui";
+    return "misc";
+}
+
+/**
+ * @brief 解码一个参数并按格式说明追加到行
+ * @param spec 占位符内的格式说明，目前支持":.Nf"指定小数位数
+ */
+const uint8_t *appendArg(QString &line, const uint8_t *arg, const uint8_t *end, QStringView spec)
+{
+    if (arg >= end) {
+        return end;
+    }
+
+    const uint8_t tag = *arg++;
+    if (tag == StringArg) {
+        uint16_t length = 0;
+        std::memcpy(&length, arg, sizeof(length));
+        arg += 2;
+        line += QString::fromUtf8(reinterpret_cast<const char *>(arg), length);
+        return arg + length;
+    }
+    if (tag == Utf16StringArg) {
+        uint16_t length = 0;
+        std::memcpy(&length, arg, sizeof(length));
+        arg += 2;
+        // 记录内的码元未必按2字节对齐，先拷贝出来
+        QString text(length / 2, Qt::Uninitialized);
+        std::memcpy(text.data(), arg, length);
+        line += text;
+        return arg + length;
+    }
+
+    uint64_t bits = 0;
+    std::memcpy(&bits, arg, sizeof(bits));
+    switch (tag) {
+    case IntArg:
+        line += QString::number(static_cast<qint64>(bits));
+        break;
+    case UIntArg:
+        line += QString::number(static_cast<quint64>(bits));
+        break;
+    case BoolArg:
+        line += bits ? QStringLiteral("true") : QStringLiteral("false");
+        break;
+    case DoubleArg: {
+        double value = 0.0;
+        std::memcpy(&value, &bits, sizeof(value));
+        int precision = -1;
+        if (spec.startsWith(QStringLiteral(":.")) && spec.endsWith(QLatin1Char('f'))) {
+            precision = spec.mid(2, spec.size() - 3).toInt();
+        }
+        line += precision >= 0 ? QString::number(value, 'f', precision) : QString::number(value, 'g', 10);
+        break;
+    }
+    default:
+        break;
+    }
+    return arg + 8;
+}
+
+/**
+ * @brief 格式化文本记录
+ */
+QString formatRecord(State &s, const RecordHeader &header, const uint8_t *record)
+{
+    const qint64 wallMs = s.wallStartMs + header.timestampNs / 1000000;
+    const qint64 second = wallMs / 1000;
+    if (second != s.cachedSecond) {
+        s.cachedSecond = second;
+        s.cachedPrefix = QDateTime::fromMSecsSinceEpoch(second * 1000).toString("yyyy-MM-dd HH:mm:ss");
+    }
+
+    QString line;
+    line.reserve(128);
+    line += s.cachedPrefix;
+    line += QStringLiteral(".%1 [%2] %3: ")
+                .arg(wallMs % 1000, 3, 10, QLatin1Char('0'))
+                .arg(QLatin1String(levelName(header.level)), QLatin1String(categoryName(header.category)));
+
+    const uint8_t *arg = record + sizeof(RecordHeader) + 1;
+    const uint8_t *end = record + header.size;
+    const QString format = QString::fromUtf8(header.format);
+    for (int i = 0; i < format.size(); ++i) {
+        const QChar c = format.at(i);
+        if (c == QLatin1Char('{')) {
+            const int close = format.indexOf(QLatin1Char('}'), i + 1);
+            if (close > i) {
+                arg = appendArg(line, arg, end, QStringView(format).mid(i + 1, close - i - 1));
+                i = close;
+                continue;
+            }
+        }
+        line += c;
+    }
+    return line;
+}
+
+/**
+ * @brief 编码帧记录为文件格式
+ * @details 小端：int64时间戳(ns，相对文件头中的起始时刻) + uint32类别 + uint8方向 + uint8帧格式 + uint16长度 + 数据
+ */
+void appendFrame(QByteArray &out, const RecordHeader &header, const uint8_t *record)
+{
+    const uint8_t *payload = record + sizeof(RecordHeader);
+    const uint8_t direction = payload[0];
+    const uint8_t format = payload[1];
+    uint16_t length = 0;
+    std::memcpy(&length, payload + 2, sizeof(length));
+
+    uint8_t buffer[16];
+    qToLittleEndian<qint64>(header.timestampNs, buffer);
+    qToLittleEndian<quint32>(header.category, buffer + 8);
+    buffer[12] = direction;
+    buffer[13] = format;
+    qToLittleEndian<quint16>(length, buffer + 14);
+    out.append(reinterpret_cast<const char *>(buffer), sizeof(buffer));
+    out.append(reinterpret_cast<const char *>(payload + 4), length);
+}
+
+/**
+ * @brief 取出全部线程的记录，按时间排序后格式化写出
+ */
+void drainAll(State &s)
+{
+    std::vector<ThreadBuffer *> buffers;
+    {
+        std::lock_guard<std::mutex> lock(s.registryMutex);
+        buffers = s.buffers;
+    }
+
+    std::vector<uint8_t> arena;
+    std::vector<ThreadBuffer *> finished;
+    for (ThreadBuffer *buffer : buffers) {
+        // 先读退出标记再取数据，保证退出线程的最后一批记录不会遗漏
+        const bool retired = buffer->retired.load(std::memory_order_acquire);
+        buffer->drainTo(arena);
+        if (retired) {
+            finished.push_back(buffer);
+        }
+    }
+    if (!finished.empty()) {
+        std::lock_guard<std::mutex> lock(s.registryMutex);
+        for (ThreadBuffer *buffer : finished) {
+            s.buffers.erase(std::find(s.buffers.begin(), s.buffers.end(), buffer));
+            delete buffer;
+        }
+    }
+
+    struct Entry {
+        int64_t timestampNs;
+        size_t offset;
+    };
+    std::vector<Entry> entries;
+    for (size_t offset = 0; offset < arena.size();) {
+        RecordHeader header;
+        std::memcpy(&header, arena.data() + offset, sizeof(header));
+        entries.push_back({header.timestampNs, offset});
+        offset += header.size;
+    }
+    std::stable_sort(entries.begin(), entries.end(), [](const Entry &a, const Entry &b) {
+        return a.timestampNs < b.timestampNs;
+    });
+
+    QByteArray text;
+    QByteArray frames;
+    const bool echo = s.consoleEcho.load(std::memory_order_relaxed);
+    for (const Entry &entry : entries) {
+        const uint8_t *record = arena.data() + entry.offset;
+        RecordHeader header;
+        std::memcpy(&header, record, sizeof(header));
+        if (header.type == 1) {
+            appendFrame(frames, header, record);
+            continue;
+        }
+        const QString line = formatRecord(s, header, record);
+        if (echo) {
+            qDebug().noquote() << line;
+        }
+        text += line.toUtf8();
+        text += '\n';
+    }
+
+    const quint64 dropped = s.dropped.load(std::memory_order_relaxed);
+    if (dropped != s.reportedDropped) {
+        text += QStringLiteral("[W] logger: %1 records dropped (buffer full)\n").arg(dropped - s.reportedDropped).toUtf8();
+        s.reportedDropped = dropped;
+    }
+
+    if (!text.isEmpty()) {
+        s.textFile.write(text);
+        s.textFile.flush();
+    }
+    if (!frames.isEmpty()) {
+        s.frameFile.write(frames);
+        s.frameFile.flush();
+    }
+}
+
+void flushLoop()
+{
+    State &s = state();
+    while (true) {
+        bool stopping = false;
+        {
+            std::unique_lock<std::mutex> lock(s.wakeMutex);
+            s.wake.wait_for(lock, std::chrono::milliseconds(50), [&s] {
+                return s.stopRequested || s.urgent.exchange(false, std::memory_order_relaxed);
+            });
+            stopping = s.stopRequested;
+        }
+        drainAll(s);
+        if (stopping) {
+            break;
+        }
+    }
+    s.textFile.close();
+    s.frameFile.close();
+}
+
+} // namespace
+
+void Logger::start(const QString &directory, qint64 maxFileBytes, int maxFiles)
+{
+    State &s = state();
+    std::lock_guard<std::mutex> lock(s.wakeMutex);
+    if (s.running) {
+        return;
+    }
+
+    QDir().mkpath(directory);
+    s.directory = directory;
+    s.textFile.open(directory, QStringLiteral("app"), QStringLiteral("log"), maxFileBytes, maxFiles, QByteArray());
+
+    // 帧文件头：魔数、版本、保留、起始时刻(ms since epoch)
+    QByteArray frameHeader(16, '\0');
+    uchar *raw = reinterpret_cast<uchar *>(frameHeader.data());
+    qToLittleEndian<quint32>(FrameFileMagic, raw);
+    qToLittleEndian<quint16>(FrameFileVersion, raw + 4);
+    qToLittleEndian<qint64>(s.wallStartMs, raw + 8);
+    s.frameFile.open(directory, QStringLiteral("bus-frames"), QStringLiteral("bin"), maxFileBytes, maxFiles, frameHeader);
+
+    s.stopRequested = false;
+    s.running = true;
+    s.flusher = std::thread(flushLoop);
+}
+
+void Logger::stop()
+{
+    State &s = state();
+    {
+        std::lock_guard<std::mutex> lock(s.wakeMutex);
+        if (!s.running) {
+            return;
+        }
+        s.stopRequested = true;
+    }
+    s.wake.notify_one();
+    s.flusher.join();
+    s.running = false;
+}
+
+void Logger::setConsoleEcho(bool enabled)
+{
+    state().consoleEcho.store(enabled, std::memory_order_relaxed);
+}
+
+quint64 Logger::droppedCount()
+{
+    return state().dropped.load(std::memory_order_relaxed);
+}
+
+QString Logger::directory()
+{
+    State &s = state();
+    std::lock_guard<std::mutex> lock(s.wakeMutex);
+    return s.running ? s.directory : QString();
+}
+
+QString Logger::frameFilePath()
+{
+    const QString dir = directory();
+    return dir.isEmpty() ? QString() : QDir(dir).filePath(QStringLiteral("bus-frames.bin"));
+}
+
+void Logger::writeFrame(uint32_t category, FrameDirection direction, FrameFormat format, const uint8_t *data, int length)
+{
+    alignas(8) uint8_t buffer[MaxRecordSize];
+    constexpr int payloadOffset = static_cast<int>(sizeof(RecordHeader));
+    length = std::max(0, std::min(length, MaxRecordSize - payloadOffset - 4));
+
+    RecordHeader header;
+    header.size = static_cast<uint16_t>(payloadOffset + 4 + length);
+    header.type = 1;
+    header.level = Trace;
+    header.category = category;
+    header.timestampNs = now();
+    header.format = nullptr;
+    std::memcpy(buffer, &header, sizeof(header));
+
+    buffer[payloadOffset] = direction;
+    buffer[payloadOffset + 1] = format;
+    const uint16_t len = static_cast<uint16_t>(length);
+    std::memcpy(buffer + payloadOffset + 2, &len, sizeof(len));
+    if (length > 0) {
+        std::memcpy(buffer + payloadOffset + 4, data, static_cast<size_t>(length));
+    }
+    commit(buffer, header.size);
+}
+
+int64_t Logger::now()
+{
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+               std::chrono::steady_clock::now() - state().steadyStart).count();
+}
+
+void Logger::commit(const uint8_t *record, int size)
+{
+    if (!threadBuffer()->push(record, size)) {
+        state().dropped.fetch_add(1, std::memory_order_relaxed);
+        return;
+    }
+    // 错误级别记录尽快落盘
+    if (record[3] >= Error) {
+        State &s = state();
+        s.urgent.store(true, std::memory_order_relaxed);
+        s.wake.notify_one();
+    }
+}
+
+} // namespace Log
@@ -0,0 +1,340 @@
+#ifndef LOGGER_H
+#define LOGGER_H
+
+#include <QString>
+#include <QByteArray>
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <cstring>
+#include <type_traits>
+
+/**
+ * @brief 编译期最低日志级别
+ * @details 低于该级别的LOG_*调用连同参数求值一起被编译器消除。
+ *          默认Release为Info，Debug为Debug，可通过编译定义覆盖
+ */
+#ifndef EVOLVE_LOG_MIN_LEVEL
+#  ifdef NDEBUG
+#    define EVOLVE_LOG_MIN_LEVEL 2
+#  else
+#    define EVOLVE_LOG_MIN_LEVEL 1
+#  endif
+#endif
+
+/**
+ * @brief 编译期启用的日志类别位掩码
+ */
+#ifndef EVOLVE_LOG_CATEGORIES
+#  define EVOLVE_LOG_CATEGORIES 0xFFFFFFFFu
+#endif
+
+namespace Log {
+
+/**
+ * @brief 日志级别
+ */
+enum Level : uint8_t {
+    Trace = 0,
+    Debug = 1,
+    Info = 2,
+    Warning = 3,
+    Error = 4
+};
+
+/**
+ * @brief 日志类别（位掩码）
+ */
+enum Category : uint32_t {
+    General = 1u << 0,
+    Modbus = 1u << 1,
+    Transport = 1u << 2,
+    Recorder = 1u << 3,
+    Serial = 1u << 4,
+    Ui = 1u << 5
+};
+
+/**
+ * @brief 编译期判断级别与类别是否启用
+ */
+constexpr bool enabled(Level level, uint32_t category)
+{
+    return level >= EVOLVE_LOG_MIN_LEVEL && (category & EVOLVE_LOG_CATEGORIES) != 0;
+}
+
+/**
+ * @brief 总线帧方向
+ */
+enum FrameDirection : uint8_t {
+    Tx = 0,
+    Rx = 1
+};
+
+/**
+ * @brief 总线帧格式
+ * @details 写入帧文件，供离线分析工具选择解码方式
+ */
+enum FrameFormat : uint8_t {
+    RtuFrame = 0,           ///< 串口或RTU over TCP的原始RTU帧（含CRC）
+    TcpFrame = 1,           ///< Modbus TCP帧（含MBAP报文头）
+    RebuiltRtuFrame = 2     ///< 由Qt Modbus主站的PDU补全地址与CRC重建，时间戳为提交/完成时刻
+};
+
+namespace detail {
+inline std::atomic<uint8_t> runtimeLevel{Trace};
+inline std::atomic<bool> frameLogging{false};
+} // namespace detail
+
+/**
+ * @brief 单条记录的最大字节数（含头部）
+ */
+constexpr int MaxRecordSize = 512;
+
+/**
+ * @brief 记录头
+ * @details 生产线程只拷贝原始参数，格式化推迟到后台刷新线程
+ */
+struct RecordHeader {
+    uint16_t size;
+    uint8_t type;           ///< 0：文本，1：总线帧
+    uint8_t level;
+    uint32_t category;
+    int64_t timestampNs;    ///< 单调时钟
+    const char *format;     ///< 文本格式串（必须是字符串字面量），帧记录为nullptr
+};
+
+/**
+ * @brief 参数类型标记
+ */
+enum ArgTag : uint8_t {
+    IntArg = 0,
+    UIntArg = 1,
+    DoubleArg = 2,
+    StringArg = 3,          ///< UTF-8字节
+    BoolArg = 4,
+    Utf16StringArg = 5      ///< QString的UTF-16码元原样拷贝，刷新线程再转换
+};
+
+/**
+ * @brief 记录编码器
+ * @details 在栈上按标记+原始值依次写入参数，超出容量的参数被截断
+ */
+class RecordWriter
+{
+public:
+    explicit RecordWriter(uint8_t *buffer) : m_buffer(buffer), m_pos(sizeof(RecordHeader) + 1), m_count(0) {}
+
+    void add(bool value) { putTagged(BoolArg, static_cast<uint64_t>(value)); }
+    void add(const char *value) { putString(value, value ? static_cast<int>(std::strlen(value)) : 0); }
+    void add(const QString &value) { putUtf16(value.constData(), static_cast<int>(value.size())); }
+    void add(const QByteArray &value) { putString(value.constData(), value.size()); }
+
+    template<typename T>
+    std::enable_if_t<std::is_floating_point_v<T>> add(T value)
+    {
+        const double d = static_cast<double>(value);
+        uint64_t bits;
+        std::memcpy(&bits, &d, sizeof(bits));
+        putTagged(DoubleArg, bits);
+    }
+
+    template<typename T>
+    std::enable_if_t<std::is_integral_v<T> && !std::is_same_v<T, bool>> add(T value)
+    {
+        if constexpr (std::is_signed_v<T>) {
+            putTagged(IntArg, static_cast<uint64_t>(static_cast<int64_t>(value)));
+        } else {
+            putTagged(UIntArg, static_cast<uint64_t>(value));
+        }
+    }
+
+    template<typename T>
+    std::enable_if_t<std::is_enum_v<T>> add(T value)
+    {
+        add(static_cast<std::underlying_type_t<T>>(value));
+    }
+
+    int finish()
+    {
+        m_buffer[sizeof(RecordHeader)] = m_count;
+        return m_pos;
+    }
+
+private:
+    void putTagged(ArgTag tag, uint64_t value)
+    {
+        if (m_pos + 9 > MaxRecordSize) {
+            return;
+        }
+        m_buffer[m_pos++] = tag;
+        std::memcpy(m_buffer + m_pos, &value, sizeof(value));
+        m_pos += 8;
+        ++m_count;
+    }
+
+    void putString(const char *data, int length)
+    {
+        if (m_pos + 3 > MaxRecordSize) {
+            return;
+        }
+        length = std::max(0, std::min(length, MaxRecordSize - m_pos - 3));
+        m_buffer[m_pos++] = StringArg;
+        const uint16_t len = static_cast<uint16_t>(length);
+        std::memcpy(m_buffer + m_pos, &len, sizeof(len));
+        m_pos += 2;
+        if (length > 0) {
+            std::memcpy(m_buffer + m_pos, data, static_cast<size_t>(length));
+            m_pos += length;
+        }
+        ++m_count;
+    }
+
+    /**
+     * @brief 按UTF-16码元拷贝字符串，不转码、不分配内存
+     * @details 截断时不保留落单的高位代理项
+     */
+    void putUtf16(const QChar *data, int units)
+    {
+        if (m_pos + 3 > MaxRecordSize) {
+            return;
+        }
+        units = std::max(0, std::min(units, (MaxRecordSize - m_pos - 3) / 2));
+        if (units > 0 && data[units - 1].isHighSurrogate()) {
+            --units;
+        }
+        m_buffer[m_pos++] = Utf16StringArg;
+        const uint16_t len = static_cast<uint16_t>(units * 2);
+        std::memcpy(m_buffer + m_pos, &len, sizeof(len));
+        m_pos += 2;
+        if (units > 0) {
+            std::memcpy(m_buffer + m_pos, data, len);
+            m_pos += len;
+        }
+        ++m_count;
+    }
+
+    uint8_t *m_buffer;
+    int m_pos;
+    uint8_t m_count;
+};
+
+/**
+ * @brief 异步结构化日志
+ * @details - 每个生产线程拥有独立的无锁单生产者/单消费者环形缓冲，写入只拷贝原始参数
+ *          - 后台线程定期取出各线程记录，按时间排序后格式化写入滚动文本文件
+ *          - 总线帧以二进制格式写入单独的滚动文件
+ *          - 缓冲区满时丢弃记录并计数，热路径永不阻塞
+ */
+class Logger
+{
+public:
+    /**
+     * @brief 启动后台刷新线程
+     * @param directory 日志目录
+     * @param maxFileBytes 单个文件最大字节数，超过后滚动
+     * @param maxFiles 每种日志保留的文件数
+     */
+    static void start(const QString &directory, qint64 maxFileBytes = 4 * 1024 * 1024, int maxFiles = 5);
+
+    /**
+     * @brief 写出剩余记录并停止后台线程
+     */
+    static void stop();
+
+    /**
+     * @brief 设置运行期最低级别（在编译期级别之上进一步过滤）
+     */
+    static void setLevel(Level level) { detail::runtimeLevel.store(level, std::memory_order_relaxed); }
+    static Level level() { return static_cast<Level>(detail::runtimeLevel.load(std::memory_order_relaxed)); }
+
+    /**
+     * @brief 是否同时输出到控制台（Debug构建默认开启）
+     */
+    static void setConsoleEcho(bool enabled);
+
+    /**
+     * @brief 是否记录总线帧（默认关闭）
+     */
+    static void setFrameLogging(bool enabled) { detail::frameLogging.store(enabled, std::memory_order_relaxed); }
+    static bool frameLogging() { return detail::frameLogging.load(std::memory_order_relaxed); }
+
+    /**
+     * @brief 因缓冲区满而丢弃的记录数
+     */
+    static quint64 droppedCount();
+
+    /**
+     * @brief 日志目录，未启动时为空
+     */
+    static QString directory();
+
+    /**
+     * @brief 当前总线帧文件路径（bus-frames.bin），未启动时为空
+     */
+    static QString frameFilePath();
+
+    /**
+     * @brief 写入文本记录
+     * @param format 含{}占位符的字符串字面量
+     */
+    template<typename... Args>
+    static void write(Level level, uint32_t category, const char *format, const Args &...args)
+    {
+        if (level < Logger::level()) {
+            return;
+        }
+        alignas(8) uint8_t buffer[MaxRecordSize];
+        RecordWriter writer(buffer);
+        (writer.add(args), ...);
+        const int size = writer.finish();
+
+        RecordHeader header;
+        header.size = static_cast<uint16_t>(size);
+        header.type = 0;
+        header.level = level;
+        header.category = category;
+        header.timestampNs = now();
+        header.format = format;
+        std::memcpy(buffer, &header, sizeof(header));
+        commit(buffer, size);
+    }
+
+    /**
+     * @brief 写入二进制总线帧
+     * @param direction 发送或接收
+     * @param format 帧格式
+     * @param data 帧数据
+     * @param length 字节数
+     */
+    static void writeFrame(uint32_t category, FrameDirection direction, FrameFormat format, const uint8_t *data, int length);
+
+private:
+    static int64_t now();
+    static void commit(const uint8_t *record, int size);
+};
+
+} // namespace Log
+
+#define EVOLVE_LOG(level, category, ...) \
+    do { \
+        if constexpr (Log::enabled(level, category)) { \
+            Log::Logger::write(level, category, __VA_ARGS__); \
+        } \
+    } while (0)
+
+#define LOG_TRACE(category, ...) EVOLVE_LOG(Log::Trace, category, __VA_ARGS__)
+#define LOG_DEBUG(category, ...) EVOLVE_LOG(Log::Debug, category, __VA_ARGS__)
+#define LOG_INFO(category, ...) EVOLVE_LOG(Log::Info, category, __VA_ARGS__)
+#define LOG_WARNING(category, ...) EVOLVE_LOG(Log::Warning, category, __VA_ARGS__)
+#define LOG_ERROR(category, ...) EVOLVE_LOG(Log::Error, category, __VA_ARGS__)
+
+#define LOG_FRAME(category, direction, format, data, length) \
+    do { \
+        if constexpr (((category) & EVOLVE_LOG_CATEGORIES) != 0) { \
+            if (Log::Logger::frameLogging()) { \
+                Log::Logger::writeFrame(category, direction, format, data, length); \
+            } \
+        } \
+    } while (0)
+
+#endif
@@ -0,0 +1,404 @@
+#include "Metrics.h"
+#include "Logger.h"
+#include <QTimer>
+#include <QThread>
+#include <QDateTime>
+#include <QDir>
+#include <QFile>
+#include <QSaveFile>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QMetaEnum>
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <mutex>
+#include <vector>
+
+#if defined(Q_OS_WIN)
+#include <windows.h>
+#include <psapi.h>
+#elif defined(Q_OS_MACOS)
+#include <mach/mach.h>
+#elif defined(Q_OS_LINUX)
+#include <unistd.h>
+#endif
+
+namespace {
+
+/**
+ * @brief 单个线程的指标槽
+ * @details 只由所属线程写入，写入方先load再store（单写者不需要RMW），
+ *          汇总线程relaxed读取，读到的是某一时刻的近似值
+ */
+struct ThreadSlot {
+    std::atomic<qint64> counters[Metrics::CounterCount] = {};
+    std::atomic<qint64> levels[Metrics::LevelCount] = {};
+    std::atomic<qint64> spanCount[Metrics::SpanCount] = {};
+    std::atomic<qint64> spanNs[Metrics::SpanCount] = {};
+    std::atomic<qint64> spanMaxNs[Metrics::SpanCount] = {};
+    std::atomic<quint32> maxEpoch{0};       ///< spanMaxNs所属的快照周期
+    std::atomic<bool> retired{false};
+    QString thread;
+};
+
+/**
+ * @brief 指标全局状态
+ * @details 与日志缓冲区一样有意不释放；退出线程的槽保留，保证累计值与电平不丢失
+ */
+struct State {
+    std::mutex registryMutex;
+    std::vector<ThreadSlot *> threadSlots;
+    std::atomic<quint32> epoch{1};
+    std::atomic<bool> framesEnabled{false};
+    std::atomic<qint64> framePeriodNs{16666667};
+    qint64 lastSwapNs = 0;                  ///< 只由渲染线程访问
+};
+
+State &state()
+{
+    static State *s = new State;
+    return *s;
+}
+
+struct SlotHandle {
+    ThreadSlot *slot = nullptr;
+    ~SlotHandle()
+    {
+        if (slot) {
+            slot->retired.store(true, std::memory_order_relaxed);
+        }
+    }
+};
+
+thread_local SlotHandle t_slot;
+
+ThreadSlot *threadSlot()
+{
+    if (!t_slot.slot) {
+        auto *slot = new ThreadSlot;
+        QThread *thread = QThread::currentThread();
+        slot->thread = thread && !thread->objectName().isEmpty()
+                           ? thread->objectName()
+                           : QStringLiteral("0x%1").arg(reinterpret_cast<quintptr>(QThread::currentThreadId()), 0, 16);
+        State &s = state();
+        std::lock_guard<std::mutex> lock(s.registryMutex);
+        s.threadSlots.push_back(slot);
+        t_slot.slot = slot;
+    }
+    return t_slot.slot;
+}
+
+inline void bump(std::atomic<qint64> &value, qint64 delta)
+{
+    value.store(value.load(std::memory_order_relaxed) + delta, std::memory_order_relaxed);
+}
+
+const std::chrono::steady_clock::time_point g_start = std::chrono::steady_clock::now();
+
+double toMs(qint64 ns)
+{
+    return ns / 1e6;
+}
+
+} // namespace
+
+Metrics::Metrics(QObject *parent)
+    : QObject(parent)
+    , m_enabled(false)
+    , m_timer(new QTimer(this))
+    , m_droppedTotal(0)
+{
+    m_timer->setInterval(1000);
+    connect(m_timer, &QTimer::timeout, this, &Metrics::takeSnapshot);
+}
+
+Metrics::~Metrics()
+{
+    state().framesEnabled.store(false, std::memory_order_relaxed);
+}
+
+void Metrics::add(Counter counter, qint64 n)
+{
+    bump(threadSlot()->counters[counter], n);
+}
+
+void Metrics::adjust(Level level, qint64 delta)
+{
+    bump(threadSlot()->levels[level], delta);
+}
+
+void Metrics::record(Span span, qint64 ns)
+{
+    ThreadSlot *slot = threadSlot();
+    bump(slot->spanCount[span], 1);
+    bump(slot->spanNs[span], ns);
+
+    // 快照周期变化后本线程的最大值从头统计
+    const quint32 epoch = state().epoch.load(std::memory_order_relaxed);
+    if (slot->maxEpoch.load(std::memory_order_relaxed) != epoch) {
+        for (auto &value : slot->spanMaxNs) {
+            value.store(0, std::memory_order_relaxed);
+        }
+        slot->maxEpoch.store(epoch, std::memory_order_relaxed);
+    }
+    if (ns > slot->spanMaxNs[span].load(std::memory_order_relaxed)) {
+        slot->spanMaxNs[span].store(ns, std::memory_order_relaxed);
+    }
+}
+
+qint64 Metrics::now()
+{
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - g_start).count();
+}
+
+void Metrics::frameSwapped()
+{
+    State &s = state();
+    if (!s.framesEnabled.load(std::memory_order_relaxed)) {
+        s.lastSwapNs = 0;
+        return;
+    }
+
+    const qint64 t = now();
+    const qint64 interval = s.lastSwapNs > 0 ? t - s.lastSwapNs : 0;
+    s.lastSwapNs = t;
+    add(FramesRendered);
+    // 场景静止时不渲染，超过250ms的间隔视为空闲而不是掉帧
+    if (interval <= 0 || interval > 250000000) {
+        return;
+    }
+    record(FrameTime, interval);
+    const qint64 period = s.framePeriodNs.load(std::memory_order_relaxed);
+    if (interval * 2 > period * 3) {
+        add(FramesDropped, std::max<qint64>(1, (interval + period / 2) / period - 1));
+    }
+}
+
+void Metrics::setRefreshRate(double hz)
+{
+    state().framePeriodNs.store(static_cast<qint64>(1e9 / (hz > 0 ? hz : 60.0)), std::memory_order_relaxed);
+}
+
+void Metrics::setEnabled(bool enabled)
+{
+    if (m_enabled == enabled) {
+        return;
+    }
+    m_enabled = enabled;
+    state().framesEnabled.store(enabled, std::memory_order_relaxed);
+    if (enabled) {
+        m_previous = collect();
+        m_droppedTotal = 0;
+        m_interval.start();
+        m_timer->start();
+    } else {
+        m_timer->stop();
+    }
+    emit enabledChanged();
+}
+
+double Metrics::beginSpan() const
+{
+    return static_cast<double>(now());
+}
+
+void Metrics::endSpan(Span span, double started)
+{
+    if (span >= 0 && span < SpanCount && started > 0) {
+        record(span, now() - static_cast<qint64>(started));
+    }
+}
+
+void Metrics::count(Counter counter, int n)
+{
+    if (counter >= 0 && counter < CounterCount) {
+        add(counter, n);
+    }
+}
+
+Metrics::Totals Metrics::collect()
+{
+    State &s = state();
+    std::vector<ThreadSlot *> threadSlots;
+    {
+        std::lock_guard<std::mutex> lock(s.registryMutex);
+        threadSlots = s.threadSlots;
+    }
+
+    // 先推进周期，之后写入的最大值归入下一个快照
+    const quint32 epoch = s.epoch.fetch_add(1, std::memory_order_relaxed);
+    Totals totals;
+    for (ThreadSlot *slot : threadSlots) {
+        for (int i = 0; i < CounterCount; ++i) {
+            totals.counters[i] += slot->counters[i].load(std::memory_order_relaxed);
+        }
+        for (int i = 0; i < LevelCount; ++i) {
+            totals.levels[i] += slot->levels[i].load(std::memory_order_relaxed);
+        }
+        const bool currentMax = slot->maxEpoch.load(std::memory_order_relaxed) == epoch;
+        for (int i = 0; i < SpanCount; ++i) {
+            totals.spanCount[i] += slot->spanCount[i].load(std::memory_order_relaxed);
+            totals.spanNs[i] += slot->spanNs[i].load(std::memory_order_relaxed);
+            if (currentMax) {
+                totals.spanMaxNs[i] = std::max(totals.spanMaxNs[i], slot->spanMaxNs[i].load(std::memory_order_relaxed));
+            }
+        }
+        if (!slot->retired.load(std::memory_order_relaxed)) {
+            ++totals.threads;
+        }
+    }
+    return totals;
+}
+
+QVariantMap Metrics::spanEntry(const Totals &current, const Totals &previous, Span span, double seconds)
+{
+    const qint64 count = current.spanCount[span] - previous.spanCount[span];
+    const qint64 ns = current.spanNs[span] - previous.spanNs[span];
+    QVariantMap entry;
+    entry["perSec"] = count / seconds;
+    entry["avgMs"] = count > 0 ? toMs(ns) / count : 0.0;
+    entry["maxMs"] = toMs(current.spanMaxNs[span]);
+    // 每秒累计占用的主线程时间，直观反映对帧预算的挤占
+    entry["msPerSec"] = toMs(ns) / seconds;
+    return entry;
+}
+
+void Metrics::takeSnapshot()
+{
+    const Totals current = collect();
+    const double seconds = std::max<qint64>(1, m_interval.restart()) / 1000.0;
+    auto rate = [&](Counter counter) {
+        return (current.counters[counter] - m_previous.counters[counter]) / seconds;
+    };
+
+    const qint64 dropped = current.counters[FramesDropped] - m_previous.counters[FramesDropped];
+    m_droppedTotal += dropped;
+
+    QVariantMap snapshot;
+    snapshot["time"] = QDateTime::currentDateTime().toString(Qt::ISODateWithMs);
+    snapshot["intervalMs"] = seconds * 1000.0;
+
+    const QVariantMap frame = spanEntry(current, m_previous, FrameTime, seconds);
+    snapshot["fps"] = rate(FramesRendered);
+    snapshot["frameAvgMs"] = frame["avgMs"];
+    snapshot["frameMaxMs"] = frame["maxMs"];
+    snapshot["framePeriodMs"] = toMs(state().framePeriodNs.load(std::memory_order_relaxed));
+    snapshot["droppedFrames"] = dropped;
+    snapshot["droppedTotal"] = m_droppedTotal;
+
+    // 数据路径各级速率：采集 → 历史数据 → 记录 → 落盘
+    snapshot["acquiredPerSec"] = rate(SamplesAcquired);
+    snapshot["historyPerSec"] = (current.spanCount[AddDataPoint] - m_previous.spanCount[AddDataPoint]) / seconds;
+    snapshot["recordedPerSec"] = rate(RecordsAdded);
+    snapshot["writtenPerSec"] = rate(RecordsWritten);
+    snapshot["writtenKBps"] = rate(BytesWritten) / 1024.0;
+    snapshot["busPerSec"] = rate(BusTransactions);
+    snapshot["busErrorsPerSec"] = rate(BusErrors);
+
+    snapshot["addDataPoint"] = spanEntry(current, m_previous, AddDataPoint, seconds);
+    snapshot["chartUpdate"] = spanEntry(current, m_previous, ChartUpdate, seconds);
+    snapshot["chartPaint"] = spanEntry(current, m_previous, ChartPaint, seconds);
+
+    snapshot["transportQueue"] = current.levels[TransportQueue];
+    snapshot["pendingReads"] = current.levels[PendingReads];
+    snapshot["schedulerTasks"] = current.levels[SchedulerTasks];
+
+    const qint64 rss = residentBytes();
+    snapshot["rssMB"] = rss >= 0 ? rss / (1024.0 * 1024.0) : -1.0;
+    snapshot["threads"] = current.threads;
+
+    m_previous = current;
+    m_snapshot = snapshot;
+    emit snapshotChanged();
+}
+
+QString Metrics::exportSnapshot(const QString &filePath)
+{
+    QString path = filePath;
+    if (path.isEmpty()) {
+        const QString dir = Log::Logger::directory();
+        if (dir.isEmpty() || !QDir().mkpath(dir)) {
+            LOG_WARNING(Log::General, "性能快照导出失败: 日志目录不可用");
+            return QString();
+        }
+        path = QDir(dir).filePath(QStringLiteral("metrics_%1.json")
+                                      .arg(QDateTime::currentDateTime().toString("yyyyMMdd_HHmmss")));
+    }
+
+    QJsonObject root = QJsonObject::fromVariantMap(m_snapshot);
+    root["enabled"] = m_enabled;
+
+    // 各线程累计值，便于区分采集、传输与界面线程的负载
+    State &s = state();
+    std::vector<ThreadSlot *> threadSlots;
+    {
+        std::lock_guard<std::mutex> lock(s.registryMutex);
+        threadSlots = s.threadSlots;
+    }
+    QJsonArray threads;
+    for (ThreadSlot *slot : threadSlots) {
+        QJsonObject counters;
+        for (int i = 0; i < CounterCount; ++i) {
+            const qint64 value = slot->counters[i].load(std::memory_order_relaxed);
+            if (value != 0) {
+                counters[QString::fromLatin1(QMetaEnum::fromType<Counter>().valueToKey(i))] = value;
+            }
+        }
+        QJsonObject spans;
+        for (int i = 0; i < SpanCount; ++i) {
+            const qint64 count = slot->spanCount[i].load(std::memory_order_relaxed);
+            if (count > 0) {
+                spans[QString::fromLatin1(QMetaEnum::fromType<Span>().valueToKey(i))] = QJsonObject{
+                    {"count", count},
+                    {"avgMs", toMs(slot->spanNs[i].load(std::memory_order_relaxed)) / count}};
+            }
+        }
+        threads.append(QJsonObject{{"thread", slot->thread},
+                                   {"exited", slot->retired.load(std::memory_order_relaxed)},
+                                   {"counters", counters},
+                                   {"spans", spans}});
+    }
+    root["threadDetails"] = threads;
+
+    QSaveFile file(path);
+    if (!file.open(QIODevice::WriteOnly) || file.write(QJsonDocument(root).toJson(QJsonDocument::Indented)) < 0
+        || !file.commit()) {
+        LOG_WARNING(Log::General, "性能快照导出失败: {} {}", path, file.errorString());
+        return QString();
+    }
+    LOG_INFO(Log::General, "性能快照已导出: {}", path);
+    return path;
+}
+
+qint64 Metrics::residentBytes()
+{
+#if defined(Q_OS_LINUX)
+    QFile file(QStringLiteral("/proc/self/statm"));
+    if (!file.open(QIODevice::ReadOnly)) {
+        return -1;
+    }
+    const QList<QByteArray> fields = file.readAll().split(' ');
+    if (fields.size() < 2) {
+        return -1;
+    }
+    static const qint64 pageSize = sysconf(_SC_PAGESIZE);
+    return fields.at(1).toLongLong() * pageSize;
+#elif defined(Q_OS_WIN)
+    PROCESS_MEMORY_COUNTERS counters;
+    if (GetProcessMemoryInfo(GetCurrentProcess(), &counters, sizeof(counters))) {
+        return static_cast<qint64>(counters.WorkingSetSize);
+    }
+    return -1;
+#elif defined(Q_OS_MACOS)
+    mach_task_basic_info info;
+    mach_msg_type_number_t count = MACH_TASK_BASIC_INFO_COUNT;
+    if (task_info(mach_task_self(), MACH_TASK_BASIC_INFO, reinterpret_cast<task_info_t>(&info), &count) == KERN_SUCCESS) {
+        return static_cast<qint64>(info.resident_size);
+    }
+    return -1;
+#else
+    return -1;
+#endif
+}
@@ -0,0 +1,191 @@
+#ifndef METRICS_H
+#define METRICS_H
+
+#include <QObject>
+#include <QVariantMap>
+#include <QElapsedTimer>
+
+class QTimer;
+
+/**
+ * @brief 性能指标登记
+ * @details 覆盖采集到落盘的整条数据路径：
+ *          - 计数器与耗时统计按线程分槽存放，每个槽只由所属线程写入（relaxed原子读写，不加锁、无RMW），
+ *            汇总时遍历全部槽相加，热路径只有一次线程局部查找和几次普通存储
+ *          - 电平型指标（队列深度）以增减量记录，汇总后即为当前值，多个实例（如多总线）自动累加
+ *          - 帧时间由渲染线程在frameSwapped中调用frameSwapped()记录
+ *          本类只依赖QtCore，无界面版也可链接；静态add/adjust/record可在任意线程调用，
+ *          实例以QML单例Metrics提供，
+ *          启用后每秒生成一次快照（速率、耗时、队列、进程内存），供性能浮层显示与导出
+ */
+class Metrics : public QObject
+{
+    Q_OBJECT
+    /**
+     * @brief 是否启用浮层统计
+     * @details 关闭时不记录帧时间、不生成快照，QML中的耗时打点也应以此判断后跳过；
+     *          数据路径上的计数器始终累计，开销只有几次线程局部存储
+     */
+    Q_PROPERTY(bool enabled READ enabled WRITE setEnabled NOTIFY enabledChanged)
+
+    /**
+     * @brief 最近一次快照
+     */
+    Q_PROPERTY(QVariantMap snapshot READ snapshot NOTIFY snapshotChanged)
+
+public:
+    /**
+     * @brief 累计计数器
+     */
+    enum Counter {
+        SamplesAcquired,    ///< ModbusManager发出的采样
+        RecordsAdded,       ///< DataRecorder追加的记录行
+        RecordsWritten,     ///< 流式写入文件的记录行
+        BytesWritten,       ///< 流式写入的字节数
+        BusTransactions,
+        BusErrors,
+        FramesRendered,
+        FramesDropped,
+        CounterCount
+    };
+    Q_ENUM(Counter)
+
+    /**
+     * @brief 电平型指标
+     */
+    enum Level {
+        TransportQueue,     ///< 自有传输层排队与进行中的事务
+        PendingReads,       ///< ModbusManager等待应答的读请求
+        SchedulerTasks,     ///< UpdateScheduler待执行的更新
+        LevelCount
+    };
+    Q_ENUM(Level)
+
+    /**
+     * @brief 耗时统计
+     */
+    enum Span {
+        FrameTime,          ///< 相邻两次帧交换的间隔
+        AddDataPoint,       ///< WaveformDataManager.addDataPoint
+        ChartUpdate,        ///< WaveformDataManager.updateChartData
+        ChartPaint,         ///< 图表Canvas的onPaint
+        SpanCount
+    };
+    Q_ENUM(Span)
+
+    explicit Metrics(QObject *parent = nullptr);
+    ~Metrics();
+
+    /**
+     * @brief 计数器加n
+     */
+    static void add(Counter counter, qint64 n = 1);
+
+    /**
+     * @brief 电平增减
+     */
+    static void adjust(Level level, qint64 delta);
+
+    /**
+     * @brief 记录一次耗时
+     * @param ns 纳秒
+     */
+    static void record(Span span, qint64 ns);
+
+    /**
+     * @brief 单调时钟（纳秒）
+     */
+    static qint64 now();
+
+    /**
+     * @brief 作用域计时
+     */
+    class ScopedSpan
+    {
+    public:
+        explicit ScopedSpan(Span span) : m_span(span), m_start(now()) {}
+        ~ScopedSpan() { record(m_span, now() - m_start); }
+    private:
+        Span m_span;
+        qint64 m_start;
+    };
+
+    /**
+     * @brief 记录一次帧交换
+     * @details 在渲染线程直接调用，统计相邻帧间隔、帧数与掉帧，未启用时立即返回
+     */
+    static void frameSwapped();
+
+    /**
+     * @brief 设置屏幕刷新率，用于判断掉帧
+     * @param hz 刷新率，<=0时按60Hz
+     */
+    void setRefreshRate(double hz);
+
+    bool enabled() const { return m_enabled; }
+    void setEnabled(bool enabled);
+
+    QVariantMap snapshot() const { return m_snapshot; }
+
+    /**
+     * @brief 开始计时（供QML使用）
+     * @return 单调时钟纳秒值
+     */
+    Q_INVOKABLE double beginSpan() const;
+
+    /**
+     * @brief 结束计时（供QML使用）
+     * @param span 耗时类别
+     * @param started beginSpan的返回值
+     */
+    Q_INVOKABLE void endSpan(Span span, double started);
+
+    /**
+     * @brief 计数器加n（供QML使用）
+     */
+    Q_INVOKABLE void count(Counter counter, int n = 1);
+
+    /**
+     * @brief 导出当前快照与各线程明细
+     * @param filePath 为空时写入日志目录下的metrics_<时间>.json
+     * @return 实际写入的路径，失败返回空字符串
+     */
+    Q_INVOKABLE QString exportSnapshot(const QString &filePath = QString());
+
+    /**
+     * @brief 进程常驻内存（字节），不支持的平台返回-1
+     */
+    static qint64 residentBytes();
+
+signals:
+    void enabledChanged();
+    void snapshotChanged();
+
+private slots:
+    void takeSnapshot();
+
+private:
+    /**
+     * @brief 全部线程槽的汇总
+     */
+    struct Totals {
+        qint64 counters[CounterCount] = {};
+        qint64 levels[LevelCount] = {};
+        qint64 spanCount[SpanCount] = {};
+        qint64 spanNs[SpanCount] = {};
+        qint64 spanMaxNs[SpanCount] = {};
+        int threads = 0;
+    };
+
+    static Totals collect();
+    static QVariantMap spanEntry(const Totals &current, const Totals &previous, Span span, double seconds);
+
+    bool m_enabled;
+    QTimer *m_timer;
+    QElapsedTimer m_interval;
+    Totals m_previous;
+    QVariantMap m_snapshot;
+    qint64 m_droppedTotal;
+};
+
+#endif
@@ -0,0 +1,239 @@
+#include "SampleClock.h"
+#include "Logger.h"
+#include <QDateTime>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include <cstring>
+
+namespace {
+
+/**
+ * @brief 与系统时钟比较的间隔
+ */
+constexpr qint64 SYNC_INTERVAL_NS = 1000000000LL;
+
+/**
+ * @brief 偏差超过该值视为系统时间跳变
+ */
+constexpr qint64 STEP_THRESHOLD_NS = 100000000LL;
+
+/**
+ * @brief 偏差在该时长内逐步消除
+ */
+constexpr double SLEW_HORIZON_NS = 10e9;
+
+/**
+ * @brief 换算速率校正上限
+ */
+constexpr double MAX_RATE_ADJUST = 500e-6;
+
+/**
+ * @brief "yyyy-MM-dd HH:mm:"的长度
+ */
+constexpr int MINUTE_PREFIX_LENGTH = 17;
+
+const std::chrono::steady_clock::time_point g_start = std::chrono::steady_clock::now();
+
+qint64 wallNs()
+{
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+            std::chrono::system_clock::now().time_since_epoch()).count();
+}
+
+/**
+ * @brief toOffsetUs/fromOffsetUs的时间原点（UTC纳秒），进程内固定不变
+ */
+const qint64 g_offsetOriginNs = wallNs();
+
+/**
+ * @brief 换算锚点
+ * @details 以序号保护（写入期间为奇数），读取方发现序号变化时重读；
+ *          写入只由赢得nextSync的线程进行，每秒至多一次
+ */
+struct State {
+    std::atomic<quint32> sequence{0};
+    std::atomic<qint64> anchorMono{0};
+    std::atomic<qint64> anchorUtc{0};
+    std::atomic<double> rate{0.0};
+    std::atomic<qint64> nextSync{0};
+
+    std::atomic<qint64> lastErrorNs{0};
+    std::atomic<quint64> steps{0};
+    std::atomic<quint64> syncs{0};
+
+    State()
+    {
+        const qint64 mono = SampleClock::monotonicNs();
+        anchorMono.store(mono, std::memory_order_relaxed);
+        anchorUtc.store(wallNs(), std::memory_order_relaxed);
+        nextSync.store(mono + SYNC_INTERVAL_NS, std::memory_order_relaxed);
+    }
+};
+
+State &state()
+{
+    static State s;
+    return s;
+}
+
+struct Anchor {
+    qint64 mono;
+    qint64 utc;
+    double rate;
+
+    qint64 convert(qint64 monotonicNs) const
+    {
+        const qint64 delta = monotonicNs - mono;
+        return utc + delta + std::llround(static_cast<double>(delta) * rate);
+    }
+};
+
+Anchor readAnchor(const State &s)
+{
+    Anchor anchor;
+    quint32 before = 0;
+    do {
+        before = s.sequence.load(std::memory_order_acquire);
+        anchor.mono = s.anchorMono.load(std::memory_order_relaxed);
+        anchor.utc = s.anchorUtc.load(std::memory_order_relaxed);
+        anchor.rate = s.rate.load(std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_acquire);
+    } while ((before & 1) != 0 || before != s.sequence.load(std::memory_order_relaxed));
+    return anchor;
+}
+
+void writeAnchor(State &s, const Anchor &anchor)
+{
+    const quint32 sequence = s.sequence.load(std::memory_order_relaxed);
+    s.sequence.store(sequence + 1, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+    s.anchorMono.store(anchor.mono, std::memory_order_relaxed);
+    s.anchorUtc.store(anchor.utc, std::memory_order_relaxed);
+    s.rate.store(anchor.rate, std::memory_order_relaxed);
+    s.sequence.store(sequence + 2, std::memory_order_release);
+}
+
+/**
+ * @brief 到期时与系统时钟比较并校正
+ * @details 偏差较小时以当前换算值为新锚点、调整速率，换算结果保持连续；
+ *          偏差超过阈值时直接锚定到系统时钟
+ */
+void syncIfDue(State &s, qint64 mono)
+{
+    qint64 due = s.nextSync.load(std::memory_order_relaxed);
+    if (mono < due || !s.nextSync.compare_exchange_strong(due, mono + SYNC_INTERVAL_NS, std::memory_order_relaxed)) {
+        return;
+    }
+
+    const Anchor current = readAnchor(s);
+    const qint64 utc = current.convert(mono);
+    const qint64 wall = wallNs();
+    const qint64 error = wall - utc;
+    s.lastErrorNs.store(error, std::memory_order_relaxed);
+    s.syncs.fetch_add(1, std::memory_order_relaxed);
+
+    Anchor next;
+    next.mono = mono;
+    if (std::llabs(error) > STEP_THRESHOLD_NS) {
+        next.utc = wall;
+        next.rate = 0.0;
+        writeAnchor(s, next);
+        s.steps.fetch_add(1, std::memory_order_relaxed);
+        LOG_WARNING(Log::General, "系统时间跳变 {:.1f} ms，采样时间戳已重新锚定", error / 1e6);
+        return;
+    }
+    next.utc = utc;
+    next.rate = qBound(-MAX_RATE_ADJUST, error / SLEW_HORIZON_NS, MAX_RATE_ADJUST);
+    writeAnchor(s, next);
+}
+
+/**
+ * @brief 每个线程缓存的本地时间前缀
+ */
+struct MinuteCache {
+    qint64 minute = -1;
+    char prefix[MINUTE_PREFIX_LENGTH];
+};
+
+thread_local MinuteCache t_minuteCache;
+
+} // namespace
+
+qint64 SampleClock::monotonicNs()
+{
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - g_start).count();
+}
+
+qint64 SampleClock::nowNs()
+{
+    State &s = state();
+    const qint64 mono = monotonicNs();
+    syncIfDue(s, mono);
+    return readAnchor(s).convert(mono);
+}
+
+qint64 SampleClock::toUtcNs(qint64 monotonicNs)
+{
+    return readAnchor(state()).convert(monotonicNs);
+}
+
+double SampleClock::toOffsetUs(qint64 utcNs)
+{
+    return (utcNs - g_offsetOriginNs) / 1000.0;
+}
+
+qint64 SampleClock::fromOffsetUs(double offsetUs)
+{
+    return g_offsetOriginNs + std::llround(offsetUs * 1000.0);
+}
+
+void SampleClock::appendLocalTime(QByteArray &out, qint64 utcNs, bool withMillis)
+{
+    const qint64 ms = utcNs / 1000000;
+    const qint64 minute = ms / 60000;
+    MinuteCache &cache = t_minuteCache;
+    if (cache.minute != minute) {
+        const QByteArray prefix = QDateTime::fromMSecsSinceEpoch(minute * 60000).toString("yyyy-MM-dd HH:mm:").toLatin1();
+        if (prefix.size() != MINUTE_PREFIX_LENGTH) {
+            // 年份超出四位等异常情况不缓存
+            out += QDateTime::fromMSecsSinceEpoch(ms).toString(withMillis ? "yyyy-MM-dd HH:mm:ss.zzz" : "yyyy-MM-dd HH:mm:ss").toLatin1();
+            return;
+        }
+        std::memcpy(cache.prefix, prefix.constData(), MINUTE_PREFIX_LENGTH);
+        cache.minute = minute;
+    }
+
+    const int inMinute = static_cast<int>(ms - minute * 60000);
+    const int second = inMinute / 1000;
+    const int millis = inMinute % 1000;
+    char tail[6];
+    tail[0] = static_cast<char>('0' + second / 10);
+    tail[1] = static_cast<char>('0' + second % 10);
+    tail[2] = '.';
+    tail[3] = static_cast<char>('0' + millis / 100);
+    tail[4] = static_cast<char>('0' + millis / 10 % 10);
+    tail[5] = static_cast<char>('0' + millis % 10);
+    out.append(cache.prefix, MINUTE_PREFIX_LENGTH);
+    out.append(tail, withMillis ? 6 : 2);
+}
+
+QString SampleClock::formatLocal(qint64 utcNs, bool withMillis)
+{
+    QByteArray text;
+    text.reserve(MINUTE_PREFIX_LENGTH + 6);
+    appendLocalTime(text, utcNs, withMillis);
+    return QString::fromLatin1(text);
+}
+
+QVariantMap SampleClock::statistics()
+{
+    State &s = state();
+    QVariantMap stats;
+    stats["offsetErrorUs"] = s.lastErrorNs.load(std::memory_order_relaxed) / 1000.0;
+    stats["rateAdjustPpm"] = readAnchor(s).rate * 1e6;
+    stats["steps"] = static_cast<qint64>(s.steps.load(std::memory_order_relaxed));
+    stats["syncs"] = static_cast<qint64>(s.syncs.load(std::memory_order_relaxed));
+    return stats;
+}
@@ -0,0 +1,74 @@
+#ifndef SAMPLECLOCK_H
+#define SAMPLECLOCK_H
+
+#include <QtGlobal>
+#include <QByteArray>
+#include <QString>
+#include <QVariantMap>
+
+/**
+ * @brief 采样时间戳服务
+ * @details 样本在应答到达时打时间戳，时间戳为UTC纳秒：
+ *          - 以单调时钟为基准，按锚点换算为UTC，热路径只有一次单调时钟读取和几次原子读取，不构造QDateTime
+ *          - 漂移校正：每秒与系统时钟比较一次，偏差在阈值内时调整换算速率（最多±500ppm），
+ *            约10秒内逐步消除偏差，换算结果连续且单调递增
+ *          - 跳变检测：偏差超过100ms（NTP步进、手动改时间、休眠唤醒）时重新锚定到系统时钟，计入steps
+ *          - 时区与格式只在导出和显示时换算（appendLocalTime/formatLocal），每个线程按分钟缓存本地时间前缀
+ *          全部为静态函数，可在任意线程调用；本类只依赖QtCore，无界面版同样使用
+ */
+class SampleClock
+{
+public:
+    /**
+     * @brief 单调时钟（纳秒）
+     * @details 只用于计算间隔，不受系统时间调整影响
+     */
+    static qint64 monotonicNs();
+
+    /**
+     * @brief 当前UTC时间（纳秒）
+     */
+    static qint64 nowNs();
+
+    /**
+     * @brief 将单调时钟读数换算为UTC纳秒
+     * @details 供先在热路径记录单调时刻、稍后再换算的场景，读数应接近当前时刻
+     */
+    static qint64 toUtcNs(qint64 monotonicNs);
+
+    /**
+     * @brief 将UTC纳秒换算为相对进程时间原点的微秒
+     * @details QML的number为double，直接承载UTC纳秒时分辨率只有256ns；
+     *          相对原点的微秒在进程运行数十天内可经fromOffsetUs无损还原为原纳秒值
+     */
+    static double toOffsetUs(qint64 utcNs);
+
+    /**
+     * @brief 将toOffsetUs的结果还原为UTC纳秒
+     */
+    static qint64 fromOffsetUs(double offsetUs);
+
+    /**
+     * @brief 追加本地时间
+     * @param out 输出
+     * @param utcNs UTC纳秒
+     * @param withMillis 为true时格式为"yyyy-MM-dd HH:mm:ss.zzz"，否则到秒
+     * @details 同一分钟内只做一次时区换算（时区偏移按整分钟处理）
+     */
+    static void appendLocalTime(QByteArray &out, qint64 utcNs, bool withMillis = true);
+
+    /**
+     * @brief 格式化为本地时间字符串
+     * @see appendLocalTime
+     */
+    static QString formatLocal(qint64 utcNs, bool withMillis = true);
+
+    /**
+     * @brief 时钟校正统计
+     * @return offsetErrorUs（最近一次与系统时钟的偏差）、rateAdjustPpm（当前速率校正）、
+     *         steps（检测到的跳变次数）、syncs（比较次数）
+     */
+    static QVariantMap statistics();
+};
+
+#endif
@@ -0,0 +1,107 @@
+#include "ScaledImageProvider.h"
+#include "Logger.h"
+#include <QImageReader>
+#include <QImageWriter>
+#include <QSaveFile>
+#include <QFileInfo>
+#include <QFile>
+#include <QDir>
+#include <QCryptographicHash>
+#include <QDateTime>
+
+namespace {
+
+/**
+ * @brief 缓存JPEG质量
+ */
+constexpr int CACHE_JPEG_QUALITY = 90;
+
+} // namespace
+
+ScaledImageProvider::ScaledImageProvider(const QString &cacheDirectory)
+    : QQuickImageProvider(QQuickImageProvider::Image, QQuickImageProvider::ForceAsynchronousImageLoading)
+    , m_cacheDirectory(cacheDirectory)
+{
+    QDir().mkpath(m_cacheDirectory);
+}
+
+QImage ScaledImageProvider::requestImage(const QString &id, QSize *size, const QSize &requestedSize)
+{
+    const QString path = resolvePath(id);
+    QImageReader reader(path);
+    const QSize sourceSize = reader.size();
+    if (size) {
+        *size = sourceSize;
+    }
+
+    // 未指定显示尺寸或不需要缩小时返回原图
+    QSize target = sourceSize;
+    if (sourceSize.isValid() && (requestedSize.width() > 0 || requestedSize.height() > 0)) {
+        const QSize bound(requestedSize.width() > 0 ? requestedSize.width() : sourceSize.width(),
+                          requestedSize.height() > 0 ? requestedSize.height() : sourceSize.height());
+        target = sourceSize.scaled(bound, Qt::KeepAspectRatioByExpanding).boundedTo(sourceSize);
+    }
+    if (!sourceSize.isValid() || target == sourceSize) {
+        QImage image = reader.read();
+        if (image.isNull()) {
+            LOG_WARNING(Log::Ui, "cannot load image {}: {}", path, reader.errorString());
+        }
+        return image;
+    }
+
+    // JPEG源缓存为JPEG，其余（可能带透明通道）缓存为PNG
+    const bool alpha = reader.format() != "jpeg";
+    const QString cached = cachePath(path, sourceSize, target, alpha);
+    QImage image(cached);
+    if (!image.isNull()) {
+        return image;
+    }
+
+    reader.setScaledSize(target);
+    image = reader.read();
+    if (image.isNull()) {
+        LOG_WARNING(Log::Ui, "cannot load image {}: {}", path, reader.errorString());
+        return image;
+    }
+
+    // 同一图片并发请求时各自写临时文件，提交时原子替换
+    QSaveFile file(cached);
+    if (file.open(QIODevice::WriteOnly)) {
+        QImageWriter writer(&file, alpha ? "png" : "jpg");
+        if (!alpha) {
+            writer.setQuality(CACHE_JPEG_QUALITY);
+        }
+        if (writer.write(image)) {
+            file.commit();
+        } else {
+            file.cancelWriting();
+        }
+    }
+    return image;
+}
+
+QString ScaledImageProvider::resolvePath(const QString &id) const
+{
+    const QString resource = QStringLiteral(":/") + id;
+    return QFile::exists(resource) ? resource : id;
+}
+
+/**
+ * @brief 缓存文件路径
+ * @details 以源路径、原始尺寸与修改时间（资源文件无修改时间，取大小）为键，
+ *          源图片变化后自动使用新的缓存
+ */
+QString ScaledImageProvider::cachePath(const QString &sourcePath, const QSize &sourceSize, const QSize &targetSize, bool alpha) const
+{
+    const QFileInfo info(sourcePath);
+    QCryptographicHash hash(QCryptographicHash::Sha1);
+    hash.addData(sourcePath.toUtf8());
+    hash.addData(QByteArray::number(sourceSize.width()) + 'x' + QByteArray::number(sourceSize.height()));
+    hash.addData(QByteArray::number(info.size()));
+    hash.addData(QByteArray::number(info.lastModified().toMSecsSinceEpoch()));
+    return QDir(m_cacheDirectory).filePath(QStringLiteral("%1_%2x%3.%4")
+            .arg(QString::fromLatin1(hash.result().toHex().left(16)))
+            .arg(targetSize.width())
+            .arg(targetSize.height())
+            .arg(alpha ? QStringLiteral("png") : QStringLiteral("jpg")));
+}
@@ -0,0 +1,33 @@
+#ifndef SCALEDIMAGEPROVIDER_H
+#define SCALEDIMAGEPROVIDER_H
+
+#include <QQuickImageProvider>
+#include <QString>
+
+/**
+ * @brief 按显示尺寸提供图片的图片源
+ * @details 以"image://scaled/<资源路径>"访问，例如
+ *          "image://scaled/new/prefix1/fonts/pic/01.jpg"对应":/new/prefix1/fonts/pic/01.jpg"，
+ *          不存在的资源路径按本地文件处理。
+ *          设置了Image.sourceSize时在解码阶段直接缩小（JPEG按比例解码），
+ *          结果写入磁盘缓存，下次启动直接读取小图；未设置时返回原图。
+ *          在线程池中异步加载，不阻塞界面线程
+ */
+class ScaledImageProvider : public QQuickImageProvider
+{
+public:
+    /**
+     * @param cacheDirectory 缩放结果缓存目录
+     */
+    explicit ScaledImageProvider(const QString &cacheDirectory);
+
+    QImage requestImage(const QString &id, QSize *size, const QSize &requestedSize) override;
+
+private:
+    QString resolvePath(const QString &id) const;
+    QString cachePath(const QString &sourcePath, const QSize &sourceSize, const QSize &targetSize, bool alpha) const;
+
+    QString m_cacheDirectory;
+};
+
+#endif
@@ -0,0 +1,202 @@
+#include "StartupTrace.h"
+#include "Logger.h"
+#include <QQuickWindow>
+#include <QElapsedTimer>
+#include <QThread>
+#include <QSaveFile>
+#include <QFileInfo>
+#include <QDir>
+#include <QHash>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QVector>
+#include <atomic>
+#include <memory>
+#include <mutex>
+
+namespace {
+
+/**
+ * @brief 单个阶段
+ */
+struct Phase {
+    QString name;
+    qint64 ns;
+    quintptr thread;
+};
+
+/**
+ * @brief 全局跟踪状态
+ */
+struct TraceState {
+    std::mutex mutex;
+    QElapsedTimer clock;
+    QVector<Phase> phases;
+    quintptr mainThread = 0;
+};
+
+TraceState &state()
+{
+    static TraceState s;
+    return s;
+}
+
+} // namespace
+
+StartupTrace::StartupTrace(QObject *parent)
+    : QObject(parent)
+    , m_firstFrameShown(false)
+    , m_interactive(false)
+    , m_finished(false)
+{
+}
+
+void StartupTrace::begin()
+{
+    TraceState &s = state();
+    std::lock_guard<std::mutex> lock(s.mutex);
+    if (s.clock.isValid()) {
+        return;
+    }
+    s.clock.start();
+    s.mainThread = reinterpret_cast<quintptr>(QThread::currentThreadId());
+    s.phases.reserve(32);
+    s.phases.append({QStringLiteral("main"), 0, s.mainThread});
+}
+
+void StartupTrace::mark(const QString &phase)
+{
+    TraceState &s = state();
+    std::lock_guard<std::mutex> lock(s.mutex);
+    if (!s.clock.isValid()) {
+        return;
+    }
+    s.phases.append({phase, s.clock.nsecsElapsed(), reinterpret_cast<quintptr>(QThread::currentThreadId())});
+}
+
+double StartupTrace::elapsedMs()
+{
+    TraceState &s = state();
+    std::lock_guard<std::mutex> lock(s.mutex);
+    return s.clock.isValid() ? s.clock.nsecsElapsed() / 1e6 : 0.0;
+}
+
+void StartupTrace::setOutputFile(const QString &filePath)
+{
+    m_outputFile = filePath;
+}
+
+/**
+ * @brief 监听首帧
+ * @details frameSwapped在渲染线程发出，直接连接以记录真实的帧交换时刻，
+ *          只处理第一次后转回界面线程
+ */
+void StartupTrace::watchFirstFrame(QQuickWindow *window)
+{
+    if (!window || m_firstFrameShown) {
+        return;
+    }
+    auto connection = std::make_shared<QMetaObject::Connection>();
+    auto fired = std::make_shared<std::atomic<bool>>(false);
+    *connection = connect(window, &QQuickWindow::frameSwapped, this, [this, connection, fired]() {
+        if (fired->exchange(true)) {
+            return;
+        }
+        mark(QStringLiteral("first frame"));
+        QObject::disconnect(*connection);
+        QMetaObject::invokeMethod(this, &StartupTrace::onFirstFrame, Qt::QueuedConnection);
+    }, Qt::DirectConnection);
+}
+
+void StartupTrace::markPhase(const QString &phase)
+{
+    if (m_finished) {
+        LOG_DEBUG(Log::Ui, "startup phase after finish: {} at {:.1f} ms", phase, elapsedMs());
+        return;
+    }
+    mark(phase);
+}
+
+void StartupTrace::markInteractive()
+{
+    if (m_interactive || m_finished) {
+        return;
+    }
+    mark(QStringLiteral("interactive"));
+    m_interactive = true;
+
+    const double totalMs = elapsedMs();
+    if (totalMs > INTERACTIVE_TARGET_MS) {
+        LOG_WARNING(Log::Ui, "startup interactive after {:.1f} ms (target {} ms)", totalMs, INTERACTIVE_TARGET_MS);
+    } else {
+        LOG_INFO(Log::Ui, "startup interactive after {:.1f} ms", totalMs);
+    }
+    writeTrace();
+    emit interactiveChanged();
+}
+
+void StartupTrace::finish()
+{
+    if (m_finished) {
+        return;
+    }
+    markInteractive();
+    m_finished = true;
+    LOG_INFO(Log::Ui, "startup trace finished after {:.1f} ms", elapsedMs());
+    writeTrace();
+    emit finishedChanged();
+}
+
+void StartupTrace::onFirstFrame()
+{
+    m_firstFrameShown = true;
+    LOG_INFO(Log::Ui, "first frame after {:.1f} ms", elapsedMs());
+    // 预热页面之前先落盘一次，预热异常时也保留首帧数据
+    writeTrace();
+    emit firstFrameShownChanged();
+}
+
+/**
+ * @brief 写入Chrome Trace格式文件
+ * @details 每个阶段为一个即时事件，tid区分界面线程(1)与其他线程
+ */
+bool StartupTrace::writeTrace() const
+{
+    if (m_outputFile.isEmpty()) {
+        return false;
+    }
+
+    QJsonArray events;
+    {
+        TraceState &s = state();
+        std::lock_guard<std::mutex> lock(s.mutex);
+        QHash<quintptr, int> threadIds;
+        threadIds.insert(s.mainThread, 1);
+        for (const Phase &phase : std::as_const(s.phases)) {
+            if (!threadIds.contains(phase.thread)) {
+                threadIds.insert(phase.thread, threadIds.size() + 1);
+            }
+            QJsonObject event;
+            event["name"] = phase.name;
+            event["ph"] = QStringLiteral("i");
+            event["s"] = QStringLiteral("g");
+            event["ts"] = phase.ns / 1000.0;
+            event["pid"] = 1;
+            event["tid"] = threadIds.value(phase.thread);
+            events.append(event);
+        }
+    }
+
+    QDir().mkpath(QFileInfo(m_outputFile).absolutePath());
+    QSaveFile file(m_outputFile);
+    if (!file.open(QIODevice::WriteOnly)) {
+        LOG_WARNING(Log::Ui, "cannot write startup trace: {}", m_outputFile);
+        return false;
+    }
+    QJsonObject root;
+    root["traceEvents"] = events;
+    root["displayTimeUnit"] = QStringLiteral("ms");
+    file.write(QJsonDocument(root).toJson(QJsonDocument::Indented));
+    return file.commit();
+}
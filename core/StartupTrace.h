@@ -0,0 +1,108 @@
+#ifndef STARTUPTRACE_H
+#define STARTUPTRACE_H
+
+#include <QObject>
+#include <QString>
+
+class QQuickWindow;
+
+/**
+ * @brief 启动耗时跟踪
+ * @details 从main()开始按阶段打点，直到首帧显示与页面预热完成，
+ *          结果以Chrome Trace格式（可在chrome://tracing或Perfetto中打开）写入文件，
+ *          并在日志中输出首帧与可交互耗时。
+ *          静态mark()可在任意线程、QGuiApplication创建之前调用；
+ *          实例以QML单例StartupTrace提供给界面打点
+ */
+class StartupTrace : public QObject
+{
+    Q_OBJECT
+    /**
+     * @brief 首帧是否已显示，页面预热以此为起点
+     */
+    Q_PROPERTY(bool firstFrameShown READ firstFrameShown NOTIFY firstFrameShownChanged)
+
+    /**
+     * @brief 初始页面是否已可交互
+     */
+    Q_PROPERTY(bool interactive READ interactive NOTIFY interactiveChanged)
+
+    /**
+     * @brief 是否已结束跟踪
+     */
+    Q_PROPERTY(bool finished READ finished NOTIFY finishedChanged)
+
+public:
+    /**
+     * @brief 可交互耗时目标（毫秒），超出时记录警告
+     */
+    static constexpr qint64 INTERACTIVE_TARGET_MS = 1000;
+
+    explicit StartupTrace(QObject *parent = nullptr);
+
+    /**
+     * @brief 开始计时，应为main()的第一条语句
+     */
+    static void begin();
+
+    /**
+     * @brief 记录一个阶段（线程安全）
+     * @param phase 阶段名称
+     */
+    static void mark(const QString &phase);
+
+    /**
+     * @brief 自begin()起经过的毫秒数
+     */
+    static double elapsedMs();
+
+    /**
+     * @brief 设置跟踪文件路径
+     */
+    void setOutputFile(const QString &filePath);
+
+    /**
+     * @brief 监听窗口的首帧
+     * @param window 主窗口，首帧交换后记录"first frame"并写入跟踪文件
+     */
+    void watchFirstFrame(QQuickWindow *window);
+
+    bool firstFrameShown() const { return m_firstFrameShown; }
+    bool interactive() const { return m_interactive; }
+    bool finished() const { return m_finished; }
+
+    /**
+     * @brief 在界面中打点
+     * @param phase 阶段名称
+     */
+    Q_INVOKABLE void markPhase(const QString &phase);
+
+    /**
+     * @brief 初始页面已可交互
+     * @details 记录"interactive"阶段，按INTERACTIVE_TARGET_MS检查耗时并重写跟踪文件；
+     *          与其余页面的预热无关，预热阶段继续打点直到finish()
+     */
+    Q_INVOKABLE void markInteractive();
+
+    /**
+     * @brief 结束跟踪
+     * @details 尚未标记可交互时先标记，然后重写跟踪文件，之后的打点只写日志
+     */
+    Q_INVOKABLE void finish();
+
+signals:
+    void firstFrameShownChanged();
+    void interactiveChanged();
+    void finishedChanged();
+
+private:
+    void onFirstFrame();
+    bool writeTrace() const;
+
+    QString m_outputFile;
+    bool m_firstFrameShown;
+    bool m_interactive;
+    bool m_finished;
+};
+
+#endif
@@ -0,0 +1,191 @@
+#include "UpdateScheduler.h"
+#include "Metrics.h"
+#include <QQuickWindow>
+#include <QQuickItem>
+#include <QEvent>
+
+UpdateScheduler::UpdateScheduler(QObject *parent)
+    : QObject(parent)
+    , m_windowActive(false)
+    , m_frameRequested(false)
+    , m_frames(0)
+    , m_executed(0)
+    , m_coalesced(0)
+{
+}
+
+void UpdateScheduler::setWindow(QQuickWindow *window)
+{
+    if (m_window == window) {
+        return;
+    }
+    if (m_window) {
+        m_window->removeEventFilter(this);
+        disconnect(m_window, nullptr, this, nullptr);
+    }
+    m_window = window;
+    m_frameRequested = false;
+    if (m_window) {
+        // afterAnimating在每帧同步、绘制之前于界面线程发出，此时请求的重绘会在同一帧完成
+        connect(m_window, &QQuickWindow::afterAnimating, this, &UpdateScheduler::onAfterAnimating);
+        connect(m_window, &QWindow::visibilityChanged, this, &UpdateScheduler::updateWindowActive);
+        m_window->installEventFilter(this);
+    }
+    updateWindowActive();
+}
+
+bool UpdateScheduler::isActive(QQuickItem *view) const
+{
+    return m_windowActive && (!view || view->isVisible());
+}
+
+void UpdateScheduler::requestPaint(QQuickItem *canvas)
+{
+    schedule(canvas, canvas, QStringLiteral("requestPaint"));
+}
+
+void UpdateScheduler::schedule(QQuickItem *view, QObject *target, const QString &method)
+{
+    if (!target || method.isEmpty()) {
+        return;
+    }
+    const QByteArray name = method.toLatin1();
+    for (Task &task : m_tasks) {
+        if (task.target == target && task.method == name) {
+            task.view = view;
+            task.hasView = view != nullptr;
+            ++m_coalesced;
+            if (taskActive(task)) {
+                requestFrame();
+            }
+            return;
+        }
+    }
+
+    Task task;
+    task.view = view;
+    task.hasView = view != nullptr;
+    task.target = target;
+    task.method = name;
+    m_tasks.append(task);
+    Metrics::adjust(Metrics::SchedulerTasks, 1);
+    if (view) {
+        watchView(view);
+    }
+    if (taskActive(task)) {
+        requestFrame();
+    }
+}
+
+QVariantMap UpdateScheduler::statistics() const
+{
+    QVariantMap stats;
+    stats["frames"] = m_frames;
+    stats["executed"] = m_executed;
+    stats["coalesced"] = m_coalesced;
+    stats["deferred"] = m_tasks.size();
+    return stats;
+}
+
+bool UpdateScheduler::eventFilter(QObject *watched, QEvent *event)
+{
+    // 被其他窗口完全遮挡或锁屏时窗口收到未暴露的Expose事件
+    if (watched == m_window && event->type() == QEvent::Expose) {
+        QMetaObject::invokeMethod(this, &UpdateScheduler::updateWindowActive, Qt::QueuedConnection);
+    }
+    return QObject::eventFilter(watched, event);
+}
+
+/**
+ * @brief 帧动画阶段结束
+ * @details 执行所属视图处于活动状态的更新，其余保留到视图重新可见
+ */
+void UpdateScheduler::onAfterAnimating()
+{
+    m_frameRequested = false;
+    ++m_frames;
+    if (m_tasks.isEmpty()) {
+        return;
+    }
+
+    QVector<Task> tasks;
+    tasks.swap(m_tasks);
+    int deferred = 0;
+    for (const Task &task : std::as_const(tasks)) {
+        if (!task.target || (task.hasView && !task.view)) {
+            continue;
+        }
+        if (!taskActive(task)) {
+            m_tasks.append(task);
+            ++deferred;
+            continue;
+        }
+        QMetaObject::invokeMethod(task.target, task.method.constData());
+        ++m_executed;
+    }
+    Metrics::adjust(Metrics::SchedulerTasks, deferred - tasks.size());
+
+    // 执行过程中新增的请求在下一帧处理
+    for (const Task &task : std::as_const(m_tasks)) {
+        if (taskActive(task)) {
+            requestFrame();
+            break;
+        }
+    }
+}
+
+void UpdateScheduler::onViewVisibleChanged()
+{
+    auto *view = qobject_cast<QQuickItem *>(sender());
+    if (!view || !view->isVisible()) {
+        return;
+    }
+    for (const Task &task : std::as_const(m_tasks)) {
+        if (taskActive(task)) {
+            requestFrame();
+            return;
+        }
+    }
+}
+
+void UpdateScheduler::updateWindowActive()
+{
+    const bool active = m_window && m_window->isVisible() && m_window->isExposed()
+            && m_window->visibility() != QWindow::Minimized;
+    if (m_windowActive == active) {
+        return;
+    }
+    m_windowActive = active;
+    emit windowActiveChanged();
+    if (m_windowActive && !m_tasks.isEmpty()) {
+        requestFrame();
+    }
+}
+
+bool UpdateScheduler::taskActive(const Task &task) const
+{
+    return isActive(task.hasView ? task.view.data() : nullptr) && (!task.hasView || task.view);
+}
+
+/**
+ * @brief 监听视图可见性
+ * @details QQuickItem::visibleChanged在自身或任一父项可见性变化时都会发出
+ */
+void UpdateScheduler::watchView(QQuickItem *view)
+{
+    if (m_watchedViews.contains(view)) {
+        return;
+    }
+    m_watchedViews.insert(view);
+    connect(view, &QQuickItem::visibleChanged, this, &UpdateScheduler::onViewVisibleChanged);
+    connect(view, &QObject::destroyed, this, [this, view]() { m_watchedViews.remove(view); });
+}
+
+void UpdateScheduler::requestFrame()
+{
+    if (m_frameRequested || !m_window || !m_windowActive) {
+        return;
+    }
+    m_frameRequested = true;
+    m_window->update();
+}
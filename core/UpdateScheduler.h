@@ -0,0 +1,104 @@
+#ifndef UPDATESCHEDULER_H
+#define UPDATESCHEDULER_H
+
+#include <QObject>
+#include <QPointer>
+#include <QVector>
+#include <QSet>
+#include <QVariantMap>
+
+class QQuickWindow;
+class QQuickItem;
+
+/**
+ * @brief 界面更新调度器
+ * @details 统一管理图表重绘等界面更新：
+ *          - 同一帧内对同一目标的多次请求合并为一次，在下一帧（随显示器垂直同步）动画阶段之后执行
+ *          - 所属视图不可见（未选中的页面）或窗口最小化/被完全遮挡时暂缓执行，
+ *            数据照常采集，视图重新可见时补做一次
+ *          以QML单例UpdateScheduler提供给各页面与组件
+ */
+class UpdateScheduler : public QObject
+{
+    Q_OBJECT
+    /**
+     * @brief 窗口是否可见且未最小化、未被遮挡
+     */
+    Q_PROPERTY(bool windowActive READ windowActive NOTIFY windowActiveChanged)
+
+public:
+    explicit UpdateScheduler(QObject *parent = nullptr);
+
+    /**
+     * @brief 绑定主窗口
+     * @param window 应用主窗口
+     */
+    void setWindow(QQuickWindow *window);
+
+    bool windowActive() const { return m_windowActive; }
+
+    /**
+     * @brief 视图当前是否需要更新
+     * @param view 视图，为空时只看窗口状态
+     * @return 窗口处于活动状态且视图（含全部父项）可见
+     */
+    Q_INVOKABLE bool isActive(QQuickItem *view) const;
+
+    /**
+     * @brief 请求重绘Canvas
+     * @param canvas 需要重绘的Canvas，自身可见性决定是否暂缓
+     */
+    Q_INVOKABLE void requestPaint(QQuickItem *canvas);
+
+    /**
+     * @brief 在下一帧调用目标的无参方法
+     * @param view 决定是否暂缓的视图，为空时只看窗口状态
+     * @param target 目标对象
+     * @param method 方法名（C++槽、Q_INVOKABLE或QML函数）
+     * @details 执行前重复的请求只保留一个
+     */
+    Q_INVOKABLE void schedule(QQuickItem *view, QObject *target, const QString &method);
+
+    /**
+     * @brief 获取调度统计
+     * @return 包含frames、executed、coalesced、deferred字段
+     */
+    Q_INVOKABLE QVariantMap statistics() const;
+
+signals:
+    void windowActiveChanged();
+
+protected:
+    bool eventFilter(QObject *watched, QEvent *event) override;
+
+private slots:
+    void onAfterAnimating();
+    void onViewVisibleChanged();
+    void updateWindowActive();
+
+private:
+    /**
+     * @brief 待执行的更新
+     */
+    struct Task {
+        QPointer<QQuickItem> view;
+        bool hasView = false;
+        QPointer<QObject> target;
+        QByteArray method;
+    };
+
+    bool taskActive(const Task &task) const;
+    void watchView(QQuickItem *view);
+    void requestFrame();
+
+    QPointer<QQuickWindow> m_window;
+    QVector<Task> m_tasks;
+    QSet<QQuickItem *> m_watchedViews;
+    bool m_windowActive;
+    bool m_frameRequested;
+    qint64 m_frames;
+    qint64 m_executed;
+    qint64 m_coalesced;
+};
+
+#endif
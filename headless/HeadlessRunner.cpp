@@ -0,0 +1,600 @@
+#include "HeadlessRunner.h"
+#include "../core/Logger.h"
+#include "../serial/ModbusManager.h"
+#include "../serial/DataRecorder.h"
+#include "../serial/LivePublisher.h"
+#include "../serial/ModbusBusPool.h"
+#include <QCommandLineParser>
+#include <QDateTime>
+#include <QDir>
+#include <QFile>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QStandardPaths>
+#include <csignal>
+#include <cstdio>
+
+namespace {
+
+volatile std::sig_atomic_t g_interruptRequested = 0;
+
+void handleInterrupt(int)
+{
+    g_interruptRequested = 1;
+}
+
+int parseParity(const QString &value, bool *ok)
+{
+    const QString lower = value.trimmed().toLower();
+    *ok = true;
+    if (lower == "none" || lower == "0") {
+        return 0;
+    }
+    if (lower == "odd" || lower == "1") {
+        return 1;
+    }
+    if (lower == "even" || lower == "2") {
+        return 2;
+    }
+    *ok = false;
+    return 0;
+}
+
+int parseFraming(const QString &value, bool *ok)
+{
+    const QString lower = value.trimmed().toLower();
+    *ok = true;
+    if (lower == "tcp") {
+        return ModbusManager::ModbusTcp;
+    }
+    if (lower == "rtu-over-tcp") {
+        return ModbusManager::RtuOverTcp;
+    }
+    *ok = false;
+    return ModbusManager::ModbusTcp;
+}
+
+void writeLine(const QByteArray &line)
+{
+    std::fwrite(line.constData(), 1, static_cast<size_t>(line.size()), stdout);
+    std::fputc('\n', stdout);
+    std::fflush(stdout);
+}
+
+} // namespace
+
+HeadlessRunner::HeadlessRunner(const HeadlessConfig &config, QObject *parent)
+    : QObject(parent)
+    , m_config(config)
+    , m_modbus(nullptr)
+    , m_recorder(nullptr)
+    , m_publisher(nullptr)
+    , m_pool(nullptr)
+    , m_sampleCount(0)
+    , m_stopped(false)
+    , m_benchmarkPhase(-1)
+    , m_benchmarkRunning(false)
+{
+    m_modbus = new ModbusManager(this);
+    m_recorder = new DataRecorder(this);
+    // 长时间记录只写文件，不在内存中累积
+    m_recorder->setRetainRecords(false);
+    m_recorder->setInterval(m_config.recordIntervalSec);
+
+    connect(m_modbus, &ModbusManager::sampleReady, this, [this](double voltage, double current, double power, qint64 timestampNs) {
+        ++m_sampleCount;
+        // 多总线时记录器由采集池直接写入全部通道
+        if (!m_pool) {
+            m_recorder->addData(voltage, current, power, timestampNs);
+        }
+    });
+    connect(m_modbus, &ModbusManager::connectedChanged, this, &HeadlessRunner::onConnectedChanged);
+    connect(m_recorder, &DataRecorder::streamError, this, [this](const QString &error) {
+        LOG_ERROR(Log::General, "记录文件写入失败，退出: {}", error);
+        stop();
+        emit finished(2);
+    });
+
+    m_statusTimer.setInterval(m_config.statusIntervalSec * 1000);
+    connect(&m_statusTimer, &QTimer::timeout, this, &HeadlessRunner::printStatus);
+
+    m_interruptTimer.setInterval(200);
+    connect(&m_interruptTimer, &QTimer::timeout, this, &HeadlessRunner::checkInterrupt);
+}
+
+HeadlessRunner::~HeadlessRunner()
+{
+    stop();
+}
+
+/**
+ * @brief 向解析器添加全部命令行选项
+ * @details 选项的长名同时也是配置文件中的键名
+ */
+void HeadlessRunner::addOptions(QCommandLineParser &parser)
+{
+    parser.addOptions({
+        {"config", "JSON配置文件，键名与长选项相同", "file"},
+        {"port", "串口名称", "name"},
+        {"baud", "波特率（默认9600）", "rate"},
+        {"parity", "校验位：none、odd、even", "parity"},
+        {"native", "串口使用自有RTU传输层"},
+        {"host", "以太网网关地址", "address"},
+        {"tcp-port", "网关TCP端口（默认502）", "port"},
+        {"framing", "网络帧格式：tcp、rtu-over-tcp", "framing"},
+        {"bus", "多总线采集，每条总线一个选项：串口[:波特率[:校验]] 通道=从站/寄存器[*系数] ...", "spec"},
+        {"poll-interval", "轮询间隔，毫秒（默认1000）", "ms"},
+        {"adaptive", "自适应采样：数值变化或写入后以总线最高速率轮询，稳定后降回轮询间隔"},
+        {"record-interval", "记录间隔，秒（默认3）", "seconds"},
+        {"output", "CSV输出文件（已存在时追加）", "file"},
+        {"status", "状态输出：console、json、none", "format"},
+        {"status-interval", "状态输出间隔，秒（默认5）", "seconds"},
+        {"duration", "运行时长，秒（默认一直运行）", "seconds"},
+        {"publish", "以该服务名称启动本地实时数据发布", "name"},
+        {"accept-set-points", "允许发布服务的订阅者写入设定值"},
+        {"benchmark", "传输层基准测试：依次以Qt主站与自有传输层突发轮询各若干秒，输出吞吐与往返时间后退出", "seconds"}
+    });
+}
+
+/**
+ * @brief 从命令行参数与配置文件生成配置
+ * @details 先读取配置文件，再用命令行中显式给出的选项覆盖
+ */
+bool HeadlessRunner::loadConfig(const QCommandLineParser &parser, HeadlessConfig &config, QString &error)
+{
+    QVariantMap values;
+    if (parser.isSet("config")) {
+        QFile file(parser.value("config"));
+        if (!file.open(QIODevice::ReadOnly)) {
+            error = QString("无法打开配置文件 %1: %2").arg(file.fileName(), file.errorString());
+            return false;
+        }
+        QJsonParseError parseError;
+        const QJsonDocument doc = QJsonDocument::fromJson(file.readAll(), &parseError);
+        if (!doc.isObject()) {
+            error = QString("配置文件格式错误: %1").arg(parseError.errorString());
+            return false;
+        }
+        values = doc.object().toVariantMap();
+    }
+    const QStringList optionNames = {"port", "baud", "parity", "host", "tcp-port", "framing", "poll-interval",
+                                     "record-interval", "output", "status", "status-interval", "duration", "publish",
+                                     "benchmark"};
+    for (const QString &name : optionNames) {
+        if (parser.isSet(name)) {
+            values[name] = parser.value(name);
+        }
+    }
+    if (parser.isSet("native")) {
+        values["native"] = true;
+    }
+    if (parser.isSet("accept-set-points")) {
+        values["accept-set-points"] = true;
+    }
+    if (parser.isSet("adaptive")) {
+        values["adaptive"] = true;
+    }
+    if (parser.isSet("bus")) {
+        values["bus"] = parser.values("bus");
+    }
+
+    auto intValue = [&](const QString &key, int fallback, int minimum, int &out) {
+        if (!values.contains(key)) {
+            out = fallback;
+            return true;
+        }
+        bool ok = false;
+        out = values.value(key).toString().toInt(&ok);
+        if (!ok || out < minimum) {
+            error = QString("无效的 %1: %2").arg(key, values.value(key).toString());
+            return false;
+        }
+        return true;
+    };
+
+    config.portName = values.value("port").toString();
+    config.host = values.value("host").toString();
+    config.nativeTransport = values.value("native").toBool();
+    config.outputFile = values.value("output").toString();
+    config.publishName = values.value("publish").toString();
+    config.acceptSetPoints = values.value("accept-set-points").toBool();
+    config.adaptiveSampling = values.value("adaptive").toBool();
+    // 配置文件中可写为字符串或字符串数组
+    config.busSpec = values.value("bus").toStringList().join(';');
+    const int sources = (config.portName.isEmpty() ? 0 : 1) + (config.host.isEmpty() ? 0 : 1) + (config.busSpec.isEmpty() ? 0 : 1);
+    if (sources != 1) {
+        error = "必须且只能指定 --port、--host 或 --bus 之一";
+        return false;
+    }
+    if (!intValue("baud", 9600, 1, config.baudRate)
+        || !intValue("tcp-port", 502, 1, config.tcpPort)
+        || !intValue("poll-interval", 1000, 10, config.pollIntervalMs)
+        || !intValue("record-interval", 3, 1, config.recordIntervalSec)
+        || !intValue("status-interval", 5, 1, config.statusIntervalSec)
+        || !intValue("duration", 0, 0, config.durationSec)
+        || !intValue("benchmark", 0, 0, config.benchmarkSec)) {
+        return false;
+    }
+    // 网络连接始终使用自有传输层，只有串口能对比两种传输层
+    if (config.benchmarkSec > 0 && config.portName.isEmpty()) {
+        error = "--benchmark 只支持 --port 串口连接";
+        return false;
+    }
+    if (config.tcpPort > 65535) {
+        error = QString("无效的 tcp-port: %1").arg(config.tcpPort);
+        return false;
+    }
+    bool ok = true;
+    if (values.contains("parity")) {
+        config.parity = parseParity(values.value("parity").toString(), &ok);
+        if (!ok) {
+            error = QString("无效的 parity: %1").arg(values.value("parity").toString());
+            return false;
+        }
+    }
+    if (values.contains("framing")) {
+        config.framing = parseFraming(values.value("framing").toString(), &ok);
+        if (!ok) {
+            error = QString("无效的 framing: %1").arg(values.value("framing").toString());
+            return false;
+        }
+    }
+    const QString status = values.value("status", "console").toString().toLower();
+    if (status != "console" && status != "json" && status != "none") {
+        error = QString("无效的 status: %1").arg(status);
+        return false;
+    }
+    config.jsonStatus = status == "json";
+    config.quiet = status == "none";
+    return true;
+}
+
+/**
+ * @brief 连接设备并开始采集与记录
+ * @details 打开输出文件后发起连接，连接建立后才开始轮询
+ */
+bool HeadlessRunner::start()
+{
+    std::signal(SIGINT, handleInterrupt);
+    std::signal(SIGTERM, handleInterrupt);
+    m_interruptTimer.start();
+    m_uptime.start();
+
+    if (m_config.benchmarkSec > 0) {
+        return startBenchmarkPhase(false);
+    }
+
+    if (!m_config.busSpec.isEmpty() && !setupBusPool()) {
+        return false;
+    }
+
+    QString outputFile = m_config.outputFile;
+    if (outputFile.isEmpty()) {
+        const QString dir = QDir(QStandardPaths::writableLocation(QStandardPaths::AppLocalDataLocation)).filePath("recordings");
+        outputFile = QDir(dir).filePath(QString("record_%1.csv").arg(QDateTime::currentDateTime().toString("yyyyMMdd_HHmmss")));
+    }
+    if (!m_recorder->startStreaming(outputFile)) {
+        return false;
+    }
+
+    if (!m_config.publishName.isEmpty()) {
+        m_publisher = new LivePublisher(this);
+        m_publisher->setServerName(m_config.publishName);
+        m_publisher->setAcceptSetPoints(m_config.acceptSetPoints);
+        m_publisher->setModbusManager(m_modbus);
+        m_publisher->start();
+    }
+
+    if (m_pool) {
+        if (!m_pool->start(m_config.pollIntervalMs)) {
+            LOG_ERROR(Log::General, "无法启动多总线采集");
+            m_recorder->stopStreaming();
+            return false;
+        }
+        m_recorder->startRecording();
+    } else if (!connectDevice()) {
+        m_recorder->stopStreaming();
+        return false;
+    }
+
+    if (!m_config.quiet) {
+        m_statusTimer.start();
+    }
+    if (m_config.durationSec > 0) {
+        QTimer::singleShot(m_config.durationSec * 1000, this, [this]() {
+            LOG_INFO(Log::General, "已到达运行时长 {} 秒，退出", m_config.durationSec);
+            stop();
+            emit finished(0);
+        });
+    }
+    LOG_INFO(Log::General, "无界面模式已启动，输出文件: {}", outputFile);
+    return true;
+}
+
+/**
+ * @brief 创建多总线采集池
+ * @details 记录器的通道按总线配置生成，合并样本的全部通道写入记录文件，
+ *          前三个通道另注入ModbusManager，发布服务与单总线时一样从其sampleReady取数
+ */
+bool HeadlessRunner::setupBusPool()
+{
+    m_pool = new ModbusBusPool(this);
+    connect(m_pool, &ModbusBusPool::errorOccurred, this, [](int bus, const QString &error) {
+        LOG_WARNING(Log::General, "总线 {} 错误: {}", bus, error);
+    });
+    if (!m_pool->configure(m_config.busSpec)) {
+        return false;
+    }
+
+    QVector<RecordChannel> schema;
+    for (const QString &name : m_pool->channelNames()) {
+        RecordChannel channel;
+        channel.name = name;
+        channel.type = ChannelType::Float64;
+        channel.decimals = 3;
+        schema.append(channel);
+    }
+    if (!m_recorder->setSchema(schema)) {
+        return false;
+    }
+    m_pool->setAlignIntervalMs(m_config.pollIntervalMs);
+    m_pool->setDataRecorder(m_recorder);
+    m_pool->setModbusManager(m_modbus);
+    return true;
+}
+
+/**
+ * @brief 连接单总线设备
+ * @details 自有串口传输层在connectToPort内同步打开，连接建立后由onConnectedChanged开始轮询
+ */
+bool HeadlessRunner::connectDevice()
+{
+    m_modbus->setNativeTransport(m_config.nativeTransport);
+    const bool started = m_config.host.isEmpty()
+            ? m_modbus->connectToPort(m_config.portName, m_config.baudRate, m_config.parity)
+            : m_modbus->connectToHost(m_config.host, m_config.tcpPort, m_config.framing);
+    if (!started) {
+        LOG_ERROR(Log::General, "无法连接设备");
+        return false;
+    }
+    if (m_modbus->connected()) {
+        onConnectedChanged();
+    }
+    return true;
+}
+
+/**
+ * @brief 开始一个基准测试阶段
+ * @param native 是否使用自有RTU传输层
+ * @details 两个阶段使用同一串口参数与相同的突发轮询，结果只取决于传输层
+ */
+bool HeadlessRunner::startBenchmarkPhase(bool native)
+{
+    m_benchmarkPhase = native ? 1 : 0;
+    m_benchmarkRunning = false;
+    m_modbus->setNativeTransport(native);
+    if (!m_modbus->connectToPort(m_config.portName, m_config.baudRate, m_config.parity)) {
+        LOG_ERROR(Log::General, "基准测试无法连接设备: {}", m_config.portName);
+        return false;
+    }
+    if (m_modbus->connected()) {
+        beginBenchmarkMeasurement();
+    }
+    return true;
+}
+
+/**
+ * @brief 清零统计并以总线最高速率轮询
+ */
+void HeadlessRunner::beginBenchmarkMeasurement()
+{
+    m_benchmarkRunning = true;
+    m_modbus->resetTransportStatistics();
+    m_sampleCount = 0;
+    m_benchmarkTimer.start();
+    m_modbus->startBurstReading(ModbusManager::AllChannels);
+
+    const int phase = m_benchmarkPhase;
+    QTimer::singleShot(m_config.benchmarkSec * 1000, this, [this, phase]() {
+        if (!m_stopped && m_benchmarkPhase == phase) {
+            finishBenchmarkPhase();
+        }
+    });
+}
+
+/**
+ * @brief 结束当前阶段
+ * @details 统计须在断开前读取（断开后不再区分传输层）；第一阶段结束后切换传输层重新连接
+ */
+void HeadlessRunner::finishBenchmarkPhase()
+{
+    const double elapsedSec = m_benchmarkTimer.nsecsElapsed() / 1e9;
+    m_modbus->stopBurstReading();
+
+    QVariantMap result = m_modbus->transportStatistics();
+    const qint64 transactions = result.value("transactions").toLongLong();
+    result["durationSec"] = elapsedSec;
+    result["samples"] = static_cast<qint64>(m_sampleCount);
+    result["samplesPerSec"] = elapsedSec > 0.0 ? m_sampleCount / elapsedSec : 0.0;
+    result["transactionsPerSec"] = elapsedSec > 0.0 ? transactions / elapsedSec : 0.0;
+    m_benchmarkResults.append(result);
+    printBenchmarkResult(result);
+
+    m_modbus->disconnectPort();
+    m_benchmarkRunning = false;
+    if (m_benchmarkPhase == 0) {
+        if (!startBenchmarkPhase(true)) {
+            stop();
+            emit finished(1);
+        }
+        return;
+    }
+
+    m_benchmarkPhase = -1;
+    printBenchmarkSummary();
+    stop();
+    emit finished(0);
+}
+
+/**
+ * @brief 输出一个阶段的结果
+ */
+void HeadlessRunner::printBenchmarkResult(const QVariantMap &result)
+{
+    if (m_config.jsonStatus) {
+        QJsonObject object = QJsonObject::fromVariantMap(result);
+        object["benchmark"] = result.value("transport").toString();
+        writeLine(QJsonDocument(object).toJson(QJsonDocument::Compact));
+        return;
+    }
+
+    const QString line = QString("[基准] %1 时长=%2s 样本=%3 (%4/s) 事务=%5 (%6/s) 错误=%7 平均往返=%8us 最大往返=%9us")
+            .arg(result.value("transport").toString() == "native" ? QStringLiteral("自有传输层") : QStringLiteral("Qt主站"))
+            .arg(result.value("durationSec").toDouble(), 0, 'f', 1)
+            .arg(result.value("samples").toLongLong())
+            .arg(result.value("samplesPerSec").toDouble(), 0, 'f', 1)
+            .arg(result.value("transactions").toLongLong())
+            .arg(result.value("transactionsPerSec").toDouble(), 0, 'f', 1)
+            .arg(result.value("errors").toLongLong())
+            .arg(result.value("avgRoundTripUs").toLongLong())
+            .arg(result.value("maxRoundTripUs").toLongLong());
+    writeLine(line.toUtf8());
+}
+
+/**
+ * @brief 输出两种传输层的对比
+ */
+void HeadlessRunner::printBenchmarkSummary()
+{
+    if (m_benchmarkResults.size() != 2) {
+        return;
+    }
+    const QVariantMap qt = m_benchmarkResults.at(0).toMap();
+    const QVariantMap native = m_benchmarkResults.at(1).toMap();
+    const double qtRate = qt.value("samplesPerSec").toDouble();
+    const double ratio = qtRate > 0.0 ? native.value("samplesPerSec").toDouble() / qtRate : 0.0;
+
+    if (m_config.jsonStatus) {
+        QJsonObject summary;
+        summary["benchmark"] = "summary";
+        summary["throughputRatio"] = ratio;
+        summary["qtAvgRoundTripUs"] = qt.value("avgRoundTripUs").toLongLong();
+        summary["nativeAvgRoundTripUs"] = native.value("avgRoundTripUs").toLongLong();
+        writeLine(QJsonDocument(summary).toJson(QJsonDocument::Compact));
+        return;
+    }
+
+    const QString line = QString("[基准] 自有传输层吞吐为Qt主站的 %1 倍，平均往返 %2us → %3us")
+            .arg(ratio, 0, 'f', 2)
+            .arg(qt.value("avgRoundTripUs").toLongLong())
+            .arg(native.value("avgRoundTripUs").toLongLong());
+    writeLine(line.toUtf8());
+}
+
+/**
+ * @brief 停止记录并断开设备
+ * @details 最后输出一次状态，便于脚本获取本次运行的汇总
+ */
+void HeadlessRunner::stop()
+{
+    if (m_stopped) {
+        return;
+    }
+    m_stopped = true;
+    m_statusTimer.stop();
+    m_interruptTimer.stop();
+    m_recorder->stopRecording();
+    // 基准测试已逐阶段输出结果
+    if (!m_config.quiet && m_config.benchmarkSec == 0) {
+        printStatus();
+    }
+    m_recorder->stopStreaming();
+    if (m_publisher) {
+        m_publisher->stop();
+    }
+    if (m_pool) {
+        m_pool->stop();
+    }
+    m_modbus->disconnectPort();
+}
+
+/**
+ * @brief 连接状态变化
+ * @details 连接建立后开始轮询与记录；断开时保持记录文件打开，状态中显示为未连接
+ */
+void HeadlessRunner::onConnectedChanged()
+{
+    if (m_stopped) {
+        return;
+    }
+    if (m_config.benchmarkSec > 0) {
+        // Qt主站异步连接，连接建立后才开始计时
+        if (m_modbus->connected() && m_benchmarkPhase >= 0 && !m_benchmarkRunning) {
+            beginBenchmarkMeasurement();
+        }
+        return;
+    }
+    if (m_modbus->connected()) {
+        m_modbus->setAdaptiveSampling(m_config.adaptiveSampling);
+        m_modbus->startReading(m_config.pollIntervalMs);
+        m_recorder->startRecording();
+    } else {
+        LOG_WARNING(Log::General, "设备连接已断开");
+    }
+}
+
+/**
+ * @brief 输出一次运行状态
+ */
+void HeadlessRunner::printStatus()
+{
+    const QVariantMap stats = m_modbus->transportStatistics();
+    const qint64 uptimeSec = m_uptime.elapsed() / 1000;
+
+    if (m_config.jsonStatus) {
+        QJsonObject status;
+        status["uptimeSec"] = uptimeSec;
+        status["connected"] = m_modbus->connected();
+        status["voltage"] = m_modbus->voltage();
+        status["current"] = m_modbus->current();
+        status["power"] = m_modbus->power();
+        status["samples"] = static_cast<qint64>(m_sampleCount);
+        status["records"] = static_cast<qint64>(m_recorder->streamedCount());
+        status["file"] = m_recorder->streamFile();
+        status["transport"] = QJsonObject::fromVariantMap(stats);
+        if (m_pool) {
+            status["buses"] = QJsonArray::fromVariantList(m_pool->busStatistics());
+        }
+        writeLine(QJsonDocument(status).toJson(QJsonDocument::Compact));
+        return;
+    }
+
+    const QString line = QString("[%1:%2:%3] %4 电压=%5V 电流=%6A 功率=%7kW 样本=%8 记录=%9 事务=%10 错误=%11 平均往返=%12us")
+            .arg(uptimeSec / 3600, 2, 10, QChar('0'))
+            .arg(uptimeSec / 60 % 60, 2, 10, QChar('0'))
+            .arg(uptimeSec % 60, 2, 10, QChar('0'))
+            .arg(m_modbus->connected() ? QStringLiteral("已连接") : QStringLiteral("未连接"))
+            .arg(m_modbus->voltage(), 0, 'f', 2)
+            .arg(m_modbus->current(), 0, 'f', 2)
+            .arg(m_modbus->power(), 0, 'f', 3)
+            .arg(m_sampleCount)
+            .arg(m_recorder->streamedCount())
+            .arg(stats.value("transactions").toLongLong())
+            .arg(stats.value("errors").toLongLong())
+            .arg(stats.value("avgRoundTripUs").toLongLong());
+    writeLine(line.toUtf8());
+}
+
+/**
+ * @brief 检查中断信号
+ * @details 信号处理函数只置位标志，由事件循环中的定时器完成退出
+ */
+void HeadlessRunner::checkInterrupt()
+{
+    if (g_interruptRequested) {
+        LOG_INFO(Log::General, "收到中断信号，退出");
+        stop();
+        emit finished(0);
+    }
+}
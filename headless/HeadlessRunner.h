@@ -0,0 +1,122 @@
+#ifndef HEADLESSRUNNER_H
+#define HEADLESSRUNNER_H
+
+#include <QObject>
+#include <QString>
+#include <QElapsedTimer>
+#include <QTimer>
+#include <QVariantList>
+
+class QCommandLineParser;
+class ModbusManager;
+class DataRecorder;
+class LivePublisher;
+class ModbusBusPool;
+
+/**
+ * @brief 无界面运行配置
+ * @details 可由JSON配置文件与命令行参数共同给出，命令行优先
+ */
+struct HeadlessConfig {
+    QString portName;               ///< 串口名称，与host、busSpec三选一
+    int baudRate = 9600;
+    int parity = 0;                 ///< 0：无校验，1：奇校验，2：偶校验
+    bool nativeTransport = false;   ///< 串口使用自有RTU传输层
+    QString host;                   ///< 以太网网关地址
+    int tcpPort = 502;
+    int framing = 0;                ///< 0：Modbus TCP，1：RTU over TCP
+    QString busSpec;                ///< 多总线配置（ModbusBusPool::configure格式），非空时以多总线并行采集
+    int pollIntervalMs = 1000;
+    bool adaptiveSampling = false;  ///< 数值变化或写入后加速轮询，稳定后降回pollIntervalMs
+    int recordIntervalSec = 3;
+    QString outputFile;             ///< 为空时写入应用数据目录下的recordings
+    bool jsonStatus = false;
+    bool quiet = false;             ///< 不输出周期状态
+    int statusIntervalSec = 5;
+    int durationSec = 0;            ///< 0表示一直运行到收到中断信号
+    QString publishName;            ///< 非空时启动本地实时数据发布服务
+    bool acceptSetPoints = false;   ///< 发布服务是否接受设定值写入请求
+    int benchmarkSec = 0;           ///< 大于0时依次以Qt主站与自有传输层各突发轮询该秒数并输出对比，不记录
+};
+
+/**
+ * @brief 无界面采集运行器
+ * @details 在QCoreApplication下运行ModbusManager轮询与DataRecorder流式记录，
+ *          不加载QML、字体与图片，供机架电脑长时间无人值守记录使用
+ */
+class HeadlessRunner : public QObject
+{
+    Q_OBJECT
+
+public:
+    explicit HeadlessRunner(const HeadlessConfig &config, QObject *parent = nullptr);
+    ~HeadlessRunner();
+
+    /**
+     * @brief 从命令行参数与配置文件生成配置
+     * @param parser 已处理过参数的解析器
+     * @param config 输出配置
+     * @param error 失败原因
+     * @return 配置是否有效
+     */
+    static bool loadConfig(const QCommandLineParser &parser, HeadlessConfig &config, QString &error);
+
+    /**
+     * @brief 向解析器添加全部命令行选项
+     */
+    static void addOptions(QCommandLineParser &parser);
+
+    /**
+     * @brief 连接设备并开始采集与记录
+     * @return 是否成功启动
+     */
+    bool start();
+
+    /**
+     * @brief 停止记录并断开设备
+     */
+    void stop();
+
+signals:
+    /**
+     * @brief 运行结束信号
+     * @param exitCode 进程退出码
+     */
+    void finished(int exitCode);
+
+private slots:
+    void onConnectedChanged();
+    void printStatus();
+    void checkInterrupt();
+
+private:
+    bool setupBusPool();
+    bool connectDevice();
+    bool startBenchmarkPhase(bool native);
+    void beginBenchmarkMeasurement();
+    void finishBenchmarkPhase();
+    void printBenchmarkResult(const QVariantMap &result);
+    void printBenchmarkSummary();
+
+    HeadlessConfig m_config;
+    ModbusManager *m_modbus;
+    DataRecorder *m_recorder;
+    LivePublisher *m_publisher;
+    ModbusBusPool *m_pool;
+    QTimer m_statusTimer;
+    QTimer m_interruptTimer;
+    QElapsedTimer m_uptime;
+    quint64 m_sampleCount;
+    bool m_stopped;
+
+    /**
+     * @brief 基准测试状态
+     * @details 阶段-1：未运行，0：Qt主站，1：自有传输层；连接建立后才开始计时
+     */
+    int m_benchmarkPhase;
+    bool m_benchmarkRunning;
+    QElapsedTimer m_benchmarkTimer;
+    QVariantList m_benchmarkResults;
+};
+
+#endif
@@ -0,0 +1,43 @@
+#include <QCoreApplication>
+#include <QCommandLineParser>
+#include <QStandardPaths>
+#include <QDir>
+#include <cstdio>
+#include "HeadlessRunner.h"
+#include "../core/Logger.h"
+
+int main(int argc, char *argv[]) {
+    QCoreApplication app(argc, argv);
+    // 与界面版共用应用数据目录（日志、记录文件）
+    QCoreApplication::setApplicationName("demo3");
+
+    QCommandLineParser parser;
+    parser.setApplicationDescription("无界面采集与记录：Modbus轮询 + CSV流式记录");
+    parser.addHelpOption();
+    HeadlessRunner::addOptions(parser);
+    parser.process(app);
+
+    HeadlessConfig config;
+    QString error;
+    if (!HeadlessRunner::loadConfig(parser, config, error)) {
+        std::fprintf(stderr, "%s\n\n%s", qPrintable(error), qPrintable(parser.helpText()));
+        return 1;
+    }
+
+    Log::Logger::start(QDir(QStandardPaths::writableLocation(QStandardPaths::AppLocalDataLocation)).filePath("logs"));
+    Log::Logger::setFrameLogging(qEnvironmentVariableIsSet("EVOLVE_LOG_FRAMES"));
+    // JSON状态供脚本解析，关闭日志控制台回显
+    if (config.jsonStatus) {
+        Log::Logger::setConsoleEcho(false);
+    }
+
+    HeadlessRunner runner(config);
+    QObject::connect(&runner, &HeadlessRunner::finished, &app, &QCoreApplication::exit, Qt::QueuedConnection);
+    int exitCode = 1;
+    if (runner.start()) {
+        exitCode = app.exec();
+    }
+    runner.stop();
+    Log::Logger::stop();
+    return exitCode;
+}
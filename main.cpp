@@ -1,20 +1,97 @@
 #include <QGuiApplication>
 #include <QQmlApplicationEngine>
+#include <QQuickWindow>
+#include <QScreen>
 #include <QIcon>
+#include <QStandardPaths>
+#include <QDir>
+#include "core/Logger.h"
+#include "core/UpdateScheduler.h"
+#include "core/StartupTrace.h"
+#include "core/Metrics.h"
+#include "core/ScaledImageProvider.h"
+#include "core/FetchCache.h"
 #include "serial/SerialPortManager.h"
+#include "serial/SerialTerminalModel.h"
 #include "serial/ModbusManager.h"
 #include "serial/DataRecorder.h"
+#include "serial/TriggerCapture.h"
+#include "serial/RecordTableModel.h"
+#include "serial/ModbusBusPool.h"
+#include "serial/LivePublisher.h"
+#include "serial/SessionReplay.h"
+#include "serial/SignalGenerator.h"
+#include "serial/SessionImporter.h"
+#include "music/MusicLibrary.h"
+#include "music/AudioMetadata.h"
 
 int main(int argc, char *argv[]) {
+    StartupTrace::begin();
     QGuiApplication app(argc, argv);
     app.setWindowIcon(QIcon(":/new/prefix1/fonts/app.ico"));
+    StartupTrace::mark("application");
+
+    // 异步日志：文本与总线帧分别写入滚动文件
+    const QString logDirectory = QDir(QStandardPaths::writableLocation(QStandardPaths::AppLocalDataLocation)).filePath("logs");
+    Log::Logger::start(logDirectory);
+    Log::Logger::setFrameLogging(qEnvironmentVariableIsSet("EVOLVE_LOG_FRAMES"));
+    StartupTrace::mark("logger");
 
     qmlRegisterType<SerialPortManager>("EvolveUI", 1, 0, "SerialPortManager");
+    qmlRegisterType<SerialTerminalModel>("EvolveUI", 1, 0, "SerialTerminalModel");
     qmlRegisterType<ModbusManager>("EvolveUI", 1, 0, "ModbusManager");
     qmlRegisterType<DataRecorder>("EvolveUI", 1, 0, "DataRecorder");
+    qmlRegisterType<TriggerCapture>("EvolveUI", 1, 0, "TriggerCapture");
+    qmlRegisterType<RecordTableModel>("EvolveUI", 1, 0, "RecordTableModel");
+    qmlRegisterType<ModbusBusPool>("EvolveUI", 1, 0, "ModbusBusPool");
+    qmlRegisterType<LivePublisher>("EvolveUI", 1, 0, "LivePublisher");
+    qmlRegisterType<SessionReplay>("EvolveUI", 1, 0, "SessionReplay");
+    qmlRegisterType<SignalGenerator>("EvolveUI", 1, 0, "SignalGenerator");
+    qmlRegisterType<SessionImporter>("EvolveUI", 1, 0, "SessionImporter");
+    // 音乐组件沿用各自的模块名；标签解析与索引由共享的MusicIndex在后台完成
+    qmlRegisterType<MusicLibrary>("MusicLibrary", 1, 0, "MusicLibrary");
+    qmlRegisterType<AudioMetadata>("AudioMetadata", 1, 0, "AudioMetadata");
+
+    // 界面更新调度：合并同帧重绘，页面不可见或窗口最小化时暂缓
+    UpdateScheduler updateScheduler;
+    qmlRegisterSingletonInstance("EvolveUI", 1, 0, "UpdateScheduler", &updateScheduler);
+
+    // 启动耗时跟踪：各阶段写入startup-trace.json，页面在首帧之后预热
+    StartupTrace startupTrace;
+    startupTrace.setOutputFile(QDir(logDirectory).filePath("startup-trace.json"));
+    qmlRegisterSingletonInstance("EvolveUI", 1, 0, "StartupTrace", &startupTrace);
+
+    // 网络内容缓存：卡片先显示缓存，网络请求在后台进行，离线时沿用缓存
+    FetchCache fetchCache(QDir(QStandardPaths::writableLocation(QStandardPaths::CacheLocation)).filePath("fetch"));
+    qmlRegisterSingletonInstance("EvolveUI", 1, 0, "FetchCache", &fetchCache);
+
+    // 性能指标：数据路径计数器始终累计，浮层打开时统计帧时间并每秒生成快照
+    Metrics metrics;
+    qmlRegisterSingletonInstance("EvolveUI", 1, 0, "Metrics", &metrics);
+    StartupTrace::mark("types registered");
 
     QQmlApplicationEngine engine;
     QObject::connect(&engine, &QQmlApplicationEngine::objectCreationFailed, &app, [](){ QCoreApplication::exit(-1); }, Qt::QueuedConnection);
+    // 图片按显示尺寸解码并缓存缩放结果：image://scaled/<资源路径>
+    engine.addImageProvider("scaled", new ScaledImageProvider(
+            QDir(QStandardPaths::writableLocation(QStandardPaths::CacheLocation)).filePath("images")));
+    StartupTrace::mark("engine");
     engine.loadFromModule("EvolveUI", "Main");
-    return app.exec();
+    StartupTrace::mark("main qml loaded");
+    if (!engine.rootObjects().isEmpty()) {
+        auto *window = qobject_cast<QQuickWindow *>(engine.rootObjects().first());
+        updateScheduler.setWindow(window);
+        startupTrace.watchFirstFrame(window);
+        if (window) {
+            // frameSwapped在渲染线程发出，直接连接以记录真实的帧间隔
+            QObject::connect(window, &QQuickWindow::frameSwapped, window, &Metrics::frameSwapped, Qt::DirectConnection);
+            metrics.setRefreshRate(window->screen() ? window->screen()->refreshRate() : 0.0);
+            QObject::connect(window, &QQuickWindow::screenChanged, &metrics, [&metrics](QScreen *screen) {
+                metrics.setRefreshRate(screen ? screen->refreshRate() : 0.0);
+            });
+        }
+    }
+    const int exitCode = app.exec();
+    Log::Logger::stop();
+    return exitCode;
 }
@@ -0,0 +1,83 @@
+#include "AudioMetadata.h"
+#include "MusicIndex.h"
+#include "MusicLibrary.h"
+#include <QFileInfo>
+
+AudioMetadata::AudioMetadata(QObject *parent)
+    : QObject(parent)
+    , m_duration(0)
+{
+    connect(MusicIndex::instance(), &MusicIndex::trackReady, this, &AudioMetadata::onTrackReady);
+}
+
+void AudioMetadata::setSource(const QUrl &source)
+{
+    if (m_source == source) {
+        return;
+    }
+    m_source = source;
+    m_path = source.isLocalFile() ? source.toLocalFile() : MusicLibrary::toLocalPath(source.toString());
+    emit sourceChanged();
+
+    if (m_path.isEmpty()) {
+        apply(QVariantMap());
+        return;
+    }
+
+    TrackInfo info;
+    apply(MusicIndex::instance()->lookup(m_path, &info) ? info.toMap() : QVariantMap());
+    // 正在播放的文件优先解析；索引有效时只做一次stat
+    MusicIndex::instance()->enqueue(QStringList{ m_path }, true);
+}
+
+void AudioMetadata::onTrackReady(const QString &path, const QVariantMap &meta)
+{
+    if (path == m_path) {
+        apply(meta);
+    }
+}
+
+void AudioMetadata::apply(const QVariantMap &meta)
+{
+    QString title = meta.value("title").toString();
+    if (title.isEmpty()) {
+        title = m_path.isEmpty() ? QString() : QFileInfo(m_path).completeBaseName();
+    }
+    QString artist = meta.value("artist").toString();
+    if (artist.isEmpty()) {
+        artist = "未知艺术家";
+    }
+    const QString album = meta.value("album").toString();
+    const int duration = meta.value("duration").toInt();
+    const QUrl coverImageUrl = meta.value("coverUrl").toUrl();
+    const QColor prominentColor = meta.value("prominentColor").value<QColor>();
+    const QColor mutedColor = meta.value("mutedColor").value<QColor>();
+    const QColor darkColor = meta.value("darkColor").value<QColor>();
+
+    if (m_title != title) {
+        m_title = title;
+        emit titleChanged();
+    }
+    if (m_artist != artist) {
+        m_artist = artist;
+        emit artistChanged();
+    }
+    if (m_album != album) {
+        m_album = album;
+        emit albumChanged();
+    }
+    if (m_duration != duration) {
+        m_duration = duration;
+        emit durationChanged();
+    }
+    if (m_coverImageUrl != coverImageUrl) {
+        m_coverImageUrl = coverImageUrl;
+        emit coverImageUrlChanged();
+    }
+    if (m_prominentColor != prominentColor || m_mutedColor != mutedColor || m_darkColor != darkColor) {
+        m_prominentColor = prominentColor;
+        m_mutedColor = mutedColor;
+        m_darkColor = darkColor;
+        emit paletteChanged();
+    }
+}
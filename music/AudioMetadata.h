@@ -0,0 +1,80 @@
+#ifndef AUDIOMETADATA_H
+#define AUDIOMETADATA_H
+
+#include <QObject>
+#include <QColor>
+#include <QUrl>
+#include <QVariantMap>
+
+/**
+ * @brief 单个音频文件的元数据
+ * @details 设置source后立即使用MusicIndex中的索引结果（无索引时标题取文件名），
+ *          同时将该文件插到解析队列首部，解析完成后更新各属性。
+ *          封面色板在解析时于工作线程计算并随索引缓存，切换曲目时不再在界面线程取色。
+ *          以QML类型AudioMetadata提供（模块AudioMetadata 1.0）
+ */
+class AudioMetadata : public QObject
+{
+    Q_OBJECT
+    Q_PROPERTY(QUrl source READ source WRITE setSource NOTIFY sourceChanged)
+    Q_PROPERTY(QString title READ title NOTIFY titleChanged)
+    Q_PROPERTY(QString artist READ artist NOTIFY artistChanged)
+    Q_PROPERTY(QString album READ album NOTIFY albumChanged)
+    /**
+     * @brief 时长（秒），未知时为0
+     */
+    Q_PROPERTY(int duration READ duration NOTIFY durationChanged)
+    /**
+     * @brief 封面缓存文件地址，无封面时为空
+     */
+    Q_PROPERTY(QUrl coverImageUrl READ coverImageUrl NOTIFY coverImageUrlChanged)
+    /**
+     * @brief 是否有封面色板
+     */
+    Q_PROPERTY(bool hasPalette READ hasPalette NOTIFY paletteChanged)
+    Q_PROPERTY(QColor prominentColor READ prominentColor NOTIFY paletteChanged)
+    Q_PROPERTY(QColor mutedColor READ mutedColor NOTIFY paletteChanged)
+    Q_PROPERTY(QColor darkColor READ darkColor NOTIFY paletteChanged)
+
+public:
+    explicit AudioMetadata(QObject *parent = nullptr);
+
+    QUrl source() const { return m_source; }
+    void setSource(const QUrl &source);
+
+    QString title() const { return m_title; }
+    QString artist() const { return m_artist; }
+    QString album() const { return m_album; }
+    int duration() const { return m_duration; }
+    QUrl coverImageUrl() const { return m_coverImageUrl; }
+    bool hasPalette() const { return m_prominentColor.isValid(); }
+    QColor prominentColor() const { return m_prominentColor; }
+    QColor mutedColor() const { return m_mutedColor; }
+    QColor darkColor() const { return m_darkColor; }
+
+signals:
+    void sourceChanged();
+    void titleChanged();
+    void artistChanged();
+    void albumChanged();
+    void durationChanged();
+    void coverImageUrlChanged();
+    void paletteChanged();
+
+private:
+    void onTrackReady(const QString &path, const QVariantMap &meta);
+    void apply(const QVariantMap &meta);
+
+    QUrl m_source;
+    QString m_path;
+    QString m_title;
+    QString m_artist;
+    QString m_album;
+    int m_duration;
+    QUrl m_coverImageUrl;
+    QColor m_prominentColor;
+    QColor m_mutedColor;
+    QColor m_darkColor;
+};
+
+#endif
@@ -0,0 +1,563 @@
+#include "AudioTagReader.h"
+#include <QFile>
+#include <QFileInfo>
+#include <QStringDecoder>
+#include <QtEndian>
+
+namespace {
+
+/**
+ * @brief 单个标签块的大小上限
+ * @details 防止损坏文件中的异常长度导致一次读入过多数据
+ */
+constexpr qint64 MAX_TAG_BYTES = 16 * 1024 * 1024;
+
+/**
+ * @brief 查找MP3首帧时读取的字节数
+ */
+constexpr qint64 MP3_SYNC_SEARCH_BYTES = 64 * 1024;
+
+quint32 syncsafe(const uchar *p)
+{
+    return (quint32(p[0] & 0x7F) << 21) | (quint32(p[1] & 0x7F) << 14) | (quint32(p[2] & 0x7F) << 7) | quint32(p[3] & 0x7F);
+}
+
+/**
+ * @brief 还原ID3不同步处理（0xFF 0x00 -> 0xFF）
+ */
+QByteArray removeUnsync(const QByteArray &data)
+{
+    QByteArray out;
+    out.reserve(data.size());
+    for (qsizetype i = 0; i < data.size(); ++i) {
+        out.append(data.at(i));
+        if (static_cast<uchar>(data.at(i)) == 0xFF && i + 1 < data.size() && data.at(i + 1) == 0) {
+            ++i;
+        }
+    }
+    return out;
+}
+
+/**
+ * @brief 跳过以结束符结尾的字符串
+ * @return 结束符之后的偏移
+ */
+qsizetype skipString(uchar encoding, const char *data, qsizetype size)
+{
+    if (encoding == 1 || encoding == 2) {
+        for (qsizetype i = 0; i + 1 < size; i += 2) {
+            if (data[i] == 0 && data[i + 1] == 0) {
+                return i + 2;
+            }
+        }
+        return size;
+    }
+    for (qsizetype i = 0; i < size; ++i) {
+        if (data[i] == 0) {
+            return i + 1;
+        }
+    }
+    return size;
+}
+
+/**
+ * @brief 解码ID3文本帧
+ * @details 编码0按规范为ISO-8859-1，但国内文件多以GBK写入，
+ *          这里按本地编码解码，中文系统下可正确显示；多值时只取第一个
+ */
+QString decodeText(uchar encoding, const char *data, qsizetype size)
+{
+    const bool wide = encoding == 1 || encoding == 2;
+    qsizetype length = wide ? (size & ~qsizetype(1)) : size;
+    for (qsizetype i = 0; i < length; i += wide ? 2 : 1) {
+        if (data[i] == 0 && (!wide || data[i + 1] == 0)) {
+            length = i;
+            break;
+        }
+    }
+    if (length <= 0) {
+        return QString();
+    }
+    switch (encoding) {
+    case 1: {
+        QStringDecoder decoder(QStringConverter::Utf16);
+        return QString(decoder(QByteArrayView(data, length))).trimmed();
+    }
+    case 2: {
+        QStringDecoder decoder(QStringConverter::Utf16BE);
+        return QString(decoder(QByteArrayView(data, length))).trimmed();
+    }
+    case 3:
+        return QString::fromUtf8(data, length).trimmed();
+    default:
+        return QString::fromLocal8Bit(data, length).trimmed();
+    }
+}
+
+/**
+ * @brief 读取ID3v2标签
+ * @return 标签总长度（音频数据起始偏移），无标签返回0
+ */
+qint64 readId3v2(QFile &file, AudioTags &tags, bool withCover)
+{
+    if (!file.seek(0)) {
+        return 0;
+    }
+    const QByteArray header = file.read(10);
+    if (header.size() < 10 || !header.startsWith("ID3")) {
+        return 0;
+    }
+    const uchar *h = reinterpret_cast<const uchar *>(header.constData());
+    const int version = h[3];
+    const uchar flags = h[5];
+    const qint64 size = syncsafe(h + 6);
+    const qint64 total = 10 + size + ((flags & 0x10) ? 10 : 0);
+    if (version < 2 || version > 4 || size > MAX_TAG_BYTES) {
+        return total;
+    }
+
+    QByteArray body = file.read(size);
+    if (version < 4 && (flags & 0x80)) {
+        body = removeUnsync(body);
+    }
+    qsizetype pos = 0;
+    if (version >= 3 && (flags & 0x40) && body.size() >= 4) {
+        const uchar *e = reinterpret_cast<const uchar *>(body.constData());
+        pos = version == 4 ? syncsafe(e) : qFromBigEndian<quint32>(e) + 4;
+    }
+
+    const int idLength = version == 2 ? 3 : 4;
+    const int headerLength = version == 2 ? 6 : 10;
+    while (pos + headerLength <= body.size()) {
+        const char *f = body.constData() + pos;
+        if (f[0] == 0) {
+            break;  // 填充区
+        }
+        const QByteArray id(f, idLength);
+        const uchar *sizeBytes = reinterpret_cast<const uchar *>(f) + idLength;
+        qint64 frameSize = 0;
+        if (version == 2) {
+            frameSize = (qint64(sizeBytes[0]) << 16) | (qint64(sizeBytes[1]) << 8) | sizeBytes[2];
+        } else if (version == 4) {
+            frameSize = syncsafe(sizeBytes);
+        } else {
+            frameSize = qFromBigEndian<quint32>(sizeBytes);
+        }
+        const uchar formatFlags = version >= 3 ? static_cast<uchar>(f[9]) : 0;
+        pos += headerLength;
+        if (frameSize <= 0 || pos + frameSize > body.size()) {
+            break;
+        }
+        QByteArray frame = body.mid(pos, frameSize);
+        pos += frameSize;
+
+        if (version == 4) {
+            if (formatFlags & 0x0C) {
+                continue;  // 压缩或加密
+            }
+            if (formatFlags & 0x01) {
+                frame = frame.mid(4);
+            }
+            if (formatFlags & 0x02) {
+                frame = removeUnsync(frame);
+            }
+        } else if (version == 3 && (formatFlags & 0xC0)) {
+            continue;
+        }
+        if (frame.size() < 2) {
+            continue;
+        }
+
+        const uchar encoding = static_cast<uchar>(frame.at(0));
+        const char *data = frame.constData() + 1;
+        const qsizetype dataSize = frame.size() - 1;
+        if (id == "TIT2" || id == "TT2") {
+            if (tags.title.isEmpty()) {
+                tags.title = decodeText(encoding, data, dataSize);
+            }
+        } else if (id == "TPE1" || id == "TP1") {
+            if (tags.artist.isEmpty()) {
+                tags.artist = decodeText(encoding, data, dataSize);
+            }
+        } else if (id == "TALB" || id == "TAL") {
+            if (tags.album.isEmpty()) {
+                tags.album = decodeText(encoding, data, dataSize);
+            }
+        } else if (id == "TLEN" || id == "TLE") {
+            tags.durationMs = decodeText(encoding, data, dataSize).toLongLong();
+        } else if (withCover && tags.cover.isEmpty() && (id == "APIC" || id == "PIC")) {
+            // APIC：编码、MIME（以0结尾）、图片类型、描述、数据；PIC的MIME为3字节格式名
+            qsizetype p = id == "APIC" ? skipString(0, data, dataSize) : 3;
+            p += 1;
+            if (p >= dataSize) {
+                continue;
+            }
+            p += skipString(encoding, data + p, dataSize - p);
+            if (p < dataSize) {
+                tags.cover = QByteArray(data + p, dataSize - p);
+            }
+        }
+    }
+    return total;
+}
+
+void readId3v1(QFile &file, AudioTags &tags)
+{
+    if (file.size() < 128 || !file.seek(file.size() - 128)) {
+        return;
+    }
+    const QByteArray tag = file.read(128);
+    if (!tag.startsWith("TAG")) {
+        return;
+    }
+    auto field = [&tag](int offset) {
+        QByteArray value = tag.mid(offset, 30);
+        const int end = value.indexOf('\0');
+        if (end >= 0) {
+            value.truncate(end);
+        }
+        return QString::fromLocal8Bit(value).trimmed();
+    };
+    if (tags.title.isEmpty()) {
+        tags.title = field(3);
+    }
+    if (tags.artist.isEmpty()) {
+        tags.artist = field(33);
+    }
+    if (tags.album.isEmpty()) {
+        tags.album = field(63);
+    }
+}
+
+/**
+ * @brief 估算MP3时长
+ * @details 首帧带Xing/Info头时按帧数计算（VBR准确），否则按首帧码率当作CBR估算
+ */
+qint64 estimateMp3Duration(QFile &file, qint64 audioStart)
+{
+    if (!file.seek(audioStart)) {
+        return 0;
+    }
+    const QByteArray buffer = file.read(MP3_SYNC_SEARCH_BYTES);
+    const uchar *b = reinterpret_cast<const uchar *>(buffer.constData());
+    static const int bitratesV1[] = {0, 32, 40, 48, 56, 64, 80, 96, 112, 128, 160, 192, 224, 256, 320};
+    static const int bitratesV2[] = {0, 8, 16, 24, 32, 40, 48, 56, 64, 80, 96, 112, 128, 144, 160};
+    static const int sampleRates[] = {44100, 48000, 32000};
+
+    for (qsizetype i = 0; i + 4 <= buffer.size(); ++i) {
+        if (b[i] != 0xFF || (b[i + 1] & 0xE0) != 0xE0) {
+            continue;
+        }
+        const int versionBits = (b[i + 1] >> 3) & 0x03;     // 0:MPEG2.5 2:MPEG2 3:MPEG1
+        const int layerBits = (b[i + 1] >> 1) & 0x03;       // 1:Layer III
+        const int bitrateIndex = b[i + 2] >> 4;
+        const int rateIndex = (b[i + 2] >> 2) & 0x03;
+        if (versionBits == 1 || layerBits != 1 || bitrateIndex == 0 || bitrateIndex == 15 || rateIndex == 3) {
+            continue;
+        }
+        const bool mpeg1 = versionBits == 3;
+        int sampleRate = sampleRates[rateIndex];
+        if (versionBits == 2) {
+            sampleRate /= 2;
+        } else if (versionBits == 0) {
+            sampleRate /= 4;
+        }
+        const int bitrate = (mpeg1 ? bitratesV1 : bitratesV2)[bitrateIndex] * 1000;
+        const int samplesPerFrame = mpeg1 ? 1152 : 576;
+        const bool mono = (b[i + 3] >> 6) == 3;
+        const int sideInfo = mpeg1 ? (mono ? 17 : 32) : (mono ? 9 : 17);
+
+        const qsizetype xing = i + 4 + sideInfo;
+        if (xing + 12 <= buffer.size()) {
+            const QByteArrayView tag(buffer.constData() + xing, 4);
+            if ((tag == "Xing" || tag == "Info") && (qFromBigEndian<quint32>(b + xing + 4) & 0x01)) {
+                const quint32 frames = qFromBigEndian<quint32>(b + xing + 8);
+                return qint64(frames) * samplesPerFrame * 1000 / sampleRate;
+            }
+        }
+        return (file.size() - audioStart - i) * 8000 / bitrate;
+    }
+    return 0;
+}
+
+void parseVorbisComments(const QByteArray &block, AudioTags &tags)
+{
+    qsizetype pos = 0;
+    auto next = [&block, &pos](quint32 &value) {
+        if (pos + 4 > block.size()) {
+            return false;
+        }
+        value = qFromLittleEndian<quint32>(block.constData() + pos);
+        pos += 4;
+        return true;
+    };
+    quint32 vendorLength = 0;
+    quint32 count = 0;
+    if (!next(vendorLength)) {
+        return;
+    }
+    pos += vendorLength;
+    if (!next(count)) {
+        return;
+    }
+    for (quint32 i = 0; i < count; ++i) {
+        quint32 length = 0;
+        if (!next(length) || pos + length > block.size()) {
+            return;
+        }
+        const QByteArray comment = block.mid(pos, length);
+        pos += length;
+        const int eq = comment.indexOf('=');
+        if (eq <= 0) {
+            continue;
+        }
+        const QByteArray key = comment.left(eq).toUpper();
+        const QString value = QString::fromUtf8(comment.mid(eq + 1)).trimmed();
+        if (key == "TITLE" && tags.title.isEmpty()) {
+            tags.title = value;
+        } else if (key == "ARTIST" && tags.artist.isEmpty()) {
+            tags.artist = value;
+        } else if (key == "ALBUM" && tags.album.isEmpty()) {
+            tags.album = value;
+        }
+    }
+}
+
+void parseFlacPicture(const QByteArray &block, AudioTags &tags)
+{
+    qsizetype pos = 4;  // 图片类型
+    auto next = [&block, &pos](quint32 &value) {
+        if (pos + 4 > block.size()) {
+            return false;
+        }
+        value = qFromBigEndian<quint32>(block.constData() + pos);
+        pos += 4;
+        return true;
+    };
+    quint32 length = 0;
+    if (!next(length)) {
+        return;
+    }
+    pos += length;  // MIME
+    if (!next(length)) {
+        return;
+    }
+    pos += length + 16;  // 描述、宽、高、色深、索引色数
+    if (!next(length) || pos + length > block.size()) {
+        return;
+    }
+    tags.cover = block.mid(pos, length);
+}
+
+void readFlac(QFile &file, qint64 start, AudioTags &tags, bool withCover)
+{
+    if (!file.seek(start) || file.read(4) != "fLaC") {
+        return;
+    }
+    bool last = false;
+    while (!last) {
+        const QByteArray header = file.read(4);
+        if (header.size() < 4) {
+            return;
+        }
+        const uchar *h = reinterpret_cast<const uchar *>(header.constData());
+        last = h[0] & 0x80;
+        const int type = h[0] & 0x7F;
+        const qint64 length = (qint64(h[1]) << 16) | (qint64(h[2]) << 8) | h[3];
+
+        const bool wanted = type == 0 || type == 4 || (type == 6 && withCover && tags.cover.isEmpty());
+        if (!wanted) {
+            if (!file.seek(file.pos() + length)) {
+                return;
+            }
+            continue;
+        }
+        const QByteArray block = file.read(length);
+        if (block.size() < length) {
+            return;
+        }
+        if (type == 0 && length >= 18) {
+            // STREAMINFO：采样率20位，总采样数36位
+            const uchar *d = reinterpret_cast<const uchar *>(block.constData());
+            const quint32 sampleRate = (quint32(d[10]) << 12) | (quint32(d[11]) << 4) | (d[12] >> 4);
+            const quint64 totalSamples = (quint64(d[13] & 0x0F) << 32) | qFromBigEndian<quint32>(d + 14);
+            if (sampleRate > 0) {
+                tags.durationMs = static_cast<qint64>(totalSamples * 1000 / sampleRate);
+            }
+        } else if (type == 4) {
+            parseVorbisComments(block, tags);
+        } else if (type == 6) {
+            parseFlacPicture(block, tags);
+        }
+    }
+}
+
+/**
+ * @brief MP4 atom
+ */
+struct Atom {
+    qint64 start = 0;
+    qint64 size = 0;
+    qint64 headerSize = 8;
+    QByteArray type;
+
+    qint64 begin() const { return start + headerSize; }
+    qint64 end() const { return start + size; }
+};
+
+bool readAtom(QFile &file, qint64 pos, qint64 end, Atom &atom)
+{
+    if (pos + 8 > end || !file.seek(pos)) {
+        return false;
+    }
+    const QByteArray header = file.read(8);
+    if (header.size() < 8) {
+        return false;
+    }
+    qint64 size = qFromBigEndian<quint32>(header.constData());
+    atom.type = header.mid(4, 4);
+    atom.headerSize = 8;
+    if (size == 1) {
+        const QByteArray extended = file.read(8);
+        if (extended.size() < 8) {
+            return false;
+        }
+        size = static_cast<qint64>(qFromBigEndian<quint64>(extended.constData()));
+        atom.headerSize = 16;
+    } else if (size == 0) {
+        size = end - pos;
+    }
+    if (size < atom.headerSize || pos + size > end) {
+        return false;
+    }
+    atom.start = pos;
+    atom.size = size;
+    return true;
+}
+
+bool findAtom(QFile &file, qint64 begin, qint64 end, const QByteArray &type, Atom &result)
+{
+    Atom atom;
+    for (qint64 pos = begin; readAtom(file, pos, end, atom); pos = atom.end()) {
+        if (atom.type == type) {
+            result = atom;
+            return true;
+        }
+    }
+    return false;
+}
+
+/**
+ * @brief 读取MP4/M4A
+ * @details 逐个atom跳转而不整体读入，moov位于大块mdat之后也只读取少量字节
+ */
+void readMp4(QFile &file, AudioTags &tags, bool withCover)
+{
+    Atom ftyp;
+    Atom moov;
+    if (!readAtom(file, 0, file.size(), ftyp) || ftyp.type != "ftyp"
+            || !findAtom(file, 0, file.size(), "moov", moov)) {
+        return;
+    }
+
+    Atom mvhd;
+    if (findAtom(file, moov.begin(), moov.end(), "mvhd", mvhd) && file.seek(mvhd.begin())) {
+        const QByteArray d = file.read(32);
+        const uchar *p = reinterpret_cast<const uchar *>(d.constData());
+        quint32 timescale = 0;
+        quint64 duration = 0;
+        if (d.size() >= 32 && p[0] == 1) {
+            timescale = qFromBigEndian<quint32>(p + 20);
+            duration = qFromBigEndian<quint64>(p + 24);
+        } else if (d.size() >= 20) {
+            timescale = qFromBigEndian<quint32>(p + 12);
+            duration = qFromBigEndian<quint32>(p + 16);
+        }
+        if (timescale > 0) {
+            tags.durationMs = static_cast<qint64>(duration * 1000 / timescale);
+        }
+    }
+
+    Atom udta;
+    Atom meta;
+    Atom ilst;
+    // meta为完整atom，子atom之前有4字节版本与标志
+    if (!findAtom(file, moov.begin(), moov.end(), "udta", udta)
+            || !findAtom(file, udta.begin(), udta.end(), "meta", meta)
+            || !findAtom(file, meta.begin() + 4, meta.end(), "ilst", ilst)) {
+        return;
+    }
+
+    static const QByteArray titleAtom = QByteArray("\xA9") + "nam";
+    static const QByteArray artistAtom = QByteArray("\xA9") + "ART";
+    static const QByteArray albumAtom = QByteArray("\xA9") + "alb";
+    Atom item;
+    for (qint64 pos = ilst.begin(); readAtom(file, pos, ilst.end(), item); pos = item.end()) {
+        QString *target = nullptr;
+        if (item.type == titleAtom) {
+            target = &tags.title;
+        } else if (item.type == artistAtom) {
+            target = &tags.artist;
+        } else if (item.type == albumAtom) {
+            target = &tags.album;
+        }
+        const bool cover = item.type == "covr" && withCover && tags.cover.isEmpty();
+        if ((!target || !target->isEmpty()) && !cover) {
+            continue;
+        }
+        // data atom：4字节类型标识与4字节区域之后为内容
+        Atom data;
+        if (!findAtom(file, item.begin(), item.end(), "data", data)) {
+            continue;
+        }
+        const qint64 payload = data.size - data.headerSize - 8;
+        if (payload <= 0 || payload > MAX_TAG_BYTES || !file.seek(data.begin() + 8)) {
+            continue;
+        }
+        const QByteArray value = file.read(payload);
+        if (cover) {
+            tags.cover = value;
+        } else {
+            *target = QString::fromUtf8(value).trimmed();
+        }
+    }
+}
+
+} // namespace
+
+namespace AudioTagReader {
+
+AudioTags read(const QString &filePath, bool withCover)
+{
+    AudioTags tags;
+    QFile file(filePath);
+    if (!file.open(QIODevice::ReadOnly)) {
+        return tags;
+    }
+
+    const QString suffix = QFileInfo(filePath).suffix().toLower();
+    if (suffix == "m4a" || suffix == "mp4" || suffix == "m4b") {
+        readMp4(file, tags, withCover);
+        return tags;
+    }
+
+    const qint64 audioStart = readId3v2(file, tags, withCover);
+    if (suffix == "flac") {
+        readFlac(file, audioStart, tags, withCover);
+    } else if (suffix == "mp3") {
+        if (tags.title.isEmpty() || tags.artist.isEmpty()) {
+            readId3v1(file, tags);
+        }
+        if (tags.durationMs <= 0) {
+            tags.durationMs = estimateMp3Duration(file, audioStart);
+        }
+    }
+    return tags;
+}
+
+QString coverExtension(const QByteArray &cover)
+{
+    return cover.startsWith("\x89PNG") ? QStringLiteral("png") : QStringLiteral("jpg");
+}
+
+} // namespace AudioTagReader
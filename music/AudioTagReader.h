@@ -0,0 +1,45 @@
+#ifndef AUDIOTAGREADER_H
+#define AUDIOTAGREADER_H
+
+#include <QString>
+#include <QByteArray>
+
+/**
+ * @brief 音频文件标签
+ */
+struct AudioTags {
+    QString title;
+    QString artist;
+    QString album;
+    qint64 durationMs = 0;
+    QByteArray cover;           ///< 内嵌封面原始数据（JPEG/PNG）
+};
+
+/**
+ * @brief 音频标签解析
+ * @details 不依赖第三方库，只读取标签所在的字节：
+ *          - MP3：ID3v2.2/2.3/2.4（含不同步处理），无ID3v2时读ID3v1；
+ *            时长取TLEN，缺失时由Xing/Info帧数或首帧码率估算
+ *          - FLAC：STREAMINFO、VORBIS_COMMENT、PICTURE块（允许前置ID3v2）
+ *          - MP4/M4A：moov/mvhd时长与moov/udta/meta/ilst标签，支持moov位于文件末尾
+ *          其他格式返回空标签。可在任意线程调用
+ */
+namespace AudioTagReader {
+
+/**
+ * @brief 读取标签
+ * @param filePath 本地文件路径
+ * @param withCover 是否提取内嵌封面
+ * @return 解析结果，无法识别时各字段为空
+ */
+AudioTags read(const QString &filePath, bool withCover = true);
+
+/**
+ * @brief 封面数据对应的扩展名
+ * @return "png"或"jpg"
+ */
+QString coverExtension(const QByteArray &cover);
+
+} // namespace AudioTagReader
+
+#endif
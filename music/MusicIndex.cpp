@@ -0,0 +1,299 @@
+#include "MusicIndex.h"
+#include "AudioTagReader.h"
+#include "PaletteExtractor.h"
+#include "../core/Logger.h"
+#include <QColor>
+#include <QCoreApplication>
+#include <QCryptographicHash>
+#include <QDataStream>
+#include <QDateTime>
+#include <QDir>
+#include <QFile>
+#include <QFileInfo>
+#include <QPointer>
+#include <QSaveFile>
+#include <QStandardPaths>
+#include <QThread>
+#include <QTimer>
+#include <QUrl>
+#include <algorithm>
+
+namespace {
+
+constexpr quint32 INDEX_MAGIC = 0x4D494458;   // "MIDX"
+constexpr quint16 INDEX_VERSION = 2;
+
+/**
+ * @brief 索引更新后延迟写盘的时间（毫秒）
+ * @details 首次扫描时连续解析数千首，合并为少量几次写入
+ */
+constexpr int SAVE_DELAY_MS = 2000;
+
+/**
+ * @brief 单条索引记录的最小字节数
+ * @details 5个空QString（各4字节长度）+ 3个qint64 + 3个QRgb
+ */
+constexpr qint64 MIN_RECORD_BYTES = 5 * 4 + 3 * 8 + 3 * 4;
+
+} // namespace
+
+QVariantMap TrackInfo::toMap() const
+{
+    QVariantMap map;
+    map["title"] = title;
+    map["artist"] = artist;
+    map["album"] = album;
+    map["duration"] = static_cast<int>(durationMs / 1000);
+    map["coverUrl"] = coverFile.isEmpty() ? QUrl() : QUrl::fromLocalFile(coverFile);
+    if (prominentColor != 0) {
+        map["prominentColor"] = QColor::fromRgba(prominentColor);
+        map["mutedColor"] = QColor::fromRgba(mutedColor);
+        map["darkColor"] = QColor::fromRgba(darkColor);
+    }
+    return map;
+}
+
+MusicIndex *MusicIndex::instance()
+{
+    static QPointer<MusicIndex> s_instance;
+    if (!s_instance) {
+        s_instance = new MusicIndex(QCoreApplication::instance());
+    }
+    return s_instance;
+}
+
+MusicIndex::MusicIndex(QObject *parent)
+    : QObject(parent)
+    , m_activeWorkers(0)
+    , m_dirty(false)
+    , m_saveTimer(nullptr)
+{
+    m_indexFile = QDir(QStandardPaths::writableLocation(QStandardPaths::AppLocalDataLocation)).filePath("music-index.dat");
+    m_coverDirectory = QDir(QStandardPaths::writableLocation(QStandardPaths::CacheLocation)).filePath("covers");
+    QDir().mkpath(m_coverDirectory);
+
+    // 解析以磁盘读取为主，线程数取CPU核数即可
+    m_pool.setMaxThreadCount(qMax(2, QThread::idealThreadCount()));
+
+    m_saveTimer = new QTimer(this);
+    m_saveTimer->setSingleShot(true);
+    m_saveTimer->setInterval(SAVE_DELAY_MS);
+    connect(m_saveTimer, &QTimer::timeout, this, &MusicIndex::save);
+
+    load();
+}
+
+MusicIndex::~MusicIndex()
+{
+    {
+        QMutexLocker locker(&m_mutex);
+        m_queue.clear();
+        m_queued.clear();
+    }
+    m_pool.waitForDone();
+    save();
+}
+
+bool MusicIndex::lookup(const QString &path, TrackInfo *info) const
+{
+    QMutexLocker locker(&m_mutex);
+    auto it = m_tracks.constFind(path);
+    if (it == m_tracks.constEnd()) {
+        return false;
+    }
+    if (info) {
+        *info = it.value();
+    }
+    return true;
+}
+
+int MusicIndex::count() const
+{
+    QMutexLocker locker(&m_mutex);
+    return m_tracks.size();
+}
+
+void MusicIndex::enqueue(const QStringList &paths, bool urgent)
+{
+    {
+        QMutexLocker locker(&m_mutex);
+        if (urgent) {
+            // 逆序插入队首，保持传入顺序
+            for (auto it = paths.crbegin(); it != paths.crend(); ++it) {
+                if (it->isEmpty()) {
+                    continue;
+                }
+                if (m_queued.contains(*it)) {
+                    auto pos = std::find(m_queue.begin(), m_queue.end(), *it);
+                    if (pos != m_queue.end()) {
+                        m_queue.erase(pos);
+                    }
+                } else {
+                    m_queued.insert(*it);
+                }
+                m_queue.push_front(*it);
+            }
+        } else {
+            for (const QString &path : paths) {
+                if (!path.isEmpty() && !m_queued.contains(path)) {
+                    m_queued.insert(path);
+                    m_queue.push_back(path);
+                }
+            }
+        }
+    }
+    startWorkers();
+}
+
+void MusicIndex::startWorkers()
+{
+    QMutexLocker locker(&m_mutex);
+    const int wanted = qMin(m_pool.maxThreadCount(), static_cast<int>(m_queue.size()));
+    while (m_activeWorkers < wanted) {
+        ++m_activeWorkers;
+        m_pool.start([this]() { drain(); });
+    }
+}
+
+/**
+ * @brief 工作线程：依次取队首路径解析
+ */
+void MusicIndex::drain()
+{
+    for (;;) {
+        QString path;
+        {
+            QMutexLocker locker(&m_mutex);
+            if (m_queue.empty()) {
+                --m_activeWorkers;
+                return;
+            }
+            path = m_queue.front();
+            m_queue.pop_front();
+            m_queued.remove(path);
+        }
+
+        const QFileInfo fileInfo(path);
+        if (!fileInfo.isFile()) {
+            continue;
+        }
+        const qint64 modifiedMs = fileInfo.lastModified().toMSecsSinceEpoch();
+        const qint64 size = fileInfo.size();
+        {
+            QMutexLocker locker(&m_mutex);
+            auto it = m_tracks.constFind(path);
+            if (it != m_tracks.constEnd() && it->modifiedMs == modifiedMs && it->size == size) {
+                continue;
+            }
+        }
+
+        const AudioTags tags = AudioTagReader::read(path);
+        TrackInfo info;
+        info.modifiedMs = modifiedMs;
+        info.size = size;
+        info.title = tags.title.isEmpty() ? fileInfo.completeBaseName() : tags.title;
+        info.artist = tags.artist;
+        info.album = tags.album;
+        info.durationMs = tags.durationMs;
+        info.coverFile = storeCover(path, tags.cover);
+        const Palette palette = PaletteExtractor::fromData(tags.cover);
+        if (palette.isValid()) {
+            info.prominentColor = palette.prominent.rgba();
+            info.mutedColor = palette.muted.rgba();
+            info.darkColor = palette.dark.rgba();
+        }
+        {
+            QMutexLocker locker(&m_mutex);
+            m_tracks.insert(path, info);
+            m_dirty = true;
+        }
+
+        const QVariantMap meta = info.toMap();
+        QMetaObject::invokeMethod(this, [this, path, meta]() {
+            emit trackReady(path, meta);
+            if (!m_saveTimer->isActive()) {
+                m_saveTimer->start();
+            }
+        }, Qt::QueuedConnection);
+    }
+}
+
+QString MusicIndex::storeCover(const QString &path, const QByteArray &cover) const
+{
+    if (cover.isEmpty()) {
+        return QString();
+    }
+    const QString name = QString::fromLatin1(QCryptographicHash::hash(path.toUtf8(), QCryptographicHash::Sha1).toHex().left(20))
+            + '.' + AudioTagReader::coverExtension(cover);
+    const QString filePath = QDir(m_coverDirectory).filePath(name);
+    QSaveFile file(filePath);
+    if (!file.open(QIODevice::WriteOnly)) {
+        return QString();
+    }
+    file.write(cover);
+    return file.commit() ? filePath : QString();
+}
+
+void MusicIndex::load()
+{
+    QFile file(m_indexFile);
+    if (!file.open(QIODevice::ReadOnly)) {
+        return;
+    }
+    QDataStream in(&file);
+    quint32 magic = 0;
+    quint16 version = 0;
+    qint32 count = 0;
+    in >> magic >> version >> count;
+    if (magic != INDEX_MAGIC || version != INDEX_VERSION || count < 0) {
+        LOG_WARNING(Log::General, "music index ignored: unsupported format");
+        return;
+    }
+
+    // 记录数来自文件，损坏时可能极大，按剩余字节能容纳的记录数截断后再预分配
+    const qint64 maxCount = (file.size() - file.pos()) / MIN_RECORD_BYTES;
+    QHash<QString, TrackInfo> tracks;
+    tracks.reserve(static_cast<qsizetype>(std::min<qint64>(count, maxCount)));
+    for (qint32 i = 0; i < count && in.status() == QDataStream::Ok; ++i) {
+        QString path;
+        TrackInfo info;
+        in >> path >> info.modifiedMs >> info.size >> info.title >> info.artist >> info.album
+           >> info.durationMs >> info.coverFile >> info.prominentColor >> info.mutedColor >> info.darkColor;
+        tracks.insert(path, info);
+    }
+    if (in.status() != QDataStream::Ok) {
+        LOG_WARNING(Log::General, "music index truncated, rebuilding");
+        return;
+    }
+    QMutexLocker locker(&m_mutex);
+    m_tracks.swap(tracks);
+    LOG_INFO(Log::General, "music index loaded: {} tracks", m_tracks.size());
+}
+
+void MusicIndex::save()
+{
+    QHash<QString, TrackInfo> tracks;
+    {
+        QMutexLocker locker(&m_mutex);
+        if (!m_dirty) {
+            return;
+        }
+        tracks = m_tracks;
+        m_dirty = false;
+    }
+
+    QDir().mkpath(QFileInfo(m_indexFile).absolutePath());
+    QSaveFile file(m_indexFile);
+    if (!file.open(QIODevice::WriteOnly)) {
+        LOG_WARNING(Log::General, "cannot write music index: {}", m_indexFile);
+        return;
+    }
+    QDataStream out(&file);
+    out << INDEX_MAGIC << INDEX_VERSION << static_cast<qint32>(tracks.size());
+    for (auto it = tracks.cbegin(); it != tracks.cend(); ++it) {
+        const TrackInfo &info = it.value();
+        out << it.key() << info.modifiedMs << info.size << info.title << info.artist << info.album
+            << info.durationMs << info.coverFile << info.prominentColor << info.mutedColor << info.darkColor;
+    }
+    file.commit();
+}
@@ -0,0 +1,107 @@
+#ifndef MUSICINDEX_H
+#define MUSICINDEX_H
+
+#include <QObject>
+#include <QHash>
+#include <QSet>
+#include <QMutex>
+#include <QThreadPool>
+#include <QVariantMap>
+#include <QRgb>
+#include <deque>
+
+class QTimer;
+
+/**
+ * @brief 曲目信息
+ */
+struct TrackInfo {
+    qint64 modifiedMs = 0;      ///< 文件修改时间，与大小一起判断是否需要重新解析
+    qint64 size = 0;
+    QString title;
+    QString artist;
+    QString album;
+    qint64 durationMs = 0;
+    QString coverFile;          ///< 封面缓存文件，无封面为空
+    QRgb prominentColor = 0;    ///< 封面色板（PaletteExtractor），无封面时为0
+    QRgb mutedColor = 0;
+    QRgb darkColor = 0;
+
+    /**
+     * @brief 转为QML使用的映射
+     * @return 包含title、artist、album、duration（秒）、coverUrl字段，
+     *         有封面时另含prominentColor、mutedColor、darkColor
+     */
+    QVariantMap toMap() const;
+};
+
+/**
+ * @brief 音乐元数据索引
+ * @details 全部MusicLibrary/AudioMetadata实例共享：
+ *          - 以路径为键，修改时间与大小未变时直接使用索引，不再读取文件
+ *          - 待解析队列在线程池中并行处理，prioritize的路径插到队首（可见行优先）
+ *          - 封面写入缓存目录并在工作线程中取色，色板随索引保存
+ *          - 索引在更新后延迟写入磁盘，下次启动直接加载
+ *          只在界面线程访问公共接口
+ */
+class MusicIndex : public QObject
+{
+    Q_OBJECT
+
+public:
+    /**
+     * @brief 获取共享实例（随QCoreApplication销毁）
+     */
+    static MusicIndex *instance();
+    ~MusicIndex();
+
+    /**
+     * @brief 查询索引
+     * @param path 本地文件路径
+     * @param info 输出曲目信息
+     * @return 是否存在（不检查文件是否已变化）
+     */
+    bool lookup(const QString &path, TrackInfo *info) const;
+
+    /**
+     * @brief 已索引的曲目数
+     */
+    int count() const;
+
+    /**
+     * @brief 加入解析队列
+     * @param paths 本地文件路径
+     * @param urgent 是否插到队首
+     * @details 未变化的文件只做一次stat
+     */
+    void enqueue(const QStringList &paths, bool urgent);
+
+signals:
+    /**
+     * @brief 曲目解析完成（新增或文件已变化）
+     */
+    void trackReady(const QString &path, const QVariantMap &meta);
+
+private:
+    explicit MusicIndex(QObject *parent = nullptr);
+
+    void startWorkers();
+    void drain();
+    QString storeCover(const QString &path, const QByteArray &cover) const;
+    void load();
+    void save();
+
+    mutable QMutex m_mutex;
+    QHash<QString, TrackInfo> m_tracks;
+    std::deque<QString> m_queue;
+    QSet<QString> m_queued;
+    int m_activeWorkers;
+    bool m_dirty;
+
+    QThreadPool m_pool;
+    QTimer *m_saveTimer;
+    QString m_indexFile;
+    QString m_coverDirectory;
+};
+
+#endif
@@ -0,0 +1,335 @@
+#include "MusicLibrary.h"
+#include "MusicIndex.h"
+#include "../core/Logger.h"
+#include <QCoreApplication>
+#include <QDir>
+#include <QDirIterator>
+#include <QElapsedTimer>
+#include <QFile>
+#include <QFileInfo>
+#include <QFileSystemWatcher>
+#include <QStandardPaths>
+#include <QStringDecoder>
+#include <QTimer>
+#include <QUrl>
+
+namespace {
+
+const QStringList MUSIC_SUFFIXES = { "mp3", "m4a", "flac", "wav", "ogg", "aac", "wma" };
+
+/**
+ * @brief 目录变化后重新扫描的延迟（毫秒）
+ * @details 复制大量文件时目录会连续变化，合并为一次扫描
+ */
+constexpr int RESCAN_DELAY_MS = 800;
+
+} // namespace
+
+MusicLibrary::MusicLibrary(QObject *parent)
+    : QObject(parent)
+    , m_recursive(true)
+    , m_watcher(nullptr)
+    , m_rescanTimer(nullptr)
+{
+    connect(MusicIndex::instance(), &MusicIndex::trackReady, this, &MusicLibrary::onTrackReady);
+
+    m_rescanTimer = new QTimer(this);
+    m_rescanTimer->setSingleShot(true);
+    m_rescanTimer->setInterval(RESCAN_DELAY_MS);
+    connect(m_rescanTimer, &QTimer::timeout, this, &MusicLibrary::rescanWatched);
+}
+
+QString MusicLibrary::toLocalPath(const QString &source)
+{
+    if (source.startsWith("file:")) {
+        return QUrl(source).toLocalFile();
+    }
+    if (source.startsWith("qrc:")) {
+        return ':' + QUrl(source).path();
+    }
+    return source;
+}
+
+QStringList MusicLibrary::scanDirectory(const QString &directory, bool recursive) const
+{
+    QStringList nameFilters;
+    for (const QString &suffix : MUSIC_SUFFIXES) {
+        nameFilters << "*." + suffix;
+    }
+
+    QStringList files;
+    QDirIterator it(directory, nameFilters, QDir::Files | QDir::Readable,
+                    recursive ? QDirIterator::Subdirectories : QDirIterator::NoIteratorFlags);
+    while (it.hasNext()) {
+        files << it.next();
+    }
+    // 保持稳定的播放顺序
+    files.sort(Qt::CaseInsensitive);
+
+    QStringList urls;
+    urls.reserve(files.size());
+    for (const QString &file : files) {
+        urls << QUrl::fromLocalFile(file).toString();
+    }
+    return urls;
+}
+
+QStringList MusicLibrary::scanAllAvailableMusic(bool recursive)
+{
+    const QStringList candidates = {
+        QDir(QCoreApplication::applicationDirPath()).filePath("music"),
+        QDir::current().filePath("music"),
+        QStandardPaths::writableLocation(QStandardPaths::MusicLocation),
+    };
+
+    QElapsedTimer timer;
+    timer.start();
+    for (const QString &directory : candidates) {
+        if (directory.isEmpty() || !QFileInfo(directory).isDir()) {
+            continue;
+        }
+        const QStringList files = scanDirectory(directory, recursive);
+        if (files.isEmpty()) {
+            continue;
+        }
+        m_roots = QStringList{ directory };
+        m_recursive = recursive;
+        m_knownFiles = files;
+        updateWatchedDirectories();
+
+        QStringList paths;
+        paths.reserve(files.size());
+        for (const QString &file : files) {
+            paths << toLocalPath(file);
+        }
+        MusicIndex::instance()->enqueue(paths, false);
+
+        LOG_INFO(Log::General, "music scan: {} files in {} ({} ms)", files.size(), directory, timer.elapsed());
+        return files;
+    }
+    m_roots.clear();
+    m_knownFiles.clear();
+    updateWatchedDirectories();
+    return QStringList();
+}
+
+QStringList MusicLibrary::scanOnlyDirectory(const QString &folder)
+{
+    const QString directory = toLocalPath(folder);
+    if (directory.isEmpty() || !QFileInfo(directory).isDir()) {
+        return QStringList();
+    }
+    const QStringList files = scanDirectory(directory, true);
+    m_roots = QStringList{ directory };
+    m_recursive = true;
+    m_knownFiles = files;
+    updateWatchedDirectories();
+    return files;
+}
+
+void MusicLibrary::prefetchMetadata(const QStringList &sources)
+{
+    request(sources, false);
+}
+
+void MusicLibrary::prioritize(const QStringList &sources)
+{
+    request(sources, true);
+}
+
+void MusicLibrary::request(const QStringList &sources, bool urgent)
+{
+    QStringList paths;
+    paths.reserve(sources.size());
+    QList<QPair<QString, QVariantMap>> cached;
+    for (const QString &source : sources) {
+        const QString path = toLocalPath(source);
+        if (path.isEmpty()) {
+            continue;
+        }
+        QStringList &requested = m_requested[path];
+        if (!requested.contains(source)) {
+            requested << source;
+        }
+        paths << path;
+
+        TrackInfo info;
+        if (MusicIndex::instance()->lookup(path, &info)) {
+            cached.append({ source, info.toMap() });
+        }
+    }
+    MusicIndex::instance()->enqueue(paths, urgent);
+
+    // 调用方通常在发出请求后才连接处理，异步返回已索引的结果
+    if (!cached.isEmpty()) {
+        QMetaObject::invokeMethod(this, [this, cached]() {
+            for (const auto &entry : cached) {
+                emit metadataReady(entry.first, entry.second);
+            }
+        }, Qt::QueuedConnection);
+    }
+}
+
+void MusicLibrary::onTrackReady(const QString &path, const QVariantMap &meta)
+{
+    auto it = m_requested.constFind(path);
+    if (it == m_requested.constEnd()) {
+        return;
+    }
+    for (const QString &source : it.value()) {
+        emit metadataReady(source, meta);
+    }
+}
+
+QVariantMap MusicLibrary::getMetadata(const QString &source) const
+{
+    TrackInfo info;
+    if (!MusicIndex::instance()->lookup(toLocalPath(source), &info)) {
+        return QVariantMap();
+    }
+    return info.toMap();
+}
+
+int MusicLibrary::getCachedFileCount() const
+{
+    return MusicIndex::instance()->count();
+}
+
+bool MusicLibrary::isValidMusicFile(const QString &source) const
+{
+    const QFileInfo info(toLocalPath(source));
+    return info.isFile() && MUSIC_SUFFIXES.contains(info.suffix().toLower());
+}
+
+void MusicLibrary::startWatching()
+{
+    if (!m_watcher) {
+        m_watcher = new QFileSystemWatcher(this);
+        connect(m_watcher, &QFileSystemWatcher::directoryChanged, m_rescanTimer, qOverload<>(&QTimer::start));
+    }
+    updateWatchedDirectories();
+}
+
+void MusicLibrary::stopWatching()
+{
+    m_rescanTimer->stop();
+    delete m_watcher;
+    m_watcher = nullptr;
+}
+
+bool MusicLibrary::isWatching() const
+{
+    return m_watcher && !m_watcher->directories().isEmpty();
+}
+
+void MusicLibrary::updateWatchedDirectories()
+{
+    if (!m_watcher) {
+        return;
+    }
+    const QStringList current = m_watcher->directories();
+    if (!current.isEmpty()) {
+        m_watcher->removePaths(current);
+    }
+
+    QStringList directories;
+    for (const QString &root : m_roots) {
+        directories << root;
+        if (m_recursive) {
+            QDirIterator it(root, QDir::Dirs | QDir::NoDotAndDotDot, QDirIterator::Subdirectories);
+            while (it.hasNext()) {
+                directories << it.next();
+            }
+        }
+    }
+    if (!directories.isEmpty()) {
+        m_watcher->addPaths(directories);
+    }
+}
+
+void MusicLibrary::rescanWatched()
+{
+    QStringList files;
+    for (const QString &root : m_roots) {
+        files << scanDirectory(root, m_recursive);
+    }
+    const QSet<QString> before(m_knownFiles.cbegin(), m_knownFiles.cend());
+    const QSet<QString> after(files.cbegin(), files.cend());
+    if (before == after) {
+        return;
+    }
+
+    QStringList added;
+    for (const QString &file : files) {
+        if (!before.contains(file)) {
+            added << file;
+        }
+    }
+    QStringList removed;
+    for (const QString &file : std::as_const(m_knownFiles)) {
+        if (!after.contains(file)) {
+            removed << file;
+        }
+    }
+    m_knownFiles = files;
+    // 新建的子目录也需要监控
+    updateWatchedDirectories();
+
+    QStringList addedPaths;
+    for (const QString &file : std::as_const(added)) {
+        addedPaths << toLocalPath(file);
+    }
+    MusicIndex::instance()->enqueue(addedPaths, false);
+
+    for (const QString &file : std::as_const(removed)) {
+        emit fileRemoved(file);
+    }
+    for (const QString &file : std::as_const(added)) {
+        emit fileAdded(file);
+    }
+    emit musicFilesChanged(files);
+}
+
+QString MusicLibrary::findLyricsFileForSource(const QString &source) const
+{
+    const QFileInfo info(toLocalPath(source));
+    if (info.filePath().isEmpty()) {
+        return QString();
+    }
+    const QDir directory = info.absoluteDir();
+    const QString baseName = info.completeBaseName();
+    const QStringList candidates = {
+        directory.filePath(baseName + ".lrc"),
+        directory.filePath(baseName + ".LRC"),
+        directory.filePath("lyrics/" + baseName + ".lrc"),
+        directory.filePath("Lyrics/" + baseName + ".lrc"),
+    };
+    for (const QString &candidate : candidates) {
+        if (QFileInfo::exists(candidate)) {
+            return QUrl::fromLocalFile(candidate).toString();
+        }
+    }
+    return QString();
+}
+
+QString MusicLibrary::loadLyricsText(const QString &source) const
+{
+    const QString lyricsUrl = findLyricsFileForSource(source);
+    if (lyricsUrl.isEmpty()) {
+        return QString();
+    }
+    QFile file(toLocalPath(lyricsUrl));
+    if (!file.open(QIODevice::ReadOnly)) {
+        return QString();
+    }
+    const QByteArray data = file.readAll();
+
+    // 有BOM时按BOM编码，否则先尝试UTF-8（解码时会去掉BOM）
+    const auto encoding = QStringConverter::encodingForData(data);
+    QStringDecoder decoder(encoding.value_or(QStringConverter::Utf8));
+    const QString text = decoder(data);
+    if (decoder.hasError() && !encoding) {
+        return QString::fromLocal8Bit(data);
+    }
+    return text;
+}
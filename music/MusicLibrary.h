@@ -0,0 +1,130 @@
+#ifndef MUSICLIBRARY_H
+#define MUSICLIBRARY_H
+
+#include <QObject>
+#include <QHash>
+#include <QSet>
+#include <QStringList>
+#include <QVariantMap>
+
+class QFileSystemWatcher;
+class QTimer;
+
+/**
+ * @brief 音乐库服务
+ * @details 为播放器与播放列表提供本地音乐：
+ *          - 扫描目录得到音乐文件（返回file:// URL字符串）
+ *          - 标签与封面由共享的MusicIndex在线程池中并行解析，结果持久化，
+ *            文件未变化时下次启动直接使用索引
+ *          - prioritize的文件插到解析队列首部，用于可见行优先
+ *          - 监控扫描目录，文件增删时发出fileAdded/fileRemoved/musicFilesChanged
+ *          - 查找与读取同名LRC歌词
+ *          以QML类型MusicLibrary提供（模块MusicLibrary 1.0）
+ */
+class MusicLibrary : public QObject
+{
+    Q_OBJECT
+
+public:
+    explicit MusicLibrary(QObject *parent = nullptr);
+
+    /**
+     * @brief 扫描可用音乐
+     * @details 依次尝试程序目录下的music、工作目录下的music、系统音乐目录，
+     *          返回第一个非空结果，并将该目录作为监控目录
+     * @param recursive 是否包含子目录
+     * @return 音乐文件URL列表
+     */
+    Q_INVOKABLE QStringList scanAllAvailableMusic(bool recursive = true);
+
+    /**
+     * @brief 只扫描指定目录（含子目录）
+     * @param folder 目录路径或URL
+     * @return 音乐文件URL列表
+     */
+    Q_INVOKABLE QStringList scanOnlyDirectory(const QString &folder);
+
+    /**
+     * @brief 在后台解析元数据
+     * @details 已在索引中的文件立即发出metadataReady，解析完成（或文件已变化）后再次发出
+     * @param sources 文件路径或URL
+     */
+    Q_INVOKABLE void prefetchMetadata(const QStringList &sources);
+
+    /**
+     * @brief 优先解析（插到队首），用于当前可见的行
+     * @param sources 文件路径或URL
+     */
+    Q_INVOKABLE void prioritize(const QStringList &sources);
+
+    /**
+     * @brief 查询已索引的元数据
+     * @param source 文件路径或URL
+     * @return 包含title、artist、album、duration（秒）、coverUrl，未索引时为空
+     */
+    Q_INVOKABLE QVariantMap getMetadata(const QString &source) const;
+
+    /**
+     * @brief 索引中的曲目数
+     */
+    Q_INVOKABLE int getCachedFileCount() const;
+
+    /**
+     * @brief 是否为存在且受支持的音乐文件
+     */
+    Q_INVOKABLE bool isValidMusicFile(const QString &source) const;
+
+    Q_INVOKABLE void startWatching();
+    Q_INVOKABLE void stopWatching();
+    Q_INVOKABLE bool isWatching() const;
+
+    /**
+     * @brief 读取歌词文本
+     * @details 自动识别BOM，无BOM时按UTF-8解码，失败则按本地编码
+     * @return 歌词内容，无歌词文件时为空
+     */
+    Q_INVOKABLE QString loadLyricsText(const QString &source) const;
+
+    /**
+     * @brief 查找歌词文件
+     * @details 查找同目录或lyrics子目录下的同名.lrc文件
+     * @return 歌词文件URL，不存在时为空
+     */
+    Q_INVOKABLE QString findLyricsFileForSource(const QString &source) const;
+
+    /**
+     * @brief 将URL或路径转为本地路径
+     */
+    static QString toLocalPath(const QString &source);
+
+signals:
+    /**
+     * @brief 元数据可用
+     * @param source 与prefetchMetadata/prioritize传入时相同的字符串
+     */
+    void metadataReady(const QString &source, const QVariantMap &meta);
+
+    /**
+     * @brief 监控目录内容变化
+     * @param newFiles 变化后的完整文件列表
+     */
+    void musicFilesChanged(const QStringList &newFiles);
+    void fileAdded(const QString &filePath);
+    void fileRemoved(const QString &filePath);
+
+private:
+    QStringList scanDirectory(const QString &directory, bool recursive) const;
+    void request(const QStringList &sources, bool urgent);
+    void onTrackReady(const QString &path, const QVariantMap &meta);
+    void rescanWatched();
+    void updateWatchedDirectories();
+
+    QHash<QString, QStringList> m_requested;    ///< 本地路径 -> 调用方传入的字符串
+    QStringList m_roots;
+    bool m_recursive;
+    QStringList m_knownFiles;
+    QFileSystemWatcher *m_watcher;
+    QTimer *m_rescanTimer;
+};
+
+#endif
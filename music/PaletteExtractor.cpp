@@ -0,0 +1,179 @@
+#include "PaletteExtractor.h"
+#include <QBuffer>
+#include <QImage>
+#include <QImageReader>
+#include <algorithm>
+#include <array>
+#include <vector>
+
+namespace {
+
+constexpr int SAMPLE_SIZE = 48;
+constexpr int HUE_BINS = 36;
+
+/**
+ * @brief 像素分类
+ */
+enum Swatch : quint8 {
+    SwatchNone = 0,
+    SwatchVivid,                ///< s>0.15且0.15<v<0.95，用于主色
+    SwatchMuted,                ///< 0.05<s<=0.40且0.30<=v<=0.85
+    SwatchDark,                 ///< s>0.10且0.05<v<=0.40
+    SwatchCount
+};
+
+/**
+ * @brief 每个分类的色相直方图
+ */
+struct Histogram {
+    std::array<int, HUE_BINS> counts{};
+    std::array<qint64, HUE_BINS> sumR{};
+    std::array<qint64, HUE_BINS> sumG{};
+    std::array<qint64, HUE_BINS> sumB{};
+
+    /**
+     * @brief 占比最大一档的平均色
+     */
+    QColor dominant() const
+    {
+        const auto best = std::max_element(counts.cbegin(), counts.cend());
+        if (*best == 0) {
+            return QColor();
+        }
+        const int bin = static_cast<int>(best - counts.cbegin());
+        const int n = *best;
+        return QColor(static_cast<int>(sumR[bin] / n), static_cast<int>(sumG[bin] / n), static_cast<int>(sumB[bin] / n));
+    }
+};
+
+/**
+ * @brief 按HSL限制饱和度与亮度
+ */
+QColor adjust(const QColor &color, float minL, float maxL, float minS, float maxS)
+{
+    float h = 0;
+    float s = 0;
+    float l = 0;
+    color.getHslF(&h, &s, &l);
+    // 原本几乎无色的不强行上色
+    if (s > 0.1f) {
+        s = std::clamp(s, minS, maxS);
+    } else {
+        s = std::min(s, maxS);
+    }
+    l = std::clamp(l, minL, maxL);
+    return QColor::fromHslF(h, s, l);
+}
+
+} // namespace
+
+namespace PaletteExtractor {
+
+Palette fromImage(const QImage &source)
+{
+    if (source.isNull()) {
+        return Palette();
+    }
+    QImage image = source;
+    if (image.width() > SAMPLE_SIZE || image.height() > SAMPLE_SIZE) {
+        image = image.scaled(SAMPLE_SIZE, SAMPLE_SIZE, Qt::KeepAspectRatio, Qt::SmoothTransformation);
+    }
+    image = image.convertToFormat(QImage::Format_ARGB32);
+
+    const int width = image.width();
+    const int n = width * image.height();
+    std::vector<int> r(n), g(n), b(n), a(n);
+    for (int y = 0; y < image.height(); ++y) {
+        const QRgb *line = reinterpret_cast<const QRgb *>(image.constScanLine(y));
+        const int offset = y * width;
+        for (int x = 0; x < width; ++x) {
+            const QRgb p = line[x];
+            a[offset + x] = static_cast<int>(p >> 24);
+            r[offset + x] = static_cast<int>((p >> 16) & 0xff);
+            g[offset + x] = static_cast<int>((p >> 8) & 0xff);
+            b[offset + x] = static_cast<int>(p & 0xff);
+        }
+    }
+
+    // 分类与色相分档：全部为逐元素运算，阈值以整数比较代替除法
+    std::vector<quint8> swatch(n), bin(n);
+    for (int i = 0; i < n; ++i) {
+        const int mx = std::max(r[i], std::max(g[i], b[i]));
+        const int mn = std::min(r[i], std::min(g[i], b[i]));
+        const int d = mx - mn;
+        // s = d/mx，v = mx/255
+        const bool opaque = a[i] > 0;
+        const bool vivid = opaque && d * 100 > 15 * mx && mx * 100 > 15 * 255 && mx * 100 < 95 * 255;
+        const bool muted = opaque && d * 100 > 5 * mx && d * 100 <= 40 * mx && mx * 100 >= 30 * 255 && mx * 100 <= 85 * 255;
+        const bool dark = opaque && d * 100 > 10 * mx && mx * 100 > 5 * 255 && mx * 100 <= 40 * 255;
+        swatch[i] = vivid ? SwatchVivid : (muted ? SwatchMuted : (dark ? SwatchDark : SwatchNone));
+
+        const float fd = d > 0 ? static_cast<float>(d) : 1.0f;
+        float h = mx == r[i] ? (g[i] - b[i]) / fd
+                : (mx == g[i] ? (b[i] - r[i]) / fd + 2.0f : (r[i] - g[i]) / fd + 4.0f);
+        h = h < 0.0f ? h + 6.0f : h;
+        bin[i] = static_cast<quint8>(std::min(HUE_BINS - 1, static_cast<int>(h * (HUE_BINS / 6.0f))));
+    }
+
+    std::array<Histogram, SwatchCount> histograms;
+    qint64 totalR = 0;
+    qint64 totalG = 0;
+    qint64 totalB = 0;
+    int totalN = 0;
+    for (int i = 0; i < n; ++i) {
+        Histogram &hist = histograms[swatch[i]];
+        const int k = bin[i];
+        ++hist.counts[k];
+        hist.sumR[k] += r[i];
+        hist.sumG[k] += g[i];
+        hist.sumB[k] += b[i];
+        if (a[i] > 0) {
+            totalR += r[i];
+            totalG += g[i];
+            totalB += b[i];
+            ++totalN;
+        }
+    }
+    if (totalN == 0) {
+        return Palette();
+    }
+
+    // 没有鲜艳像素时退回整体平均色
+    QColor prominent = histograms[SwatchVivid].dominant();
+    if (!prominent.isValid()) {
+        prominent = QColor(static_cast<int>(totalR / totalN), static_cast<int>(totalG / totalN), static_cast<int>(totalB / totalN));
+    }
+    QColor muted = histograms[SwatchMuted].dominant();
+    if (!muted.isValid()) {
+        muted = prominent;
+    }
+    QColor dark = histograms[SwatchDark].dominant();
+    if (!dark.isValid()) {
+        dark = prominent;
+    }
+
+    Palette palette;
+    palette.prominent = adjust(prominent, 0.35f, 0.75f, 0.3f, 1.0f);
+    palette.muted = adjust(muted, 0.45f, 0.70f, 0.1f, 0.35f);
+    palette.dark = adjust(dark, 0.10f, 0.25f, 0.2f, 0.6f);
+    return palette;
+}
+
+Palette fromData(const QByteArray &data)
+{
+    if (data.isEmpty()) {
+        return Palette();
+    }
+    QBuffer buffer;
+    buffer.setData(data);
+    buffer.open(QIODevice::ReadOnly);
+    QImageReader reader(&buffer);
+    const QSize size = reader.size();
+    if (size.isValid() && (size.width() > SAMPLE_SIZE || size.height() > SAMPLE_SIZE)) {
+        // JPEG可在解码时按比例缩小，无需先解出整幅封面
+        reader.setScaledSize(size.scaled(SAMPLE_SIZE, SAMPLE_SIZE, Qt::KeepAspectRatio));
+    }
+    return fromImage(reader.read());
+}
+
+} // namespace PaletteExtractor
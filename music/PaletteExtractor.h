@@ -0,0 +1,41 @@
+#ifndef PALETTEEXTRACTOR_H
+#define PALETTEEXTRACTOR_H
+
+#include <QColor>
+#include <QByteArray>
+
+class QImage;
+
+/**
+ * @brief 封面色板
+ */
+struct Palette {
+    QColor prominent;           ///< 主色：高饱和度色相中占比最大者，亮度限制在0.35~0.75
+    QColor muted;               ///< 柔和色：低饱和度中等亮度
+    QColor dark;                ///< 暗色：适合作深色背景
+
+    bool isValid() const { return prominent.isValid(); }
+};
+
+/**
+ * @brief 封面取色
+ * @details 图片先缩小到48x48以内再统计，主色按10°一档的色相直方图选取，
+ *          与原先EMusicPlayer中Canvas取色的规则一致。像素循环按分量数组展开、
+ *          分类与分档采用无分支写法，便于编译器向量化。可在任意线程调用
+ */
+namespace PaletteExtractor {
+
+/**
+ * @brief 从图片取色
+ * @return 色板，图片为空或全透明时无效
+ */
+Palette fromImage(const QImage &image);
+
+/**
+ * @brief 从编码后的图片数据取色（解码时直接缩小）
+ */
+Palette fromData(const QByteArray &data);
+
+} // namespace PaletteExtractor
+
+#endif
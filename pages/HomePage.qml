@@ -20,6 +20,15 @@ Page {
     /** @brief 动画窗口别名，用于页面切换动画 */
     property alias animatedWindow: animationWrapper
 
+    /** @brief Modbus管理器别名，供其他页面订阅采样数据 */
+    property alias modbusManager: modbusManager
+
+    /** @brief 多总线采集池别名，由设置页配置与启停 */
+    property alias busPool: busPool
+
+    /** @brief 实时数据发布服务别名，由设置页启停 */
+    property alias livePublisher: livePublisher
+
     /** @brief 当前选中的串口索引，-1表示未选中 */
     property int selectedSerialPortIndex: -1
 
@@ -50,13 +59,16 @@ Page {
      */
     property bool dataUpdatePending: false
 
+    /** @brief 100ms内最新一个样本的时刻（modbusManager.sampleTimeUs()，微秒），随数据点送入波形 */
+    property real pendingSampleUs: 0
+
     Timer {
         id: dataUpdateTimer
         interval: 100
         repeat: false
         onTriggered: {
             if (modbusManager.voltage > 0 || modbusManager.current > 0 || modbusManager.power > 0) {
-                waveformDataManager.addDataPoint(modbusManager.voltage, modbusManager.current, modbusManager.power)
+                waveformDataManager.addDataPoint(modbusManager.voltage, modbusManager.current, modbusManager.power, window.pendingSampleUs)
             }
             window.dataUpdatePending = false
         }
@@ -65,7 +77,17 @@ Page {
     ModbusManager {
         id: modbusManager
 
-        onVoltageChanged: {
+        onSampleReady: function(voltage, current, power, timestampNs) {
+            // timestampNs转为number后只精确到256ns，改取C++换算的同一样本时刻
+            var sampleTimeUs = modbusManager.sampleTimeUs()
+            // 回放时每个采样单独上图，最快速度回放测得的是完整的波形路径
+            if (!waveformDataManager.mergeInput) {
+                if (voltage > 0 || current > 0 || power > 0) {
+                    waveformDataManager.addDataPoint(voltage, current, power, sampleTimeUs)
+                }
+                return
+            }
+            window.pendingSampleUs = sampleTimeUs
             if (!window.dataUpdatePending) {
                 window.dataUpdatePending = true
                 dataUpdateTimer.start()
@@ -77,6 +99,37 @@ Page {
         }
     }
 
+    /**
+     * @brief 多总线采集池
+     * 各串口并行轮询，时间对齐后的前三个通道作为电压、电流、功率注入Modbus管理器，
+     * 与单总线采样走同一路径进入波形与记录
+     */
+    ModbusBusPool {
+        id: busPool
+        modbusManager: modbusManager
+
+        onErrorOccurred: function(bus, error) {
+            console.log("多总线错误:", bus, error)
+        }
+    }
+
+    /**
+     * @brief 实时数据发布服务
+     * 订阅Modbus管理器的每个采样，经本地套接字推送给MES采集程序与测试脚本；
+     * 随程序启动，服务名称已被其他实例占用时报错而不抢占
+     */
+    LivePublisher {
+        id: livePublisher
+        modbusManager: modbusManager
+        serverName: "demo3-live"
+
+        Component.onCompleted: start()
+
+        onErrorOccurred: function(error) {
+            console.log("实时数据发布错误:", error)
+        }
+    }
+
     /**
      * @brief 更新串口下拉框数据模型
      * 将串口管理器返回的端口列表转换为下拉框可用的格式
@@ -5,19 +5,36 @@ import EvolveUI
 
 Page {
     property var animWindowRef
+    // 多总线采集池（首页创建，合并样本注入首页的Modbus管理器）
+    property var busPool: null
+    // 实时数据发布服务（首页创建并随程序启动）
+    property var livePublisher: null
     padding: 20
     background: Rectangle {
         color: "transparent"
     }
 
-    Label {
-        text: "Settings Page"
-        anchors.centerIn: parent
-        font.pixelSize: 24
-        color: theme.textColor
+    // 串口调试终端，独立于Modbus连接使用；端口由用户手动打开关闭，断开后不自动重连
+    SerialPortManager {
+        id: terminalPort
+        autoReconnect: false
+        onErrorOccurred: function(error) {
+            terminalErrorDialog.message = "终端串口错误：" + error
+            terminalErrorDialog.open()
+        }
+    }
+
+    // 终端串口错误提示
+    EAlertDialog {
+        id: terminalErrorDialog
+        title: "串口错误"
+        message: ""
+        confirmText: "确定"
+        cancelText: ""
     }
-  
+
     ColumnLayout {
+        anchors.fill: parent
         spacing: 10
 
         EButton {
@@ -26,7 +43,211 @@ Page {
         iconRotateOnClick: true
         onClicked: theme.toggleTheme()
         }
-    }
 
-    
+        RowLayout {
+            spacing: 10
+
+            EDropdown {
+                id: terminalPortDropdown
+                title: "终端串口"
+                Layout.preferredWidth: 200
+                model: terminalPort.availablePorts.map(function(name) { return { text: name } })
+            }
+
+            EDropdown {
+                id: terminalBaudDropdown
+                title: "波特率"
+                Layout.preferredWidth: 160
+                selectedIndex: 2
+                model: [{ text: "9600" }, { text: "57600" }, { text: "115200" }, { text: "460800" }, { text: "1000000" }]
+            }
+
+            EButton {
+                text: terminalPort.isConnected ? "关闭" : "打开"
+                size: "s"
+                onClicked: {
+                    if (terminalPort.isConnected) {
+                        terminalPort.closePort()
+                    } else if (terminalPortDropdown.selectedIndex >= 0) {
+                        terminalPort.openPort(terminalPort.availablePorts[terminalPortDropdown.selectedIndex],
+                                              parseInt(terminalBaudDropdown.model[Math.max(terminalBaudDropdown.selectedIndex, 0)].text))
+                    }
+                }
+            }
+        }
+
+        // 实时数据发布：本地套接字推送每个采样，可选允许订阅者写入设定值
+        RowLayout {
+            spacing: 10
+
+            ESwitchButton {
+                text: "实时数据发布"
+                size: "s"
+                enabled: livePublisher !== null
+                checked: livePublisher ? livePublisher.running : false
+                onToggled: function(checked) {
+                    if (checked) {
+                        livePublisher.start()
+                    } else {
+                        livePublisher.stop()
+                    }
+                }
+            }
+
+            ESwitchButton {
+                text: "允许写入设定值"
+                size: "s"
+                enabled: livePublisher !== null
+                checked: livePublisher ? livePublisher.acceptSetPoints : false
+                onToggled: function(checked) {
+                    livePublisher.acceptSetPoints = checked
+                }
+            }
+
+            Text {
+                Layout.fillWidth: true
+                color: "#9E9E9E"
+                font.pixelSize: 12
+                text: livePublisher && livePublisher.running
+                      ? livePublisher.serverName + "  订阅者 " + livePublisher.subscriberCount : "未发布"
+            }
+        }
+
+        // 多总线采集：每条总线以分号分隔，如 COM3:9600 电压=1/0*0.1 电流=2/0*0.1; COM4 功率=3/0*0.01
+        RowLayout {
+            spacing: 10
+
+            EInput {
+                id: busSpecInput
+                Layout.fillWidth: true
+                Layout.preferredHeight: 36
+                fontSize: 13
+                placeholderText: "多总线：串口[:波特率[:校验]] 通道=从站/寄存器[*系数]; ..."
+            }
+
+            EButton {
+                text: busPool && busPool.running ? "停止采集" : "多总线采集"
+                size: "s"
+                enabled: busPool !== null
+                onClicked: {
+                    if (busPool.running) {
+                        busPool.stop()
+                    } else if (busPool.configure(busSpecInput.text)) {
+                        busPool.start(100)
+                    }
+                }
+            }
+        }
+
+        // 各总线状态，采集期间每秒刷新
+        Text {
+            id: busStatsText
+            Layout.fillWidth: true
+            color: "#9E9E9E"
+            font.pixelSize: 12
+            visible: text !== ""
+
+            Timer {
+                interval: 1000
+                repeat: true
+                running: busPool !== null && busPool.running
+                onTriggered: {
+                    var parts = []
+                    var stats = busPool.busStatistics()
+                    for (var i = 0; i < stats.length; i++) {
+                        parts.push(stats[i].port + (stats[i].connected ? " 已连接" : " 未连接")
+                                   + " 周期 " + (stats[i].avgCycleUs / 1000).toFixed(1) + "ms"
+                                   + " 超限 " + stats[i].overruns + " 错误 " + stats[i].errors)
+                    }
+                    busStatsText.text = parts.join("    ")
+                }
+            }
+
+            Connections {
+                target: busPool
+                function onErrorOccurred(bus, error) {
+                    busStatsText.text = (bus >= 0 ? "总线 " + bus + " " : "") + error
+                }
+            }
+        }
+
+        ESerialTerminal {
+            Layout.fillWidth: true
+            Layout.fillHeight: true
+            terminal: terminalPort.terminal
+        }
+
+        // 发送：十六进制数据，单次或按周期发送
+        RowLayout {
+            spacing: 10
+
+            EInput {
+                id: sendInput
+                Layout.fillWidth: true
+                Layout.preferredHeight: 36
+                fontSize: 13
+                placeholderText: "十六进制数据，如 01 03 00 00 00 0A"
+                onAccepted: terminalPort.sendHex(text)
+            }
+
+            EInput {
+                id: periodInput
+                Layout.preferredWidth: 110
+                Layout.preferredHeight: 36
+                fontSize: 13
+                placeholderText: "周期(ms)"
+            }
+
+            EButton {
+                text: "发送"
+                size: "s"
+                onClicked: terminalPort.sendHex(sendInput.text)
+            }
+
+            EButton {
+                text: terminalPort.sending ? "停止" : "定时发送"
+                size: "s"
+                onClicked: {
+                    if (terminalPort.sending) {
+                        terminalPort.stopSending()
+                    } else {
+                        terminalPort.startPeriodicSend(sendInput.text, parseFloat(periodInput.text))
+                    }
+                }
+            }
+        }
+
+        // 定时发送统计，发送期间每秒刷新
+        Text {
+            id: sendStatsText
+            Layout.fillWidth: true
+            color: "#9E9E9E"
+            font.pixelSize: 12
+            visible: text !== ""
+
+            function refresh() {
+                var s = terminalPort.sendStatistics()
+                if (s.sent === 0 && s.missed === 0) {
+                    text = ""
+                    return
+                }
+                text = "已发送 " + s.sent + "  跳过 " + s.missed
+                        + "  速率 " + s.achievedRate.toFixed(1) + " / " + s.requestedRate.toFixed(1) + " 次/秒"
+                        + "  延迟 平均 " + s.avgLatenessUs.toFixed(0) + "µs 最大 " + s.maxLatenessUs.toFixed(0) + "µs"
+                        + "  排队 " + s.bytesQueued + " B"
+            }
+
+            Timer {
+                interval: 1000
+                repeat: true
+                running: terminalPort.sending
+                onTriggered: sendStatsText.refresh()
+            }
+
+            Connections {
+                target: terminalPort
+                function onSendingChanged() { sendStatsText.refresh() }
+            }
+        }
+    }
 }
@@ -14,6 +14,65 @@ Page {
     // 动画窗口属性别名，用于外部访问
     property alias animatedWindow: animationWrapper
 
+    // Modbus管理器（由Main.qml传入），触发捕获订阅其采样
+    property var modbusManager: null
+
+    // 触发捕获波形数据
+    property var captureChartData: [{ name: "捕获", color: "#E91E63", data: [] }]
+
+    // 触发捕获器
+    TriggerCapture {
+        id: triggerCapture
+        modbusManager: root.modbusManager
+        triggerSource: TriggerCapture.VoltageLevel
+        triggerEdge: TriggerCapture.AnyEdge
+        preTriggerSamples: 200
+        postTriggerSamples: 500
+
+        onCaptureFinished: {
+            root.updateCaptureChart()
+        }
+
+        onSaveFinished: function(success, filePath) {
+            exportSuccessDialog.message = success ? "触发捕获已保存到：\n" + filePath : "捕获保存失败，请检查文件路径"
+            exportSuccessDialog.open()
+        }
+    }
+
+    // 根据冻结的捕获窗口生成图表数据（按触发源显示对应通道）
+    function updateCaptureChart() {
+        var channel = triggerCapture.triggerSource === TriggerCapture.CurrentStep ? 1 : 0
+        var units = ["V", "A", "kW"]
+        var values = triggerCapture.capturedValues(channel)
+        var offsets = triggerCapture.capturedTimeOffsets()
+        var data = []
+        for (var i = 0; i < values.length; i++) {
+            var label = offsets[i] + "ms"
+            data.push({
+                month: label,
+                value: values[i],
+                label: label + " " + values[i].toFixed(1) + units[channel]
+            })
+        }
+        root.captureChartData = [{ name: "捕获", color: "#E91E63", data: data }]
+    }
+
+    // 捕获文件保存对话框
+    LabsPlatform.FileDialog {
+        id: captureFileDialog
+        title: "保存触发捕获"
+        fileMode: LabsPlatform.FileDialog.SaveFile
+        defaultSuffix: "lbcp"
+        nameFilters: ["捕获文件 (*.lbcp)", "所有文件 (*)"]
+        onAccepted: {
+            var filePath = captureFileDialog.file.toString()
+            if (filePath.startsWith("file:///")) {
+                filePath = filePath.substring(8)
+            }
+            triggerCapture.saveCapture(filePath)
+        }
+    }
+
     // 数据记录器
     DataRecorder {
         id: dataRecorder
@@ -30,6 +89,12 @@ Page {
         }
     }
 
+    // 报表记录表格模型（直接读取数据记录器存储）
+    RecordTableModel {
+        id: recordTableModel
+        recorder: dataRecorder
+    }
+
     // 文件保存对话框
     LabsPlatform.FileDialog {
         id: fileDialog
@@ -49,6 +114,120 @@ Page {
         }
     }
 
+    // 会话导入器：加载历史CSV作为对比曲线
+    SessionImporter {
+        id: sessionImporter
+
+        onLoadFinished: function(success, error) {
+            if (success) {
+                waveformDataManager.setComparison(sessionImporter)
+            } else {
+                exportSuccessDialog.message = "导入失败：" + error
+                exportSuccessDialog.open()
+            }
+        }
+    }
+
+    // 对比会话选择对话框
+    LabsPlatform.FileDialog {
+        id: importDialog
+        title: "导入对比会话"
+        fileMode: LabsPlatform.FileDialog.OpenFile
+        nameFilters: ["CSV文件 (*.csv)", "所有文件 (*)"]
+        onAccepted: {
+            sessionImporter.load(importDialog.file.toString())
+        }
+    }
+
+    // 压力测试记录器：每个样本一行流式写入临时文件，测量样本到落盘的延迟，不影响报表记录
+    DataRecorder {
+        id: stressRecorder
+        interval: 0
+        retainRecords: false
+
+        onStreamError: function(error) {
+            signalGenerator.stop()
+            exportSuccessDialog.message = "压力测试记录写入失败：" + error
+            exportSuccessDialog.open()
+        }
+    }
+
+    // 合成信号源：经首页的Modbus管理器注入，与真实采样走同一路径
+    SignalGenerator {
+        id: signalGenerator
+        modbusManager: root.modbusManager
+        dataRecorder: stressRecorder
+        sampleRate: 1000
+    }
+
+    // 开始/停止压力测试
+    function toggleStressTest() {
+        if (signalGenerator.running) {
+            signalGenerator.stop()
+            stressRecorder.stopRecording()
+            stressRecorder.stopStreaming()
+            return
+        }
+        var dir = StandardPaths.writableLocation(StandardPaths.TempLocation).toString()
+        if (dir.startsWith("file:///")) {
+            dir = dir.substring(8)
+        }
+        if (!stressRecorder.startStreaming(dir + "/demo3-stress.csv")) {
+            return
+        }
+        stressRecorder.startRecording()
+        signalGenerator.resetStatistics()
+        signalGenerator.trackWindow(root.Window.window)
+        signalGenerator.start()
+    }
+
+    // 会话回放：经首页的Modbus管理器注入，回放期间关闭首页的合并刷新，每个样本单独上图
+    SessionReplay {
+        id: sessionReplay
+        modbusManager: root.modbusManager
+
+        onPlayingChanged: {
+            waveformDataManager.mergeInput = !playing
+        }
+
+        Component.onDestruction: {
+            waveformDataManager.mergeInput = true
+        }
+
+        onBenchmarkFinished: function(samples, elapsedMs, samplesPerSecond) {
+            exportSuccessDialog.message = "最快速度回放 " + samples + " 条，耗时 " + elapsedMs.toFixed(1)
+                    + " ms，吞吐 " + samplesPerSecond.toFixed(0) + " 条/秒\n（含每个样本的波形历史更新，图表每帧重新生成一次）"
+            exportSuccessDialog.open()
+        }
+
+        onErrorOccurred: function(error) {
+            exportSuccessDialog.message = "回放失败：" + error
+            exportSuccessDialog.open()
+        }
+    }
+
+    // 回放会话选择对话框
+    LabsPlatform.FileDialog {
+        id: replayDialog
+        title: "回放会话"
+        fileMode: LabsPlatform.FileDialog.OpenFile
+        nameFilters: ["CSV文件 (*.csv)", "所有文件 (*)"]
+        onAccepted: {
+            var filePath = replayDialog.file.toString()
+            if (filePath.startsWith("file:///")) {
+                filePath = filePath.substring(8)
+            }
+            if (sessionReplay.load(filePath)) {
+                sessionReplay.play()
+            }
+        }
+    }
+
+    // 延迟统计的显示文本
+    function latencyText(latency) {
+        return latency.count > 0 ? (latency.avgUs / 1000).toFixed(1) + "/" + (latency.maxUs / 1000).toFixed(1) + "ms" : "-"
+    }
+
     // 导出成功对话框
     EAlertDialog {
         id: exportSuccessDialog
@@ -82,25 +261,11 @@ Page {
         }
     }
 
-    // 实时更新数据 - 从波形数据管理器获取最新值
-    Timer {
-        interval: 100
-        running: true
-        repeat: true
-        onTriggered: {
-            var voltage = 0
-            var current = 0
-            var power = 0
-            if (waveformDataManager.voltageHistory && waveformDataManager.voltageHistory.length > 0) {
-                voltage = waveformDataManager.voltageHistory[waveformDataManager.voltageHistory.length - 1]
-            }
-            if (waveformDataManager.currentHistory && waveformDataManager.currentHistory.length > 0) {
-                current = waveformDataManager.currentHistory[waveformDataManager.currentHistory.length - 1]
-            }
-            if (waveformDataManager.powerHistory && waveformDataManager.powerHistory.length > 0) {
-                power = waveformDataManager.powerHistory[waveformDataManager.powerHistory.length - 1]
-            }
-            dataRecorder.addData(voltage, current, power)
+    // 每个采样点连同其到达时刻直接送入记录器，不经过首页的界面刷新合并，页面隐藏时照常记录
+    Connections {
+        target: root.modbusManager
+        function onSampleReady(voltage, current, power, timestampNs) {
+            dataRecorder.addData(voltage, current, power, timestampNs)
         }
     }
 
@@ -124,7 +289,7 @@ Page {
             width: scrollView.width - scrollView.ScrollBar.vertical.width
             height: contentHeight
             // 计算内容高度，确保所有图表都能显示
-            contentHeight: column.children.length > 0 ? column.children[0].height + column.children[1].height + column.children[2].height + column.children[3].height + 32 : 600
+            contentHeight: column.height > 0 ? column.height + 8 : 600
 
             // 垂直布局容器
             Column {
@@ -191,6 +356,30 @@ Page {
                         }
                     }
 
+                    // 导入对比会话按钮（已有对比曲线时清除）
+                    EButton {
+                        id: importButton
+                        text: sessionImporter.loading ? "导入中 " + Math.round(sessionImporter.progress * 100) + "%"
+                                                      : (sessionImporter.rowCount > 0 ? "清除对比" : "导入对比")
+                        iconCharacter: "\uf56f"
+                        size: "s"
+                        containerColor: theme.secondaryColor
+                        textColor: theme.textColor
+                        iconColor: theme.textColor
+                        shadowEnabled: true
+                        onClicked: {
+                            if (sessionImporter.loading) {
+                                return
+                            }
+                            if (sessionImporter.rowCount > 0) {
+                                sessionImporter.clear()
+                                waveformDataManager.clearComparison()
+                            } else {
+                                importDialog.open()
+                            }
+                        }
+                    }
+
                     // 清除波形图按钮
                     EButton {
                         id: clearWaveformButton
@@ -303,6 +492,297 @@ Page {
                     subtitleFontSize: 10  // 副标题字体大小
                     startFromFirstValue: true  // 从第一个值开始绘制
                 }
+
+                // 报表记录表格（虚拟化，仅创建可见行）
+                EDataTableView {
+                    id: recordTable
+                    x: 5
+                    width: parent.width - 10
+                    height: 320
+                    model: recordTableModel
+                    selectable: true
+                    headers: recordTableModel.headers
+                }
+
+                // 触发捕获控制行
+                RowLayout {
+                    width: parent.width
+                    height: 60
+                    spacing: 16
+
+                    // 左侧空白占位
+                    Item {
+                        width: 10
+                        height: 10
+                    }
+
+                    // 触发源选择
+                    EDropdown {
+                        id: triggerSourceDropdown
+                        z: 5
+                        title: "触发源"
+                        Layout.preferredWidth: 150
+                        headerHeight: 40
+                        radius: 20
+                        containerColor: theme.secondaryColor
+                        textColor: theme.textColor
+                        shadowEnabled: true
+                        popupDirection: 1
+                        enabled: triggerCapture.state !== TriggerCapture.Armed && triggerCapture.state !== TriggerCapture.Triggered
+                        model: [
+                            { text: "电压穿越" },
+                            { text: "电流阶跃" },
+                            { text: "高温报警" }
+                        ]
+                        Component.onCompleted: {
+                            selectedIndex = 0
+                        }
+                        onSelectionChanged: function(index) {
+                            triggerCapture.triggerSource = index
+                        }
+                    }
+
+                    // 触发电平输入
+                    EInput {
+                        id: triggerLevelInput
+                        Layout.preferredWidth: 120
+                        placeholderText: triggerCapture.triggerSource === TriggerCapture.CurrentStep ? "阶跃(A)" : "电平(V)"
+                        readOnly: triggerCapture.triggerSource === TriggerCapture.HighTempEdge
+                        onAccepted: {
+                            var level = parseFloat(text)
+                            if (!isNaN(level)) {
+                                triggerCapture.triggerLevel = level
+                            }
+                        }
+                    }
+
+                    // 布防/撤防按钮
+                    EButton {
+                        text: triggerCapture.state === TriggerCapture.Armed ? "等待触发..." :
+                              triggerCapture.state === TriggerCapture.Triggered ? "采集中..." : "布防"
+                        iconCharacter: "\uf0e7"
+                        size: "s"
+                        containerColor: (triggerCapture.state === TriggerCapture.Armed || triggerCapture.state === TriggerCapture.Triggered) ? "#f59e0b" : theme.secondaryColor
+                        textColor: theme.textColor
+                        iconColor: theme.textColor
+                        shadowEnabled: true
+                        onClicked: {
+                            if (triggerCapture.state === TriggerCapture.Armed || triggerCapture.state === TriggerCapture.Triggered) {
+                                triggerCapture.disarm()
+                            } else {
+                                var level = parseFloat(triggerLevelInput.text)
+                                if (!isNaN(level)) {
+                                    triggerCapture.triggerLevel = level
+                                }
+                                if (!triggerCapture.arm() && triggerCapture.triggerSource === TriggerCapture.CurrentStep) {
+                                    exportSuccessDialog.message = "电流阶跃阈值必须大于 0"
+                                    exportSuccessDialog.open()
+                                }
+                            }
+                        }
+                    }
+
+                    // 保存捕获按钮
+                    EButton {
+                        text: "保存捕获"
+                        iconCharacter: "\uf0c7"
+                        size: "s"
+                        containerColor: theme.secondaryColor
+                        textColor: theme.textColor
+                        iconColor: theme.textColor
+                        shadowEnabled: true
+                        enabled: triggerCapture.state === TriggerCapture.Captured
+                        onClicked: {
+                            captureFileDialog.open()
+                        }
+                    }
+
+                    // 自适应采样：数值变化或写入后加速轮询，稳定后降回轮询间隔
+                    ESwitchButton {
+                        text: "自适应采样"
+                        size: "s"
+                        containerColor: theme.secondaryColor
+                        textColor: theme.textColor
+                        thumbColor: "#FFFFFF"
+                        trackUncheckedColor: theme.isDark ? "#555555" : "#CCCCCC"
+                        trackCheckedColor: theme.isDark ? "#66BB6A" : "#4CAF50"
+                        shadowEnabled: true
+                        enabled: modbusManager !== null
+                        checked: modbusManager ? modbusManager.adaptiveSampling : false
+                        onToggled: function(checked) {
+                            if (modbusManager) modbusManager.adaptiveSampling = checked
+                        }
+                    }
+
+                    // 捕获状态显示
+                    Text {
+                        Layout.fillWidth: true
+                        horizontalAlignment: Text.AlignRight
+                        text: triggerCapture.state === TriggerCapture.Captured ?
+                                  "已捕获: " + triggerCapture.captureCount + " 点" :
+                                  (modbusManager && modbusManager.burstActive ? "突发轮询中" : "")
+                        color: theme.textColor
+                        font.pixelSize: 12
+                    }
+                }
+
+                // 触发捕获波形图表（冻结窗口）
+                EAreaChart {
+                    id: captureChart
+                    x: 5
+                    width: parent.width - 10
+                    height: 280
+                    title: "触发捕获"
+                    subtitle: "触发前后波形（时间相对触发点）"
+                    dataSeries: root.captureChartData  // 数据系列
+                    lineStyle: EAreaChart.LineStyle.Linear  // 直线样式，保留瞬态细节
+                    topPadding: 50  // 顶部内边距
+                    chartPadding: 10  // 图表内边距
+                    titleFontSize: 14  // 标题字体大小
+                    subtitleFontSize: 10  // 副标题字体大小
+                }
+
+                // 压力测试控制行
+                RowLayout {
+                    width: parent.width
+                    height: 60
+                    spacing: 16
+
+                    // 左侧空白占位
+                    Item {
+                        width: 10
+                        height: 10
+                    }
+
+                    // 采样率选择
+                    EDropdown {
+                        id: sampleRateDropdown
+                        z: 5
+                        title: "采样率"
+                        Layout.preferredWidth: 150
+                        headerHeight: 40
+                        radius: 20
+                        containerColor: theme.secondaryColor
+                        textColor: theme.textColor
+                        shadowEnabled: true
+                        popupDirection: 1
+                        enabled: !signalGenerator.running
+                        model: [
+                            { text: "100 Hz" },
+                            { text: "1 kHz" },
+                            { text: "10 kHz" }
+                        ]
+                        Component.onCompleted: {
+                            selectedIndex = 1
+                        }
+                        onSelectionChanged: function(index) {
+                            signalGenerator.sampleRate = [100, 1000, 10000][index]
+                        }
+                    }
+
+                    // 信号发生器开关
+                    EButton {
+                        text: signalGenerator.running ? "停止压力测试" : "压力测试"
+                        iconCharacter: "\uf0e4"
+                        size: "s"
+                        containerColor: signalGenerator.running ? "#f59e0b" : theme.secondaryColor
+                        textColor: theme.textColor
+                        iconColor: theme.textColor
+                        shadowEnabled: true
+                        enabled: root.modbusManager !== null
+                        onClicked: {
+                            root.toggleStressTest()
+                        }
+                    }
+
+                    // 压力测试统计：上图延迟包含首页100ms的合并刷新等待
+                    Text {
+                        id: stressStatsText
+                        Layout.fillWidth: true
+                        horizontalAlignment: Text.AlignRight
+                        color: theme.textColor
+                        font.pixelSize: 12
+                    }
+
+                    Timer {
+                        interval: 1000
+                        repeat: true
+                        running: signalGenerator.running
+                        onTriggered: {
+                            var stats = signalGenerator.statistics()
+                            stressStatsText.text = "实际 " + stats.actualRate.toFixed(0) + " Hz | 跳过 " + stats.lagged
+                                    + " | 上图 " + root.latencyText(stats.pixelLatency)
+                                    + " | 落盘 " + root.latencyText(stats.diskLatency) + "（平均/最大）"
+                        }
+                    }
+                }
+
+                // 会话回放控制行
+                RowLayout {
+                    width: parent.width
+                    height: 60
+                    spacing: 16
+
+                    // 左侧空白占位
+                    Item {
+                        width: 10
+                        height: 10
+                    }
+
+                    // 回放倍速选择
+                    EDropdown {
+                        id: replaySpeedDropdown
+                        z: 5
+                        title: "回放速度"
+                        Layout.preferredWidth: 150
+                        headerHeight: 40
+                        radius: 20
+                        containerColor: theme.secondaryColor
+                        textColor: theme.textColor
+                        shadowEnabled: true
+                        popupDirection: 1
+                        model: [
+                            { text: "实时" },
+                            { text: "10 倍速" },
+                            { text: "最快速度" }
+                        ]
+                        Component.onCompleted: {
+                            selectedIndex = 0
+                        }
+                        onSelectionChanged: function(index) {
+                            sessionReplay.speed = [1, 10, 0][index]
+                        }
+                    }
+
+                    // 回放开关
+                    EButton {
+                        text: sessionReplay.playing ? "停止回放" : "回放会话"
+                        iconCharacter: sessionReplay.playing ? "\uf04d" : "\uf04b"
+                        size: "s"
+                        containerColor: sessionReplay.playing ? "#f59e0b" : theme.secondaryColor
+                        textColor: theme.textColor
+                        iconColor: theme.textColor
+                        shadowEnabled: true
+                        enabled: root.modbusManager !== null
+                        onClicked: {
+                            if (sessionReplay.playing) {
+                                sessionReplay.stop()
+                            } else {
+                                replayDialog.open()
+                            }
+                        }
+                    }
+
+                    // 回放进度
+                    Text {
+                        Layout.fillWidth: true
+                        horizontalAlignment: Text.AlignRight
+                        text: sessionReplay.sampleCount > 0 ?
+                                  (sessionReplay.positionMs / 1000).toFixed(1) + " / " + (sessionReplay.durationMs / 1000).toFixed(1) + " s" : ""
+                        color: theme.textColor
+                        font.pixelSize: 12
+                    }
+                }
             }
         }
     }
@@ -320,6 +800,10 @@ Page {
             voltageChart.dataSeries = waveformDataManager.voltageChartData
             currentChart.dataSeries = waveformDataManager.currentChartData
             powerChart.dataSeries = waveformDataManager.powerChartData
+            // 图表已更新到该样本，下一次帧交换即为包含它的帧
+            if (signalGenerator.running) {
+                signalGenerator.markPlotted(waveformDataManager.latestSampleUs)
+            }
         }
     }
 }
@@ -1,16 +1,23 @@
 #include "DataRecorder.h"
-#include <QDebug>
+#include "../core/Logger.h"
+#include "../core/Metrics.h"
+#include "../core/SampleClock.h"
 #include <QStandardPaths>
 #include <QDir>
+#include <QFileInfo>
+#include <algorithm>
 
 DataRecorder::DataRecorder(QObject *parent)
     : QObject(parent)
     , m_timer(nullptr)
+    , m_streamFile(nullptr)
+    , m_streamedCount(0)
+    , m_retainRecords(true)
+    , m_latest(m_table.channelCount(), 0.0)
+    , m_latestTimeNs(-1)
+    , m_hasNewValues(false)
     , m_recording(false)
     , m_interval(3)
-    , m_lastVoltage(0.0)
-    , m_lastCurrent(0.0)
-    , m_lastPower(0.0)
 {
     m_timer = new QTimer(this);
     connect(m_timer, &QTimer::timeout, this, &DataRecorder::onTimerTimeout);
@@ -21,19 +28,117 @@ DataRecorder::~DataRecorder()
     if (m_timer) {
         m_timer->stop();
     }
+    stopStreaming();
 }
 
 void DataRecorder::setInterval(int seconds)
 {
-    if (m_interval != seconds && seconds > 0) {
+    if (m_interval != seconds && seconds >= 0) {
         m_interval = seconds;
         emit intervalChanged();
         if (m_recording && m_timer) {
-            m_timer->setInterval(m_interval * 1000);
+            if (m_interval > 0) {
+                m_timer->start(m_interval * 1000);
+            } else {
+                m_timer->stop();
+            }
         }
     }
 }
 
+QString DataRecorder::streamFile() const
+{
+    return m_streamFile ? m_streamFile->fileName() : QString();
+}
+
+void DataRecorder::setRetainRecords(bool retain)
+{
+    if (m_retainRecords != retain) {
+        m_retainRecords = retain;
+        emit retainRecordsChanged();
+    }
+}
+
+/**
+ * @brief 已有文件的表头是否与当前通道定义一致
+ */
+bool DataRecorder::headerMatches(const QString &filePath) const
+{
+    QFile file(filePath);
+    if (!file.open(QIODevice::ReadOnly)) {
+        return false;
+    }
+    QByteArray header = file.readLine();
+    if (header.startsWith("\xEF\xBB\xBF")) {
+        header.remove(0, 3);
+    }
+    return header.trimmed() == m_table.csvHeader().trimmed();
+}
+
+bool DataRecorder::startStreaming(const QString &filePath)
+{
+    stopStreaming();
+
+    QFileInfo info(filePath);
+    QDir().mkpath(info.absolutePath());
+    bool isNew = !info.exists() || info.size() == 0;
+    QString path = filePath;
+    // 通道定义变化后追加会得到列数不一致的文件，改写到新文件
+    if (!isNew && !headerMatches(filePath)) {
+        path = info.dir().filePath(QString("%1_%2.%3").arg(info.completeBaseName(),
+                                                           QDateTime::currentDateTime().toString("yyyyMMdd_HHmmss"),
+                                                           info.suffix().isEmpty() ? QStringLiteral("csv") : info.suffix()));
+        LOG_WARNING(Log::Recorder, "文件表头与当前通道定义不一致: {}，改为写入 {}", filePath, path);
+        isNew = true;
+    }
+
+    QFile *file = new QFile(path, this);
+    if (!file->open(QIODevice::WriteOnly | QIODevice::Append)) {
+        LOG_WARNING(Log::Recorder, "无法打开文件: {}", path);
+        emit streamError(file->errorString());
+        delete file;
+        return false;
+    }
+    if (isNew) {
+        file->write("\xEF\xBB\xBF");
+        file->write(m_table.csvHeader());
+        file->flush();
+    }
+
+    m_streamFile = file;
+    m_streamedCount = 0;
+    LOG_INFO(Log::Recorder, "数据流式写入: {}", path);
+    emit streamFileChanged();
+    return true;
+}
+
+void DataRecorder::stopStreaming()
+{
+    if (!m_streamFile) {
+        return;
+    }
+    m_streamFile->close();
+    LOG_INFO(Log::Recorder, "停止流式写入，共写入 {} 条", m_streamedCount);
+    delete m_streamFile;
+    m_streamFile = nullptr;
+    emit streamFileChanged();
+}
+
+void DataRecorder::writeStreamRecord(const RecordTable &table, int row)
+{
+    const QByteArray line = table.csvRow(row);
+    if (m_streamFile->write(line) != line.size() || !m_streamFile->flush()) {
+        const QString error = m_streamFile->errorString();
+        LOG_ERROR(Log::Recorder, "写入记录失败: {}", error);
+        stopStreaming();
+        emit streamError(error);
+        return;
+    }
+    ++m_streamedCount;
+    Metrics::add(Metrics::RecordsWritten);
+    Metrics::add(Metrics::BytesWritten, line.size());
+}
+
 void DataRecorder::startRecording()
 {
     if (m_recording) {
@@ -41,10 +146,12 @@ void DataRecorder::startRecording()
     }
     
     m_recording = true;
-    m_timer->setInterval(m_interval * 1000);
-    m_timer->start();
+    // 间隔为0时由数值更新直接追加，不启动定时器
+    if (m_interval > 0) {
+        m_timer->start(m_interval * 1000);
+    }
     
-    qDebug() << "开始记录数据，间隔:" << m_interval << "秒";
+    LOG_INFO(Log::Recorder, "开始记录数据，间隔: {} 秒", m_interval);
     emit recordingChanged();
 }
 
@@ -57,35 +164,133 @@ void DataRecorder::stopRecording()
     m_recording = false;
     m_timer->stop();
     
-    qDebug() << "停止记录数据，共记录" << m_records.size() << "条";
+    LOG_INFO(Log::Recorder, "停止记录数据，共记录 {} 条", recordCount());
     emit recordingChanged();
 }
 
 void DataRecorder::addData(double voltage, double current, double power)
 {
-    m_lastVoltage = voltage;
-    m_lastCurrent = current;
-    m_lastPower = power;
+    addData(voltage, current, power, SampleClock::nowNs());
+}
+
+void DataRecorder::addData(double voltage, double current, double power, qint64 timestampNs)
+{
+    const double values[] = { voltage, current, power };
+    const int n = qMin(3, static_cast<int>(m_latest.size()));
+    std::copy(values, values + n, m_latest.begin());
+    valuesUpdated(timestampNs);
+}
+
+QVariantList DataRecorder::channels() const
+{
+    QVariantList list;
+    for (const RecordChannel &channel : m_table.channels()) {
+        list.append(channel.toMap());
+    }
+    return list;
+}
+
+bool DataRecorder::setChannels(const QVariantList &channels)
+{
+    QVector<RecordChannel> schema;
+    schema.reserve(channels.size());
+    for (const QVariant &item : channels) {
+        bool ok = false;
+        schema.append(RecordChannel::fromMap(item.toMap(), &ok));
+        if (!ok) {
+            LOG_WARNING(Log::Recorder, "通道定义无效: {}", item.toMap().value("name").toString());
+            return false;
+        }
+    }
+    return setSchema(schema);
+}
+
+bool DataRecorder::setSchema(const QVector<RecordChannel> &channels)
+{
+    if (channels.isEmpty() || m_recording || m_streamFile) {
+        return false;
+    }
+    m_table = RecordTable(channels);
+    m_streamRow = RecordTable(channels);
+    m_latest = QVector<double>(channels.size(), 0.0);
+    m_latestTimeNs = -1;
+    m_hasNewValues = false;
+    LOG_INFO(Log::Recorder, "记录通道: {} 个，每行 {} 字节", channels.size(), m_table.bytesPerRow());
+    emit channelsChanged();
+    emit recordsCleared();
+    emit recordCountChanged();
+    return true;
+}
+
+void DataRecorder::setValue(int channel, double value)
+{
+    if (channel >= 0 && channel < m_latest.size()) {
+        m_latest[channel] = value;
+        valuesUpdated(SampleClock::nowNs());
+    }
+}
+
+void DataRecorder::setValues(const QList<double> &values)
+{
+    setValues(values.constData(), static_cast<int>(values.size()));
+}
+
+void DataRecorder::setValues(const double *values, int count)
+{
+    setValues(values, count, SampleClock::nowNs());
+}
+
+void DataRecorder::setValues(const double *values, int count, qint64 timestampNs)
+{
+    const int n = qMin(count, static_cast<int>(m_latest.size()));
+    std::copy(values, values + n, m_latest.begin());
+    valuesUpdated(timestampNs);
+}
+
+void DataRecorder::valuesUpdated(qint64 timestampNs)
+{
+    m_latestTimeNs = timestampNs;
+    m_hasNewValues = true;
+    if (m_recording && m_interval == 0) {
+        appendRow();
+    }
 }
 
 void DataRecorder::onTimerTimeout()
 {
-    DataRecord record;
-    record.timestamp = QDateTime::currentDateTime();
-    record.voltage = m_lastVoltage;
-    record.current = m_lastCurrent;
-    record.power = m_lastPower;
-    
-    m_records.append(record);
-    
-    QString timeStr = record.timestamp.toString("yyyy-MM-dd HH:mm:ss");
-    qDebug() << QString("记录数据 [%1] 电压: %2 V, 电流: %3 A, 功率: %4 kW")
-                    .arg(timeStr)
-                    .arg(record.voltage, 0, 'f', 2)
-                    .arg(record.current, 0, 'f', 2)
-                    .arg(record.power, 0, 'f', 3);
-    
-    emit dataAdded(timeStr, record.voltage, record.current, record.power);
+    appendRow();
+}
+
+void DataRecorder::appendRow()
+{
+    // 上一行之后没有新数值时不追加，避免断开期间写入时间戳重复的旧值
+    if (!m_hasNewValues) {
+        LOG_DEBUG(Log::Recorder, "记录间隔内没有新数值，跳过");
+        return;
+    }
+    m_hasNewValues = false;
+    const qint64 timeNs = m_latestTimeNs;
+    // 不保留记录时只在单行暂存表中编码，供流式写入格式化
+    RecordTable &target = m_retainRecords ? m_table : m_streamRow;
+    if (!m_retainRecords) {
+        target.clear();
+    }
+    target.append(timeNs, m_latest.constData(), m_latest.size());
+    const int row = target.rowCount() - 1;
+    Metrics::add(Metrics::RecordsAdded);
+    if (m_streamFile) {
+        writeStreamRecord(target, row);
+    }
+
+    LOG_DEBUG(Log::Recorder, "记录数据 {} 个通道，首通道: {:.3f}", m_latest.size(), m_latest.value(0));
+
+    const QString timeStr = SampleClock::formatLocal(timeNs, false);
+    auto channelValue = [this](int channel) { return channel < m_latest.size() ? m_latest.at(channel) : 0.0; };
+    if (m_retainRecords) {
+        emit recordAdded(row);
+    }
+    emit dataAdded(timeStr, channelValue(0), channelValue(1), channelValue(2));
+    emit rowAppended(timeNs);
     emit recordCountChanged();
 }
 
@@ -101,41 +306,33 @@ void DataRecorder::exportToExcel(const QString &filePath)
     
     QFile file(actualPath);
     if (!file.open(QIODevice::WriteOnly | QIODevice::Text)) {
-        qDebug() << "无法打开文件:" << actualPath;
+        LOG_WARNING(Log::Recorder, "无法打开文件: {}", actualPath);
         emit exportFinished(false, actualPath);
         return;
     }
     
-    QTextStream out(&file);
-    out.setEncoding(QStringConverter::Utf8);
-    
-    QByteArray bom = "\xEF\xBB\xBF";
-    file.write(bom);
-    
-    out << "时间,电压(V),电流(A),功率(kW)\n";
-    
-    for (const DataRecord &record : m_records) {
-        out << "'" << record.timestamp.toString("yyyy-MM-dd HH:mm:ss") << ","
-            << QString::number(record.voltage, 'f', 2) << ","
-            << QString::number(record.current, 'f', 2) << ","
-            << QString::number(record.power, 'f', 3) << "\n";
+    file.write("\xEF\xBB\xBF");
+    file.write(m_table.csvHeader());
+    const int rows = m_table.rowCount();
+    for (int row = 0; row < rows; ++row) {
+        file.write(m_table.csvRow(row));
     }
     
     file.close();
     
-    qDebug() << "数据已导出到:" << actualPath;
-    qDebug() << "共导出" << m_records.size() << "条记录";
+    LOG_INFO(Log::Recorder, "数据已导出到: {}，共导出 {} 条记录", actualPath, rows);
     emit exportFinished(true, actualPath);
 }
 
 void DataRecorder::clearData()
 {
-    m_records.clear();
-    qDebug() << "已清除所有记录数据";
+    m_table.clear();
+    LOG_INFO(Log::Recorder, "已清除所有记录数据");
+    emit recordsCleared();
     emit recordCountChanged();
 }
 
 int DataRecorder::recordCount() const
 {
-    return m_records.size();
+    return m_table.rowCount();
 }
@@ -6,21 +6,41 @@
 #include <QDateTime>
 #include <QVector>
 #include <QFile>
-#include <QTextStream>
+#include <QVariantList>
+#include "RecordTable.h"
 
+/**
+ * @brief 单条三通道记录（触发捕获等固定格式场景使用）
+ */
 struct DataRecord {
-    QDateTime timestamp;
+    qint64 timestampNs = 0; ///< 采样到达时刻，UTC纳秒（SampleClock）
     double voltage;
     double current;
     double power;
 };
 
+/**
+ * @brief 数据记录器
+ * @details 记录格式由通道定义决定（默认电压/电流/功率三通道），数据按列存放在RecordTable中。
+ *          addData/setValue/setValues只更新各通道的最新值及其到达时刻，定时器到期时追加一行，
+ *          行时间为所记录数值的到达时刻而不是定时器触发时刻；上一行之后没有新数值（如连接断开）时不追加。
+ *          interval为0时不使用定时器，每次更新数值立即追加一行
+ */
 class DataRecorder : public QObject
 {
     Q_OBJECT
     Q_PROPERTY(bool recording READ recording NOTIFY recordingChanged)
+    /**
+     * @brief 通道定义列表，每项包含name、unit、type、scale、decimals
+     */
+    Q_PROPERTY(QVariantList channels READ channels NOTIFY channelsChanged)
+    /**
+     * @brief 记录间隔（秒），0表示每次更新数值立即追加一行
+     */
     Q_PROPERTY(int interval READ interval WRITE setInterval NOTIFY intervalChanged)
     Q_PROPERTY(int recordCount READ recordCount NOTIFY recordCountChanged)
+    Q_PROPERTY(QString streamFile READ streamFile NOTIFY streamFileChanged)
+    Q_PROPERTY(bool retainRecords READ retainRecords WRITE setRetainRecords NOTIFY retainRecordsChanged)
 
 public:
     explicit DataRecorder(QObject *parent = nullptr);
@@ -29,32 +49,111 @@ public:
     bool recording() const { return m_recording; }
     int interval() const { return m_interval; }
     void setInterval(int seconds);
+    QString streamFile() const;
+    bool retainRecords() const { return m_retainRecords; }
+    void setRetainRecords(bool retain);
 
     Q_INVOKABLE void startRecording();
     Q_INVOKABLE void stopRecording();
     Q_INVOKABLE void exportToExcel(const QString &filePath);
     Q_INVOKABLE void addData(double voltage, double current, double power);
+
+    /**
+     * @brief 更新前三个通道的最新值
+     * @param timestampNs 采样到达时刻（UTC纳秒，SampleClock），如ModbusManager::sampleReady携带的时间戳
+     */
+    Q_INVOKABLE void addData(double voltage, double current, double power, qint64 timestampNs);
+
+    QVariantList channels() const;
+
+    /**
+     * @brief 设置通道定义
+     * @param channels 每项包含name、unit、type（int16/int32/float32/float64/bits16/bits32）、
+     *                 scale（整数类型的换算系数）、decimals
+     * @return 定义无效或正在记录/流式写入时返回false
+     * @details 成功后清空已有记录
+     */
+    Q_INVOKABLE bool setChannels(const QVariantList &channels);
+    bool setSchema(const QVector<RecordChannel> &channels);
+
+    /**
+     * @brief 更新单个通道的最新值
+     */
+    Q_INVOKABLE void setValue(int channel, double value);
+
+    /**
+     * @brief 按通道顺序更新最新值
+     */
+    Q_INVOKABLE void setValues(const QList<double> &values);
+    void setValues(const double *values, int count);
+
+    /**
+     * @brief 按通道顺序更新最新值
+     * @param timestampNs 数值的采样时刻（UTC纳秒，SampleClock）
+     */
+    void setValues(const double *values, int count, qint64 timestampNs);
     Q_INVOKABLE void clearData();
     Q_INVOKABLE int recordCount() const;
 
+    /**
+     * @brief 边记录边写入CSV文件
+     * @param filePath 目标文件，已存在且表头与当前通道定义一致时追加，新文件写入BOM与表头；
+     *                 表头不一致时改为写入同目录下带时间后缀的新文件（见streamFile）
+     * @return 文件是否打开成功
+     * @details 每条记录写入后立即刷新，进程意外退出时最多丢失当前一条；
+     *          配合retainRecords=false可长时间记录而内存不增长
+     */
+    Q_INVOKABLE bool startStreaming(const QString &filePath);
+    Q_INVOKABLE void stopStreaming();
+    quint64 streamedCount() const { return m_streamedCount; }
+
+    const RecordTable &table() const { return m_table; }
+
 signals:
     void recordingChanged();
     void intervalChanged();
     void recordCountChanged();
+    void recordsCleared();
+    /**
+     * @brief 追加一行后发出，数值取前三个通道（不足时为0）
+     */
     void dataAdded(const QString &timestamp, double voltage, double current, double power);
+    /**
+     * @brief 追加一行后发出
+     * @param row 新行的行号
+     */
+    void recordAdded(int row);
+    /**
+     * @brief 追加一行（流式写入时已写入并刷新文件）后发出
+     * @param timestampNs 该行的时间，即所记录数值的到达时刻
+     */
+    void rowAppended(qint64 timestampNs);
+    void channelsChanged();
     void exportFinished(bool success, const QString &filePath);
+    void streamFileChanged();
+    void retainRecordsChanged();
+    void streamError(const QString &error);
 
 private slots:
     void onTimerTimeout();
 
 private:
+    void writeStreamRecord(const RecordTable &table, int row);
+    bool headerMatches(const QString &filePath) const;
+    void valuesUpdated(qint64 timestampNs);
+    void appendRow();
+
     QTimer *m_timer;
-    QVector<DataRecord> m_records;
+    QFile *m_streamFile;
+    quint64 m_streamedCount;
+    bool m_retainRecords;
+    RecordTable m_table;
+    RecordTable m_streamRow;        ///< 不保留记录时用于编码当前行
+    QVector<double> m_latest;
+    qint64 m_latestTimeNs;          ///< 最新值的到达时刻，-1表示尚无数据
+    bool m_hasNewValues;            ///< 上一行之后是否有新数值
     bool m_recording;
     int m_interval;
-    double m_lastVoltage;
-    double m_lastCurrent;
-    double m_lastPower;
 };
 
 #endif
@@ -0,0 +1,524 @@
+#include "LivePublisher.h"
+#include "../core/Logger.h"
+#include "../core/SampleClock.h"
+#include <QLocalServer>
+#include <QLocalSocket>
+#include <QTimer>
+#include <QPointer>
+#include <QtEndian>
+#include <cstring>
+
+namespace {
+
+/**
+ * @brief 套接字待写字节超过该值时暂停向该订阅者写入
+ */
+constexpr qint64 HIGH_WATER_BYTES = 64 * 1024;
+
+/**
+ * @brief 单个SampleBatch帧最多携带的样本数
+ */
+constexpr int MAX_BATCH_SAMPLES = 1024;
+
+/**
+ * @brief 单个样本在SampleBatch帧中的字节数
+ */
+constexpr int SAMPLE_BYTES = 20;
+
+/**
+ * @brief 监听失败时探测已有服务的连接超时（毫秒）
+ */
+constexpr int PROBE_TIMEOUT_MS = 200;
+
+template<typename T>
+void appendLE(QByteArray &out, T value)
+{
+    char bytes[sizeof(T)];
+    qToLittleEndian(value, bytes);
+    out.append(bytes, sizeof(T));
+}
+
+void appendFloat(QByteArray &out, float value)
+{
+    quint32 bits;
+    std::memcpy(&bits, &value, sizeof(bits));
+    appendLE(out, bits);
+}
+
+float readFloat(const char *data)
+{
+    const quint32 bits = qFromLittleEndian<quint32>(data);
+    float value;
+    std::memcpy(&value, &bits, sizeof(value));
+    return value;
+}
+
+} // namespace
+
+/**
+ * @brief 发布工作对象构造函数
+ * @details 服务与定时器在start()中于工作线程内创建
+ */
+LivePublisherWorker::LivePublisherWorker(LiveSampleQueue *queue, qint64 startEpochMs, int batchIntervalMs, int queueCapacity)
+    : QObject(nullptr)
+    , m_queue(queue)
+    , m_startEpochMs(startEpochMs)
+    , m_batchIntervalMs(batchIntervalMs)
+    , m_queueCapacity(queueCapacity)
+    , m_server(nullptr)
+    , m_batchTimer(nullptr)
+    , m_nextSubscriberId(1)
+    , m_publishedSinceReport(0)
+    , m_droppedSinceReport(0)
+{
+}
+
+void LivePublisherWorker::start(const QString &serverName)
+{
+    m_server = new QLocalServer(this);
+    connect(m_server, &QLocalServer::newConnection, this, &LivePublisherWorker::onNewConnection);
+    // 先探测该名称是否已有实例在服务，直接清理会抢占它的套接字
+    {
+        QLocalSocket probe;
+        probe.connectToServer(serverName);
+        if (probe.waitForConnected(PROBE_TIMEOUT_MS)) {
+            probe.abort();
+            emit listening(false, QString("服务名称已被其他实例占用: %1").arg(serverName));
+            return;
+        }
+    }
+    // 无人应答时才清理上次异常退出遗留的Unix域套接字文件，否则监听会失败
+    QLocalServer::removeServer(serverName);
+    if (!m_server->listen(serverName)) {
+        emit listening(false, m_server->errorString());
+        return;
+    }
+
+    m_batchTimer = new QTimer(this);
+    connect(m_batchTimer, &QTimer::timeout, this, &LivePublisherWorker::publishBatch);
+    m_batchTimer->start(m_batchIntervalMs);
+    emit listening(true, m_server->fullServerName());
+}
+
+void LivePublisherWorker::stop()
+{
+    if (m_batchTimer) {
+        m_batchTimer->stop();
+    }
+    for (auto it = m_subscribers.begin(); it != m_subscribers.end(); ++it) {
+        it->socket->disconnect(this);
+        it->socket->abort();
+        it->socket->deleteLater();
+    }
+    m_subscribers.clear();
+    if (m_server) {
+        m_server->close();
+    }
+    emit subscriberCountChanged(0);
+}
+
+void LivePublisherWorker::onNewConnection()
+{
+    while (QLocalSocket *socket = m_server->nextPendingConnection()) {
+        const quint32 id = m_nextSubscriberId++;
+        Subscriber &subscriber = m_subscribers[id];
+        subscriber.socket = socket;
+        subscriber.queue.resize(m_queueCapacity);
+
+        connect(socket, &QLocalSocket::readyRead, this, [this, id]() { readRequests(id); });
+        connect(socket, &QLocalSocket::bytesWritten, this, [this, id]() {
+            auto it = m_subscribers.find(id);
+            if (it != m_subscribers.end()) {
+                flush(*it);
+            }
+        });
+        // 断开可能在写入过程中同步发出，延迟到事件循环中移除
+        connect(socket, &QLocalSocket::disconnected, this, [this, id]() { removeSubscriber(id); }, Qt::QueuedConnection);
+
+        QByteArray hello;
+        appendLE<quint16>(hello, LIVE_PROTOCOL_VERSION);
+        appendLE<quint16>(hello, 3);
+        appendLE<qint64>(hello, m_startEpochMs);
+        writeFrame(socket, LiveHello, hello);
+
+        LOG_INFO(Log::General, "live subscriber {} connected, total {}", id, m_subscribers.size());
+        emit subscriberCountChanged(m_subscribers.size());
+    }
+}
+
+/**
+ * @brief 取走本周期的样本并分发给各订阅者
+ */
+void LivePublisherWorker::publishBatch()
+{
+    quint32 firstSequence;
+    m_batch.clear();
+    {
+        QMutexLocker locker(&m_queue->mutex);
+        m_batch.swap(m_queue->samples);
+        firstSequence = m_queue->nextSequence - static_cast<quint32>(m_batch.size());
+    }
+
+    for (auto it = m_subscribers.begin(); it != m_subscribers.end(); ++it) {
+        if (!m_batch.isEmpty()) {
+            enqueue(*it, m_batch, firstSequence);
+        }
+        flush(*it);
+    }
+
+    if (m_publishedSinceReport > 0 || m_droppedSinceReport > 0) {
+        emit batchPublished(m_publishedSinceReport, m_droppedSinceReport);
+        m_publishedSinceReport = 0;
+        m_droppedSinceReport = 0;
+    }
+}
+
+/**
+ * @brief 将样本放入订阅者队列
+ * @details 队列满时移出最旧样本：合并策略下并入聚合统计，否则计为丢弃。
+ *          只移出队首，队列中的样本序号始终连续
+ */
+void LivePublisherWorker::enqueue(Subscriber &subscriber, const QVector<LiveSample> &samples, quint32 firstSequence)
+{
+    const int capacity = subscriber.queue.size();
+    for (int i = 0; i < samples.size(); ++i) {
+        if (subscriber.count == capacity) {
+            const LiveSample &oldest = subscriber.queue[subscriber.head];
+            if (subscriber.aggregate) {
+                const float values[3] = {oldest.voltage, oldest.current, oldest.power};
+                if (subscriber.aggCount == 0) {
+                    subscriber.aggFirstUs = oldest.timestampUs;
+                    for (int c = 0; c < 3; ++c) {
+                        subscriber.aggMin[c] = values[c];
+                        subscriber.aggMax[c] = values[c];
+                        subscriber.aggSum[c] = 0.0;
+                    }
+                }
+                for (int c = 0; c < 3; ++c) {
+                    subscriber.aggMin[c] = qMin(subscriber.aggMin[c], values[c]);
+                    subscriber.aggMax[c] = qMax(subscriber.aggMax[c], values[c]);
+                    subscriber.aggSum[c] += values[c];
+                }
+                subscriber.aggLastUs = oldest.timestampUs;
+                ++subscriber.aggCount;
+            } else {
+                ++subscriber.dropped;
+            }
+            subscriber.head = (subscriber.head + 1) % capacity;
+            --subscriber.count;
+            ++subscriber.firstSequence;
+            ++m_droppedSinceReport;
+        }
+        if (subscriber.count == 0) {
+            subscriber.firstSequence = firstSequence + static_cast<quint32>(i);
+        }
+        subscriber.queue[(subscriber.head + subscriber.count) % capacity] = samples.at(i);
+        ++subscriber.count;
+    }
+}
+
+/**
+ * @brief 在写缓冲低于高水位时向订阅者写出积压的帧
+ * @details 先写出聚合/丢弃通知（它们覆盖的样本早于队列中的样本），再按批写出队列
+ */
+void LivePublisherWorker::flush(Subscriber &subscriber)
+{
+    QLocalSocket *socket = subscriber.socket;
+    if (socket->state() != QLocalSocket::ConnectedState || socket->bytesToWrite() > HIGH_WATER_BYTES) {
+        return;
+    }
+
+    if (subscriber.aggCount > 0) {
+        QByteArray payload;
+        appendLE<quint32>(payload, subscriber.aggCount);
+        appendLE<qint64>(payload, subscriber.aggFirstUs);
+        appendLE<qint64>(payload, subscriber.aggLastUs);
+        for (int c = 0; c < 3; ++c) {
+            appendFloat(payload, subscriber.aggMin[c]);
+            appendFloat(payload, subscriber.aggMax[c]);
+            appendFloat(payload, static_cast<float>(subscriber.aggSum[c] / subscriber.aggCount));
+        }
+        writeFrame(socket, LiveAggregate, payload);
+        subscriber.aggCount = 0;
+    }
+    if (subscriber.dropped > 0) {
+        QByteArray payload;
+        appendLE<quint32>(payload, subscriber.dropped);
+        writeFrame(socket, LiveDropped, payload);
+        subscriber.dropped = 0;
+    }
+
+    const int capacity = subscriber.queue.size();
+    QByteArray payload;
+    while (subscriber.count > 0 && socket->bytesToWrite() <= HIGH_WATER_BYTES) {
+        const int n = qMin(subscriber.count, MAX_BATCH_SAMPLES);
+        payload.clear();
+        payload.reserve(6 + n * SAMPLE_BYTES);
+        appendLE<quint32>(payload, subscriber.firstSequence);
+        appendLE<quint16>(payload, static_cast<quint16>(n));
+        for (int i = 0; i < n; ++i) {
+            const LiveSample &sample = subscriber.queue[(subscriber.head + i) % capacity];
+            appendLE<qint64>(payload, sample.timestampUs);
+            appendFloat(payload, sample.voltage);
+            appendFloat(payload, sample.current);
+            appendFloat(payload, sample.power);
+        }
+        writeFrame(socket, LiveSampleBatch, payload);
+        subscriber.head = (subscriber.head + n) % capacity;
+        subscriber.count -= n;
+        subscriber.firstSequence += static_cast<quint32>(n);
+        m_publishedSinceReport += n;
+    }
+}
+
+/**
+ * @brief 解析订阅者发来的请求帧
+ */
+void LivePublisherWorker::readRequests(quint32 id)
+{
+    auto it = m_subscribers.find(id);
+    if (it == m_subscribers.end()) {
+        return;
+    }
+    Subscriber &subscriber = *it;
+    subscriber.rxBuffer.append(subscriber.socket->readAll());
+
+    int offset = 0;
+    const QByteArray &rx = subscriber.rxBuffer;
+    while (rx.size() - offset >= 4) {
+        const quint8 type = static_cast<quint8>(rx.at(offset));
+        const int length = qFromLittleEndian<quint16>(rx.constData() + offset + 2);
+        if (rx.size() - offset - 4 < length) {
+            break;
+        }
+        const char *payload = rx.constData() + offset + 4;
+        if (type == LiveSubscribe && length >= 1) {
+            subscriber.aggregate = payload[0] != 0;
+        } else if (type == LiveSetPoint && length >= 12) {
+            const quint32 requestId = qFromLittleEndian<quint32>(payload);
+            emit setPointRequested(id, requestId, readFloat(payload + 4), readFloat(payload + 8));
+        } else {
+            LOG_DEBUG(Log::General, "live subscriber {} sent unknown frame type {}", id, type);
+        }
+        offset += 4 + length;
+    }
+    subscriber.rxBuffer.remove(0, offset);
+}
+
+void LivePublisherWorker::sendSetPointResult(quint32 subscriberId, quint32 requestId, bool accepted, double voltage, double current)
+{
+    auto it = m_subscribers.find(subscriberId);
+    if (it == m_subscribers.end()) {
+        return;
+    }
+    QByteArray payload;
+    appendLE<quint32>(payload, requestId);
+    appendLE<quint8>(payload, accepted ? 0 : 1);
+    appendFloat(payload, static_cast<float>(voltage));
+    appendFloat(payload, static_cast<float>(current));
+    writeFrame(it->socket, LiveSetPointResult, payload);
+}
+
+void LivePublisherWorker::removeSubscriber(quint32 id)
+{
+    auto it = m_subscribers.find(id);
+    if (it == m_subscribers.end()) {
+        return;
+    }
+    it->socket->deleteLater();
+    m_subscribers.erase(it);
+    LOG_INFO(Log::General, "live subscriber {} disconnected, total {}", id, m_subscribers.size());
+    emit subscriberCountChanged(m_subscribers.size());
+}
+
+void LivePublisherWorker::writeFrame(QLocalSocket *socket, LiveFrameType type, const QByteArray &payload)
+{
+    QByteArray frame;
+    frame.reserve(4 + payload.size());
+    appendLE<quint8>(frame, type);
+    appendLE<quint8>(frame, 0);
+    appendLE<quint16>(frame, static_cast<quint16>(payload.size()));
+    frame.append(payload);
+    socket->write(frame);
+}
+
+LivePublisher::LivePublisher(QObject *parent)
+    : QObject(parent)
+    , m_modbusManager(nullptr)
+    , m_serverName(QStringLiteral("demo3-live"))
+    , m_acceptSetPoints(false)
+    , m_subscriberCount(0)
+    , m_startNs(0)
+    , m_thread(nullptr)
+    , m_worker(nullptr)
+    , m_sampleCount(0)
+    , m_publishedCount(0)
+    , m_droppedCount(0)
+{
+}
+
+LivePublisher::~LivePublisher()
+{
+    stop();
+}
+
+void LivePublisher::setModbusManager(ModbusManager *manager)
+{
+    if (m_modbusManager == manager) {
+        return;
+    }
+    if (m_modbusManager) {
+        disconnect(m_modbusManager, &ModbusManager::sampleReady, this, &LivePublisher::onSampleReady);
+    }
+    m_modbusManager = manager;
+    if (m_modbusManager) {
+        connect(m_modbusManager, &ModbusManager::sampleReady, this, &LivePublisher::onSampleReady);
+    }
+    emit modbusManagerChanged();
+}
+
+void LivePublisher::setServerName(const QString &name)
+{
+    if (m_serverName != name && !name.isEmpty()) {
+        m_serverName = name;
+        emit serverNameChanged();
+    }
+}
+
+void LivePublisher::setAcceptSetPoints(bool accept)
+{
+    if (m_acceptSetPoints != accept) {
+        m_acceptSetPoints = accept;
+        emit acceptSetPointsChanged();
+    }
+}
+
+void LivePublisher::start(int batchIntervalMs, int queueCapacity)
+{
+    if (m_thread) {
+        return;
+    }
+
+    {
+        QMutexLocker locker(&m_queue.mutex);
+        m_queue.samples.clear();
+        m_queue.nextSequence = 0;
+    }
+    m_sampleCount = 0;
+    m_publishedCount = 0;
+    m_droppedCount = 0;
+    m_startNs = SampleClock::nowNs();
+
+    m_thread = new QThread(this);
+    m_thread->setObjectName(QStringLiteral("LivePublisher"));
+    m_worker = new LivePublisherWorker(&m_queue, m_startNs / 1000000,
+                                       qMax(1, batchIntervalMs), qMax(16, queueCapacity));
+    m_worker->moveToThread(m_thread);
+
+    connect(m_thread, &QThread::finished, m_worker, &QObject::deleteLater);
+    connect(m_worker, &LivePublisherWorker::listening, this, [this](bool ok, const QString &detail) {
+        if (ok) {
+            LOG_INFO(Log::General, "live publisher listening on {}", detail);
+            return;
+        }
+        LOG_WARNING(Log::General, "live publisher listen failed: {}", detail);
+        emit errorOccurred(detail);
+        stop();
+    });
+    connect(m_worker, &LivePublisherWorker::subscriberCountChanged, this, [this](int count) {
+        if (m_subscriberCount != count) {
+            m_subscriberCount = count;
+            emit subscriberCountChanged();
+        }
+    });
+    connect(m_worker, &LivePublisherWorker::batchPublished, this, [this](qint64 published, qint64 dropped) {
+        m_publishedCount += published;
+        m_droppedCount += dropped;
+    });
+    connect(m_worker, &LivePublisherWorker::setPointRequested, this, &LivePublisher::onSetPointRequested);
+    connect(this, &LivePublisher::setPointResultReady, m_worker, &LivePublisherWorker::sendSetPointResult, Qt::QueuedConnection);
+
+    m_thread->start();
+    QMetaObject::invokeMethod(m_worker, "start", Qt::QueuedConnection, Q_ARG(QString, m_serverName));
+    emit runningChanged();
+}
+
+void LivePublisher::stop()
+{
+    if (!m_thread) {
+        return;
+    }
+
+    // 在工作线程中关闭连接后再结束线程
+    QMetaObject::invokeMethod(m_worker, "stop", Qt::BlockingQueuedConnection);
+    m_thread->quit();
+    m_thread->wait();
+    delete m_thread;
+    m_thread = nullptr;
+    m_worker = nullptr;
+
+    if (m_subscriberCount != 0) {
+        m_subscriberCount = 0;
+        emit subscriberCountChanged();
+    }
+    emit runningChanged();
+}
+
+QVariantMap LivePublisher::statistics() const
+{
+    QVariantMap stats;
+    stats["samples"] = m_sampleCount;
+    stats["published"] = m_publishedCount;
+    stats["dropped"] = m_droppedCount;
+    stats["subscribers"] = m_subscriberCount;
+    return stats;
+}
+
+/**
+ * @brief 采集样本到达
+ * @details 采集线程上唯一的开销：换算时间戳并在锁内追加
+ * @param timestampNs sampleReady携带的回复到达时刻
+ */
+void LivePublisher::onSampleReady(double voltage, double current, double power, qint64 timestampNs)
+{
+    if (!m_thread) {
+        return;
+    }
+
+    LiveSample sample;
+    sample.timestampUs = (timestampNs - m_startNs) / 1000;
+    sample.voltage = static_cast<float>(voltage);
+    sample.current = static_cast<float>(current);
+    sample.power = static_cast<float>(power);
+    {
+        QMutexLocker locker(&m_queue.mutex);
+        m_queue.samples.append(sample);
+        ++m_queue.nextSequence;
+    }
+    ++m_sampleCount;
+}
+
+/**
+ * @brief 处理订阅者的设定值写入请求
+ * @details 经ModbusManager写入并回读，结果只返回给发起请求的订阅者。
+ *          结果经setPointResultReady排队到工作对象，不在回调中持有或访问工作对象：
+ *          工作对象在发布线程中销毁，跨线程检查其指针不安全；
+ *          回调在ModbusManager所在线程（与本对象相同）执行，只检查本对象是否仍存在
+ */
+void LivePublisher::onSetPointRequested(quint32 subscriberId, quint32 requestId, double voltage, double current)
+{
+    QPointer<LivePublisher> self(this);
+    auto reply = [self, subscriberId, requestId](bool accepted, double setVoltage, double setCurrent) {
+        if (self) {
+            emit self->setPointResultReady(subscriberId, requestId, accepted, setVoltage, setCurrent);
+        }
+    };
+
+    if (!m_acceptSetPoints || !m_modbusManager) {
+        LOG_WARNING(Log::General, "live subscriber {} set-point request {} rejected", subscriberId, requestId);
+        reply(false, 0.0, 0.0);
+        return;
+    }
+    LOG_INFO(Log::General, "live subscriber {} set-point request {}: {} V, {} A", subscriberId, requestId, voltage, current);
+    m_modbusManager->writeVoltageAndCurrent(voltage, current, reply);
+}
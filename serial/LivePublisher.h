@@ -0,0 +1,266 @@
+#ifndef LIVEPUBLISHER_H
+#define LIVEPUBLISHER_H
+
+#include <QObject>
+#include <QVector>
+#include <QHash>
+#include <QMutex>
+#include <QThread>
+#include <QVariantMap>
+#include "ModbusManager.h"
+
+class QLocalServer;
+class QLocalSocket;
+class QTimer;
+
+/**
+ * @brief 本地发布协议版本
+ */
+constexpr quint16 LIVE_PROTOCOL_VERSION = 1;
+
+/**
+ * @brief 本地发布协议帧类型
+ * @details 每帧为4字节头（u8类型、u8保留、u16负载长度）加负载，全部小端序。
+ *          服务端→客户端：
+ *          - Hello：u16协议版本、u16通道数(3)、i64发布开始时刻(Unix毫秒)
+ *          - SampleBatch：u32首样本序号、u16样本数，随后每样本20字节
+ *            （i64相对发布开始的微秒、f32电压、f32电流、f32功率）
+ *          - Aggregate：慢速订阅者被合并的样本，u32样本数、i64首/末时间(微秒)、
+ *            电压/电流/功率各自的f32最小/最大/平均值
+ *          - Dropped：慢速订阅者被丢弃的样本，u32样本数
+ *          - SetPointResult：u32请求号、u8结果(0：回读一致，1：失败或不一致)、f32设定电压、f32设定电流
+ *          客户端→服务端：
+ *          - Subscribe：u8慢速策略(0：丢弃最旧样本，1：合并为Aggregate)
+ *          - SetPoint：u32请求号、f32电压、f32电流，经ModbusManager以功能码23写入并回读
+ */
+enum LiveFrameType : quint8 {
+    LiveHello = 0x01,
+    LiveSampleBatch = 0x02,
+    LiveAggregate = 0x03,
+    LiveDropped = 0x04,
+    LiveSetPointResult = 0x10,
+    LiveSubscribe = 0x81,
+    LiveSetPoint = 0x82
+};
+
+/**
+ * @brief 发布的单个采集样本
+ */
+struct LiveSample {
+    qint64 timestampUs = 0;
+    float voltage = 0.0f;
+    float current = 0.0f;
+    float power = 0.0f;
+};
+
+/**
+ * @brief 采集线程与发布线程之间的交接缓冲
+ * @details 采集侧只在锁内追加一个样本，发布线程按批次整体交换取走
+ */
+struct LiveSampleQueue {
+    QMutex mutex;
+    QVector<LiveSample> samples;
+    quint32 nextSequence = 0;
+};
+
+/**
+ * @brief 本地发布工作对象
+ * @details 运行在独立线程中，拥有QLocalServer与全部订阅连接。
+ *          每个订阅者有固定容量的样本队列，套接字写缓冲超过高水位时暂停写入，
+ *          队列满后按订阅者选择的策略丢弃或合并最旧样本，不会反压到采集线程
+ */
+class LivePublisherWorker : public QObject
+{
+    Q_OBJECT
+
+public:
+    LivePublisherWorker(LiveSampleQueue *queue, qint64 startEpochMs, int batchIntervalMs, int queueCapacity);
+
+public slots:
+    /**
+     * @brief 开始监听
+     * @param serverName 本地服务名称
+     */
+    void start(const QString &serverName);
+
+    /**
+     * @brief 关闭全部连接并停止监听
+     */
+    void stop();
+
+    /**
+     * @brief 向发起请求的订阅者返回设定值写入结果
+     */
+    void sendSetPointResult(quint32 subscriberId, quint32 requestId, bool accepted, double voltage, double current);
+
+signals:
+    /**
+     * @brief 监听结果信号
+     */
+    void listening(bool ok, const QString &error);
+
+    /**
+     * @brief 订阅者数量变化信号
+     */
+    void subscriberCountChanged(int count);
+
+    /**
+     * @brief 订阅者请求写入设定值
+     */
+    void setPointRequested(quint32 subscriberId, quint32 requestId, double voltage, double current);
+
+    /**
+     * @brief 批次统计信号
+     * @param published 上次统计以来写入各订阅者的样本总数
+     * @param dropped 上次统计以来因订阅者过慢被丢弃或合并的样本数
+     */
+    void batchPublished(qint64 published, qint64 dropped);
+
+private slots:
+    void onNewConnection();
+    void publishBatch();
+
+private:
+    /**
+     * @brief 订阅者状态
+     * @details queue为环形缓冲，head指向最旧样本，firstSequence为其序号
+     */
+    struct Subscriber {
+        QLocalSocket *socket = nullptr;
+        bool aggregate = true;
+        QVector<LiveSample> queue;
+        int head = 0;
+        int count = 0;
+        quint32 firstSequence = 0;
+        quint32 dropped = 0;
+        quint32 aggCount = 0;
+        qint64 aggFirstUs = 0;
+        qint64 aggLastUs = 0;
+        float aggMin[3] = {0.0f, 0.0f, 0.0f};
+        float aggMax[3] = {0.0f, 0.0f, 0.0f};
+        double aggSum[3] = {0.0, 0.0, 0.0};
+        QByteArray rxBuffer;
+    };
+
+    void enqueue(Subscriber &subscriber, const QVector<LiveSample> &samples, quint32 firstSequence);
+    void flush(Subscriber &subscriber);
+    void readRequests(quint32 id);
+    void removeSubscriber(quint32 id);
+    static void writeFrame(QLocalSocket *socket, LiveFrameType type, const QByteArray &payload);
+
+    LiveSampleQueue *m_queue;
+    qint64 m_startEpochMs;
+    int m_batchIntervalMs;
+    int m_queueCapacity;
+    QLocalServer *m_server;
+    QTimer *m_batchTimer;
+    QHash<quint32, Subscriber> m_subscribers;
+    quint32 m_nextSubscriberId;
+    QVector<LiveSample> m_batch;
+    qint64 m_publishedSinceReport;
+    qint64 m_droppedSinceReport;
+};
+
+/**
+ * @brief 本地实时数据发布服务
+ * @details 订阅ModbusManager的采集样本，通过本地套接字（Windows命名管道/Unix域套接字）
+ *          以紧凑二进制帧分批推送给MES采集程序、测试脚本等多个外部进程，
+ *          并接受订阅者的设定值写入请求。采集线程只做一次加锁追加，
+ *          打包与各订阅者的写入全部在发布线程中完成
+ */
+class LivePublisher : public QObject
+{
+    Q_OBJECT
+    /**
+     * @brief 数据来源，设定值请求同样经其写入
+     */
+    Q_PROPERTY(ModbusManager *modbusManager READ modbusManager WRITE setModbusManager NOTIFY modbusManagerChanged)
+
+    /**
+     * @brief 本地服务名称
+     */
+    Q_PROPERTY(QString serverName READ serverName WRITE setServerName NOTIFY serverNameChanged)
+
+    /**
+     * @brief 是否接受订阅者的设定值写入请求
+     */
+    Q_PROPERTY(bool acceptSetPoints READ acceptSetPoints WRITE setAcceptSetPoints NOTIFY acceptSetPointsChanged)
+
+    /**
+     * @brief 是否正在发布
+     */
+    Q_PROPERTY(bool running READ running NOTIFY runningChanged)
+
+    /**
+     * @brief 当前订阅者数量
+     */
+    Q_PROPERTY(int subscriberCount READ subscriberCount NOTIFY subscriberCountChanged)
+
+public:
+    explicit LivePublisher(QObject *parent = nullptr);
+    ~LivePublisher();
+
+    ModbusManager *modbusManager() const { return m_modbusManager; }
+    void setModbusManager(ModbusManager *manager);
+    QString serverName() const { return m_serverName; }
+    void setServerName(const QString &name);
+    bool acceptSetPoints() const { return m_acceptSetPoints; }
+    void setAcceptSetPoints(bool accept);
+    bool running() const { return m_thread != nullptr; }
+    int subscriberCount() const { return m_subscriberCount; }
+
+    /**
+     * @brief 启动发布线程并开始监听
+     * @param batchIntervalMs 批次周期，同一周期内的样本合并为一帧
+     * @param queueCapacity 每个订阅者最多缓存的样本数
+     */
+    Q_INVOKABLE void start(int batchIntervalMs = 20, int queueCapacity = 4096);
+
+    /**
+     * @brief 断开全部订阅者并停止发布线程
+     */
+    Q_INVOKABLE void stop();
+
+    /**
+     * @brief 获取发布统计
+     * @return 包含samples、published、dropped、subscribers字段
+     */
+    Q_INVOKABLE QVariantMap statistics() const;
+
+signals:
+    void modbusManagerChanged();
+    void serverNameChanged();
+    void acceptSetPointsChanged();
+    void runningChanged();
+    void subscriberCountChanged();
+
+    /**
+     * @brief 错误信号（如服务名称被占用）
+     */
+    void errorOccurred(const QString &error);
+
+    /**
+     * @brief 设定值请求结果信号
+     * @details start()中以队列连接到发布线程的工作对象，工作对象随stop()销毁时连接自动断开
+     */
+    void setPointResultReady(quint32 subscriberId, quint32 requestId, bool accepted, double voltage, double current);
+
+private slots:
+    void onSampleReady(double voltage, double current, double power, qint64 timestampNs);
+    void onSetPointRequested(quint32 subscriberId, quint32 requestId, double voltage, double current);
+
+private:
+    ModbusManager *m_modbusManager;
+    QString m_serverName;
+    bool m_acceptSetPoints;
+    int m_subscriberCount;
+    LiveSampleQueue m_queue;
+    qint64 m_startNs;               ///< 发布开始时刻（UTC纳秒），样本时间相对于此
+    QThread *m_thread;
+    LivePublisherWorker *m_worker;
+    qint64 m_sampleCount;
+    qint64 m_publishedCount;
+    qint64 m_droppedCount;
+};
+
+#endif
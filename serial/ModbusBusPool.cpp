@@ -0,0 +1,482 @@
+#include "ModbusBusPool.h"
+#include "ModbusTransport.h"
+#include "../core/Logger.h"
+#include "../core/SampleClock.h"
+#include <QRegularExpression>
+#include <QVariantMap>
+
+/**
+ * @brief 总线工作对象构造函数
+ * @details 串口与定时器在start()中于工作线程内创建
+ */
+ModbusBusWorker::ModbusBusWorker(int bus, const QString &portName, int baudRate, QSerialPort::Parity parity,
+                                 const QVector<BusPoint> &points)
+    : QObject(nullptr)
+    , m_bus(bus)
+    , m_portName(portName)
+    , m_baudRate(baudRate)
+    , m_parity(parity)
+    , m_points(points)
+    , m_transport(nullptr)
+    , m_pollTimer(nullptr)
+    , m_cyclePending(0)
+    , m_cycleErrors(0)
+    , m_cycleStartNs(0)
+{
+}
+
+void ModbusBusWorker::start(int intervalMs)
+{
+    if (!m_transport) {
+        m_transport = new ModbusTransport(this);
+        m_transport->setTimeout(qMax(50, intervalMs));
+        m_transport->setNumberOfRetries(1);
+        connect(m_transport, &ModbusTransport::connectedChanged, this, [this](bool connected) {
+            emit connectionChanged(m_bus, connected);
+        });
+        connect(m_transport, &ModbusTransport::errorOccurred, this, [this](const QString &error) {
+            emit errorOccurred(m_bus, error);
+        });
+
+        m_pollTimer = new QTimer(this);
+        m_pollTimer->setTimerType(Qt::PreciseTimer);
+        connect(m_pollTimer, &QTimer::timeout, this, &ModbusBusWorker::poll);
+    }
+
+    if (!m_transport->isOpen() && !m_transport->open(m_portName, m_baudRate, m_parity)) {
+        return;
+    }
+
+    m_cyclePending = 0;
+    m_pollTimer->start(intervalMs);
+    poll();
+}
+
+void ModbusBusWorker::stop()
+{
+    if (m_pollTimer) {
+        m_pollTimer->stop();
+    }
+    if (m_transport) {
+        m_transport->close();
+    }
+    m_cyclePending = 0;
+}
+
+/**
+ * @brief 发起一轮轮询
+ * @details 本轮全部请求一次性提交到传输层排队，上一轮未完成时跳过本次
+ */
+void ModbusBusWorker::poll()
+{
+    if (m_cyclePending > 0) {
+        emit cycleOverrun(m_bus);
+        return;
+    }
+    if (!m_transport->isOpen() || m_points.isEmpty()) {
+        return;
+    }
+
+    m_cycleSamples.clear();
+    m_cycleErrors = 0;
+    m_cycleStartNs = SampleClock::monotonicNs();
+    m_cyclePending = m_points.size();
+
+    for (const BusPoint &point : std::as_const(m_points)) {
+        const bool sent = m_transport->readHoldingRegisters(point.slave, point.address, 1,
+            [this, point](const ModbusTransport::Result &result) {
+                if (result.error == ModbusTransport::NoError && result.count > 0) {
+                    // 以请求与应答的中点作为采样时刻，与其他采集路径同用SampleClock
+                    BusSample sample;
+                    sample.channel = point.channel;
+                    sample.value = result.values[0] * point.scale;
+                    sample.timestampNs = SampleClock::nowNs() - result.roundTripNs / 2;
+                    m_cycleSamples.append(sample);
+                } else {
+                    ++m_cycleErrors;
+                }
+                finishRequest();
+            });
+        if (!sent) {
+            ++m_cycleErrors;
+            finishRequest();
+        }
+    }
+}
+
+void ModbusBusWorker::finishRequest()
+{
+    if (m_cyclePending <= 0 || --m_cyclePending > 0) {
+        return;
+    }
+    emit cycleCompleted(m_bus, m_cycleSamples, SampleClock::monotonicNs() - m_cycleStartNs, m_cycleErrors);
+}
+
+/**
+ * @brief 多总线采集池构造函数
+ * @param parent 父对象
+ */
+ModbusBusPool::ModbusBusPool(QObject *parent)
+    : QObject(parent)
+    , m_modbusManager(nullptr)
+    , m_dataRecorder(nullptr)
+    , m_startNs(0)
+    , m_alignTimer(new QTimer(this))
+    , m_alignIntervalMs(100)
+    , m_pollIntervalMs(100)
+    , m_running(false)
+{
+    qRegisterMetaType<BusSample>();
+    qRegisterMetaType<QList<BusSample>>();
+
+    m_alignTimer->setTimerType(Qt::PreciseTimer);
+    connect(m_alignTimer, &QTimer::timeout, this, &ModbusBusPool::emitAlignedFrame);
+}
+
+ModbusBusPool::~ModbusBusPool()
+{
+    stop();
+}
+
+QStringList ModbusBusPool::channelNames() const
+{
+    QStringList names;
+    names.reserve(m_channels.size());
+    for (const Channel &channel : m_channels) {
+        names.append(channel.name);
+    }
+    return names;
+}
+
+void ModbusBusPool::setAlignIntervalMs(int intervalMs)
+{
+    intervalMs = qMax(1, intervalMs);
+    if (m_alignIntervalMs == intervalMs) {
+        return;
+    }
+    m_alignIntervalMs = intervalMs;
+    if (m_alignTimer->isActive()) {
+        m_alignTimer->start(m_alignIntervalMs);
+    }
+    emit alignIntervalMsChanged();
+}
+
+void ModbusBusPool::setModbusManager(ModbusManager *manager)
+{
+    if (m_modbusManager != manager) {
+        m_modbusManager = manager;
+        emit modbusManagerChanged();
+    }
+}
+
+void ModbusBusPool::setDataRecorder(DataRecorder *recorder)
+{
+    if (m_dataRecorder != recorder) {
+        m_dataRecorder = recorder;
+        emit dataRecorderChanged();
+    }
+}
+
+int ModbusBusPool::addBus(const QString &portName, int baudRate, int parity)
+{
+    if (m_running || portName.isEmpty()) {
+        return -1;
+    }
+    for (const Bus &bus : std::as_const(m_buses)) {
+        if (bus.portName == portName) {
+            LOG_WARNING(Log::Modbus, "bus already configured: {}", portName);
+            return -1;
+        }
+    }
+
+    Bus bus;
+    bus.portName = portName;
+    bus.baudRate = baudRate;
+    bus.parity = parity == 1 ? QSerialPort::OddParity : parity == 2 ? QSerialPort::EvenParity : QSerialPort::NoParity;
+    m_buses.append(bus);
+    emit busesChanged();
+    return m_buses.size() - 1;
+}
+
+int ModbusBusPool::assignSlave(int bus, const QString &channelName, int slaveAddress, int registerAddress, double scale)
+{
+    if (m_running || bus < 0 || bus >= m_buses.size() || slaveAddress < 1 || slaveAddress > 247) {
+        return -1;
+    }
+
+    Channel channel;
+    channel.name = channelName;
+    channel.bus = bus;
+    m_channels.append(channel);
+
+    BusPoint point;
+    point.channel = m_channels.size() - 1;
+    point.slave = slaveAddress;
+    point.address = registerAddress;
+    point.scale = scale;
+    m_buses[bus].points.append(point);
+
+    emit channelsChanged();
+    return point.channel;
+}
+
+/**
+ * @brief 按配置文本设置全部总线与通道
+ * @details 供设置页与无界面版的--bus选项共用；任一项无效时整体失败
+ */
+bool ModbusBusPool::configure(const QString &spec)
+{
+    if (m_running) {
+        return failConfigure("采集中不能修改总线配置");
+    }
+    clear();
+
+    // 通道=从站/寄存器[*系数]
+    static const QRegularExpression pointPattern(QStringLiteral("^([^=]+)=(\\d+)/(0[xX][0-9a-fA-F]+|\\d+)(?:\\*([-+0-9.eE]+))?$"));
+    const QStringList busSpecs = spec.split(';', Qt::SkipEmptyParts);
+    for (const QString &busSpec : busSpecs) {
+        const QStringList parts = busSpec.simplified().split(' ', Qt::SkipEmptyParts);
+        if (parts.isEmpty()) {
+            continue;
+        }
+        const QStringList port = parts.first().split(':');
+        bool ok = true;
+        const int baudRate = port.size() > 1 ? port.at(1).toInt(&ok) : 9600;
+        int parity = 0;
+        if (ok && port.size() > 2) {
+            parity = QStringLiteral("noe").indexOf(port.at(2).left(1).toLower());
+            ok = parity >= 0 && !port.at(2).isEmpty();
+        }
+        const int bus = ok && baudRate > 0 ? addBus(port.first(), baudRate, parity) : -1;
+        if (bus < 0) {
+            return failConfigure(QString("无效的总线: %1").arg(parts.first()));
+        }
+        if (parts.size() < 2) {
+            return failConfigure(QString("总线 %1 没有分配通道").arg(port.first()));
+        }
+
+        for (int i = 1; i < parts.size(); ++i) {
+            const QRegularExpressionMatch match = pointPattern.match(parts.at(i));
+            bool registerOk = false;
+            bool scaleOk = true;
+            const QString registerText = match.captured(3);
+            const int registerAddress = registerText.startsWith("0x", Qt::CaseInsensitive)
+                    ? registerText.mid(2).toInt(&registerOk, 16) : registerText.toInt(&registerOk);
+            const double scale = match.hasMatch() && match.hasCaptured(4) ? match.captured(4).toDouble(&scaleOk) : 1.0;
+            if (!match.hasMatch() || !registerOk || !scaleOk || registerAddress > 0xFFFF
+                    || assignSlave(bus, match.captured(1), match.captured(2).toInt(), registerAddress, scale) < 0) {
+                return failConfigure(QString("无效的通道: %1").arg(parts.at(i)));
+            }
+        }
+    }
+    if (m_channels.isEmpty()) {
+        return failConfigure("未配置任何总线");
+    }
+    LOG_INFO(Log::Modbus, "bus pool configured: {} buses, {} channels", m_buses.size(), m_channels.size());
+    return true;
+}
+
+bool ModbusBusPool::failConfigure(const QString &error)
+{
+    if (!m_running) {
+        clear();
+    }
+    LOG_WARNING(Log::Modbus, "bus pool configuration rejected: {}", error);
+    emit errorOccurred(-1, error);
+    return false;
+}
+
+void ModbusBusPool::clear()
+{
+    stop();
+    m_buses.clear();
+    m_channels.clear();
+    m_latestFrame.clear();
+    emit busesChanged();
+    emit channelsChanged();
+}
+
+/**
+ * @brief 启动全部总线
+ * @details 每条总线创建独立线程，工作对象移入线程后在线程内打开串口
+ */
+bool ModbusBusPool::start(int pollIntervalMs)
+{
+    if (m_running || m_buses.isEmpty()) {
+        return false;
+    }
+
+    m_pollIntervalMs = qMax(1, pollIntervalMs);
+    for (Channel &channel : m_channels) {
+        channel.hasSample = false;
+    }
+
+    for (int i = 0; i < m_buses.size(); ++i) {
+        Bus &bus = m_buses[i];
+        bus.cycles = 0;
+        bus.overruns = 0;
+        bus.errors = 0;
+        bus.totalCycleNs = 0;
+        bus.maxCycleNs = 0;
+
+        bus.thread = new QThread(this);
+        bus.thread->setObjectName(QStringLiteral("ModbusBus-%1").arg(bus.portName));
+        bus.worker = new ModbusBusWorker(i, bus.portName, bus.baudRate, bus.parity, bus.points);
+        bus.worker->moveToThread(bus.thread);
+
+        connect(bus.thread, &QThread::finished, bus.worker, &QObject::deleteLater);
+        connect(bus.worker, &ModbusBusWorker::cycleCompleted, this, &ModbusBusPool::onCycleCompleted);
+        connect(bus.worker, &ModbusBusWorker::cycleOverrun, this, &ModbusBusPool::onCycleOverrun);
+        connect(bus.worker, &ModbusBusWorker::connectionChanged, this, &ModbusBusPool::onBusConnectionChanged);
+        connect(bus.worker, &ModbusBusWorker::errorOccurred, this, &ModbusBusPool::errorOccurred);
+
+        bus.thread->start();
+        QMetaObject::invokeMethod(bus.worker, "start", Qt::QueuedConnection, Q_ARG(int, m_pollIntervalMs));
+    }
+
+    m_startNs = SampleClock::nowNs();
+    m_alignTimer->start(m_alignIntervalMs);
+    m_running = true;
+    emit runningChanged();
+    return true;
+}
+
+void ModbusBusPool::stop()
+{
+    if (!m_running) {
+        return;
+    }
+
+    m_alignTimer->stop();
+    for (int i = 0; i < m_buses.size(); ++i) {
+        Bus &bus = m_buses[i];
+        // 在工作线程中关闭串口后再结束线程
+        QMetaObject::invokeMethod(bus.worker, "stop", Qt::BlockingQueuedConnection);
+        bus.thread->quit();
+        bus.thread->wait();
+        delete bus.thread;
+        bus.thread = nullptr;
+        bus.worker = nullptr;
+        if (bus.connected) {
+            bus.connected = false;
+            emit busConnectionChanged(i, false);
+        }
+    }
+
+    m_running = false;
+    emit runningChanged();
+}
+
+QVariantList ModbusBusPool::busStatistics() const
+{
+    QVariantList list;
+    for (const Bus &bus : m_buses) {
+        QVariantMap stats;
+        stats["port"] = bus.portName;
+        stats["connected"] = bus.connected;
+        stats["cycles"] = bus.cycles;
+        stats["overruns"] = bus.overruns;
+        stats["errors"] = bus.errors;
+        stats["avgCycleUs"] = bus.cycles > 0 ? bus.totalCycleNs / bus.cycles / 1000 : 0;
+        stats["maxCycleUs"] = bus.maxCycleNs / 1000;
+        list.append(stats);
+    }
+    return list;
+}
+
+void ModbusBusPool::onCycleCompleted(int bus, const QList<BusSample> &samples, qint64 cycleNs, int errors)
+{
+    if (bus < 0 || bus >= m_buses.size()) {
+        return;
+    }
+
+    Bus &b = m_buses[bus];
+    ++b.cycles;
+    b.errors += errors;
+    b.totalCycleNs += cycleNs;
+    b.maxCycleNs = qMax(b.maxCycleNs, cycleNs);
+
+    for (const BusSample &sample : samples) {
+        if (sample.channel < 0 || sample.channel >= m_channels.size()) {
+            continue;
+        }
+        Channel &channel = m_channels[sample.channel];
+        if (channel.hasSample) {
+            channel.prevValue = channel.lastValue;
+            channel.prevTimestampNs = channel.lastTimestampNs;
+        } else {
+            channel.prevValue = sample.value;
+            channel.prevTimestampNs = sample.timestampNs;
+            channel.hasSample = true;
+        }
+        channel.lastValue = sample.value;
+        channel.lastTimestampNs = sample.timestampNs;
+    }
+}
+
+void ModbusBusPool::onCycleOverrun(int bus)
+{
+    if (bus >= 0 && bus < m_buses.size()) {
+        ++m_buses[bus].overruns;
+    }
+}
+
+void ModbusBusPool::onBusConnectionChanged(int bus, bool connected)
+{
+    if (bus < 0 || bus >= m_buses.size() || m_buses[bus].connected == connected) {
+        return;
+    }
+    m_buses[bus].connected = connected;
+    LOG_INFO(Log::Modbus, "bus {} {}", m_buses[bus].portName, connected ? "connected" : "disconnected");
+    emit busConnectionChanged(bus, connected);
+}
+
+/**
+ * @brief 输出时间对齐的合并样本
+ * @details 对齐时刻落后当前时间一个轮询周期，保证各总线都已有该时刻之后的样本；
+ *          落在最近两个样本之间时线性插值，否则取最近的样本值。
+ *          全部通道都有样本后，合并样本以对齐时刻写入记录器并注入ModbusManager
+ */
+void ModbusBusPool::emitAlignedFrame()
+{
+    const qint64 alignNs = SampleClock::nowNs() - static_cast<qint64>(m_pollIntervalMs) * 1000000LL;
+    if (alignNs <= m_startNs) {
+        return;
+    }
+
+    QVariantList values;
+    values.reserve(m_channels.size());
+    QVector<double> numbers(m_channels.size(), 0.0);
+    bool complete = true;
+    for (int i = 0; i < m_channels.size(); ++i) {
+        const Channel &channel = m_channels.at(i);
+        if (!channel.hasSample) {
+            values.append(QVariant());
+            complete = false;
+            continue;
+        }
+        if (alignNs >= channel.lastTimestampNs) {
+            numbers[i] = channel.lastValue;
+        } else if (alignNs <= channel.prevTimestampNs || channel.lastTimestampNs == channel.prevTimestampNs) {
+            numbers[i] = channel.prevValue;
+        } else {
+            const double t = static_cast<double>(alignNs - channel.prevTimestampNs)
+                           / static_cast<double>(channel.lastTimestampNs - channel.prevTimestampNs);
+            numbers[i] = channel.prevValue + (channel.lastValue - channel.prevValue) * t;
+        }
+        values.append(numbers.at(i));
+    }
+
+    m_latestFrame = values;
+    emit frameReady((alignNs - m_startNs) / 1e6, values, alignNs);
+
+    if (!complete) {
+        return;
+    }
+    if (m_dataRecorder) {
+        m_dataRecorder->setValues(numbers.constData(), static_cast<int>(numbers.size()), alignNs);
+    }
+    if (m_modbusManager) {
+        m_modbusManager->injectSample(numbers.value(0), numbers.value(1), numbers.value(2), alignNs);
+    }
+}
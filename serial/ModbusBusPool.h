@@ -0,0 +1,308 @@
+#ifndef MODBUSBUSPOOL_H
+#define MODBUSBUSPOOL_H
+
+#include <QObject>
+#include <QVector>
+#include <QStringList>
+#include <QVariantList>
+#include <QSerialPort>
+#include <QTimer>
+#include <QThread>
+#include <QMetaType>
+#include "ModbusManager.h"
+#include "DataRecorder.h"
+
+class ModbusTransport;
+
+/**
+ * @brief 单个寄存器采样点
+ * @details 总线工作对象按此配置轮询，结果通过channel编号归入合并后的数据流
+ */
+struct BusPoint {
+    int channel = 0;
+    int slave = 1;
+    int address = 0;
+    double scale = 1.0;
+};
+
+/**
+ * @brief 带时间戳的通道样本
+ * @details timestampNs为采样时刻（请求与应答的中点），UTC纳秒（SampleClock），
+ *          与ModbusManager::sampleReady及记录器的时间戳可直接比较
+ */
+struct BusSample {
+    int channel = 0;
+    double value = 0.0;
+    qint64 timestampNs = 0;
+};
+Q_DECLARE_METATYPE(BusSample)
+
+/**
+ * @brief 总线工作对象
+ * @details 运行在独立线程中，独占一个串口和一个ModbusTransport，
+ *          按固定周期轮询分配到本总线的从站寄存器
+ */
+class ModbusBusWorker : public QObject
+{
+    Q_OBJECT
+
+public:
+    /**
+     * @brief 构造函数
+     * @param bus 总线编号
+     * @param portName 串口名称
+     * @param baudRate 波特率
+     * @param parity 校验位
+     * @param points 本总线的采样点
+     */
+    ModbusBusWorker(int bus, const QString &portName, int baudRate, QSerialPort::Parity parity,
+                    const QVector<BusPoint> &points);
+
+public slots:
+    /**
+     * @brief 打开串口并开始轮询
+     * @param intervalMs 轮询周期
+     * @details 必须在工作线程中调用，串口对象在此创建
+     */
+    void start(int intervalMs);
+
+    /**
+     * @brief 停止轮询并关闭串口
+     */
+    void stop();
+
+signals:
+    /**
+     * @brief 一轮轮询完成信号
+     * @param bus 总线编号
+     * @param samples 本轮成功读取的样本
+     * @param cycleNs 本轮耗时
+     * @param errors 本轮失败的请求数
+     */
+    void cycleCompleted(int bus, const QList<BusSample> &samples, qint64 cycleNs, int errors);
+
+    /**
+     * @brief 上一轮未完成导致跳过的轮询信号
+     */
+    void cycleOverrun(int bus);
+
+    /**
+     * @brief 连接状态变化信号
+     */
+    void connectionChanged(int bus, bool connected);
+
+    /**
+     * @brief 错误发生信号
+     */
+    void errorOccurred(int bus, const QString &error);
+
+private:
+    void poll();
+    void finishRequest();
+
+    int m_bus;
+    QString m_portName;
+    int m_baudRate;
+    QSerialPort::Parity m_parity;
+    QVector<BusPoint> m_points;
+
+    ModbusTransport *m_transport;
+    QTimer *m_pollTimer;
+
+    QList<BusSample> m_cycleSamples;
+    int m_cyclePending;
+    int m_cycleErrors;
+    qint64 m_cycleStartNs;
+};
+
+/**
+ * @brief 多总线采集池
+ * @details 每个配置的串口对应一个工作线程和一个主站，各总线并行轮询，
+ *          总吞吐随适配器数量增加而不受单条9600波特率总线限制。
+ *          各通道样本以SampleClock打时间戳，按对齐周期插值合并为一条时间对齐的数据流。
+ *          合并后的样本可直接写入记录器（全部通道），并经ModbusManager::injectSample
+ *          以前三个通道作为电压/电流/功率注入实时数据路径（波形、记录、发布）
+ */
+class ModbusBusPool : public QObject
+{
+    Q_OBJECT
+    /**
+     * @brief 已配置的总线数
+     */
+    Q_PROPERTY(int busCount READ busCount NOTIFY busesChanged)
+
+    /**
+     * @brief 合并数据流的通道名称，顺序与frameReady的values一致
+     */
+    Q_PROPERTY(QStringList channelNames READ channelNames NOTIFY channelsChanged)
+
+    /**
+     * @brief 是否正在采集
+     */
+    Q_PROPERTY(bool running READ running NOTIFY runningChanged)
+
+    /**
+     * @brief 合并输出周期（毫秒）
+     */
+    Q_PROPERTY(int alignIntervalMs READ alignIntervalMs WRITE setAlignIntervalMs NOTIFY alignIntervalMsChanged)
+
+    /**
+     * @brief 注入目标，设置后每个合并样本的前三个通道作为电压/电流/功率注入
+     */
+    Q_PROPERTY(ModbusManager *modbusManager READ modbusManager WRITE setModbusManager NOTIFY modbusManagerChanged)
+
+    /**
+     * @brief 记录器，设置后每个合并样本的全部通道按对齐时刻写入（通道定义应与channelNames一致）
+     */
+    Q_PROPERTY(DataRecorder *dataRecorder READ dataRecorder WRITE setDataRecorder NOTIFY dataRecorderChanged)
+
+public:
+    explicit ModbusBusPool(QObject *parent = nullptr);
+    ~ModbusBusPool();
+
+    int busCount() const { return m_buses.size(); }
+    QStringList channelNames() const;
+    bool running() const { return m_running; }
+    int alignIntervalMs() const { return m_alignIntervalMs; }
+    void setAlignIntervalMs(int intervalMs);
+    ModbusManager *modbusManager() const { return m_modbusManager; }
+    void setModbusManager(ModbusManager *manager);
+    DataRecorder *dataRecorder() const { return m_dataRecorder; }
+    void setDataRecorder(DataRecorder *recorder);
+
+    /**
+     * @brief 添加总线
+     * @param portName 串口名称
+     * @param baudRate 波特率
+     * @param parity 校验位（0：无校验，1：奇校验，2：偶校验）
+     * @return 总线编号，采集中或串口重复时返回-1
+     */
+    Q_INVOKABLE int addBus(const QString &portName, int baudRate = 9600, int parity = 0);
+
+    /**
+     * @brief 将从站寄存器分配到总线
+     * @param bus 总线编号
+     * @param channelName 通道名称
+     * @param slaveAddress 从站地址
+     * @param registerAddress 寄存器地址
+     * @param scale 原始值换算系数
+     * @return 通道编号，失败返回-1
+     */
+    Q_INVOKABLE int assignSlave(int bus, const QString &channelName, int slaveAddress, int registerAddress, double scale = 1.0);
+
+    /**
+     * @brief 按配置文本设置全部总线与通道
+     * @param spec 各总线以分号分隔，每条总线为"串口[:波特率[:校验]] 通道=从站/寄存器[*系数] ..."，
+     *             校验为none/odd/even，寄存器可写为0x十六进制，如"COM3:9600 电压=1/0*0.1 电流=2/0*0.1; COM4 功率=3/0*0.01"
+     * @return 配置是否有效，无效时清空配置并发出errorOccurred(-1, 原因)
+     */
+    Q_INVOKABLE bool configure(const QString &spec);
+
+    /**
+     * @brief 清除全部总线与通道配置
+     */
+    Q_INVOKABLE void clear();
+
+    /**
+     * @brief 启动全部总线
+     * @param pollIntervalMs 各总线的轮询周期
+     * @return 是否启动
+     */
+    Q_INVOKABLE bool start(int pollIntervalMs = 100);
+
+    /**
+     * @brief 停止全部总线并等待工作线程退出
+     */
+    Q_INVOKABLE void stop();
+
+    /**
+     * @brief 获取最近一次合并输出的各通道值
+     */
+    Q_INVOKABLE QVariantList latestFrame() const { return m_latestFrame; }
+
+    /**
+     * @brief 获取各总线统计
+     * @return 每条总线一个映射：port、connected、cycles、overruns、errors、avgCycleUs、maxCycleUs
+     */
+    Q_INVOKABLE QVariantList busStatistics() const;
+
+signals:
+    void busesChanged();
+    void channelsChanged();
+    void runningChanged();
+    void alignIntervalMsChanged();
+    void modbusManagerChanged();
+    void dataRecorderChanged();
+
+    /**
+     * @brief 时间对齐的合并样本信号
+     * @param timeMs 对齐时刻（相对启动时刻的毫秒数）
+     * @param values 各通道在该时刻的值，尚无样本的通道为空值
+     * @param timestampNs 对齐时刻，UTC纳秒（SampleClock）
+     */
+    void frameReady(double timeMs, const QVariantList &values, qint64 timestampNs);
+
+    /**
+     * @brief 总线连接状态变化信号
+     */
+    void busConnectionChanged(int bus, bool connected);
+
+    /**
+     * @brief 总线错误信号
+     * @param bus 总线编号，配置错误时为-1
+     */
+    void errorOccurred(int bus, const QString &error);
+
+private slots:
+    void onCycleCompleted(int bus, const QList<BusSample> &samples, qint64 cycleNs, int errors);
+    void onCycleOverrun(int bus);
+    void onBusConnectionChanged(int bus, bool connected);
+    void emitAlignedFrame();
+
+private:
+    bool failConfigure(const QString &error);
+
+    /**
+     * @brief 总线配置与运行统计
+     */
+    struct Bus {
+        QString portName;
+        int baudRate = 9600;
+        QSerialPort::Parity parity = QSerialPort::NoParity;
+        QVector<BusPoint> points;
+        QThread *thread = nullptr;
+        ModbusBusWorker *worker = nullptr;
+        bool connected = false;
+        qint64 cycles = 0;
+        qint64 overruns = 0;
+        qint64 errors = 0;
+        qint64 totalCycleNs = 0;
+        qint64 maxCycleNs = 0;
+    };
+
+    /**
+     * @brief 通道的最近两个样本，用于对齐时刻的线性插值
+     */
+    struct Channel {
+        QString name;
+        int bus = 0;
+        bool hasSample = false;
+        double lastValue = 0.0;
+        qint64 lastTimestampNs = 0;
+        double prevValue = 0.0;
+        qint64 prevTimestampNs = 0;
+    };
+
+    QVector<Bus> m_buses;
+    QVector<Channel> m_channels;
+    ModbusManager *m_modbusManager;
+    DataRecorder *m_dataRecorder;
+    qint64 m_startNs;               ///< 启动时刻，UTC纳秒
+    QTimer *m_alignTimer;
+    int m_alignIntervalMs;
+    int m_pollIntervalMs;
+    bool m_running;
+    QVariantList m_latestFrame;
+};
+
+#endif
@@ -0,0 +1,64 @@
+#ifndef MODBUSCRC_H
+#define MODBUSCRC_H
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+
+/**
+ * @brief Modbus RTU CRC16 计算
+ * @details 多项式0xA001（反射），初值0xFFFF。采用slicing-by-8查表：
+ *          8张256项表在编译期生成，每次迭代处理8个字节
+ */
+namespace ModbusCrc {
+
+using Table = std::array<std::array<uint16_t, 256>, 8>;
+
+constexpr Table makeTable()
+{
+    Table table{};
+    for (int n = 0; n < 256; ++n) {
+        uint16_t crc = static_cast<uint16_t>(n);
+        for (int bit = 0; bit < 8; ++bit) {
+            crc = (crc & 1) ? static_cast<uint16_t>((crc >> 1) ^ 0xA001) : static_cast<uint16_t>(crc >> 1);
+        }
+        table[0][n] = crc;
+    }
+    for (int k = 1; k < 8; ++k) {
+        for (int n = 0; n < 256; ++n) {
+            const uint16_t prev = table[k - 1][n];
+            table[k][n] = static_cast<uint16_t>((prev >> 8) ^ table[0][prev & 0xFF]);
+        }
+    }
+    return table;
+}
+
+inline constexpr Table kTable = makeTable();
+
+/**
+ * @brief 计算CRC16
+ * @param data 数据
+ * @param length 字节数
+ * @return CRC值（低字节在前发送）
+ */
+inline uint16_t compute(const uint8_t *data, std::size_t length)
+{
+    uint16_t crc = 0xFFFF;
+    while (length >= 8) {
+        crc ^= static_cast<uint16_t>(data[0] | (data[1] << 8));
+        crc = kTable[7][crc & 0xFF] ^ kTable[6][crc >> 8]
+            ^ kTable[5][data[2]] ^ kTable[4][data[3]]
+            ^ kTable[3][data[4]] ^ kTable[2][data[5]]
+            ^ kTable[1][data[6]] ^ kTable[0][data[7]];
+        data += 8;
+        length -= 8;
+    }
+    while (length--) {
+        crc = static_cast<uint16_t>((crc >> 8) ^ kTable[0][(crc ^ *data++) & 0xFF]);
+    }
+    return crc;
+}
+
+} // namespace ModbusCrc
+
+#endif
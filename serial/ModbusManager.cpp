@@ -1,8 +1,101 @@
 // 包含必要的头文件
 #include "ModbusManager.h"
-#include <QDebug>
+#include "ModbusCrc.h"
+#include "../core/Logger.h"
+#include "../core/Metrics.h"
+#include "../core/SampleClock.h"
 #include <QVariant>
 #include <QSerialPort>
+#include <QElapsedTimer>
+#include <QModbusPdu>
+#include <QtAlgorithms>
+#include <cstring>
+#include <limits>
+
+namespace {
+
+/**
+ * @brief 按大端序追加16位值
+ */
+void appendWord(QByteArray &data, int value)
+{
+    data.append(static_cast<char>((value >> 8) & 0xFF));
+    data.append(static_cast<char>(value & 0xFF));
+}
+
+/**
+ * @brief 追加字节数与寄存器值（功能码16/23的写入部分）
+ */
+void appendValues(QByteArray &data, const QVector<quint16> &values)
+{
+    data.append(static_cast<char>(values.size() * 2));
+    for (quint16 value : values) {
+        appendWord(data, value);
+    }
+}
+
+/**
+ * @brief 捕获Qt Modbus主站的总线帧
+ * @details QModbusRtuSerialMaster不暴露原始字节，按PDU补全从站地址与CRC重建RTU帧；
+ *          Qt内部的重试不可见，CRC错误的应答也不会出现在捕获中
+ */
+void captureRebuiltFrame(Log::FrameDirection direction, int slave, quint8 functionCode, const QByteArray &data)
+{
+    quint8 adu[256];
+    const int length = qMin(static_cast<int>(data.size()), 252);
+    adu[0] = static_cast<quint8>(slave);
+    adu[1] = functionCode;
+    std::memcpy(adu + 2, data.constData(), static_cast<size_t>(length));
+    const quint16 crc = ModbusCrc::compute(adu, static_cast<std::size_t>(length + 2));
+    adu[length + 2] = static_cast<quint8>(crc & 0xFF);
+    adu[length + 3] = static_cast<quint8>(crc >> 8);
+    LOG_FRAME(Log::Modbus, direction, Log::RebuiltRtuFrame, adu, length + 4);
+}
+
+/**
+ * @brief 捕获Qt Modbus主站收到的应答
+ * @details 超时等没有应答PDU的情况不写入，由分析工具按未应答请求统计
+ */
+void captureReply(const QModbusReply *reply)
+{
+    if (!Log::Logger::frameLogging()) {
+        return;
+    }
+    const QModbusResponse raw = reply->rawResult();
+    if (!raw.isValid()) {
+        return;
+    }
+    const quint8 functionCode = static_cast<quint8>(raw.functionCode()) | (raw.isException() ? 0x80 : 0x00);
+    captureRebuiltFrame(Log::Rx, reply->serverAddress(), functionCode, raw.data());
+}
+
+/**
+ * @brief 自适应采样：活动保持期结束后读取间隔的起始值与每次读取的放大倍数
+ */
+constexpr qint64 ADAPTIVE_MIN_INTERVAL_NS = 10 * 1000000LL;
+constexpr double ADAPTIVE_DECAY_FACTOR = 1.5;
+
+/**
+ * @brief 到期时刻相差不足该值的通道合并到同一轮读取
+ */
+constexpr qint64 ADAPTIVE_GROUP_NS = 5 * 1000000LL;
+
+/**
+ * @brief 读取间隔指数平均的系数
+ */
+constexpr double RATE_SMOOTHING = 0.2;
+
+/**
+ * @brief 模拟量通道，三者相互关联，其中一个变化时一起加速
+ */
+constexpr int ANALOG_CHANNELS = ModbusManager::VoltageChannel | ModbusManager::CurrentChannel | ModbusManager::PowerChannel;
+
+/**
+ * @brief 各通道在samplingRates()中的键名，按Channel的位序号排列
+ */
+const char *const CHANNEL_NAMES[] = {"voltage", "current", "power", "fanState", "highTemp"};
+
+} // namespace
 
 /**
  * @brief ModbusManager构造函数
@@ -22,6 +115,25 @@ ModbusManager::ModbusManager(QObject *parent)
     , m_hasFanStateData(false)
     , m_hasHighTempData(false)
     , m_pendingReads(0)
+    , m_burstActive(false)
+    , m_burstMask(AllChannels)
+    , m_resumeTimerAfterBurst(false)
+    , m_sampleTimeNs(0)
+    , m_lastSampleNs(0)
+    , m_adaptiveSampling(false)
+    , m_adaptiveRunning(false)
+    , m_activityHoldMs(2000)
+    , m_adaptiveTimer(nullptr)
+    , m_transport(nullptr)
+    , m_nativeTransport(false)
+    , m_transportActive(false)
+    , m_transactionCount(0)
+    , m_transactionErrors(0)
+    , m_totalRoundTripNs(0)
+    , m_maxRoundTripNs(0)
+    , m_setPointVoltage(0.0)
+    , m_setPointCurrent(0.0)
+    , m_readWriteUnsupported(false)
 {
     // 创建Modbus RTU串行主机
     m_modbusMaster = new QModbusRtuSerialMaster(this);
@@ -33,11 +145,37 @@ ModbusManager::ModbusManager(QObject *parent)
     connect(m_modbusMaster, &QModbusClient::errorOccurred,
             this, &ModbusManager::onErrorOccurred);
     
+    // 创建自有RTU传输层（仅在启用nativeTransport时使用）
+    m_transport = new ModbusTransport(this);
+    connect(m_transport, &ModbusTransport::connectedChanged, this, [this](bool connected) {
+        if (m_transportActive && m_connected != connected) {
+            m_connected = connected;
+            emit connectedChanged();
+            LOG_INFO(Log::Modbus, "state changed: {}", connected ? "connected" : "disconnected");
+        }
+    });
+    connect(m_transport, &ModbusTransport::errorOccurred, this, [this](const QString &error) {
+        emit errorOccurred(error);
+        LOG_WARNING(Log::Modbus, "error: {}", error);
+    });
+    
     // 创建读取定时器
     m_readTimer = new QTimer(this);
     m_readTimer->setInterval(1000); // 默认读取间隔为1000毫秒
     // 连接定时器超时信号到读取所有寄存器的槽函数
     connect(m_readTimer, &QTimer::timeout, this, &ModbusManager::readAllRegisters);
+
+    // 自适应采样的单次定时器，每轮读取完成后按最早到期的通道重新安排
+    m_adaptiveTimer = new QTimer(this);
+    m_adaptiveTimer->setSingleShot(true);
+    m_adaptiveTimer->setTimerType(Qt::PreciseTimer);
+    connect(m_adaptiveTimer, &QTimer::timeout, this, &ModbusManager::readAllRegisters);
+    m_activityClock.start();
+
+    // 默认死区约为5个最小分度
+    m_channels[0].deadband = 0.5;   // 电压，V
+    m_channels[1].deadband = 0.2;   // 电流，A
+    m_channels[2].deadband = 0.05;  // 功率，kW
 }
 
 /**
@@ -49,6 +187,10 @@ ModbusManager::~ModbusManager()
     if (m_modbusMaster) {
         m_modbusMaster->disconnectDevice();
     }
+    if (m_transport) {
+        m_transport->close();
+    }
+    Metrics::adjust(Metrics::PendingReads, -m_pendingReads);
 }
 
 /**
@@ -74,33 +216,92 @@ bool ModbusManager::connectToPort(const QString &portName, int baudRate, int par
         parityValue = QSerialPort::EvenParity;
     }
     
-    // 设置连接参数
-    m_modbusMaster->setConnectionParameter(QModbusDevice::SerialPortNameParameter, QVariant::fromValue(portName));
-    m_modbusMaster->setConnectionParameter(QModbusDevice::SerialBaudRateParameter, QVariant::fromValue(baudRate));
-    m_modbusMaster->setConnectionParameter(QModbusDevice::SerialDataBitsParameter, QVariant::fromValue(QSerialPort::Data8));
-    m_modbusMaster->setConnectionParameter(QModbusDevice::SerialParityParameter, QVariant::fromValue(parityValue));
-    m_modbusMaster->setConnectionParameter(QModbusDevice::SerialStopBitsParameter, QVariant::fromValue(QSerialPort::OneStop));
+    resetDeviceCapabilities();
     
-    // 设置超时和重试次数
-    m_modbusMaster->setTimeout(1000);
-    m_modbusMaster->setNumberOfRetries(3);
+    // 使用自有RTU传输层时直接打开串口
+    m_transportActive = m_nativeTransport;
+    if (m_transportActive) {
+        m_transport->setTimeout(1000);
+        m_transport->setNumberOfRetries(3);
+        if (!m_transport->open(portName, baudRate, parityValue)) {
+            m_transportActive = false;
+            return false;
+        }
+        LOG_INFO(Log::Modbus, "使用自有RTU传输层，帧间静默: {} us", m_transport->silentIntervalNs() / 1000);
+    } else {
+        // 设置连接参数
+        m_modbusMaster->setConnectionParameter(QModbusDevice::SerialPortNameParameter, QVariant::fromValue(portName));
+        m_modbusMaster->setConnectionParameter(QModbusDevice::SerialBaudRateParameter, QVariant::fromValue(baudRate));
+        m_modbusMaster->setConnectionParameter(QModbusDevice::SerialDataBitsParameter, QVariant::fromValue(QSerialPort::Data8));
+        m_modbusMaster->setConnectionParameter(QModbusDevice::SerialParityParameter, QVariant::fromValue(parityValue));
+        m_modbusMaster->setConnectionParameter(QModbusDevice::SerialStopBitsParameter, QVariant::fromValue(QSerialPort::OneStop));
     
-    // 连接设备
-    m_modbusMaster->connectDevice();
+        // 设置超时和重试次数
+        m_modbusMaster->setTimeout(1000);
+        m_modbusMaster->setNumberOfRetries(3);
+    
+        // 连接设备
+        m_modbusMaster->connectDevice();
+    }
     
     // 输出连接参数
     QString parityStr = (parity == 0) ? "无校验" : (parity == 1) ? "奇校验" : "偶校验";
-    qDebug() << "========================================";
-    qDebug() << "Modbus 连接参数:";
-    qDebug() << "  串口号:" << portName;
-    qDebug() << "  波特率:" << baudRate;
-    qDebug() << "  校验位:" << parityStr;
-    qDebug() << "  数据位: 8";
-    qDebug() << "  停止位: 1";
-    qDebug() << "========================================";
+    LOG_INFO(Log::Modbus, "连接参数: 串口号={} 波特率={} 校验位={} 数据位=8 停止位=1", portName, baudRate, parityStr);
+    return true;
+}
+
+/**
+ * @brief 通过以太网网关连接Modbus设备
+ * @param host 网关地址
+ * @param port TCP端口
+ * @param framing 帧格式（0：Modbus TCP，1：RTU over TCP）
+ * @return 是否已开始连接
+ * @details 网络连接始终使用自有传输层：Modbus TCP下轮询的各个读请求同时发出，
+ *          按事务标识符匹配应答，不再逐个等待
+ */
+bool ModbusManager::connectToHost(const QString &host, int port, int framing)
+{
+    // 如果已经连接，先断开
+    if (m_connected) {
+        disconnectPort();
+    }
+    
+    if (port < 1 || port > 65535) {
+        LOG_WARNING(Log::Modbus, "invalid TCP port: {}", port);
+        return false;
+    }
+    
+    resetDeviceCapabilities();
+    
+    const ModbusTransport::Framing transportFraming = framing == RtuOverTcp
+            ? ModbusTransport::RtuOverTcpFraming : ModbusTransport::TcpFraming;
+    m_transportActive = true;
+    m_transport->setTimeout(1000);
+    m_transport->setNumberOfRetries(3);
+    if (!m_transport->openTcp(host, static_cast<quint16>(port), transportFraming)) {
+        m_transportActive = false;
+        return false;
+    }
+    
+    // 输出连接参数
+    LOG_INFO(Log::Modbus, "连接参数: 网关地址={} 端口={} 帧格式={} 最大未完成事务数={}", host, port,
+             framing == RtuOverTcp ? "RTU over TCP" : "Modbus TCP",
+             framing == RtuOverTcp ? 1 : m_transport->maxOutstanding());
     return true;
 }
 
+/**
+ * @brief 新连接前重置从站能力探测结果
+ * @details 新连接的从站重新探测功能码23支持情况
+ */
+void ModbusManager::resetDeviceCapabilities()
+{
+    if (m_readWriteUnsupported) {
+        m_readWriteUnsupported = false;
+        emit readWriteSupportedChanged();
+    }
+}
+
 /**
  * @brief 断开与Modbus设备的连接
  * @details 停止读取并断开设备连接
@@ -113,6 +314,12 @@ void ModbusManager::disconnectPort()
     if (m_modbusMaster) {
         m_modbusMaster->disconnectDevice();
     }
+    if (m_transport) {
+        m_transport->close();
+    }
+    // 未返回的请求随连接一起作废
+    Metrics::adjust(Metrics::PendingReads, -m_pendingReads);
+    m_pendingReads = 0;
     // 更新连接状态
     m_connected = false;
     emit connectedChanged();
@@ -121,16 +328,21 @@ void ModbusManager::disconnectPort()
 /**
  * @brief 开始定时读取数据
  * @param intervalMs 读取间隔，单位为毫秒
- * @details 启动定时器，定时读取Modbus寄存器
+ * @details 启动定时器，定时读取Modbus寄存器；自适应采样时该间隔为稳定状态下的最低速率
  */
 void ModbusManager::startReading(int intervalMs)
 {
     if (m_readTimer) {
         // 设置读取间隔
         m_readTimer->setInterval(intervalMs);
-        // 启动定时器
-        m_readTimer->start();
-        qDebug() << "Started reading Modbus registers every" << intervalMs << "ms";
+        // 启动定时器（突发轮询中则在突发结束后启动）
+        if (m_burstActive) {
+            m_resumeTimerAfterBurst = true;
+        } else {
+            resumeReading();
+        }
+        LOG_INFO(Log::Modbus, "started reading registers every {} ms{}", intervalMs,
+                 m_adaptiveSampling ? " (adaptive)" : "");
     }
 }
 
@@ -143,6 +355,259 @@ void ModbusManager::stopReading()
     if (m_readTimer) {
         m_readTimer->stop();
     }
+    m_adaptiveTimer->stop();
+    m_adaptiveRunning = false;
+    // 停止读取时同时退出突发模式，且不再恢复定时器
+    if (m_burstActive) {
+        m_burstActive = false;
+        m_resumeTimerAfterBurst = false;
+        emit burstActiveChanged();
+    }
+}
+
+/**
+ * @brief 开始突发轮询
+ * @param channelMask 需要读取的通道位掩码
+ * @details 暂停定时器，只读取指定通道，每轮读取完成后立即发起下一轮
+ */
+void ModbusManager::startBurstReading(int channelMask)
+{
+    const int mask = channelMask & AllChannels;
+    if (!m_connected || mask == 0) {
+        return;
+    }
+
+    m_burstMask = mask;
+    if (!m_burstActive) {
+        // 记录突发前定时器是否在运行，以便结束后恢复
+        m_resumeTimerAfterBurst = readingActive();
+        m_readTimer->stop();
+        m_adaptiveTimer->stop();
+        m_adaptiveRunning = false;
+        m_burstActive = true;
+        emit burstActiveChanged();
+    }
+
+    // 若上一轮仍在进行，则由其完成时接续下一轮
+    if (m_pendingReads == 0) {
+        readAllRegisters();
+    }
+}
+
+/**
+ * @brief 停止突发轮询
+ * @details 退出突发模式并恢复之前的定时读取
+ */
+void ModbusManager::stopBurstReading()
+{
+    if (!m_burstActive) {
+        return;
+    }
+
+    m_burstActive = false;
+    emit burstActiveChanged();
+    if (m_resumeTimerAfterBurst) {
+        resumeReading();
+    }
+    m_resumeTimerAfterBurst = false;
+}
+
+/**
+ * @brief 设置是否启用自适应采样
+ * @param enabled 是否启用
+ * @details 正在定时读取时立即在固定间隔与自适应之间切换；突发轮询中则在突发结束后生效
+ */
+void ModbusManager::setAdaptiveSampling(bool enabled)
+{
+    if (m_adaptiveSampling == enabled) {
+        return;
+    }
+    const bool reading = readingActive();
+    m_adaptiveSampling = enabled;
+    if (reading && !m_burstActive) {
+        resumeReading();
+    }
+    emit adaptiveSamplingChanged();
+}
+
+/**
+ * @brief 设置活动后保持最高速率的时间
+ * @param ms 毫秒
+ */
+void ModbusManager::setActivityHoldMs(int ms)
+{
+    ms = qMax(0, ms);
+    if (m_activityHoldMs == ms) {
+        return;
+    }
+    m_activityHoldMs = ms;
+    emit activityHoldMsChanged();
+}
+
+/**
+ * @brief 设置通道的变化死区
+ * @param channel 通道
+ * @param deadband 死区
+ */
+void ModbusManager::setDeadband(int channel, double deadband)
+{
+    if (channel <= 0 || (channel & (channel - 1)) != 0 || (channel & AllChannels) == 0) {
+        LOG_WARNING(Log::Modbus, "invalid deadband channel: {}", channel);
+        return;
+    }
+    m_channels[qCountTrailingZeroBits(static_cast<quint32>(channel))].deadband = qMax(0.0, deadband);
+}
+
+/**
+ * @brief 获取各通道的实际采样速率
+ * @return 每秒读取次数
+ * @details 按读取间隔的指数平均计算；距上次读取已超过平均间隔时按实际等待时间计算，
+ *          停止读取后速率随之下降
+ */
+QVariantMap ModbusManager::samplingRates() const
+{
+    const qint64 now = m_activityClock.nsecsElapsed();
+    QVariantMap rates;
+    for (int i = 0; i < CHANNEL_COUNT; ++i) {
+        const ChannelActivity &channel = m_channels[i];
+        double rate = 0.0;
+        if (channel.lastSampleNs >= 0 && channel.averageIntervalNs > 0) {
+            rate = 1e9 / qMax(channel.averageIntervalNs, static_cast<double>(now - channel.lastSampleNs));
+        }
+        rates[CHANNEL_NAMES[i]] = rate;
+    }
+    return rates;
+}
+
+/**
+ * @brief 是否正在定时读取
+ * @return 固定间隔定时器在运行或自适应读取在进行
+ */
+bool ModbusManager::readingActive() const
+{
+    return m_readTimer->isActive() || m_adaptiveRunning;
+}
+
+/**
+ * @brief 按当前模式恢复定时读取
+ */
+void ModbusManager::resumeReading()
+{
+    if (m_adaptiveSampling) {
+        m_readTimer->stop();
+        m_adaptiveRunning = true;
+        scheduleAdaptiveRead();
+    } else {
+        m_adaptiveTimer->stop();
+        m_adaptiveRunning = false;
+        m_readTimer->start();
+    }
+}
+
+/**
+ * @brief 记录通道的一次读数并更新其读取间隔
+ * @param channelIndex 通道序号
+ * @param value 读数
+ * @details 读数与上次活动时的读数相差超过死区时视为活动（缓慢漂移累计超过死区同样触发）；
+ *          活动保持期内每轮都读取，之后间隔从10ms起每次放大1.5倍，直至startReading的间隔
+ */
+void ModbusManager::updateChannelActivity(int channelIndex, double value)
+{
+    ChannelActivity &channel = m_channels[channelIndex];
+    const qint64 now = m_activityClock.nsecsElapsed();
+    if (channel.lastSampleNs >= 0) {
+        const double intervalNs = static_cast<double>(now - channel.lastSampleNs);
+        channel.averageIntervalNs = channel.averageIntervalNs > 0
+                ? channel.averageIntervalNs + RATE_SMOOTHING * (intervalNs - channel.averageIntervalNs)
+                : intervalNs;
+    }
+    channel.lastSampleNs = now;
+
+    if (!channel.hasValue || qAbs(value - channel.lastValue) > channel.deadband) {
+        if (channel.hasValue) {
+            const int bit = 1 << channelIndex;
+            markActivity((bit & ANALOG_CHANNELS) ? ANALOG_CHANNELS : bit);
+        }
+        channel.lastValue = value;
+        channel.hasValue = true;
+    }
+
+    const qint64 holdNs = static_cast<qint64>(m_activityHoldMs) * 1000000LL;
+    const qint64 idleNs = static_cast<qint64>(m_readTimer->interval()) * 1000000LL;
+    if (channel.lastActiveNs >= 0 && now - channel.lastActiveNs < holdNs) {
+        channel.intervalNs = 0;
+    } else {
+        const qint64 decayed = static_cast<qint64>(channel.intervalNs * ADAPTIVE_DECAY_FACTOR);
+        channel.intervalNs = qMin(idleNs, qMax(ADAPTIVE_MIN_INTERVAL_NS, decayed));
+    }
+}
+
+/**
+ * @brief 记录通道的一次读取失败并退避其读取间隔
+ * @param channelIndex 通道序号
+ * @details 失败同样记下读取时刻（计入实际读取速率），但不更新读数、不视为活动：
+ *          清除活动保持，读取间隔直接回到startReading的间隔，从站无应答或返回异常时
+ *          不会以总线最高速率重试；下次读取成功后按正常规则重新加速
+ */
+void ModbusManager::recordChannelFailure(int channelIndex)
+{
+    ChannelActivity &channel = m_channels[channelIndex];
+    channel.lastSampleNs = m_activityClock.nsecsElapsed();
+    channel.lastActiveNs = -1;
+    channel.intervalNs = static_cast<qint64>(m_readTimer->interval()) * 1000000LL;
+}
+
+/**
+ * @brief 标记通道活动
+ * @param channelMask 通道位掩码
+ * @details 这些通道立即到期，下一轮起以总线允许的最高速率读取
+ */
+void ModbusManager::markActivity(int channelMask)
+{
+    const qint64 now = m_activityClock.nsecsElapsed();
+    for (int i = 0; i < CHANNEL_COUNT; ++i) {
+        if (channelMask & (1 << i)) {
+            m_channels[i].lastActiveNs = now;
+            m_channels[i].intervalNs = 0;
+        }
+    }
+    scheduleAdaptiveRead();
+}
+
+/**
+ * @brief 获取已到读取时刻的通道
+ * @return 通道位掩码
+ */
+int ModbusManager::dueChannels() const
+{
+    const qint64 now = m_activityClock.nsecsElapsed();
+    int mask = 0;
+    for (int i = 0; i < CHANNEL_COUNT; ++i) {
+        const ChannelActivity &channel = m_channels[i];
+        if (channel.lastSampleNs < 0 || channel.lastSampleNs + channel.intervalNs <= now + ADAPTIVE_GROUP_NS) {
+            mask |= 1 << i;
+        }
+    }
+    return mask;
+}
+
+/**
+ * @brief 按最早到期的通道安排下一轮自适应读取
+ * @details 本轮读取尚未全部返回时由finishPendingRead在完成后安排
+ */
+void ModbusManager::scheduleAdaptiveRead()
+{
+    if (!m_adaptiveRunning || m_burstActive || m_pendingReads > 0) {
+        return;
+    }
+    const qint64 now = m_activityClock.nsecsElapsed();
+    qint64 earliest = std::numeric_limits<qint64>::max();
+    for (const ChannelActivity &channel : m_channels) {
+        const qint64 due = channel.lastSampleNs < 0 ? now : channel.lastSampleNs + channel.intervalNs;
+        earliest = qMin(earliest, due);
+    }
+    const qint64 waitNs = earliest - now;
+    m_adaptiveTimer->start(waitNs > 0 ? static_cast<int>((waitNs + 999999) / 1000000) : 0);
 }
 
 /**
@@ -152,11 +617,16 @@ void ModbusManager::stopReading()
  */
 void ModbusManager::onStateChanged(QModbusDevice::State state)
 {
+    // 使用自有传输层时忽略Qt主站的状态
+    if (m_transportActive) {
+        return;
+    }
+    
     bool newConnected = (state == QModbusDevice::ConnectedState);
     if (m_connected != newConnected) {
         m_connected = newConnected;
         emit connectedChanged();
-        qDebug() << "Modbus state changed:" << (newConnected ? "connected" : "disconnected");
+        LOG_INFO(Log::Modbus, "state changed: {}", newConnected ? "connected" : "disconnected");
     }
 }
 
@@ -169,7 +639,7 @@ void ModbusManager::onErrorOccurred(QModbusDevice::Error error)
 {
     if (error != QModbusDevice::NoError) {
         emit errorOccurred(m_modbusMaster->errorString());
-        qDebug() << "Modbus error:" << m_modbusMaster->errorString();
+        LOG_WARNING(Log::Modbus, "error: {}", m_modbusMaster->errorString());
     }
 }
 
@@ -179,115 +649,564 @@ void ModbusManager::onErrorOccurred(QModbusDevice::Error error)
  */
 void ModbusManager::readAllRegisters()
 {
-    // 检查连接状态
-    if (!m_connected || !m_modbusMaster) {
+    // 检查连接状态（自适应读取没有周期定时器，需按空闲间隔重试）
+    if (!m_connected || !busConnected()) {
+        if (m_adaptiveRunning) {
+            m_adaptiveTimer->start(m_readTimer->interval());
+        }
+        return;
+    }
+    
+    // 上一轮读取尚未全部返回时不再叠加请求
+    if (m_pendingReads > 0) {
         return;
     }
     
-    // 设置待处理的读取请求数量
-    m_pendingReads = 5;
+    // 突发模式下只读取指定通道，自适应模式下只读取已到期的通道
+    int mask = AllChannels;
+    if (m_burstActive) {
+        mask = m_burstMask;
+    } else if (m_adaptiveRunning) {
+        mask = dueChannels();
+        if (mask == 0) {
+            scheduleAdaptiveRead();
+            return;
+        }
+    }
+    
+    // 读取各个寄存器（成功发出的请求会计入待处理数量）
+    if (mask & VoltageChannel) {
+        readHoldingRegister(VOLTAGE_SLAVE_ADDRESS, VOLTAGE_REGISTER_ADDRESS, 0);
+    }
+    if (mask & CurrentChannel) {
+        readHoldingRegister(CURRENT_SLAVE_ADDRESS, CURRENT_REGISTER_ADDRESS, 1);
+    }
+    if (mask & PowerChannel) {
+        readHoldingRegister(POWER_SLAVE_ADDRESS, POWER_REGISTER_ADDRESS, 2);
+    }
+    if (mask & FanStateChannel) {
+        readHoldingRegister(FAN_STATE_SLAVE_ADDRESS, FAN_STATE_REGISTER_ADDRESS, 3);
+    }
+    if (mask & HighTempChannel) {
+        readHoldingRegister(HIGH_TEMP_SLAVE_ADDRESS, HIGH_TEMP_REGISTER_ADDRESS, 4);
+    }
     
-    // 读取各个寄存器
-    readHoldingRegister(VOLTAGE_SLAVE_ADDRESS, VOLTAGE_REGISTER_ADDRESS);
-    readHoldingRegister(CURRENT_SLAVE_ADDRESS, CURRENT_REGISTER_ADDRESS);
-    readHoldingRegister(POWER_SLAVE_ADDRESS, POWER_REGISTER_ADDRESS);
-    readHoldingRegister(FAN_STATE_SLAVE_ADDRESS, FAN_STATE_REGISTER_ADDRESS);
-    readHoldingRegister(HIGH_TEMP_SLAVE_ADDRESS, HIGH_TEMP_REGISTER_ADDRESS);
+    // 一个请求都没有发出时不会有完成回调，自适应模式下按空闲间隔重试
+    if (m_adaptiveRunning && !m_burstActive && m_pendingReads == 0) {
+        m_adaptiveTimer->start(m_readTimer->interval());
+    }
 }
 
 /**
- * @brief 读取保持寄存器
- * @param slaveAddress 从站地址
- * @param registerAddress 寄存器地址
- * @details 发送Modbus读取请求，读取指定的保持寄存器
+ * @brief 完成一个读取请求
+ * @details 本轮请求全部返回后发出采样完成信号，突发模式下立即发起下一轮
  */
-void ModbusManager::readHoldingRegister(int slaveAddress, int registerAddress)
+void ModbusManager::finishPendingRead()
 {
-    // 检查连接状态
-    if (!m_modbusMaster || m_modbusMaster->state() != QModbusDevice::ConnectedState) {
+    if (m_pendingReads <= 0) {
+        return;
+    }
+    Metrics::adjust(Metrics::PendingReads, -1);
+    if (--m_pendingReads > 0) {
         return;
     }
     
+    Metrics::add(Metrics::SamplesAcquired);
+    m_lastSampleNs = m_sampleTimeNs;
+    emit sampleReady(m_voltage, m_current, m_power, m_sampleTimeNs);
+    
+    if (m_burstActive) {
+        // 排队到事件循环，避免在回复处理内递归
+        QTimer::singleShot(0, this, &ModbusManager::readAllRegisters);
+    } else if (m_adaptiveRunning) {
+        scheduleAdaptiveRead();
+    }
+}
+
+/**
+ * @brief 注入一个采样
+ * @details 与handleRegisterValue/finishPendingRead对电压、电流、功率的处理一致
+ */
+void ModbusManager::injectSample(double voltage, double current, double power)
+{
+    injectSample(voltage, current, power, SampleClock::nowNs());
+}
+
+void ModbusManager::injectSample(double voltage, double current, double power, qint64 timestampNs)
+{
+    m_voltage = voltage;
+    emit voltageChanged();
+    m_current = current;
+    emit currentChanged();
+    m_power = power;
+    emit powerChanged();
+    Metrics::add(Metrics::SamplesAcquired);
+    m_lastSampleNs = timestampNs;
+    emit sampleReady(m_voltage, m_current, m_power, timestampNs);
+}
+
+/**
+ * @brief 获取当前连接的总线是否可用
+ * @return 当前传输层是否处于连接状态
+ */
+bool ModbusManager::busConnected() const
+{
+    if (m_transportActive) {
+        return m_transport && m_transport->isOpen();
+    }
+    return m_modbusMaster && m_modbusMaster->state() == QModbusDevice::ConnectedState;
+}
+
+/**
+ * @brief 发送读保持寄存器请求
+ * @param slaveAddress 从站地址
+ * @param startAddress 起始寄存器地址
+ * @param count 寄存器数量
+ * @param handler 应答处理函数
+ * @return 请求是否已发出
+ * @details 根据当前传输层选择Qt Modbus主站或自有RTU传输层，并统计事务往返时间
+ */
+bool ModbusManager::sendReadRequest(int slaveAddress, int startAddress, int count, ReplyHandler handler)
+{
+    QElapsedTimer elapsed;
+    elapsed.start();
+    
+    if (m_transportActive) {
+        return m_transport->readHoldingRegisters(slaveAddress, startAddress, count,
+            [this, elapsed, handler](const ModbusTransport::Result &result) {
+                const bool ok = result.error == ModbusTransport::NoError;
+                recordTransaction(elapsed.nsecsElapsed(), ok);
+                handler(ok, result.errorString(), result.values, result.count);
+            });
+    }
+    
     // 创建读取单元
-    QModbusDataUnit readUnit(QModbusDataUnit::HoldingRegisters, registerAddress, 1);
+    QModbusDataUnit readUnit(QModbusDataUnit::HoldingRegisters, startAddress, count);
     
     // 发送读取请求
     if (auto *reply = m_modbusMaster->sendReadRequest(readUnit, slaveAddress)) {
+        if (Log::Logger::frameLogging()) {
+            QByteArray pdu;
+            appendWord(pdu, startAddress);
+            appendWord(pdu, count);
+            captureRebuiltFrame(Log::Tx, slaveAddress, QModbusPdu::ReadHoldingRegisters, pdu);
+        }
         if (!reply->isFinished()) {
             // 连接读取完成信号
-            connect(reply, &QModbusReply::finished, this, &ModbusManager::onReadReady);
-        } else {
-            // 读取已完成，删除回复
-            delete reply;
+            connect(reply, &QModbusReply::finished, this, [this, reply, elapsed, handler]() {
+                captureReply(reply);
+                const bool ok = reply->error() == QModbusDevice::NoError;
+                recordTransaction(elapsed.nsecsElapsed(), ok);
+                const QList<quint16> resultValues = reply->result().values();
+                handler(ok, reply->errorString(), resultValues.constData(), resultValues.size());
+                reply->deleteLater();
+            });
+            return true;
         }
+        // 读取已完成，删除回复
+        delete reply;
     } else {
         // 发送请求失败
-        qDebug() << "Modbus read error:" << m_modbusMaster->errorString();
+        LOG_WARNING(Log::Modbus, "read request error: {}", m_modbusMaster->errorString());
     }
+    return false;
 }
 
 /**
- * @brief 读取完成槽函数
- * @details 处理Modbus读取回复，更新相应的数据
+ * @brief 发送写保持寄存器请求
+ * @param slaveAddress 从站地址（0为广播）
+ * @param startAddress 起始寄存器地址
+ * @param values 要写入的原始值
+ * @param handler 应答处理函数
+ * @return 请求是否已发出
+ * @details 单个寄存器使用功能码06，多个寄存器使用功能码16
  */
-void ModbusManager::onReadReady()
+bool ModbusManager::sendWriteRequest(int slaveAddress, int startAddress, const QVector<quint16> &values, ReplyHandler handler)
 {
-    // 获取发送者（回复对象）
-    auto reply = qobject_cast<QModbusReply *>(sender());
-    if (!reply) {
-        return;
+    QElapsedTimer elapsed;
+    elapsed.start();
+    
+    if (m_transportActive) {
+        auto callback = [this, elapsed, handler](const ModbusTransport::Result &result) {
+            const bool ok = result.error == ModbusTransport::NoError;
+            recordTransaction(elapsed.nsecsElapsed(), ok);
+            handler(ok, result.errorString(), result.values, result.count);
+        };
+        if (values.size() == 1) {
+            return m_transport->writeSingleRegister(slaveAddress, startAddress, values.first(), callback);
+        }
+        return m_transport->writeMultipleRegisters(slaveAddress, startAddress, values.constData(), values.size(), callback);
     }
     
-    // 处理回复
-    if (reply->error() == QModbusDevice::NoError) {
-        // 获取回复数据
-        const QModbusDataUnit unit = reply->result();
-        int slaveAddress = reply->serverAddress();
-        int registerAddress = unit.startAddress();
-        
-        // 检查是否有数据
-        if (unit.valueCount() > 0) {
-            // 获取原始值
-            quint16 rawValue = unit.value(0);
-            
-            // 根据从站地址和寄存器地址更新相应的数据
-            if (slaveAddress == VOLTAGE_SLAVE_ADDRESS && registerAddress == VOLTAGE_REGISTER_ADDRESS) {
-                // 更新电压值（原始值乘以0.1）
-                m_voltage = rawValue * 0.1;
-                emit voltageChanged();
-            } else if (slaveAddress == CURRENT_SLAVE_ADDRESS && registerAddress == CURRENT_REGISTER_ADDRESS) {
-                // 更新电流值（原始值乘以0.1）
-                m_current = rawValue * 0.1;
-                emit currentChanged();
-            } else if (slaveAddress == POWER_SLAVE_ADDRESS && registerAddress == POWER_REGISTER_ADDRESS) {
-                // 更新功率值（原始值乘以0.01）
-                m_power = rawValue * 0.01;
-                emit powerChanged();
-            } else if (slaveAddress == FAN_STATE_SLAVE_ADDRESS && registerAddress == FAN_STATE_REGISTER_ADDRESS) {
-                // 更新风机状态
-                m_fanState = rawValue;
-                if (!m_hasFanStateData) {
-                    m_hasFanStateData = true;
-                    emit hasFanStateDataChanged();
+    // 创建写入单元
+    QModbusDataUnit writeUnit(QModbusDataUnit::HoldingRegisters, startAddress, values.size());
+    for (int i = 0; i < values.size(); ++i) {
+        writeUnit.setValue(i, values.at(i));
+    }
+    
+    // 发送写入请求
+    if (auto *reply = m_modbusMaster->sendWriteRequest(writeUnit, slaveAddress)) {
+        if (Log::Logger::frameLogging()) {
+            QByteArray pdu;
+            appendWord(pdu, startAddress);
+            if (values.size() == 1) {
+                appendWord(pdu, values.first());
+                captureRebuiltFrame(Log::Tx, slaveAddress, QModbusPdu::WriteSingleRegister, pdu);
+            } else {
+                appendWord(pdu, values.size());
+                appendValues(pdu, values);
+                captureRebuiltFrame(Log::Tx, slaveAddress, QModbusPdu::WriteMultipleRegisters, pdu);
+            }
+        }
+        if (!reply->isFinished()) {
+            // 连接写入完成信号
+            connect(reply, &QModbusReply::finished, this, [this, reply, elapsed, handler]() {
+                captureReply(reply);
+                const bool ok = reply->error() == QModbusDevice::NoError;
+                recordTransaction(elapsed.nsecsElapsed(), ok);
+                const QList<quint16> resultValues = reply->result().values();
+                handler(ok, reply->errorString(), resultValues.constData(), resultValues.size());
+                reply->deleteLater();
+            });
+        } else {
+            // 广播写入无应答，发出即完成
+            delete reply;
+            handler(true, QString(), values.constData(), values.size());
+        }
+        return true;
+    }
+    
+    // 发送请求失败
+    LOG_WARNING(Log::Modbus, "write request error: {}", m_modbusMaster->errorString());
+    return false;
+}
+
+/**
+ * @brief 发送读写多个寄存器请求（功能码23）
+ * @param slaveAddress 从站地址
+ * @param readAddress 回读起始寄存器地址
+ * @param readCount 回读寄存器数量
+ * @param writeAddress 写入起始寄存器地址
+ * @param values 要写入的原始值
+ * @param handler 应答处理函数（携带回读值）
+ * @return 请求是否已发出
+ * @details 从站以非法功能码异常应答时记录为不支持，并立即改用写+读流水线重发
+ */
+bool ModbusManager::sendReadWriteRequest(int slaveAddress, int readAddress, int readCount,
+                                         int writeAddress, const QVector<quint16> &values, ReplyHandler handler)
+{
+    // 已确认从站不支持功能码23时直接走写+读流水线
+    if (m_readWriteUnsupported) {
+        return sendWriteThenRead(slaveAddress, readAddress, readCount, writeAddress, values, handler);
+    }
+    
+    QElapsedTimer elapsed;
+    elapsed.start();
+    
+    if (m_transportActive) {
+        return m_transport->readWriteMultipleRegisters(slaveAddress, readAddress, readCount,
+            writeAddress, values.constData(), values.size(),
+            [this, elapsed, handler, slaveAddress, readAddress, readCount, writeAddress, values](const ModbusTransport::Result &result) {
+                const bool ok = result.error == ModbusTransport::NoError;
+                recordTransaction(elapsed.nsecsElapsed(), ok);
+                if (result.error == ModbusTransport::ExceptionError && result.exceptionCode == QModbusPdu::IllegalFunction) {
+                    markReadWriteUnsupported();
+                    if (!sendWriteThenRead(slaveAddress, readAddress, readCount, writeAddress, values, handler)) {
+                        handler(false, result.errorString(), nullptr, 0);
+                    }
+                    return;
                 }
-                emit fanStateChanged();
-            } else if (slaveAddress == HIGH_TEMP_SLAVE_ADDRESS && registerAddress == HIGH_TEMP_REGISTER_ADDRESS) {
-                // 更新高温报警状态
-                m_highTempState = rawValue;
-                if (!m_hasHighTempData) {
-                    m_hasHighTempData = true;
-                    emit hasHighTempDataChanged();
+                handler(ok, result.errorString(), result.values, result.count);
+            });
+    }
+    
+    // 创建读、写单元
+    QModbusDataUnit readUnit(QModbusDataUnit::HoldingRegisters, readAddress, readCount);
+    QModbusDataUnit writeUnit(QModbusDataUnit::HoldingRegisters, writeAddress, values.size());
+    for (int i = 0; i < values.size(); ++i) {
+        writeUnit.setValue(i, values.at(i));
+    }
+    
+    // 发送读写请求
+    if (auto *reply = m_modbusMaster->sendReadWriteRequest(readUnit, writeUnit, slaveAddress)) {
+        if (Log::Logger::frameLogging()) {
+            QByteArray pdu;
+            appendWord(pdu, readAddress);
+            appendWord(pdu, readCount);
+            appendWord(pdu, writeAddress);
+            appendWord(pdu, values.size());
+            appendValues(pdu, values);
+            captureRebuiltFrame(Log::Tx, slaveAddress, QModbusPdu::ReadWriteMultipleRegisters, pdu);
+        }
+        if (!reply->isFinished()) {
+            connect(reply, &QModbusReply::finished, this,
+                    [this, reply, elapsed, handler, slaveAddress, readAddress, readCount, writeAddress, values]() {
+                captureReply(reply);
+                const bool ok = reply->error() == QModbusDevice::NoError;
+                recordTransaction(elapsed.nsecsElapsed(), ok);
+                const QModbusResponse raw = reply->rawResult();
+                if (reply->error() == QModbusDevice::ProtocolError && raw.isException()
+                        && raw.exceptionCode() == QModbusPdu::IllegalFunction) {
+                    markReadWriteUnsupported();
+                    if (!sendWriteThenRead(slaveAddress, readAddress, readCount, writeAddress, values, handler)) {
+                        handler(false, reply->errorString(), nullptr, 0);
+                    }
+                } else {
+                    const QList<quint16> resultValues = reply->result().values();
+                    handler(ok, reply->errorString(), resultValues.constData(), resultValues.size());
                 }
-                emit highTempStateChanged();
+                reply->deleteLater();
+            });
+            return true;
+        }
+        delete reply;
+    } else {
+        // 发送请求失败
+        LOG_WARNING(Log::Modbus, "read/write request error: {}", m_modbusMaster->errorString());
+    }
+    return false;
+}
+
+/**
+ * @brief 以写+读两个请求代替功能码23
+ * @details 读请求在写应答返回后才发出：TCP流水线允许多个请求同时在途，
+ *          连续发出时回读可能先于写入被处理而读到旧值
+ */
+bool ModbusManager::sendWriteThenRead(int slaveAddress, int readAddress, int readCount,
+                                      int writeAddress, const QVector<quint16> &values, ReplyHandler handler)
+{
+    return sendWriteRequest(slaveAddress, writeAddress, values,
+        [this, slaveAddress, readAddress, readCount, handler](bool ok, const QString &errorString, const quint16 *, int) {
+            if (!ok) {
+                handler(false, errorString, nullptr, 0);
+                return;
+            }
+            if (!sendReadRequest(slaveAddress, readAddress, readCount, handler)) {
+                handler(false, QStringLiteral("回读请求发送失败"), nullptr, 0);
+            }
+        });
+}
+
+/**
+ * @brief 设定值写入后回读风机与高温报警状态寄存器
+ * @details 在设定值应答的完成回调中发出，与写入组成一次流水线操作；
+ *          读取结果按轮询相同的路径更新风机状态与高温报警
+ */
+void ModbusManager::readBackStatus()
+{
+    const bool sent = sendReadRequest(FAN_STATE_SLAVE_ADDRESS, STATUS_READBACK_START_ADDRESS, STATUS_READBACK_REGISTER_COUNT,
+        [this](bool ok, const QString &errorString, const quint16 *values, int count) {
+            if (!ok) {
+                LOG_WARNING(Log::Modbus, "状态回读失败: {}", errorString);
+                return;
+            }
+            for (int i = 0; i < count; ++i) {
+                handleRegisterValue(FAN_STATE_SLAVE_ADDRESS, STATUS_READBACK_START_ADDRESS + i, values[i]);
             }
+        });
+    if (!sent) {
+        LOG_WARNING(Log::Modbus, "状态回读请求发送失败");
+    }
+}
+
+/**
+ * @brief 标记从站不支持功能码23
+ */
+void ModbusManager::markReadWriteUnsupported()
+{
+    if (m_readWriteUnsupported) {
+        return;
+    }
+    m_readWriteUnsupported = true;
+    LOG_INFO(Log::Modbus, "从站不支持功能码23，改用写+读流水线");
+    emit readWriteSupportedChanged();
+}
+
+/**
+ * @brief 记录一次事务
+ * @param elapsedNs 往返时间（纳秒）
+ * @param ok 是否成功
+ */
+void ModbusManager::recordTransaction(qint64 elapsedNs, bool ok)
+{
+    ++m_transactionCount;
+    Metrics::add(Metrics::BusTransactions);
+    if (!ok) {
+        ++m_transactionErrors;
+        Metrics::add(Metrics::BusErrors);
+    }
+    m_totalRoundTripNs += elapsedNs;
+    m_maxRoundTripNs = qMax(m_maxRoundTripNs, elapsedNs);
+}
+
+double ModbusManager::sampleTimeUs() const
+{
+    return SampleClock::toOffsetUs(m_lastSampleNs);
+}
+
+/**
+ * @brief 获取传输层统计
+ * @return 包含transport、transactions、errors、avgRoundTripUs、maxRoundTripUs等字段
+ * @details 两种传输层使用相同口径统计，可在同一模拟从站上直接对比
+ */
+QVariantMap ModbusManager::transportStatistics() const
+{
+    QVariantMap stats;
+    stats["transport"] = m_transportActive ? "native" : "qt";
+    stats["transactions"] = m_transactionCount;
+    stats["errors"] = m_transactionErrors;
+    stats["avgRoundTripUs"] = m_transactionCount > 0 ? m_totalRoundTripNs / m_transactionCount / 1000 : 0;
+    stats["maxRoundTripUs"] = m_maxRoundTripNs / 1000;
+    if (m_transportActive && m_transport) {
+        switch (m_transport->framing()) {
+        case ModbusTransport::TcpFraming: stats["framing"] = "tcp"; break;
+        case ModbusTransport::RtuOverTcpFraming: stats["framing"] = "rtuOverTcp"; break;
+        default: stats["framing"] = "rtu"; break;
         }
+        stats["inFlight"] = m_transport->inFlightCount();
+        stats["silentIntervalUs"] = m_transport->silentIntervalNs() / 1000;
+        stats["crcErrors"] = m_transport->crcErrorCount();
+        stats["timeouts"] = m_transport->timeoutCount();
+    }
+    return stats;
+}
+
+/**
+ * @brief 清零传输层统计
+ */
+void ModbusManager::resetTransportStatistics()
+{
+    m_transactionCount = 0;
+    m_transactionErrors = 0;
+    m_totalRoundTripNs = 0;
+    m_maxRoundTripNs = 0;
+}
+
+/**
+ * @brief 设置是否使用自有RTU传输层
+ * @param enabled 是否启用
+ * @details 下次调用connectToPort时生效
+ */
+void ModbusManager::setNativeTransport(bool enabled)
+{
+    if (m_nativeTransport != enabled) {
+        m_nativeTransport = enabled;
+        emit nativeTransportChanged();
+    }
+}
+
+/**
+ * @brief 获取是否捕获总线帧
+ * @return 是否启用
+ */
+bool ModbusManager::busCapture() const
+{
+    return Log::Logger::frameLogging();
+}
+
+/**
+ * @brief 设置是否捕获总线帧
+ * @param enabled 是否启用
+ * @details 关闭时热路径只剩一次原子读取；开启后每帧只拷贝原始字节到本线程的无锁缓冲，
+ *          由日志后台线程写入文件
+ */
+void ModbusManager::setBusCapture(bool enabled)
+{
+    if (Log::Logger::frameLogging() == enabled) {
+        return;
+    }
+    Log::Logger::setFrameLogging(enabled);
+    if (enabled) {
+        LOG_INFO(Log::Modbus, "开始捕获总线帧: {}", busCaptureFile());
     } else {
-        // 读取错误
-        qDebug() << "Modbus reply error:" << reply->errorString();
+        LOG_INFO(Log::Modbus, "停止捕获总线帧");
+    }
+    emit busCaptureChanged();
+}
+
+/**
+ * @brief 获取总线帧捕获文件路径
+ * @return bus-frames.bin的完整路径
+ */
+QString ModbusManager::busCaptureFile() const
+{
+    return Log::Logger::frameFilePath();
+}
+
+/**
+ * @brief 读取保持寄存器
+ * @param slaveAddress 从站地址
+ * @param registerAddress 寄存器地址
+ * @details 发送Modbus读取请求，读取指定的保持寄存器
+ */
+void ModbusManager::readHoldingRegister(int slaveAddress, int registerAddress, int channelIndex)
+{
+    // 检查连接状态
+    if (!busConnected()) {
+        return;
     }
     
-    // 删除回复对象
-    reply->deleteLater();
+    const bool sent = sendReadRequest(slaveAddress, registerAddress, 1,
+        [this, slaveAddress, registerAddress, channelIndex](bool ok, const QString &errorString, const quint16 *values, int count) {
+            // 在回复处理的入口取时间戳，之后的换算与信号分发不计入
+            m_sampleTimeNs = SampleClock::nowNs();
+            if (ok && count > 0) {
+                handleRegisterValue(slaveAddress, registerAddress, values[0]);
+                const double channelValues[CHANNEL_COUNT] = {m_voltage, m_current, m_power,
+                                                             static_cast<double>(m_fanState),
+                                                             static_cast<double>(m_highTempState)};
+                updateChannelActivity(channelIndex, channelValues[channelIndex]);
+            } else {
+                // 读取错误
+                LOG_DEBUG(Log::Modbus, "reply error: slave={} register={} {}", slaveAddress, registerAddress, errorString);
+                recordChannelFailure(channelIndex);
+            }
+            finishPendingRead();
+        });
+    if (sent) {
+        ++m_pendingReads;
+        Metrics::adjust(Metrics::PendingReads, 1);
+    }
+}
+
+/**
+ * @brief 处理读取到的寄存器值
+ * @param slaveAddress 从站地址
+ * @param registerAddress 寄存器地址
+ * @param rawValue 原始值
+ * @details 根据从站地址和寄存器地址更新相应的数据
+ */
+void ModbusManager::handleRegisterValue(int slaveAddress, int registerAddress, quint16 rawValue)
+{
+    if (slaveAddress == VOLTAGE_SLAVE_ADDRESS && registerAddress == VOLTAGE_REGISTER_ADDRESS) {
+        // 更新电压值（原始值乘以0.1）
+        m_voltage = rawValue * 0.1;
+        emit voltageChanged();
+    } else if (slaveAddress == CURRENT_SLAVE_ADDRESS && registerAddress == CURRENT_REGISTER_ADDRESS) {
+        // 更新电流值（原始值乘以0.1）
+        m_current = rawValue * 0.1;
+        emit currentChanged();
+    } else if (slaveAddress == POWER_SLAVE_ADDRESS && registerAddress == POWER_REGISTER_ADDRESS) {
+        // 更新功率值（原始值乘以0.01）
+        m_power = rawValue * 0.01;
+        emit powerChanged();
+    } else if (slaveAddress == FAN_STATE_SLAVE_ADDRESS && registerAddress == FAN_STATE_REGISTER_ADDRESS) {
+        // 更新风机状态
+        m_fanState = rawValue;
+        if (!m_hasFanStateData) {
+            m_hasFanStateData = true;
+            emit hasFanStateDataChanged();
+        }
+        emit fanStateChanged();
+    } else if (slaveAddress == HIGH_TEMP_SLAVE_ADDRESS && registerAddress == HIGH_TEMP_REGISTER_ADDRESS) {
+        // 更新高温报警状态
+        m_highTempState = rawValue;
+        if (!m_hasHighTempData) {
+            m_hasHighTempData = true;
+            emit hasHighTempDataChanged();
+        }
+        emit highTempStateChanged();
+    }
 }
 
 /**
@@ -300,42 +1219,27 @@ void ModbusManager::onReadReady()
 void ModbusManager::writeHoldingRegister(int slaveAddress, int registerAddress, double value)
 {
     // 检查连接状态
-    if (!m_modbusMaster || m_modbusMaster->state() != QModbusDevice::ConnectedState) {
-        qDebug() << "Modbus not connected, cannot write";
+    if (!busConnected()) {
+        LOG_WARNING(Log::Modbus, "not connected, cannot write");
         return;
     }
     
+    // 写入会引起瞬态，以最高速率观察
+    markActivity(AllChannels);
+    
     // 将值转换为16位无符号整数
     quint16 rawValue = static_cast<quint16>(qRound(value));
     
-    // 创建写入单元
-    QModbusDataUnit writeUnit(QModbusDataUnit::HoldingRegisters, registerAddress, 1);
-    writeUnit.setValue(0, rawValue);
-    
-    // 发送写入请求
-    if (auto *reply = m_modbusMaster->sendWriteRequest(writeUnit, slaveAddress)) {
-        if (!reply->isFinished()) {
-            // 连接写入完成信号
-            connect(reply, &QModbusReply::finished, this, [this, reply, slaveAddress, registerAddress, value]() {
-                if (reply->error() == QModbusDevice::NoError) {
-                    // 写入成功
-                    qDebug() << "Write successful - Slave:" << slaveAddress 
-                             << "Register:" << registerAddress 
-                             << "Value:" << value;
-                } else {
-                    // 写入失败
-                    qDebug() << "Write error:" << reply->errorString();
-                }
-                reply->deleteLater();
-            });
-        } else {
-            // 写入已完成，删除回复
-            delete reply;
-        }
-    } else {
-        // 发送请求失败
-        qDebug() << "Modbus write request error:" << m_modbusMaster->errorString();
-    }
+    sendWriteRequest(slaveAddress, registerAddress, {rawValue},
+        [slaveAddress, registerAddress, value](bool ok, const QString &errorString, const quint16 *, int) {
+            if (ok) {
+                // 写入成功
+                LOG_INFO(Log::Modbus, "write successful - slave={} register={} value={}", slaveAddress, registerAddress, value);
+            } else {
+                // 写入失败
+                LOG_WARNING(Log::Modbus, "write error: {}", errorString);
+            }
+        });
 }
 
 /**
@@ -366,40 +1270,27 @@ void ModbusManager::writeCurrent(double value)
 void ModbusManager::writeFanState(bool state)
 {
     // 检查连接状态
-    if (!m_modbusMaster || m_modbusMaster->state() != QModbusDevice::ConnectedState) {
-        qDebug() << "Modbus not connected, cannot write fan state";
+    if (!busConnected()) {
+        LOG_WARNING(Log::Modbus, "not connected, cannot write fan state");
         return;
     }
     
+    // 写入会引起瞬态，以最高速率观察
+    markActivity(AllChannels);
+    
     // 将状态转换为16位无符号整数（1为开启，0为关闭）
     quint16 rawValue = state ? 1 : 0;
     
-    // 创建写入单元
-    QModbusDataUnit writeUnit(QModbusDataUnit::HoldingRegisters, FAN_REGISTER_ADDRESS, 1);
-    writeUnit.setValue(0, rawValue);
-    
-    // 发送写入请求
-    if (auto *reply = m_modbusMaster->sendWriteRequest(writeUnit, FAN_SLAVE_ADDRESS)) {
-        if (!reply->isFinished()) {
-            // 连接写入完成信号
-            connect(reply, &QModbusReply::finished, this, [this, reply, state]() {
-                if (reply->error() == QModbusDevice::NoError) {
-                    // 写入成功
-                    qDebug() << "Fan state write successful - State:" << (state ? "ON(1)" : "OFF(0)");
-                } else {
-                    // 写入失败
-                    qDebug() << "Fan state write error:" << reply->errorString();
-                }
-                reply->deleteLater();
-            });
-        } else {
-            // 写入已完成，删除回复
-            delete reply;
-        }
-    } else {
-        // 发送请求失败
-        qDebug() << "Fan state write request error:" << m_modbusMaster->errorString();
-    }
+    sendWriteRequest(FAN_SLAVE_ADDRESS, FAN_REGISTER_ADDRESS, {rawValue},
+        [state](bool ok, const QString &errorString, const quint16 *, int) {
+            if (ok) {
+                // 写入成功
+                LOG_INFO(Log::Modbus, "fan state write successful - state={}", state ? "ON(1)" : "OFF(0)");
+            } else {
+                // 写入失败
+                LOG_WARNING(Log::Modbus, "fan state write error: {}", errorString);
+            }
+        });
 }
 
 /**
@@ -409,64 +1300,75 @@ void ModbusManager::writeFanState(bool state)
  * @details 同时写入电压和电流值到指定的寄存器
  */
 void ModbusManager::writeVoltageAndCurrent(double voltage, double current)
+{
+    writeVoltageAndCurrent(voltage, current, nullptr);
+}
+
+/**
+ * @brief 同时写入电压和电流值，并单独回调本次请求的结果
+ * @param voltage 要写入的电压值
+ * @param current 要写入的电流值
+ * @param handler 结果回调，可为空
+ * @details 无论是否带回调，结果都会通过setPointVerified信号广播
+ */
+void ModbusManager::writeVoltageAndCurrent(double voltage, double current, SetPointHandler handler)
 {
     // 检查连接状态
-    if (!m_modbusMaster || m_modbusMaster->state() != QModbusDevice::ConnectedState) {
-        qDebug() << "Modbus not connected, cannot write";
+    if (!busConnected()) {
+        LOG_WARNING(Log::Modbus, "not connected, cannot write");
+        if (handler) {
+            handler(false, m_setPointVoltage, m_setPointCurrent);
+        }
         return;
     }
     
+    // 设定值阶跃后以最高速率观察瞬态
+    markActivity(AllChannels);
+    
     // 将值转换为16位无符号整数
     quint16 voltageRaw = static_cast<quint16>(qRound(voltage));
     quint16 currentRaw = static_cast<quint16>(qRound(current));
     
-    // 创建写入单元（写入2个寄存器）
-    QModbusDataUnit writeUnit(QModbusDataUnit::HoldingRegisters, WRITE_VOLTAGE_REGISTER_ADDRESS, 2);
-    writeUnit.setValue(0, voltageRaw);
-    writeUnit.setValue(1, currentRaw);
-    
     // 输出写入请求信息
-    qDebug() << "========================================";
-    qDebug() << "发送写入请求:";
-    qDebug() << "  从站地址:" << WRITE_VOLTAGE_SLAVE_ADDRESS;
-    qDebug() << "  起始寄存器:" << WRITE_VOLTAGE_REGISTER_ADDRESS;
-    qDebug() << "  寄存器数量: 2";
-    qDebug() << "  电压值(原始):" << voltageRaw << "(" << voltage << "V)";
-    qDebug() << "  电流值(原始):" << currentRaw << "(" << current << "A)";
-    qDebug() << "========================================";
+    LOG_INFO(Log::Modbus, "发送写入请求: 从站地址={} 起始寄存器={} 寄存器数量=2 电压值(原始)={} ({} V) 电流值(原始)={} ({} A)",
+             WRITE_VOLTAGE_SLAVE_ADDRESS, WRITE_VOLTAGE_REGISTER_ADDRESS, voltageRaw, voltage, currentRaw, current);
     
-    // 发送写入请求
-    if (auto *reply = m_modbusMaster->sendWriteRequest(writeUnit, WRITE_VOLTAGE_SLAVE_ADDRESS)) {
-        if (!reply->isFinished()) {
-            // 连接写入完成信号
-            connect(reply, &QModbusReply::finished, this, [this, reply, voltage, current]() {
-                qDebug() << "========================================";
-                qDebug() << "收到PLC响应:";
-                if (reply->error() == QModbusDevice::NoError) {
-                    // 写入成功
-                    const QModbusDataUnit result = reply->result();
-                    qDebug() << "  状态: 写入成功";
-                    qDebug() << "  从站地址:" << reply->serverAddress();
-                    qDebug() << "  功能码:" << static_cast<int>(result.registerType());
-                    qDebug() << "  起始地址:" << result.startAddress();
-                    qDebug() << "  写入寄存器数:" << result.valueCount();
-                    qDebug() << "  写入数据: 电压=" << voltage << "V, 电流=" << current << "A";
-                } else {
-                    // 写入失败
-                    qDebug() << "  状态: 写入失败";
-                    qDebug() << "  错误码:" << static_cast<int>(reply->error());
-                    qDebug() << "  错误信息:" << reply->errorString();
+    // 写入2个寄存器并在同一事务中回读这两个寄存器，成功后接着回读状态寄存器
+    const bool sent = sendReadWriteRequest(WRITE_VOLTAGE_SLAVE_ADDRESS, READBACK_START_ADDRESS, READBACK_REGISTER_COUNT,
+        WRITE_VOLTAGE_REGISTER_ADDRESS, {voltageRaw, currentRaw},
+        [this, voltage, current, voltageRaw, currentRaw, handler](bool ok, const QString &errorString, const quint16 *values, int count) {
+            const int voltageIndex = WRITE_VOLTAGE_REGISTER_ADDRESS - READBACK_START_ADDRESS;
+            const int currentIndex = WRITE_CURRENT_REGISTER_ADDRESS - READBACK_START_ADDRESS;
+            if (ok && count > qMax(voltageIndex, currentIndex)) {
+                m_setPointVoltage = values[voltageIndex];
+                m_setPointCurrent = values[currentIndex];
+                emit setPointChanged();
+                
+                const bool accepted = values[voltageIndex] == voltageRaw && values[currentIndex] == currentRaw;
+                LOG_INFO(Log::Modbus, "收到PLC响应: {} 从站地址={} 写入数据: 电压={} V, 电流={} A 回读数据: 电压={}, 电流={}",
+                         accepted ? "写入成功，回读一致" : "写入成功，回读不一致", WRITE_VOLTAGE_SLAVE_ADDRESS,
+                         voltage, current, m_setPointVoltage, m_setPointCurrent);
+                emit setPointVerified(accepted, m_setPointVoltage, m_setPointCurrent);
+                if (handler) {
+                    handler(accepted, m_setPointVoltage, m_setPointCurrent);
                 }
-                qDebug() << "========================================";
-                reply->deleteLater();
-            });
-        } else {
-            // 写入已完成，删除回复
-            delete reply;
-        }
-    } else {
+                // 状态寄存器不与设定值相邻，接着读取状态块，不等下一轮轮询
+                readBackStatus();
+            } else {
+                // 写入失败
+                LOG_WARNING(Log::Modbus, "收到PLC响应: 写入失败 错误信息: {}", errorString);
+                emit setPointVerified(false, m_setPointVoltage, m_setPointCurrent);
+                if (handler) {
+                    handler(false, m_setPointVoltage, m_setPointCurrent);
+                }
+            }
+        });
+    if (!sent) {
         // 发送请求失败
-        qDebug() << "发送请求失败:" << m_modbusMaster->errorString();
+        LOG_WARNING(Log::Modbus, "发送请求失败");
+        if (handler) {
+            handler(false, m_setPointVoltage, m_setPointCurrent);
+        }
     }
 }
 
@@ -477,52 +1379,31 @@ void ModbusManager::writeVoltageAndCurrent(double voltage, double current)
 void ModbusManager::writeUnload()
 {
     // 检查连接状态
-    if (!m_modbusMaster || m_modbusMaster->state() != QModbusDevice::ConnectedState) {
-        qDebug() << "Modbus not connected, cannot write unload";
+    if (!busConnected()) {
+        LOG_WARNING(Log::Modbus, "not connected, cannot write unload");
         return;
     }
     
-    // 创建写入单元
-    QModbusDataUnit writeUnit(QModbusDataUnit::HoldingRegisters, UNLOAD_REGISTER_ADDRESS, 1);
-    writeUnit.setValue(0, 1); // 写入值为1
+    // 写入会引起瞬态，以最高速率观察
+    markActivity(AllChannels);
     
     // 输出卸载请求信息
-    qDebug() << "========================================";
-    qDebug() << "发送卸载请求:";
-    qDebug() << "  从站地址:" << UNLOAD_SLAVE_ADDRESS;
-    qDebug() << "  寄存器地址:" << UNLOAD_REGISTER_ADDRESS;
-    qDebug() << "  写入值: 1";
-    qDebug() << "========================================";
+    LOG_INFO(Log::Modbus, "发送卸载请求: 从站地址={} 寄存器地址={} 写入值=1", UNLOAD_SLAVE_ADDRESS, UNLOAD_REGISTER_ADDRESS);
     
-    // 发送写入请求
-    if (auto *reply = m_modbusMaster->sendWriteRequest(writeUnit, UNLOAD_SLAVE_ADDRESS)) {
-        if (!reply->isFinished()) {
-            // 连接写入完成信号
-            connect(reply, &QModbusReply::finished, this, [this, reply]() {
-                qDebug() << "========================================";
-                qDebug() << "收到PLC响应(卸载):";
-                if (reply->error() == QModbusDevice::NoError) {
-                    // 写入成功
-                    const QModbusDataUnit result = reply->result();
-                    qDebug() << "  状态: 写入成功";
-                    qDebug() << "  从站地址:" << reply->serverAddress();
-                    qDebug() << "  寄存器地址:" << result.startAddress();
-                    qDebug() << "  写入值: 1";
-                } else {
-                    // 写入失败
-                    qDebug() << "  状态: 写入失败";
-                    qDebug() << "  错误码:" << static_cast<int>(reply->error());
-                    qDebug() << "  错误信息:" << reply->errorString();
-                }
-                qDebug() << "========================================";
-                reply->deleteLater();
-            });
-        } else {
-            // 写入已完成，删除回复
-            delete reply;
-        }
-    } else {
+    // 写入值为1
+    const bool sent = sendWriteRequest(UNLOAD_SLAVE_ADDRESS, UNLOAD_REGISTER_ADDRESS, {1},
+        [](bool ok, const QString &errorString, const quint16 *, int) {
+            if (ok) {
+                // 写入成功
+                LOG_INFO(Log::Modbus, "收到PLC响应(卸载): 写入成功 从站地址={} 寄存器地址={} 写入值=1",
+                         UNLOAD_SLAVE_ADDRESS, UNLOAD_REGISTER_ADDRESS);
+            } else {
+                // 写入失败
+                LOG_WARNING(Log::Modbus, "收到PLC响应(卸载): 写入失败 错误信息: {}", errorString);
+            }
+        });
+    if (!sent) {
         // 发送请求失败
-        qDebug() << "发送卸载请求失败:" << m_modbusMaster->errorString();
+        LOG_WARNING(Log::Modbus, "发送卸载请求失败");
     }
 }
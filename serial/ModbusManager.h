@@ -5,6 +5,11 @@
 #include <QModbusRtuSerialMaster>
 #include <QModbusDataUnit>
 #include <QTimer>
+#include <QVariantMap>
+#include <QVector>
+#include <QElapsedTimer>
+#include <functional>
+#include "ModbusTransport.h"
 
 /**
  * @brief 电压读取相关常量定义
@@ -41,6 +46,14 @@ constexpr int WRITE_VOLTAGE_REGISTER_ADDRESS = 50;//寄存器地址
 constexpr int WRITE_CURRENT_SLAVE_ADDRESS = 1;//从站地址1
 constexpr int WRITE_CURRENT_REGISTER_ADDRESS = 51;//寄存器地址51
 
+/**
+ * @brief 设定值回读相关常量定义
+ * @details 功能码23写入设定值后在同一事务中回读的寄存器范围，只覆盖写入的设定电压/电流(50/51)，
+ *          不要求从站连续映射其他地址
+ */
+constexpr int READBACK_START_ADDRESS = WRITE_VOLTAGE_REGISTER_ADDRESS;//起始寄存器地址50
+constexpr int READBACK_REGISTER_COUNT = 2;//寄存器数量2
+
 /**
  * @brief 风机控制相关常量定义
  * @details 定义风机控制的Modbus配置
@@ -62,6 +75,14 @@ constexpr int FAN_STATE_REGISTER_ADDRESS = 2;//寄存器地址2
 constexpr int HIGH_TEMP_SLAVE_ADDRESS = 1;//从站地址1
 constexpr int HIGH_TEMP_REGISTER_ADDRESS = 3;//寄存器地址3
 
+/**
+ * @brief 状态回读相关常量定义
+ * @details 设定值写入应答返回后，在同一完成回调中接着读取的风机/高温报警状态寄存器块(2-3)
+ */
+constexpr int STATUS_READBACK_START_ADDRESS = FAN_STATE_REGISTER_ADDRESS;//起始寄存器地址2
+constexpr int STATUS_READBACK_REGISTER_COUNT = HIGH_TEMP_REGISTER_ADDRESS - FAN_STATE_REGISTER_ADDRESS + 1;//寄存器数量2
+static_assert(FAN_STATE_SLAVE_ADDRESS == HIGH_TEMP_SLAVE_ADDRESS, "状态寄存器须位于同一从站");
+
 /**
  * @brief 卸载控制相关常量定义
  * @details 定义卸载控制的Modbus配置
@@ -71,11 +92,60 @@ constexpr int UNLOAD_REGISTER_ADDRESS = 35;//寄存器地址35
 
 /**
  * @brief Modbus管理器类
- * @details 负责Modbus RTU串行通信的管理，包括设备连接、数据读取和写入
+ * @details 负责Modbus RTU串行通信及Modbus TCP/RTU over TCP网络通信的管理，包括设备连接、数据读取和写入
  */
 class ModbusManager : public QObject
 {
     Q_OBJECT
+    /**
+     * @brief 突发轮询状态属性
+     * @details 为true时只轮询指定通道，且上一轮读取完成后立即发起下一轮
+     */
+    Q_PROPERTY(bool burstActive READ burstActive NOTIFY burstActiveChanged)
+
+    /**
+     * @brief 自适应采样开关
+     * @details 为true时定时读取按通道的活动程度调整轮询速率：数值变化超过死区、
+     *          写入设定值或状态跳变后以总线允许的最高速率读取，稳定后逐渐降回startReading的间隔
+     */
+    Q_PROPERTY(bool adaptiveSampling READ adaptiveSampling WRITE setAdaptiveSampling NOTIFY adaptiveSamplingChanged)
+
+    /**
+     * @brief 活动后保持最高速率的时间（毫秒）
+     */
+    Q_PROPERTY(int activityHoldMs READ activityHoldMs WRITE setActivityHoldMs NOTIFY activityHoldMsChanged)
+
+    /**
+     * @brief 自有RTU传输层开关
+     * @details 为true时下次连接使用ModbusTransport代替QModbusRtuSerialMaster
+     */
+    Q_PROPERTY(bool nativeTransport READ nativeTransport WRITE setNativeTransport NOTIFY nativeTransportChanged)
+
+    /**
+     * @brief 总线帧捕获开关
+     * @details 为true时收发的每一帧连同纳秒时间戳写入日志目录下的bus-frames.bin，
+     *          供demo3-busanalyzer离线分析；与环境变量EVOLVE_LOG_FRAMES共用同一开关
+     */
+    Q_PROPERTY(bool busCapture READ busCapture WRITE setBusCapture NOTIFY busCaptureChanged)
+
+    /**
+     * @brief 回读的设定电压属性
+     * @details 设定值写入后从寄存器50回读的原始值
+     */
+    Q_PROPERTY(double setPointVoltage READ setPointVoltage NOTIFY setPointChanged)
+
+    /**
+     * @brief 回读的设定电流属性
+     * @details 设定值写入后从寄存器51回读的原始值
+     */
+    Q_PROPERTY(double setPointCurrent READ setPointCurrent NOTIFY setPointChanged)
+
+    /**
+     * @brief 从站是否支持功能码23
+     * @details 首次收到非法功能码异常后置为false，之后改用写+读流水线
+     */
+    Q_PROPERTY(bool readWriteSupported READ readWriteSupported NOTIFY readWriteSupportedChanged)
+
     /**
      * @brief 电压值属性
      * @details 存储当前读取的电压值，单位为伏特(V)
@@ -125,6 +195,31 @@ class ModbusManager : public QObject
     Q_PROPERTY(bool hasHighTempData READ hasHighTempData NOTIFY hasHighTempDataChanged)
 
 public:
+    /**
+     * @brief 轮询通道位掩码
+     * @details 用于突发轮询时选择需要读取的寄存器
+     */
+    enum Channel {
+        VoltageChannel = 0x01,
+        CurrentChannel = 0x02,
+        PowerChannel = 0x04,
+        FanStateChannel = 0x08,
+        HighTempChannel = 0x10,
+        AllChannels = 0x1F
+    };
+    Q_ENUM(Channel)
+
+    /**
+     * @brief 网络传输帧格式
+     * @details ModbusTcp使用MBAP报文头，可同时保持多个未完成事务；
+     *          RtuOverTcp经网关透传RTU帧，与串口一样逐个事务进行
+     */
+    enum NetworkFraming {
+        ModbusTcp = 0,
+        RtuOverTcp = 1
+    };
+    Q_ENUM(NetworkFraming)
+
     /**
      * @brief 构造函数
      * @param parent 父对象
@@ -184,6 +279,84 @@ public:
      */
     bool hasHighTempData() const { return m_hasHighTempData; }
 
+    /**
+     * @brief 获取突发轮询状态
+     * @return 是否处于突发轮询模式
+     */
+    bool burstActive() const { return m_burstActive; }
+
+    /**
+     * @brief 获取是否启用自适应采样
+     * @return 是否启用
+     */
+    bool adaptiveSampling() const { return m_adaptiveSampling; }
+
+    /**
+     * @brief 设置是否启用自适应采样
+     * @param enabled 是否启用，正在定时读取时立即切换
+     */
+    void setAdaptiveSampling(bool enabled);
+
+    /**
+     * @brief 获取活动后保持最高速率的时间
+     * @return 毫秒
+     */
+    int activityHoldMs() const { return m_activityHoldMs; }
+
+    /**
+     * @brief 设置活动后保持最高速率的时间
+     * @param ms 毫秒
+     */
+    void setActivityHoldMs(int ms);
+
+    /**
+     * @brief 获取是否使用自有RTU传输层
+     * @return 是否启用
+     */
+    bool nativeTransport() const { return m_nativeTransport; }
+
+    /**
+     * @brief 设置是否使用自有RTU传输层
+     * @param enabled 是否启用，下次连接时生效
+     */
+    void setNativeTransport(bool enabled);
+
+    /**
+     * @brief 获取是否捕获总线帧
+     * @return 是否启用
+     */
+    bool busCapture() const;
+
+    /**
+     * @brief 设置是否捕获总线帧
+     * @param enabled 是否启用，立即生效
+     */
+    void setBusCapture(bool enabled);
+
+    /**
+     * @brief 获取总线帧捕获文件路径
+     * @return bus-frames.bin的完整路径，日志未启动时为空
+     */
+    Q_INVOKABLE QString busCaptureFile() const;
+
+    /**
+     * @brief 获取回读的设定电压
+     * @return 设定电压原始值
+     */
+    double setPointVoltage() const { return m_setPointVoltage; }
+
+    /**
+     * @brief 获取回读的设定电流
+     * @return 设定电流原始值
+     */
+    double setPointCurrent() const { return m_setPointCurrent; }
+
+    /**
+     * @brief 获取从站是否支持功能码23
+     * @return 是否支持
+     */
+    bool readWriteSupported() const { return !m_readWriteUnsupported; }
+
     /**
      * @brief 连接到Modbus设备
      * @param portName 串口名称
@@ -192,6 +365,15 @@ public:
      * @return 连接是否成功
      */
     Q_INVOKABLE bool connectToPort(const QString &portName, int baudRate = 9600, int parity = 0);
+
+    /**
+     * @brief 通过以太网网关连接Modbus设备
+     * @param host 网关地址
+     * @param port TCP端口，默认为502
+     * @param framing 帧格式（NetworkFraming），默认为Modbus TCP
+     * @return 是否已开始连接，结果通过connected属性通知
+     */
+    Q_INVOKABLE bool connectToHost(const QString &host, int port = 502, int framing = ModbusTcp);
     
     /**
      * @brief 断开与Modbus设备的连接
@@ -208,6 +390,34 @@ public:
      * @brief 停止定时读取数据
      */
     Q_INVOKABLE void stopReading();
+
+    /**
+     * @brief 开始突发轮询
+     * @param channelMask 需要读取的通道位掩码（Channel组合）
+     * @details 暂停定时读取，只读取指定通道，每轮完成后立即发起下一轮，
+     *          以总线允许的最高速率采样
+     */
+    Q_INVOKABLE void startBurstReading(int channelMask);
+
+    /**
+     * @brief 停止突发轮询
+     * @details 恢复突发前的定时读取
+     */
+    Q_INVOKABLE void stopBurstReading();
+
+    /**
+     * @brief 设置通道的变化死区
+     * @param channel 通道（Channel中的单个值）
+     * @param deadband 两次读数之差超过该值时视为活动，单位与属性一致
+     * @details 默认电压0.5V、电流0.2A、功率0.05kW，风机与高温报警状态任意变化都视为活动
+     */
+    Q_INVOKABLE void setDeadband(int channel, double deadband);
+
+    /**
+     * @brief 获取各通道的实际采样速率
+     * @return 键为voltage、current、power、fanState、highTemp，值为每秒读取次数
+     */
+    Q_INVOKABLE QVariantMap samplingRates() const;
     
     /**
      * @brief 写入电压值
@@ -231,9 +441,26 @@ public:
      * @brief 同时写入电压和电流值
      * @param voltage 要写入的电压值
      * @param current 要写入的电流值
+     * @details 使用功能码23在一次总线事务中写入设定值并回读状态与设定值寄存器，
+     *          结果通过setPointVerified信号返回
      */
     Q_INVOKABLE void writeVoltageAndCurrent(double voltage, double current);
     
+    /**
+     * @brief 设定值写入完成回调
+     * @param accepted 写入成功且回读值与写入值一致
+     * @param voltage 回读的设定电压
+     * @param current 回读的设定电流
+     */
+    using SetPointHandler = std::function<void(bool accepted, double voltage, double current)>;
+    
+    /**
+     * @brief 同时写入电压和电流值，并单独回调本次请求的结果
+     * @details 供本地发布服务等多个请求方共用总线时区分各自的结果；
+     *          未连接或请求未能发出时立即以accepted=false回调
+     */
+    void writeVoltageAndCurrent(double voltage, double current, SetPointHandler handler);
+    
     /**
      * @brief 写入卸载控制命令
      */
@@ -246,6 +473,41 @@ public:
      * @param value 要写入的值
      */
     Q_INVOKABLE void writeHoldingRegister(int slaveAddress, int registerAddress, double value);
+    
+    /**
+     * @brief 注入一个采样
+     * @param voltage 电压值
+     * @param current 电流值
+     * @param power 功率值
+     * @details 与总线读取完成时走同一路径：更新电压/电流/功率属性并发出sampleReady，
+     *          供回放与模拟数据源在无硬件时驱动波形、统计、报警与记录
+     */
+    Q_INVOKABLE void injectSample(double voltage, double current, double power);
+
+    /**
+     * @brief 注入一个带时间戳的采样
+     * @param timestampNs 样本产生时刻（UTC纳秒，SampleClock），随sampleReady发出
+     */
+    Q_INVOKABLE void injectSample(double voltage, double current, double power, qint64 timestampNs);
+
+    /**
+     * @brief 获取最近一次sampleReady的样本时刻
+     * @return 相对SampleClock时间原点的微秒（SampleClock::toOffsetUs）
+     * @details sampleReady的qint64纳秒时间戳到QML后按double处理会丢失精度，
+     *          QML在onSampleReady中调用本函数取得同一样本的时刻，无损传给markPlotted等C++接口
+     */
+    Q_INVOKABLE double sampleTimeUs() const;
+
+    /**
+     * @brief 获取传输层统计
+     * @return 事务数、错误数、平均/最大往返时间等
+     */
+    Q_INVOKABLE QVariantMap transportStatistics() const;
+
+    /**
+     * @brief 清零传输层统计
+     */
+    Q_INVOKABLE void resetTransportStatistics();
 
 signals:
     /**
@@ -295,6 +557,61 @@ signals:
      * @details 当高温报警状态数据有效性发生变化时触发
      */
     void hasHighTempDataChanged();
+
+    /**
+     * @brief 突发轮询状态变化信号
+     */
+    void burstActiveChanged();
+
+    /**
+     * @brief 自适应采样开关变化信号
+     */
+    void adaptiveSamplingChanged();
+
+    /**
+     * @brief 活动保持时间变化信号
+     */
+    void activityHoldMsChanged();
+
+    /**
+     * @brief 传输层开关变化信号
+     */
+    void nativeTransportChanged();
+
+    /**
+     * @brief 总线帧捕获开关变化信号
+     */
+    void busCaptureChanged();
+
+    /**
+     * @brief 回读设定值变化信号
+     */
+    void setPointChanged();
+
+    /**
+     * @brief 功能码23支持状态变化信号
+     */
+    void readWriteSupportedChanged();
+
+    /**
+     * @brief 设定值校验完成信号
+     * @details writeVoltageAndCurrent的写入与回读完成后触发
+     * @param accepted 回读值与写入值一致
+     * @param voltage 回读的设定电压
+     * @param current 回读的设定电流
+     */
+    void setPointVerified(bool accepted, double voltage, double current);
+
+    /**
+     * @brief 采样完成信号
+     * @details 一轮寄存器读取全部返回后触发，携带本轮的电压、电流、功率
+     * @param voltage 电压值
+     * @param current 电流值
+     * @param power 功率值
+     * @param timestampNs 本轮最后一个回复到达的时刻（UTC纳秒，SampleClock），
+     *                    不受信号排队与界面线程负载影响
+     */
+    void sampleReady(double voltage, double current, double power, qint64 timestampNs);
     
     /**
      * @brief 错误发生信号
@@ -323,14 +640,14 @@ private slots:
      * @details 定时读取所有需要的寄存器值
      */
     void readAllRegisters();
-    
+
+private:
     /**
-     * @brief 读取完成槽函数
-     * @details 当寄存器读取完成时调用
+     * @brief 应答处理函数
+     * @details 参数依次为是否成功、错误信息、寄存器值、寄存器数量
      */
-    void onReadReady();
+    using ReplyHandler = std::function<void(bool ok, const QString &errorString, const quint16 *values, int count)>;
 
-private:
     /**
      * @brief Modbus RTU串行主机
      */
@@ -387,12 +704,204 @@ private:
      */
     int m_pendingReads;
 
+    /**
+     * @brief 突发轮询状态
+     */
+    bool m_burstActive;
+
+    /**
+     * @brief 突发轮询的通道位掩码
+     */
+    int m_burstMask;
+
+    /**
+     * @brief 突发结束后是否恢复定时读取
+     */
+    bool m_resumeTimerAfterBurst;
+
+    /**
+     * @brief 本轮最近一个回复的到达时刻（UTC纳秒）
+     */
+    qint64 m_sampleTimeNs;
+
+    /**
+     * @brief 最近一次sampleReady携带的时间戳（UTC纳秒）
+     */
+    qint64 m_lastSampleNs;
+
+    /**
+     * @brief 完成一个读取请求
+     * @details 待处理请求归零时发出sampleReady，突发模式下立即发起下一轮
+     */
+    void finishPendingRead();
+
+    /**
+     * @brief 通道数量（Channel中的位数）
+     */
+    static constexpr int CHANNEL_COUNT = 5;
+
+    /**
+     * @brief 单个通道的采样活动状态
+     */
+    struct ChannelActivity {
+        double deadband = 0.0;          ///< 变化死区
+        double lastValue = 0.0;         ///< 上次读数
+        bool hasValue = false;
+        qint64 lastSampleNs = -1;       ///< 上次读取完成时刻，-1表示尚未读取
+        qint64 lastActiveNs = -1;       ///< 上次活动时刻
+        qint64 intervalNs = 0;          ///< 当前读取间隔，0表示每轮都读取
+        double averageIntervalNs = 0.0; ///< 读取间隔的指数平均，用于计算实际速率
+    };
+
+    /**
+     * @brief 自适应采样
+     */
+    bool m_adaptiveSampling;
+    bool m_adaptiveRunning;             ///< 定时读取正以自适应方式进行
+    int m_activityHoldMs;
+    QTimer *m_adaptiveTimer;
+    QElapsedTimer m_activityClock;
+    ChannelActivity m_channels[CHANNEL_COUNT];
+
+    /**
+     * @brief 是否正在定时读取（固定间隔或自适应）
+     */
+    bool readingActive() const;
+
+    /**
+     * @brief 按当前模式恢复定时读取
+     */
+    void resumeReading();
+
+    /**
+     * @brief 记录通道的一次读数并更新其读取间隔
+     * @param channelIndex 通道序号（Channel的位序号）
+     * @param value 读数
+     */
+    void updateChannelActivity(int channelIndex, double value);
+
+    /**
+     * @brief 记录通道的一次读取失败
+     * @param channelIndex 通道序号（Channel的位序号）
+     * @details 失败同样计为一次读取，并退回空闲间隔，持续无应答的从站不会被以总线最高速率重试
+     */
+    void recordChannelFailure(int channelIndex);
+
+    /**
+     * @brief 标记通道活动，立即以最高速率读取
+     * @param channelMask 通道位掩码
+     */
+    void markActivity(int channelMask);
+
+    /**
+     * @brief 获取已到读取时刻的通道
+     * @return 通道位掩码
+     */
+    int dueChannels() const;
+
+    /**
+     * @brief 按最早到期的通道安排下一轮自适应读取
+     */
+    void scheduleAdaptiveRead();
+
+    /**
+     * @brief 自有RTU传输层
+     */
+    ModbusTransport *m_transport;
+
+    /**
+     * @brief 是否在下次连接时使用自有传输层
+     */
+    bool m_nativeTransport;
+
+    /**
+     * @brief 当前连接是否使用自有传输层
+     */
+    bool m_transportActive;
+
+    /**
+     * @brief 事务统计
+     */
+    qint64 m_transactionCount;
+    qint64 m_transactionErrors;
+    qint64 m_totalRoundTripNs;
+    qint64 m_maxRoundTripNs;
+
+    /**
+     * @brief 当前传输层是否已连接
+     */
+    bool busConnected() const;
+
+    /**
+     * @brief 新连接前重置从站能力探测结果
+     */
+    void resetDeviceCapabilities();
+
+    /**
+     * @brief 发送读保持寄存器请求
+     * @return 请求是否已发出
+     */
+    bool sendReadRequest(int slaveAddress, int startAddress, int count, ReplyHandler handler);
+
+    /**
+     * @brief 发送写保持寄存器请求
+     * @return 请求是否已发出
+     */
+    bool sendWriteRequest(int slaveAddress, int startAddress, const QVector<quint16> &values, ReplyHandler handler);
+
+    /**
+     * @brief 发送读写多个寄存器请求（功能码23）
+     * @return 请求是否已发出
+     * @details 从站不支持功能码23时自动改用连续发出的写请求与读请求
+     */
+    bool sendReadWriteRequest(int slaveAddress, int readAddress, int readCount,
+                              int writeAddress, const QVector<quint16> &values, ReplyHandler handler);
+
+    /**
+     * @brief 以写+读两个请求代替功能码23
+     * @return 请求是否已发出
+     */
+    bool sendWriteThenRead(int slaveAddress, int readAddress, int readCount,
+                           int writeAddress, const QVector<quint16> &values, ReplyHandler handler);
+
+    /**
+     * @brief 标记从站不支持功能码23
+     */
+    void markReadWriteUnsupported();
+
+    /**
+     * @brief 设定值写入后回读风机与高温报警状态寄存器
+     */
+    void readBackStatus();
+
+    /**
+     * @brief 回读的设定电压/电流
+     */
+    double m_setPointVoltage;
+    double m_setPointCurrent;
+
+    /**
+     * @brief 从站不支持功能码23
+     */
+    bool m_readWriteUnsupported;
+
+    /**
+     * @brief 记录一次事务的往返时间
+     */
+    void recordTransaction(qint64 elapsedNs, bool ok);
+
+    /**
+     * @brief 处理读取到的寄存器值
+     */
+    void handleRegisterValue(int slaveAddress, int registerAddress, quint16 rawValue);
+
     /**
      * @brief 读取保持寄存器
      * @param slaveAddress 从站地址
      * @param registerAddress 寄存器地址
+     * @param channelIndex 通道序号，读取成功后用于更新采样活动状态
      */
-    void readHoldingRegister(int slaveAddress, int registerAddress);
+    void readHoldingRegister(int slaveAddress, int registerAddress, int channelIndex);
 };
 
 #endif
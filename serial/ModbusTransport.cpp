@@ -0,0 +1,770 @@
+#include "ModbusTransport.h"
+#include "ModbusCrc.h"
+#include "../core/Logger.h"
+#include "../core/Metrics.h"
+#include <QVarLengthArray>
+#include <QThread>
+#include <cstring>
+
+namespace {
+
+/**
+ * @brief 距总线空闲不足该值时原地等待，超过时交给定时器
+ * @details 传输层运行在界面线程，等待须短于一帧的渲染预算；
+ *          定时器只能按毫秒唤醒，多等的部分只会拉长帧间静默，不违反协议
+ */
+constexpr qint64 MAX_INLINE_WAIT_NS = 200 * 1000LL;
+
+/**
+ * @brief 按大端序写入16位值
+ */
+inline void put16(quint8 *buffer, int &pos, quint16 value)
+{
+    buffer[pos++] = static_cast<quint8>(value >> 8);
+    buffer[pos++] = static_cast<quint8>(value & 0xFF);
+}
+
+/**
+ * @brief 按大端序读取16位值
+ */
+inline quint16 get16(const quint8 *buffer)
+{
+    return static_cast<quint16>((buffer[0] << 8) | buffer[1]);
+}
+
+} // namespace
+
+QString ModbusTransport::Result::errorString() const
+{
+    switch (error) {
+    case NoError: return QString();
+    case TimeoutError: return QStringLiteral("应答超时");
+    case CrcError: return QStringLiteral("CRC校验错误");
+    case ExceptionError: return QStringLiteral("从站异常应答，异常码: %1").arg(exceptionCode);
+    case FrameError: return QStringLiteral("应答帧不匹配");
+    case NotConnectedError: return QStringLiteral("端口未连接");
+    }
+    return QString();
+}
+
+/**
+ * @brief 构造函数
+ * @param parent 父对象
+ */
+ModbusTransport::ModbusTransport(QObject *parent)
+    : QObject(parent)
+    , m_port(new QSerialPort(this))
+    , m_socket(new QTcpSocket(this))
+    , m_device(m_port)
+    , m_framing(RtuFraming)
+    , m_responseTimer(new QTimer(this))
+    , m_sendTimer(new QTimer(this))
+    , m_queueHead(0)
+    , m_queueCount(0)
+    , m_inFlightCount(0)
+    , m_maxOutstanding(16)
+    , m_nextTransactionId(1)
+    , m_rxLength(0)
+    , m_timeoutMs(1000)
+    , m_retries(3)
+    , m_turnaroundMs(100)
+    , m_charNs(0)
+    , m_silentNs(0)
+    , m_busIdleAtNs(0)
+    , m_crcErrors(0)
+    , m_timeouts(0)
+{
+    m_clock.start();
+
+    m_responseTimer->setSingleShot(true);
+    m_responseTimer->setTimerType(Qt::PreciseTimer);
+    m_sendTimer->setSingleShot(true);
+    m_sendTimer->setTimerType(Qt::PreciseTimer);
+
+    connect(m_port, &QSerialPort::readyRead, this, &ModbusTransport::onReadyRead);
+    connect(m_port, &QSerialPort::errorOccurred, this, &ModbusTransport::onSerialError);
+    connect(m_socket, &QTcpSocket::readyRead, this, &ModbusTransport::onReadyRead);
+    connect(m_socket, &QTcpSocket::connected, this, &ModbusTransport::onSocketConnected);
+    connect(m_socket, &QTcpSocket::disconnected, this, &ModbusTransport::onSocketDisconnected);
+    connect(m_socket, &QTcpSocket::errorOccurred, this, &ModbusTransport::onSocketError);
+    connect(m_responseTimer, &QTimer::timeout, this, &ModbusTransport::onResponseTimeout);
+    connect(m_sendTimer, &QTimer::timeout, this, &ModbusTransport::startNext);
+}
+
+ModbusTransport::~ModbusTransport()
+{
+    close();
+}
+
+/**
+ * @brief 打开串口
+ * @details 根据波特率和帧格式计算字符时间与3.5字符静默时间；
+ *          波特率高于19200时按规范固定为1.75ms
+ */
+bool ModbusTransport::open(const QString &portName, int baudRate, QSerialPort::Parity parity, QSerialPort::StopBits stopBits)
+{
+    close();
+    m_framing = RtuFraming;
+    m_device = m_port;
+
+    m_port->setPortName(portName);
+    m_port->setBaudRate(baudRate);
+    m_port->setDataBits(QSerialPort::Data8);
+    m_port->setParity(parity);
+    m_port->setStopBits(stopBits);
+    m_port->setFlowControl(QSerialPort::NoFlowControl);
+
+    if (!m_port->open(QIODevice::ReadWrite)) {
+        emit errorOccurred(m_port->errorString());
+        return false;
+    }
+
+    const int bitsPerChar = 1 + 8 + (parity == QSerialPort::NoParity ? 0 : 1) + (stopBits == QSerialPort::TwoStop ? 2 : 1);
+    m_charNs = static_cast<qint64>(bitsPerChar) * 1000000000LL / qMax(1, baudRate);
+    m_silentNs = baudRate > 19200 ? 1750000LL : m_charNs * 7 / 2;
+    m_busIdleAtNs = m_clock.nsecsElapsed() + m_silentNs;
+    m_rxLength = 0;
+
+    emit connectedChanged(true);
+    return true;
+}
+
+/**
+ * @brief 连接网关或Modbus TCP设备
+ * @details 帧间时序由网关负责，TCP连接不计算静默时间；关闭Nagle算法以免小帧被合并延迟
+ */
+bool ModbusTransport::openTcp(const QString &host, quint16 port, Framing framing)
+{
+    if (framing == RtuFraming) {
+        return false;
+    }
+
+    close();
+    m_framing = framing;
+    m_device = m_socket;
+    m_charNs = 0;
+    m_silentNs = 0;
+    m_busIdleAtNs = 0;
+    m_rxLength = 0;
+
+    m_socket->setSocketOption(QAbstractSocket::LowDelayOption, 1);
+    m_socket->connectToHost(host, port);
+    return true;
+}
+
+void ModbusTransport::close()
+{
+    if (m_framing == RtuFraming) {
+        if (!m_port->isOpen()) {
+            return;
+        }
+        failAll(NotConnectedError);
+        m_port->close();
+        emit connectedChanged(false);
+        return;
+    }
+
+    if (m_socket->state() == QAbstractSocket::UnconnectedState) {
+        return;
+    }
+    // 已连接时abort会触发disconnected，由onSocketDisconnected通知
+    failAll(NotConnectedError);
+    m_socket->abort();
+}
+
+bool ModbusTransport::isOpen() const
+{
+    if (m_framing == RtuFraming) {
+        return m_port->isOpen();
+    }
+    return m_socket->state() == QAbstractSocket::ConnectedState;
+}
+
+bool ModbusTransport::readHoldingRegisters(int slave, int address, int count, Callback callback)
+{
+    // 读请求不允许广播
+    if (slave < 1 || count < 1 || count > MODBUS_MAX_REGISTERS) {
+        return false;
+    }
+
+    int slot = -1;
+    Transaction *t = prepare(slave, ReadHoldingRegisters, address, callback, slot);
+    if (!t) {
+        return false;
+    }
+    put16(t->adu, t->aduLength, static_cast<quint16>(address));
+    put16(t->adu, t->aduLength, static_cast<quint16>(count));
+    finalize(*t, 5 + 2 * count);
+    return enqueue(slot);
+}
+
+bool ModbusTransport::writeSingleRegister(int slave, int address, quint16 value, Callback callback)
+{
+    int slot = -1;
+    Transaction *t = prepare(slave, WriteSingleRegister, address, callback, slot);
+    if (!t) {
+        return false;
+    }
+    put16(t->adu, t->aduLength, static_cast<quint16>(address));
+    put16(t->adu, t->aduLength, value);
+    finalize(*t, 8);
+    return enqueue(slot);
+}
+
+bool ModbusTransport::writeMultipleRegisters(int slave, int address, const quint16 *values, int count, Callback callback)
+{
+    if (count < 1 || count > 123) {
+        return false;
+    }
+
+    int slot = -1;
+    Transaction *t = prepare(slave, WriteMultipleRegisters, address, callback, slot);
+    if (!t) {
+        return false;
+    }
+    put16(t->adu, t->aduLength, static_cast<quint16>(address));
+    put16(t->adu, t->aduLength, static_cast<quint16>(count));
+    t->adu[t->aduLength++] = static_cast<quint8>(count * 2);
+    for (int i = 0; i < count; ++i) {
+        put16(t->adu, t->aduLength, values[i]);
+    }
+    finalize(*t, 8);
+    return enqueue(slot);
+}
+
+bool ModbusTransport::readWriteMultipleRegisters(int slave, int readAddress, int readCount,
+                                                 int writeAddress, const quint16 *values, int writeCount,
+                                                 Callback callback)
+{
+    if (slave < 1 || readCount < 1 || readCount > MODBUS_MAX_REGISTERS || writeCount < 1 || writeCount > 121) {
+        return false;
+    }
+
+    int slot = -1;
+    Transaction *t = prepare(slave, ReadWriteMultipleRegisters, readAddress, callback, slot);
+    if (!t) {
+        return false;
+    }
+    put16(t->adu, t->aduLength, static_cast<quint16>(readAddress));
+    put16(t->adu, t->aduLength, static_cast<quint16>(readCount));
+    put16(t->adu, t->aduLength, static_cast<quint16>(writeAddress));
+    put16(t->adu, t->aduLength, static_cast<quint16>(writeCount));
+    t->adu[t->aduLength++] = static_cast<quint8>(writeCount * 2);
+    for (int i = 0; i < writeCount; ++i) {
+        put16(t->adu, t->aduLength, values[i]);
+    }
+    finalize(*t, 5 + 2 * readCount);
+    return enqueue(slot);
+}
+
+/**
+ * @brief 从对象池取出空闲事务
+ * @return 槽位索引，池满返回-1
+ */
+int ModbusTransport::acquire()
+{
+    for (int i = 0; i < PoolSize; ++i) {
+        if (!m_pool[i].inUse) {
+            return i;
+        }
+    }
+    return -1;
+}
+
+ModbusTransport::Transaction *ModbusTransport::prepare(int slave, quint8 functionCode, int address, Callback &callback, int &slot)
+{
+    if (!isOpen() || slave < 0 || slave > 247) {
+        return nullptr;
+    }
+
+    slot = acquire();
+    if (slot < 0) {
+        LOG_WARNING(Log::Transport, "transport queue full");
+        return nullptr;
+    }
+
+    Transaction &t = m_pool[slot];
+    t.inUse = true;
+    t.slave = static_cast<quint8>(slave);
+    t.functionCode = functionCode;
+    t.address = static_cast<quint16>(address);
+    t.transactionId = 0;
+    t.retriesLeft = m_retries;
+    t.startedAtNs = 0;
+    t.deadlineNs = 0;
+    t.callback = std::move(callback);
+    t.adu[0] = t.slave;
+    t.adu[1] = functionCode;
+    t.aduLength = 2;
+    return &t;
+}
+
+/**
+ * @brief 完成组帧
+ * @details 统一按RTU格式附加CRC；Modbus TCP发送时去掉CRC并加MBAP报文头
+ */
+void ModbusTransport::finalize(Transaction &t, int expectedLength)
+{
+    const quint16 crc = ModbusCrc::compute(t.adu, static_cast<std::size_t>(t.aduLength));
+    t.adu[t.aduLength++] = static_cast<quint8>(crc & 0xFF);
+    t.adu[t.aduLength++] = static_cast<quint8>(crc >> 8);
+    t.expectedLength = t.slave == 0 ? 0 : expectedLength;
+}
+
+bool ModbusTransport::enqueue(int slot)
+{
+    m_queue[(m_queueHead + m_queueCount) % PoolSize] = slot;
+    ++m_queueCount;
+    Metrics::adjust(Metrics::TransportQueue, 1);
+    startNext();
+    return true;
+}
+
+/**
+ * @brief 发送队首事务
+ * @details 串口：距总线空闲时刻超过200µs时交给精确定时器（向上取整到毫秒），
+ *          不足200µs的余量让出时间片等待，保证两帧之间至少留出3.5字符的静默间隔。
+ *          Modbus TCP：在未完成事务数达到上限前连续发送，不等待应答
+ */
+void ModbusTransport::startNext()
+{
+    const int limit = m_framing == TcpFraming ? m_maxOutstanding : 1;
+    while (m_queueCount > 0 && m_inFlightCount < limit && isOpen()) {
+        if (m_framing == RtuFraming) {
+            const qint64 waitNs = m_busIdleAtNs - m_clock.nsecsElapsed();
+            if (waitNs > MAX_INLINE_WAIT_NS) {
+                if (!m_sendTimer->isActive()) {
+                    m_sendTimer->start(static_cast<int>((waitNs + 999999) / 1000000));
+                }
+                return;
+            }
+            while (m_clock.nsecsElapsed() < m_busIdleAtNs) {
+                QThread::yieldCurrentThread();
+            }
+        }
+
+        const int slot = m_queue[m_queueHead];
+        m_queueHead = (m_queueHead + 1) % PoolSize;
+        --m_queueCount;
+        m_inFlight[m_inFlightCount++] = slot;
+        transmit(slot);
+    }
+}
+
+void ModbusTransport::transmit(int slot)
+{
+    Transaction &t = m_pool[slot];
+    const qint64 now = m_clock.nsecsElapsed();
+    if (t.startedAtNs == 0) {
+        t.startedAtNs = now;
+    }
+
+    if (m_framing == TcpFraming) {
+        // MBAP报文头：事务标识符、协议标识符0、后续字节数；重发时使用新的事务标识符，
+        // 避免超时后迟到的应答被误认为重发的应答
+        t.transactionId = m_nextTransactionId++;
+        const int pduLength = t.aduLength - 3;
+        quint8 frame[7 + 256];
+        int pos = 0;
+        put16(frame, pos, t.transactionId);
+        put16(frame, pos, 0);
+        put16(frame, pos, static_cast<quint16>(pduLength + 1));
+        memcpy(frame + pos, t.adu, static_cast<size_t>(pduLength + 1));
+        pos += pduLength + 1;
+        m_socket->write(reinterpret_cast<const char *>(frame), pos);
+        LOG_FRAME(Log::Transport, Log::Tx, Log::TcpFrame, frame, pos);
+    } else {
+        // 丢弃上一事务残留的字节
+        m_rxLength = 0;
+        if (m_framing == RtuFraming) {
+            m_port->clear(QSerialPort::Input);
+        } else {
+            m_socket->readAll();
+        }
+        m_device->write(reinterpret_cast<const char *>(t.adu), t.aduLength);
+        LOG_FRAME(Log::Transport, Log::Tx, Log::RtuFrame, t.adu, t.aduLength);
+    }
+    if (m_framing == RtuFraming) {
+        m_port->flush();
+    } else {
+        m_socket->flush();
+    }
+
+    const qint64 txNs = t.aduLength * m_charNs;
+    if (t.slave == 0) {
+        // 广播无应答，保持总线空闲一个转向延时后即可发送下一帧
+        m_busIdleAtNs = now + txNs + static_cast<qint64>(m_turnaroundMs) * 1000000LL;
+        Result result;
+        result.slave = 0;
+        result.functionCode = t.functionCode;
+        result.address = t.address;
+        complete(slot, result);
+        return;
+    }
+
+    m_busIdleAtNs = now + txNs + m_silentNs;
+    t.deadlineNs = now + txNs + static_cast<qint64>(m_timeoutMs) * 1000000LL;
+    armResponseTimer();
+}
+
+/**
+ * @brief 将事务移出未完成列表并归还池槽位
+ */
+void ModbusTransport::release(int slot)
+{
+    for (int i = 0; i < m_inFlightCount; ++i) {
+        if (m_inFlight[i] == slot) {
+            m_inFlight[i] = m_inFlight[--m_inFlightCount];
+            break;
+        }
+    }
+    armResponseTimer();
+}
+
+/**
+ * @brief 按最早到期的未完成事务设置应答定时器
+ */
+void ModbusTransport::armResponseTimer()
+{
+    if (m_inFlightCount == 0) {
+        m_responseTimer->stop();
+        return;
+    }
+
+    qint64 earliest = m_pool[m_inFlight[0]].deadlineNs;
+    for (int i = 1; i < m_inFlightCount; ++i) {
+        earliest = qMin(earliest, m_pool[m_inFlight[i]].deadlineNs);
+    }
+    const qint64 remainingNs = earliest - m_clock.nsecsElapsed();
+    m_responseTimer->start(remainingNs > 0 ? static_cast<int>(remainingNs / 1000000) + 1 : 0);
+}
+
+/**
+ * @brief 完成事务
+ * @details 先归还池槽位再调用回调，回调中可以继续提交新请求
+ */
+void ModbusTransport::complete(int slot, Result &result)
+{
+    Transaction &t = m_pool[slot];
+    release(slot);
+    Metrics::adjust(Metrics::TransportQueue, -1);
+
+    result.roundTripNs = m_clock.nsecsElapsed() - t.startedAtNs;
+    Callback callback = std::move(t.callback);
+    t.callback = nullptr;
+    t.inUse = false;
+
+    if (callback) {
+        callback(result);
+    }
+    startNext();
+}
+
+void ModbusTransport::retryOrFail(int slot, Error error)
+{
+    Transaction &t = m_pool[slot];
+    if (t.retriesLeft > 0) {
+        --t.retriesLeft;
+        release(slot);
+        // 重新放回队首，串口等待静默间隔后重发
+        m_queueHead = (m_queueHead - 1 + PoolSize) % PoolSize;
+        m_queue[m_queueHead] = slot;
+        ++m_queueCount;
+        m_busIdleAtNs = qMax(m_busIdleAtNs, m_clock.nsecsElapsed() + m_silentNs);
+        startNext();
+        return;
+    }
+
+    Result result;
+    result.error = error;
+    result.slave = t.slave;
+    result.functionCode = t.functionCode;
+    result.address = t.address;
+    complete(slot, result);
+}
+
+void ModbusTransport::failAll(Error error)
+{
+    m_responseTimer->stop();
+    m_sendTimer->stop();
+
+    QVarLengthArray<int, PoolSize> slots;
+    for (int i = 0; i < m_inFlightCount; ++i) {
+        slots.append(m_inFlight[i]);
+    }
+    for (int i = 0; i < m_queueCount; ++i) {
+        slots.append(m_queue[(m_queueHead + i) % PoolSize]);
+    }
+    m_inFlightCount = 0;
+    m_queueHead = 0;
+    m_queueCount = 0;
+    m_rxLength = 0;
+    Metrics::adjust(Metrics::TransportQueue, -slots.size());
+
+    for (int slot : slots) {
+        Transaction &t = m_pool[slot];
+        Result result;
+        result.error = error;
+        result.slave = t.slave;
+        result.functionCode = t.functionCode;
+        result.address = t.address;
+        Callback callback = std::move(t.callback);
+        t.callback = nullptr;
+        t.inUse = false;
+        if (callback) {
+            callback(result);
+        }
+    }
+}
+
+void ModbusTransport::onReadyRead()
+{
+    if (m_inFlightCount == 0) {
+        // 没有进行中的事务，丢弃非预期字节
+        m_device->readAll();
+        return;
+    }
+
+    const qint64 space = static_cast<qint64>(sizeof(m_rxBuffer)) - m_rxLength;
+    const qint64 n = m_device->read(reinterpret_cast<char *>(m_rxBuffer) + m_rxLength, space);
+    if (n > 0) {
+        m_rxLength += static_cast<int>(n);
+    }
+
+    if (m_framing == TcpFraming) {
+        // TCP流中可能同时到达多个应答，剩余字节留待解析后继续读取
+        processTcpFrames();
+        return;
+    }
+
+    if (m_device->bytesAvailable() > 0) {
+        m_device->readAll();
+    }
+
+    // 接收期间总线视为忙，最后一个字节之后再留出静默间隔
+    m_busIdleAtNs = m_clock.nsecsElapsed() + m_silentNs;
+    processRtuFrame();
+}
+
+/**
+ * @brief 解析RTU应答帧
+ * @details 根据请求推算的应答长度（异常应答固定5字节）判断帧是否接收完整
+ */
+void ModbusTransport::processRtuFrame()
+{
+    const int slot = m_inFlight[0];
+    const Transaction &t = m_pool[slot];
+    if (m_rxLength < 2) {
+        return;
+    }
+
+    const bool exception = (m_rxBuffer[1] & 0x80) != 0;
+    const int expected = exception ? 5 : t.expectedLength;
+    if (m_rxLength < expected) {
+        return;
+    }
+
+    LOG_FRAME(Log::Transport, Log::Rx, Log::RtuFrame, m_rxBuffer, expected);
+    const quint16 crc = ModbusCrc::compute(m_rxBuffer, static_cast<std::size_t>(expected - 2));
+    const quint16 received = static_cast<quint16>(m_rxBuffer[expected - 2] | (m_rxBuffer[expected - 1] << 8));
+    if (crc != received) {
+        ++m_crcErrors;
+        retryOrFail(slot, CrcError);
+        return;
+    }
+    if (m_rxBuffer[0] != t.slave) {
+        retryOrFail(slot, FrameError);
+        return;
+    }
+
+    Result result;
+    if (!parsePdu(t, m_rxBuffer + 1, expected - 3, result)) {
+        retryOrFail(slot, FrameError);
+        return;
+    }
+    complete(slot, result);
+}
+
+/**
+ * @brief 解析TCP流中的MBAP应答
+ * @details 按事务标识符匹配未完成事务；找不到对应事务（如超时后迟到）的应答直接丢弃
+ */
+void ModbusTransport::processTcpFrames()
+{
+    while (true) {
+        int offset = 0;
+        while (m_rxLength - offset >= 7) {
+            const quint8 *frame = m_rxBuffer + offset;
+            const int length = get16(frame + 4);
+            if (get16(frame + 2) != 0 || length < 3 || length > 254) {
+                // 报文头损坏，无法重新同步，断开连接
+                m_rxLength = 0;
+                emit errorOccurred(QStringLiteral("Modbus TCP报文头无效"));
+                m_socket->abort();
+                return;
+            }
+            if (m_rxLength - offset < 6 + length) {
+                break;
+            }
+            offset += 6 + length;
+            LOG_FRAME(Log::Transport, Log::Rx, Log::TcpFrame, frame, 6 + length);
+
+            int slot = -1;
+            const quint16 transactionId = get16(frame);
+            for (int i = 0; i < m_inFlightCount; ++i) {
+                if (m_pool[m_inFlight[i]].transactionId == transactionId) {
+                    slot = m_inFlight[i];
+                    break;
+                }
+            }
+            if (slot < 0) {
+                continue;
+            }
+
+            const Transaction &t = m_pool[slot];
+            Result result;
+            if (frame[6] != t.slave || !parsePdu(t, frame + 7, length - 1, result)) {
+                retryOrFail(slot, FrameError);
+            } else {
+                complete(slot, result);
+            }
+            // 回调中可能已关闭连接
+            if (!isOpen()) {
+                m_rxLength = 0;
+                return;
+            }
+        }
+
+        // 前移未解析的字节，再从套接字补充
+        if (offset > 0) {
+            memmove(m_rxBuffer, m_rxBuffer + offset, static_cast<size_t>(m_rxLength - offset));
+            m_rxLength -= offset;
+        }
+        const qint64 space = static_cast<qint64>(sizeof(m_rxBuffer)) - m_rxLength;
+        if (space <= 0 || m_socket->bytesAvailable() == 0) {
+            return;
+        }
+        const qint64 n = m_socket->read(reinterpret_cast<char *>(m_rxBuffer) + m_rxLength, space);
+        if (n <= 0) {
+            return;
+        }
+        m_rxLength += static_cast<int>(n);
+    }
+}
+
+/**
+ * @brief 解析应答PDU
+ * @param t 对应的事务
+ * @param pdu 功能码起始的PDU
+ * @param length PDU字节数
+ * @param result 输出结果
+ * @return 功能码与长度是否与请求匹配
+ */
+bool ModbusTransport::parsePdu(const Transaction &t, const quint8 *pdu, int length, Result &result) const
+{
+    if (length < 2 || (pdu[0] & 0x7F) != t.functionCode) {
+        return false;
+    }
+
+    result.slave = t.slave;
+    result.functionCode = t.functionCode;
+    result.address = t.address;
+
+    if (pdu[0] & 0x80) {
+        result.error = ExceptionError;
+        result.exceptionCode = pdu[1];
+        return true;
+    }
+    if (length != t.expectedLength - 3) {
+        return false;
+    }
+
+    if (t.functionCode == ReadHoldingRegisters || t.functionCode == ReadWriteMultipleRegisters) {
+        const int byteCount = pdu[1];
+        if (byteCount != length - 2) {
+            return false;
+        }
+        result.count = byteCount / 2;
+        for (int i = 0; i < result.count; ++i) {
+            result.values[i] = get16(pdu + 2 + 2 * i);
+        }
+    } else if (t.functionCode == WriteSingleRegister) {
+        result.count = 1;
+        result.values[0] = get16(pdu + 3);
+    } else {
+        result.count = get16(pdu + 3);
+    }
+    return true;
+}
+
+/**
+ * @brief 应答超时
+ * @details 处理所有已到期的未完成事务
+ */
+void ModbusTransport::onResponseTimeout()
+{
+    const qint64 now = m_clock.nsecsElapsed();
+    bool expired = false;
+    // 重发的事务会获得新的截止时间，循环在没有到期事务时结束
+    while (true) {
+        int slot = -1;
+        for (int i = 0; i < m_inFlightCount; ++i) {
+            if (m_pool[m_inFlight[i]].deadlineNs <= now) {
+                slot = m_inFlight[i];
+                break;
+            }
+        }
+        if (slot < 0) {
+            break;
+        }
+        expired = true;
+        ++m_timeouts;
+        // 串口应答不完整时记录已收到的字节，便于离线区分截断帧与完全无应答
+        if (m_framing != TcpFraming && m_rxLength > 0) {
+            LOG_FRAME(Log::Transport, Log::Rx, Log::RtuFrame, m_rxBuffer, m_rxLength);
+            m_rxLength = 0;
+        }
+        retryOrFail(slot, TimeoutError);
+    }
+
+    if (!expired) {
+        armResponseTimer();
+    }
+}
+
+void ModbusTransport::onSerialError(QSerialPort::SerialPortError error)
+{
+    if (error == QSerialPort::NoError) {
+        return;
+    }
+
+    emit errorOccurred(m_port->errorString());
+    // 设备被拔出等不可恢复错误时关闭端口
+    if (error == QSerialPort::ResourceError) {
+        close();
+    }
+}
+
+void ModbusTransport::onSocketConnected()
+{
+    m_rxLength = 0;
+    emit connectedChanged(true);
+    startNext();
+}
+
+void ModbusTransport::onSocketDisconnected()
+{
+    failAll(NotConnectedError);
+    emit connectedChanged(false);
+}
+
+void ModbusTransport::onSocketError(QAbstractSocket::SocketError error)
+{
+    Q_UNUSED(error);
+    emit errorOccurred(m_socket->errorString());
+    // 连接阶段失败时不会触发disconnected，这里补发断开通知
+    if (m_socket->state() != QAbstractSocket::ConnectedState) {
+        failAll(NotConnectedError);
+        emit connectedChanged(false);
+    }
+}
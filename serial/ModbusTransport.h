@@ -0,0 +1,264 @@
+#ifndef MODBUSTRANSPORT_H
+#define MODBUSTRANSPORT_H
+
+#include <QObject>
+#include <QSerialPort>
+#include <QTcpSocket>
+#include <QElapsedTimer>
+#include <QTimer>
+#include <functional>
+
+/**
+ * @brief 单次请求可读写的最大寄存器数
+ */
+constexpr int MODBUS_MAX_REGISTERS = 125;
+
+/**
+ * @brief 轻量级Modbus主站传输层
+ * @details 直接在QSerialPort/QTcpSocket上完成组帧与解析，替代QModbusRtuSerialMaster：
+ *          - 请求对象来自固定大小的对象池，不为每次事务分配QObject
+ *          - 串口帧间静默时间按波特率精确计算为3.5个字符时间
+ *          - 支持功能码03/06/16/23及广播写（从站地址0）
+ *          - 支持Modbus TCP（MBAP报文头）与RTU over TCP（网关透传RTU帧）
+ *          串口和RTU over TCP同一时刻只允许一个事务；Modbus TCP按事务标识符匹配应答，
+ *          可同时保持多个未完成事务
+ */
+class ModbusTransport : public QObject
+{
+    Q_OBJECT
+
+public:
+    /**
+     * @brief 事务错误类型
+     */
+    enum Error {
+        NoError,
+        TimeoutError,       ///< 应答超时（重试耗尽）
+        CrcError,           ///< 应答CRC校验失败（重试耗尽）
+        ExceptionError,     ///< 从站返回异常码
+        FrameError,         ///< 应答地址/功能码/长度不匹配
+        NotConnectedError   ///< 端口未打开或连接断开
+    };
+
+    /**
+     * @brief 功能码
+     */
+    enum FunctionCode : quint8 {
+        ReadHoldingRegisters = 0x03,
+        WriteSingleRegister = 0x06,
+        WriteMultipleRegisters = 0x10,
+        ReadWriteMultipleRegisters = 0x17
+    };
+
+    /**
+     * @brief 帧格式
+     */
+    enum Framing {
+        RtuFraming,         ///< 串口RTU
+        TcpFraming,         ///< Modbus TCP（MBAP）
+        RtuOverTcpFraming   ///< TCP透传RTU帧（含CRC）
+    };
+
+    /**
+     * @brief 事务结果
+     * @details 作为回调参数以常量引用传递，回调返回后即失效
+     */
+    struct Result {
+        Error error = NoError;
+        quint8 slave = 0;
+        quint8 functionCode = 0;
+        quint8 exceptionCode = 0;
+        quint16 address = 0;
+        int count = 0;
+        quint16 values[MODBUS_MAX_REGISTERS] = {};
+        qint64 roundTripNs = 0;
+
+        QString errorString() const;
+    };
+
+    using Callback = std::function<void(const Result &)>;
+
+    explicit ModbusTransport(QObject *parent = nullptr);
+    ~ModbusTransport();
+
+    /**
+     * @brief 打开串口
+     * @param portName 串口名称
+     * @param baudRate 波特率
+     * @param parity 校验位
+     * @param stopBits 停止位
+     * @return 是否成功
+     */
+    bool open(const QString &portName, int baudRate, QSerialPort::Parity parity, QSerialPort::StopBits stopBits = QSerialPort::OneStop);
+
+    /**
+     * @brief 连接网关或Modbus TCP设备
+     * @param host 主机地址
+     * @param port TCP端口
+     * @param framing TcpFraming或RtuOverTcpFraming
+     * @return 是否已开始连接，连接结果通过connectedChanged信号通知
+     */
+    bool openTcp(const QString &host, quint16 port, Framing framing = TcpFraming);
+
+    /**
+     * @brief 关闭连接
+     * @details 所有排队中的事务以NotConnectedError完成
+     */
+    void close();
+
+    bool isOpen() const;
+
+    Framing framing() const { return m_framing; }
+
+    void setTimeout(int ms) { m_timeoutMs = ms; }
+    void setNumberOfRetries(int retries) { m_retries = retries; }
+
+    /**
+     * @brief 设置广播后的转向延时
+     * @param ms 毫秒，期间总线保持空闲以便从站处理广播
+     */
+    void setTurnaroundDelay(int ms) { m_turnaroundMs = ms; }
+
+    /**
+     * @brief 设置Modbus TCP下允许同时未完成的事务数
+     * @param count 1到PoolSize之间，串口与RTU over TCP固定为1
+     */
+    void setMaxOutstanding(int count) { m_maxOutstanding = qBound(1, count, static_cast<int>(PoolSize)); }
+    int maxOutstanding() const { return m_maxOutstanding; }
+
+    /**
+     * @brief 获取3.5字符静默时间
+     * @return 纳秒，TCP连接为0
+     */
+    qint64 silentIntervalNs() const { return m_silentNs; }
+
+    /**
+     * @brief 排队中（含进行中）的事务数
+     */
+    int pendingCount() const { return m_queueCount + m_inFlightCount; }
+
+    /**
+     * @brief 已发出尚未应答的事务数
+     */
+    int inFlightCount() const { return m_inFlightCount; }
+
+    /**
+     * @brief 读保持寄存器（FC03）
+     */
+    bool readHoldingRegisters(int slave, int address, int count, Callback callback);
+
+    /**
+     * @brief 写单个寄存器（FC06），slave为0时广播
+     */
+    bool writeSingleRegister(int slave, int address, quint16 value, Callback callback);
+
+    /**
+     * @brief 写多个寄存器（FC16），slave为0时广播
+     */
+    bool writeMultipleRegisters(int slave, int address, const quint16 *values, int count, Callback callback);
+
+    /**
+     * @brief 读写多个寄存器（FC23）
+     * @details 从站先执行写入再读取，读写在同一次总线事务中完成
+     */
+    bool readWriteMultipleRegisters(int slave, int readAddress, int readCount,
+                                    int writeAddress, const quint16 *values, int writeCount,
+                                    Callback callback);
+
+    /**
+     * @brief 统计：CRC错误次数
+     */
+    int crcErrorCount() const { return m_crcErrors; }
+
+    /**
+     * @brief 统计：超时次数（含重试）
+     */
+    int timeoutCount() const { return m_timeouts; }
+
+signals:
+    /**
+     * @brief 连接状态变化信号
+     */
+    void connectedChanged(bool connected);
+
+    /**
+     * @brief 错误发生信号
+     */
+    void errorOccurred(const QString &error);
+
+private slots:
+    void onReadyRead();
+    void onResponseTimeout();
+    void onSerialError(QSerialPort::SerialPortError error);
+    void onSocketConnected();
+    void onSocketDisconnected();
+    void onSocketError(QAbstractSocket::SocketError error);
+
+private:
+    /**
+     * @brief 池化事务
+     */
+    struct Transaction {
+        bool inUse = false;
+        quint8 adu[256] = {};
+        int aduLength = 0;
+        int expectedLength = 0;
+        quint8 slave = 0;
+        quint8 functionCode = 0;
+        quint16 address = 0;
+        quint16 transactionId = 0;
+        int retriesLeft = 0;
+        qint64 startedAtNs = 0;
+        qint64 deadlineNs = 0;
+        Callback callback;
+    };
+
+    static constexpr int PoolSize = 32;
+
+    QSerialPort *m_port;
+    QTcpSocket *m_socket;
+    QIODevice *m_device;
+    Framing m_framing;
+    QTimer *m_responseTimer;
+    QTimer *m_sendTimer;
+    QElapsedTimer m_clock;
+
+    Transaction m_pool[PoolSize];
+    int m_queue[PoolSize];
+    int m_queueHead;
+    int m_queueCount;
+    int m_inFlight[PoolSize];
+    int m_inFlightCount;
+    int m_maxOutstanding;
+    quint16 m_nextTransactionId;
+
+    quint8 m_rxBuffer[512];
+    int m_rxLength;
+
+    int m_timeoutMs;
+    int m_retries;
+    int m_turnaroundMs;
+    qint64 m_charNs;
+    qint64 m_silentNs;
+    qint64 m_busIdleAtNs;
+
+    int m_crcErrors;
+    int m_timeouts;
+
+    int acquire();
+    bool enqueue(int slot);
+    Transaction *prepare(int slave, quint8 functionCode, int address, Callback &callback, int &slot);
+    void finalize(Transaction &t, int expectedLength);
+    void startNext();
+    void transmit(int slot);
+    void release(int slot);
+    void armResponseTimer();
+    void complete(int slot, Result &result);
+    void retryOrFail(int slot, Error error);
+    void failAll(Error error);
+    void processRtuFrame();
+    void processTcpFrames();
+    bool parsePdu(const Transaction &t, const quint8 *pdu, int length, Result &result) const;
+};
+
+#endif
@@ -0,0 +1,258 @@
+#include "RecordTable.h"
+#include "../core/SampleClock.h"
+#include <cmath>
+#include <cstring>
+#include <limits>
+
+namespace {
+
+const char *const TYPE_NAMES[] = { "int16", "int32", "float32", "float64", "bits16", "bits32" };
+
+template <typename T>
+T readAt(const QByteArray &column, int row)
+{
+    T value;
+    std::memcpy(&value, column.constData() + static_cast<qsizetype>(row) * sizeof(T), sizeof(T));
+    return value;
+}
+
+template <typename T>
+void appendValue(QByteArray &column, T value)
+{
+    column.append(reinterpret_cast<const char *>(&value), sizeof(T));
+}
+
+/**
+ * @brief 按scale换算为整数原始值并截断到类型范围
+ */
+template <typename T>
+T toRaw(double value, double scale)
+{
+    const double raw = std::round(value / (scale != 0.0 ? scale : 1.0));
+    if (!(raw > std::numeric_limits<T>::min())) {
+        return std::numeric_limits<T>::min();
+    }
+    if (raw >= std::numeric_limits<T>::max()) {
+        return std::numeric_limits<T>::max();
+    }
+    return static_cast<T>(raw);
+}
+
+template <typename T>
+T toBits(double value)
+{
+    if (!(value > 0.0)) {
+        return 0;
+    }
+    return value >= std::numeric_limits<T>::max() ? std::numeric_limits<T>::max() : static_cast<T>(value);
+}
+
+} // namespace
+
+int RecordChannel::width() const
+{
+    switch (type) {
+    case ChannelType::Int16:
+    case ChannelType::Bits16:
+        return 2;
+    case ChannelType::Float64:
+        return 8;
+    default:
+        return 4;
+    }
+}
+
+QString RecordChannel::label() const
+{
+    return unit.isEmpty() ? name : QString("%1(%2)").arg(name, unit);
+}
+
+QVariantMap RecordChannel::toMap() const
+{
+    QVariantMap map;
+    map["name"] = name;
+    map["unit"] = unit;
+    map["type"] = QString::fromLatin1(TYPE_NAMES[static_cast<int>(type)]);
+    map["scale"] = scale;
+    map["decimals"] = decimals;
+    return map;
+}
+
+RecordChannel RecordChannel::fromMap(const QVariantMap &map, bool *ok)
+{
+    RecordChannel channel;
+    channel.name = map.value("name").toString();
+    channel.unit = map.value("unit").toString();
+    channel.scale = map.value("scale", 1.0).toDouble();
+    channel.decimals = qBound(0, map.value("decimals", 2).toInt(), 9);
+
+    const QString typeName = map.value("type", "float32").toString().toLower();
+    bool known = false;
+    for (int i = 0; i < 6; ++i) {
+        if (typeName == QLatin1String(TYPE_NAMES[i])) {
+            channel.type = static_cast<ChannelType>(i);
+            known = true;
+            break;
+        }
+    }
+    if (ok) {
+        *ok = known && !channel.name.isEmpty();
+    }
+    return channel;
+}
+
+RecordTable::RecordTable()
+    : RecordTable(defaultChannels())
+{
+}
+
+RecordTable::RecordTable(const QVector<RecordChannel> &channels)
+    : m_channels(channels)
+    , m_packedRowSize(0)
+{
+    m_widths.reserve(channels.size());
+    for (const RecordChannel &channel : channels) {
+        m_widths.append(channel.width());
+        m_packedRowSize += channel.width();
+    }
+    m_columns.resize(channels.size());
+}
+
+QVector<RecordChannel> RecordTable::defaultChannels()
+{
+    RecordChannel voltage;
+    voltage.name = QStringLiteral("电压");
+    voltage.unit = QStringLiteral("V");
+    RecordChannel current;
+    current.name = QStringLiteral("电流");
+    current.unit = QStringLiteral("A");
+    RecordChannel power;
+    power.name = QStringLiteral("功率");
+    power.unit = QStringLiteral("kW");
+    power.decimals = 3;
+    return { voltage, current, power };
+}
+
+int RecordTable::bytesPerRow() const
+{
+    return static_cast<int>(sizeof(qint64)) + m_packedRowSize;
+}
+
+void RecordTable::append(qint64 timeNs, const double *values, int count)
+{
+    m_timeNs.append(timeNs);
+    for (int c = 0; c < m_channels.size(); ++c) {
+        const RecordChannel &channel = m_channels.at(c);
+        const double value = c < count ? values[c] : 0.0;
+        QByteArray &column = m_columns[c];
+        switch (channel.type) {
+        case ChannelType::Int16: appendValue(column, toRaw<qint16>(value, channel.scale)); break;
+        case ChannelType::Int32: appendValue(column, toRaw<qint32>(value, channel.scale)); break;
+        case ChannelType::Float32: appendValue(column, static_cast<float>(value)); break;
+        case ChannelType::Float64: appendValue(column, value); break;
+        case ChannelType::Bits16: appendValue(column, toBits<quint16>(value)); break;
+        case ChannelType::Bits32: appendValue(column, toBits<quint32>(value)); break;
+        }
+    }
+}
+
+void RecordTable::appendPacked(qint64 timeNs, const void *row)
+{
+    m_timeNs.append(timeNs);
+    const char *p = static_cast<const char *>(row);
+    for (int c = 0; c < m_columns.size(); ++c) {
+        m_columns[c].append(p, m_widths.at(c));
+        p += m_widths.at(c);
+    }
+}
+
+void RecordTable::reserve(int rows)
+{
+    m_timeNs.reserve(rows);
+    for (int c = 0; c < m_columns.size(); ++c) {
+        m_columns[c].reserve(static_cast<qsizetype>(rows) * m_widths.at(c));
+    }
+}
+
+void RecordTable::clear()
+{
+    m_timeNs.clear();
+    for (QByteArray &column : m_columns) {
+        column.clear();
+    }
+}
+
+double RecordTable::value(int row, int channel) const
+{
+    const QByteArray &column = m_columns.at(channel);
+    const RecordChannel &spec = m_channels.at(channel);
+    switch (spec.type) {
+    case ChannelType::Int16: return readAt<qint16>(column, row) * spec.scale;
+    case ChannelType::Int32: return readAt<qint32>(column, row) * spec.scale;
+    case ChannelType::Float32: return readAt<float>(column, row);
+    case ChannelType::Float64: return readAt<double>(column, row);
+    case ChannelType::Bits16: return readAt<quint16>(column, row);
+    case ChannelType::Bits32: return readAt<quint32>(column, row);
+    }
+    return 0.0;
+}
+
+quint32 RecordTable::bits(int row, int channel) const
+{
+    const QByteArray &column = m_columns.at(channel);
+    switch (m_channels.at(channel).type) {
+    case ChannelType::Bits16: return readAt<quint16>(column, row);
+    case ChannelType::Bits32: return readAt<quint32>(column, row);
+    case ChannelType::Int16: return static_cast<quint16>(readAt<qint16>(column, row));
+    case ChannelType::Int32: return static_cast<quint32>(readAt<qint32>(column, row));
+    default: return static_cast<quint32>(value(row, channel));
+    }
+}
+
+QString RecordTable::format(int row, int channel) const
+{
+    QByteArray text;
+    appendFormatted(text, row, channel);
+    return QString::fromLatin1(text);
+}
+
+void RecordTable::appendFormatted(QByteArray &line, int row, int channel) const
+{
+    const RecordChannel &spec = m_channels.at(channel);
+    switch (spec.type) {
+    case ChannelType::Bits16:
+        line += "0x" + QByteArray::number(bits(row, channel), 16).toUpper().rightJustified(4, '0');
+        break;
+    case ChannelType::Bits32:
+        line += "0x" + QByteArray::number(bits(row, channel), 16).toUpper().rightJustified(8, '0');
+        break;
+    default:
+        line += QByteArray::number(value(row, channel), 'f', spec.decimals);
+        break;
+    }
+}
+
+QByteArray RecordTable::csvHeader() const
+{
+    QByteArray line = QStringLiteral("时间").toUtf8();
+    for (const RecordChannel &channel : m_channels) {
+        line += ',';
+        line += channel.label().toUtf8();
+    }
+    line += '\n';
+    return line;
+}
+
+QByteArray RecordTable::csvRow(int row) const
+{
+    QByteArray line;
+    line.reserve(28 + m_channels.size() * 12);
+    line += '\'';
+    SampleClock::appendLocalTime(line, m_timeNs.at(row));
+    for (int c = 0; c < m_channels.size(); ++c) {
+        line += ',';
+        appendFormatted(line, row, c);
+    }
+    line += '\n';
+    return line;
+}
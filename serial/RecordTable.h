@@ -0,0 +1,139 @@
+#ifndef RECORDTABLE_H
+#define RECORDTABLE_H
+
+#include <QString>
+#include <QByteArray>
+#include <QVector>
+#include <QVariantMap>
+
+/**
+ * @brief 通道存储类型
+ */
+enum class ChannelType : quint8 {
+    Int16,      ///< 16位整数原始值，显示值 = 原始值 * scale
+    Int32,      ///< 32位整数原始值，显示值 = 原始值 * scale
+    Float32,
+    Float64,
+    Bits16,     ///< 16位状态字
+    Bits32      ///< 32位状态字
+};
+
+/**
+ * @brief 通道定义
+ */
+struct RecordChannel {
+    QString name;
+    QString unit;
+    ChannelType type = ChannelType::Float32;
+    double scale = 1.0;         ///< 仅整数类型使用
+    int decimals = 2;           ///< 显示与导出的小数位数
+
+    /**
+     * @brief 单个值占用的字节数
+     */
+    int width() const;
+
+    /**
+     * @brief 表头文本，如"电压(V)"
+     */
+    QString label() const;
+
+    QVariantMap toMap() const;
+
+    /**
+     * @brief 从QML传入的映射解析
+     * @param map 包含name、unit、type（int16/int32/float32/float64/bits16/bits32）、scale、decimals
+     * @param ok 类型名无法识别或name为空时置为false
+     */
+    static RecordChannel fromMap(const QVariantMap &map, bool *ok = nullptr);
+};
+
+/**
+ * @brief 按列存储的记录表
+ * @details 每个通道一块连续内存，按声明的类型宽度存放，时间戳单独一列（UTC纳秒，SampleClock），
+ *          导出与显示时才换算为本地时间。
+ *          每行内存为8字节时间戳加各通道宽度之和，与最宽的类型无关。
+ *          追加一行只做逐列的定长拷贝，不经过QVariant
+ */
+class RecordTable
+{
+public:
+    RecordTable();
+    explicit RecordTable(const QVector<RecordChannel> &channels);
+
+    /**
+     * @brief 电压(V)/电流(A)/功率(kW)三通道float32，与原固定格式一致
+     */
+    static QVector<RecordChannel> defaultChannels();
+
+    const QVector<RecordChannel> &channels() const { return m_channels; }
+    int channelCount() const { return m_channels.size(); }
+    int rowCount() const { return m_timeNs.size(); }
+    bool isEmpty() const { return m_timeNs.isEmpty(); }
+
+    /**
+     * @brief 每行占用的字节数
+     */
+    int bytesPerRow() const;
+
+    /**
+     * @brief packed行（各通道按声明顺序紧密排列、无填充）的字节数
+     */
+    int packedRowSize() const { return m_packedRowSize; }
+
+    /**
+     * @brief 追加一行
+     * @param timeNs UTC纳秒
+     * @param values 各通道的显示值，不足channelCount的通道记为0
+     * @details 整数通道按scale换算为原始值并截断到类型范围
+     */
+    void append(qint64 timeNs, const double *values, int count);
+
+    /**
+     * @brief 追加一行已编码的数据
+     * @param row packedRowSize()字节，各通道按声明顺序紧密排列
+     */
+    void appendPacked(qint64 timeNs, const void *row);
+
+    void reserve(int rows);
+    void clear();
+
+    qint64 timeNs(int row) const { return m_timeNs.at(row); }
+    qint64 timeMs(int row) const { return m_timeNs.at(row) / 1000000; }
+
+    /**
+     * @brief 显示值（整数通道已乘scale，状态字按无符号整数）
+     */
+    double value(int row, int channel) const;
+
+    /**
+     * @brief 状态字通道的原始位
+     */
+    quint32 bits(int row, int channel) const;
+
+    /**
+     * @brief 格式化单元格，状态字显示为十六进制
+     */
+    QString format(int row, int channel) const;
+
+    /**
+     * @brief CSV表头行（含换行）
+     */
+    QByteArray csvHeader() const;
+
+    /**
+     * @brief CSV数据行（含换行），时间精确到毫秒，前加单引号防止Excel转换格式
+     */
+    QByteArray csvRow(int row) const;
+
+private:
+    void appendFormatted(QByteArray &line, int row, int channel) const;
+
+    QVector<RecordChannel> m_channels;
+    QVector<int> m_widths;
+    int m_packedRowSize;
+    QVector<qint64> m_timeNs;
+    QVector<QByteArray> m_columns;
+};
+
+#endif
@@ -0,0 +1,456 @@
+#include "RecordTableModel.h"
+#include "../core/SampleClock.h"
+#include <algorithm>
+
+RecordTableModel::RecordTableModel(QObject *parent)
+    : QAbstractTableModel(parent)
+    , m_checkedTotal(0)
+    , m_sortColumn(-1)
+    , m_sortDescending(false)
+    , m_filterColumn(-1)
+    , m_filterMin(0.0)
+    , m_filterMax(0.0)
+    , m_rowMapDirty(true)
+{
+}
+
+void RecordTableModel::setRecorder(DataRecorder *recorder)
+{
+    if (m_recorder == recorder) {
+        return;
+    }
+
+    beginResetModel();
+    if (m_recorder) {
+        disconnect(m_recorder, nullptr, this, nullptr);
+    }
+    m_recorder = recorder;
+    if (m_recorder) {
+        connect(m_recorder, &DataRecorder::recordAdded, this, &RecordTableModel::onRecordAppended);
+        connect(m_recorder, &DataRecorder::recordsCleared, this, &RecordTableModel::onRecordsCleared);
+        connect(m_recorder, &DataRecorder::channelsChanged, this, &RecordTableModel::onChannelsChanged);
+    }
+    m_checked = QBitArray(sourceCount());
+    m_checkedTotal = 0;
+    m_rowMapDirty = true;
+    endResetModel();
+
+    emit recorderChanged();
+    emit headersChanged();
+    emit checkedCountChanged();
+}
+
+int RecordTableModel::checkedCount() const
+{
+    if (m_filterColumn < 0) {
+        return m_checkedTotal;
+    }
+
+    // 筛选时只统计可见行
+    ensureRowMap();
+    int count = 0;
+    for (int source : std::as_const(m_rowMap)) {
+        if (m_checked.testBit(source)) {
+            ++count;
+        }
+    }
+    return count;
+}
+
+QString RecordTableModel::headerCheckState() const
+{
+    const int total = rowCount();
+    const int checked = checkedCount();
+    if (total == 0 || checked == 0) {
+        return QStringLiteral("none");
+    }
+    return checked == total ? QStringLiteral("all") : QStringLiteral("partial");
+}
+
+int RecordTableModel::rowCount(const QModelIndex &parent) const
+{
+    if (parent.isValid()) {
+        return 0;
+    }
+    if (!mapped()) {
+        return sourceCount();
+    }
+    ensureRowMap();
+    return m_rowMap.size();
+}
+
+int RecordTableModel::columnCount(const QModelIndex &parent) const
+{
+    if (parent.isValid()) {
+        return 0;
+    }
+    return 1 + (m_recorder ? m_recorder->table().channelCount() : RecordTable::defaultChannels().size());
+}
+
+/**
+ * @brief 获取单元格数据
+ * @details 仅在视图请求可见单元格时格式化，格式与导出报表一致
+ */
+QVariant RecordTableModel::data(const QModelIndex &index, int role) const
+{
+    if (!index.isValid()) {
+        return QVariant();
+    }
+
+    const int source = mapRow(index.row());
+    if (source < 0) {
+        return QVariant();
+    }
+    const RecordTable &table = m_recorder->table();
+    const int column = index.column();
+    if (column > table.channelCount()) {
+        return QVariant();
+    }
+
+    switch (role) {
+    case Qt::DisplayRole:
+        if (column == TimeColumn) {
+            return SampleClock::formatLocal(table.timeNs(source));
+        }
+        return table.format(source, column - 1);
+    case ValueRole:
+        return columnValue(source, column);
+    case CheckedRole:
+        return m_checked.testBit(source);
+    case SourceRowRole:
+        return source;
+    default:
+        return QVariant();
+    }
+}
+
+bool RecordTableModel::setData(const QModelIndex &index, const QVariant &value, int role)
+{
+    if (role != CheckedRole || !index.isValid()) {
+        return false;
+    }
+
+    const int source = mapRow(index.row());
+    if (source < 0 || m_checked.testBit(source) == value.toBool()) {
+        return false;
+    }
+
+    setCheckedBit(source, value.toBool());
+    emit dataChanged(this->index(index.row(), 0), this->index(index.row(), columnCount() - 1), {CheckedRole});
+    emit checkedCountChanged();
+    return true;
+}
+
+QVariant RecordTableModel::headerData(int section, Qt::Orientation orientation, int role) const
+{
+    if (role != Qt::DisplayRole) {
+        return QVariant();
+    }
+    if (orientation == Qt::Vertical) {
+        return section + 1;
+    }
+
+    if (section == TimeColumn) {
+        return QStringLiteral("时间");
+    }
+    const QVector<RecordChannel> channels = m_recorder ? m_recorder->table().channels() : RecordTable::defaultChannels();
+    if (section < 1 || section > channels.size()) {
+        return QVariant();
+    }
+    return channels.at(section - 1).label();
+}
+
+QVariantList RecordTableModel::headers() const
+{
+    QVariantList list;
+    list.append(QVariantMap{ { "label", QStringLiteral("时间") }, { "sample", "0000-00-00 00:00:00" } });
+    const QVector<RecordChannel> channels = m_recorder ? m_recorder->table().channels() : RecordTable::defaultChannels();
+    for (const RecordChannel &channel : channels) {
+        QString sample;
+        switch (channel.type) {
+        case ChannelType::Bits16: sample = "0x0000"; break;
+        case ChannelType::Bits32: sample = "0x00000000"; break;
+        default:
+            sample = "0000";
+            if (channel.decimals > 0) {
+                sample += '.' + QString(channel.decimals, '0');
+            }
+            break;
+        }
+        list.append(QVariantMap{ { "label", channel.label() }, { "sample", sample } });
+    }
+    return list;
+}
+
+QHash<int, QByteArray> RecordTableModel::roleNames() const
+{
+    return {
+        {Qt::DisplayRole, "display"},
+        {ValueRole, "value"},
+        {CheckedRole, "checked"},
+        {SourceRowRole, "sourceRow"}
+    };
+}
+
+void RecordTableModel::sortByColumn(int column, bool descending)
+{
+    if (column >= columnCount()) {
+        return;
+    }
+    if (column < 0) {
+        column = -1;
+    }
+    if (m_sortColumn == column && m_sortDescending == descending) {
+        return;
+    }
+
+    m_sortColumn = column;
+    m_sortDescending = descending;
+    rebuild();
+    emit sortChanged();
+}
+
+void RecordTableModel::setRangeFilter(int column, double minimum, double maximum)
+{
+    if (column < 0 || column >= columnCount()) {
+        return;
+    }
+
+    m_filterColumn = column;
+    m_filterMin = qMin(minimum, maximum);
+    m_filterMax = qMax(minimum, maximum);
+    rebuild();
+    emit filterChanged();
+    emit checkedCountChanged();
+}
+
+void RecordTableModel::clearFilter()
+{
+    if (m_filterColumn < 0) {
+        return;
+    }
+
+    m_filterColumn = -1;
+    rebuild();
+    emit filterChanged();
+    emit checkedCountChanged();
+}
+
+void RecordTableModel::toggleChecked(int row)
+{
+    const int source = mapRow(row);
+    if (source < 0) {
+        return;
+    }
+    setData(index(row, 0), !m_checked.testBit(source), CheckedRole);
+}
+
+/**
+ * @brief 设置全部可见行的勾选状态
+ * @details 未筛选时直接整体填充位图
+ */
+void RecordTableModel::setAllChecked(bool checked)
+{
+    const int rows = rowCount();
+    if (rows == 0) {
+        return;
+    }
+
+    if (m_filterColumn < 0) {
+        m_checked.fill(checked);
+        m_checkedTotal = checked ? m_checked.size() : 0;
+    } else {
+        for (int source : std::as_const(m_rowMap)) {
+            setCheckedBit(source, checked);
+        }
+    }
+
+    emit dataChanged(index(0, 0), index(rows - 1, columnCount() - 1), {CheckedRole});
+    emit checkedCountChanged();
+}
+
+int RecordTableModel::sourceRow(int row) const
+{
+    return mapRow(row);
+}
+
+QList<int> RecordTableModel::checkedSourceRows() const
+{
+    QList<int> rows;
+    rows.reserve(m_checkedTotal);
+    for (int i = 0; i < m_checked.size(); ++i) {
+        if (m_checked.testBit(i)) {
+            rows.append(i);
+        }
+    }
+    return rows;
+}
+
+/**
+ * @brief 新记录追加槽函数
+ * @details 无排序筛选时按行插入；有排序筛选时把通过筛选的新记录二分插入到映射中的排序位置，
+ *          视图的选择与滚动位置不受影响。映射尚未生成（重置后视图还未访问）时仍整体重建
+ */
+void RecordTableModel::onRecordAppended()
+{
+    const int count = sourceCount();
+    const int first = m_checked.size();
+    if (count <= first) {
+        return;
+    }
+
+    if (!mapped()) {
+        beginInsertRows(QModelIndex(), first, count - 1);
+        m_checked.resize(count);
+        endInsertRows();
+    } else if (m_rowMapDirty) {
+        m_checked.resize(count);
+        rebuild();
+    } else {
+        m_checked.resize(count);
+        for (int source = first; source < count; ++source) {
+            if (!acceptsRow(source)) {
+                continue;
+            }
+            const int row = insertPosition(source);
+            beginInsertRows(QModelIndex(), row, row);
+            m_rowMap.insert(row, source);
+            endInsertRows();
+        }
+    }
+    emit checkedCountChanged();
+}
+
+/**
+ * @brief 新记录在映射中的位置
+ * @details 取相等值之后的位置，与stable_sort按记录顺序排列相等值的结果一致
+ */
+int RecordTableModel::insertPosition(int source) const
+{
+    if (m_sortColumn < 0) {
+        return m_rowMap.size();
+    }
+    const int column = m_sortColumn;
+    const bool descending = m_sortDescending;
+    const double value = columnValue(source, column);
+    const auto it = std::upper_bound(m_rowMap.cbegin(), m_rowMap.cend(), value,
+                                     [this, column, descending](double v, int row) {
+        const double other = columnValue(row, column);
+        return descending ? v > other : v < other;
+    });
+    return static_cast<int>(it - m_rowMap.cbegin());
+}
+
+void RecordTableModel::onRecordsCleared()
+{
+    beginResetModel();
+    m_checked.clear();
+    m_checkedTotal = 0;
+    m_rowMap.clear();
+    m_rowMapDirty = true;
+    endResetModel();
+    emit checkedCountChanged();
+}
+
+void RecordTableModel::onChannelsChanged()
+{
+    // 通道变化时记录器已清空数据，列数随之变化
+    beginResetModel();
+    m_sortColumn = -1;
+    m_filterColumn = -1;
+    m_checked.clear();
+    m_checkedTotal = 0;
+    m_rowMap.clear();
+    m_rowMapDirty = true;
+    endResetModel();
+    emit headersChanged();
+    emit sortChanged();
+    emit filterChanged();
+    emit checkedCountChanged();
+}
+
+int RecordTableModel::sourceCount() const
+{
+    return m_recorder ? m_recorder->table().rowCount() : 0;
+}
+
+int RecordTableModel::mapRow(int row) const
+{
+    if (row < 0) {
+        return -1;
+    }
+    if (!mapped()) {
+        return row < sourceCount() ? row : -1;
+    }
+    ensureRowMap();
+    return row < m_rowMap.size() ? m_rowMap.at(row) : -1;
+}
+
+/**
+ * @brief 按需生成行索引映射
+ * @details 只有在排序/筛选条件变化或有新记录后首次访问时才重新计算
+ */
+void RecordTableModel::ensureRowMap() const
+{
+    if (!m_rowMapDirty) {
+        return;
+    }
+    m_rowMapDirty = false;
+    m_rowMap.clear();
+    if (!mapped()) {
+        m_rowMap.squeeze();
+        return;
+    }
+
+    const int count = sourceCount();
+    m_rowMap.reserve(count);
+    for (int i = 0; i < count; ++i) {
+        if (acceptsRow(i)) {
+            m_rowMap.append(i);
+        }
+    }
+
+    if (m_sortColumn >= 0) {
+        const int column = m_sortColumn;
+        const bool descending = m_sortDescending;
+        std::stable_sort(m_rowMap.begin(), m_rowMap.end(), [this, column, descending](int a, int b) {
+            const double va = columnValue(a, column);
+            const double vb = columnValue(b, column);
+            return descending ? va > vb : va < vb;
+        });
+    }
+}
+
+bool RecordTableModel::acceptsRow(int source) const
+{
+    if (m_filterColumn < 0) {
+        return true;
+    }
+    const double value = columnValue(source, m_filterColumn);
+    return value >= m_filterMin && value <= m_filterMax;
+}
+
+double RecordTableModel::columnValue(int source, int column) const
+{
+    const RecordTable &table = m_recorder->table();
+    if (column == TimeColumn) {
+        return static_cast<double>(table.timeMs(source));
+    }
+    return column <= table.channelCount() ? table.value(source, column - 1) : 0.0;
+}
+
+void RecordTableModel::setCheckedBit(int sourceRow, bool checked)
+{
+    if (m_checked.testBit(sourceRow) == checked) {
+        return;
+    }
+    m_checked.setBit(sourceRow, checked);
+    m_checkedTotal += checked ? 1 : -1;
+}
+
+void RecordTableModel::rebuild()
+{
+    beginResetModel();
+    m_rowMapDirty = true;
+    endResetModel();
+}
@@ -0,0 +1,186 @@
+#ifndef RECORDTABLEMODEL_H
+#define RECORDTABLEMODEL_H
+
+#include <QAbstractTableModel>
+#include <QBitArray>
+#include <QVector>
+#include <QPointer>
+#include "DataRecorder.h"
+
+/**
+ * @brief 记录数据表格模型
+ * @details 直接以DataRecorder的按列记录表为数据源，不复制行数据；列随记录器的通道定义变化。
+ *          文本在请求可见单元格时才格式化；勾选状态按源行存为位图；
+ *          排序和筛选只在需要时生成行索引映射
+ */
+class RecordTableModel : public QAbstractTableModel
+{
+    Q_OBJECT
+    /**
+     * @brief 数据源记录器
+     */
+    Q_PROPERTY(DataRecorder *recorder READ recorder WRITE setRecorder NOTIFY recorderChanged)
+
+    /**
+     * @brief 已勾选行数（仅统计当前可见行）
+     */
+    Q_PROPERTY(int checkedCount READ checkedCount NOTIFY checkedCountChanged)
+
+    /**
+     * @brief 表头全选状态："none" / "partial" / "all"
+     */
+    Q_PROPERTY(QString headerCheckState READ headerCheckState NOTIFY checkedCountChanged)
+
+    /**
+     * @brief 当前排序列，-1表示按记录顺序
+     */
+    Q_PROPERTY(int sortColumn READ sortColumn NOTIFY sortChanged)
+
+    /**
+     * @brief 当前是否降序
+     */
+    Q_PROPERTY(bool sortDescending READ sortDescending NOTIFY sortChanged)
+
+    /**
+     * @brief 是否启用了范围筛选
+     */
+    Q_PROPERTY(bool filterActive READ filterActive NOTIFY filterChanged)
+
+    /**
+     * @brief 表头定义，可直接用于EDataTableView.headers
+     * @details 每项包含label与用于估算列宽的sample
+     */
+    Q_PROPERTY(QVariantList headers READ headers NOTIFY headersChanged)
+
+public:
+    /**
+     * @brief 列定义
+     * @details 第0列为时间，其后依次为记录器的各通道；以下为默认三通道时的列号
+     */
+    enum Column {
+        TimeColumn,
+        VoltageColumn,
+        CurrentColumn,
+        PowerColumn
+    };
+    Q_ENUM(Column)
+
+    /**
+     * @brief 自定义角色
+     */
+    enum Roles {
+        ValueRole = Qt::UserRole + 1,   ///< 原始数值（时间列为毫秒时间戳）
+        CheckedRole,                    ///< 勾选状态
+        SourceRowRole                   ///< 对应的记录序号
+    };
+
+    explicit RecordTableModel(QObject *parent = nullptr);
+
+    DataRecorder *recorder() const { return m_recorder; }
+    void setRecorder(DataRecorder *recorder);
+
+    int checkedCount() const;
+    QString headerCheckState() const;
+    int sortColumn() const { return m_sortColumn; }
+    bool sortDescending() const { return m_sortDescending; }
+    bool filterActive() const { return m_filterColumn >= 0; }
+    QVariantList headers() const;
+
+    int rowCount(const QModelIndex &parent = QModelIndex()) const override;
+    int columnCount(const QModelIndex &parent = QModelIndex()) const override;
+    QVariant data(const QModelIndex &index, int role = Qt::DisplayRole) const override;
+    bool setData(const QModelIndex &index, const QVariant &value, int role = Qt::EditRole) override;
+    QVariant headerData(int section, Qt::Orientation orientation, int role = Qt::DisplayRole) const override;
+    QHash<int, QByteArray> roleNames() const override;
+
+    /**
+     * @brief 按列排序
+     * @param column 列号，-1恢复记录顺序
+     * @param descending 是否降序
+     */
+    Q_INVOKABLE void sortByColumn(int column, bool descending = false);
+
+    /**
+     * @brief 设置范围筛选
+     * @param column 列号
+     * @param minimum 下限（含）
+     * @param maximum 上限（含）
+     */
+    Q_INVOKABLE void setRangeFilter(int column, double minimum, double maximum);
+
+    /**
+     * @brief 清除筛选
+     */
+    Q_INVOKABLE void clearFilter();
+
+    /**
+     * @brief 切换某一可见行的勾选状态
+     * @param row 可见行号
+     */
+    Q_INVOKABLE void toggleChecked(int row);
+
+    /**
+     * @brief 设置全部可见行的勾选状态
+     * @param checked 勾选状态
+     */
+    Q_INVOKABLE void setAllChecked(bool checked);
+
+    /**
+     * @brief 获取某一可见行对应的记录序号
+     * @param row 可见行号
+     * @return 记录序号，越界返回-1
+     */
+    Q_INVOKABLE int sourceRow(int row) const;
+
+    /**
+     * @brief 获取已勾选的记录序号
+     * @return 记录序号列表（按记录顺序）
+     */
+    Q_INVOKABLE QList<int> checkedSourceRows() const;
+
+signals:
+    void recorderChanged();
+    void checkedCountChanged();
+    void sortChanged();
+    void filterChanged();
+    void headersChanged();
+
+private slots:
+    void onRecordAppended();
+    void onRecordsCleared();
+    void onChannelsChanged();
+
+private:
+    QPointer<DataRecorder> m_recorder;
+
+    /**
+     * @brief 勾选位图（按记录序号索引，每行1位）
+     */
+    QBitArray m_checked;
+    int m_checkedTotal;
+
+    int m_sortColumn;
+    bool m_sortDescending;
+    int m_filterColumn;
+    double m_filterMin;
+    double m_filterMax;
+
+    /**
+     * @brief 可见行到记录序号的映射
+     * @details 未排序且未筛选时为空，直接使用记录序号
+     */
+    mutable QVector<int> m_rowMap;
+    mutable bool m_rowMapDirty;
+
+    bool mapped() const { return m_sortColumn >= 0 || m_filterColumn >= 0; }
+    int sourceCount() const;
+    int mapRow(int row) const;
+    void ensureRowMap() const;
+    int insertPosition(int source) const;
+    bool acceptsRow(int source) const;
+    double columnValue(int source, int column) const;
+    void setCheckedBit(int sourceRow, bool checked);
+    void rebuild();
+};
+
+#endif
@@ -0,0 +1,33 @@
+#include "SerialPortEnumerator.h"
+#include <QSerialPortInfo>
+#include <QVariantMap>
+
+SerialPortEnumerator::SerialPortEnumerator(QObject *parent)
+    : QObject(parent)
+{
+}
+
+/**
+ * @brief 枚举系统串口
+ *
+ * 逐个读取端口的描述、厂商、序列号和VID/PID；
+ * 没有VID/PID的端口（如主板串口）对应字段为0
+ */
+void SerialPortEnumerator::enumerate()
+{
+    QVariantList list;
+    const auto ports = QSerialPortInfo::availablePorts();
+    list.reserve(ports.size());
+    for (const QSerialPortInfo &port : ports) {
+        QVariantMap info;
+        info["portName"] = port.portName();
+        info["description"] = port.description();
+        info["manufacturer"] = port.manufacturer();
+        info["serialNumber"] = port.serialNumber();
+        info["vendorId"] = port.hasVendorIdentifier() ? port.vendorIdentifier() : 0;
+        info["productId"] = port.hasProductIdentifier() ? port.productIdentifier() : 0;
+        info["systemLocation"] = port.systemLocation();
+        list.append(info);
+    }
+    emit portsEnumerated(list);
+}
@@ -0,0 +1,37 @@
+#ifndef SERIALPORTENUMERATOR_H
+#define SERIALPORTENUMERATOR_H
+
+#include <QObject>
+#include <QVariantList>
+
+/**
+ * @brief 串口枚举工作对象
+ *
+ * 运行在后台线程中调用QSerialPortInfo::availablePorts()，
+ * 避免USB转串口适配器较多时阻塞界面线程
+ */
+class SerialPortEnumerator : public QObject
+{
+    Q_OBJECT
+
+public:
+    explicit SerialPortEnumerator(QObject *parent = nullptr);
+
+public slots:
+    /**
+     * @brief 枚举系统串口
+     *
+     * 完成后发送portsEnumerated信号
+     */
+    void enumerate();
+
+signals:
+    /**
+     * @brief 枚举完成信号
+     * @param ports 每个串口一个QVariantMap：portName、description、manufacturer、
+     *              serialNumber、vendorId、productId、systemLocation
+     */
+    void portsEnumerated(const QVariantList &ports);
+};
+
+#endif
@@ -1,33 +1,176 @@
 #include "SerialPortManager.h"
-#include <QDebug>
+#include "SerialPortEnumerator.h"
+#include "SerialPortWorker.h"
+#include "../core/Logger.h"
+#include <QSerialPort>
+#include <QDir>
+#include <QThread>
+#include <QTimer>
+#include <QFileSystemWatcher>
+#include <QCoreApplication>
+#include <QAbstractNativeEventFilter>
+#include <QMetaMethod>
+#include <functional>
+#ifdef Q_OS_WIN
+#include <qt_windows.h>
+#endif
+
+namespace {
+
+/**
+ * @brief readData()缓冲区上限，超出时丢弃最早的数据
+ */
+constexpr int MaxReadBuffer = 1024 * 1024;
+
+/**
+ * @brief 解析十六进制字符串
+ * @param text 如"01 03 00 00"，允许空白分隔
+ * @param out 解析结果
+ * @return 含非十六进制字符或位数为奇数时返回false
+ */
+bool parseHex(const QString &text, QByteArray &out)
+{
+    QByteArray digits;
+    digits.reserve(text.size());
+    for (const QChar ch : text) {
+        if (ch.isSpace()) {
+            continue;
+        }
+        const char16_t c = ch.unicode();
+        if (!((c >= '0' && c <= '9') || (c >= 'a' && c <= 'f') || (c >= 'A' && c <= 'F'))) {
+            return false;
+        }
+        digits.append(static_cast<char>(ch.unicode()));
+    }
+    if (digits.size() % 2 != 0) {
+        return false;
+    }
+    out = QByteArray::fromHex(digits);
+    return true;
+}
+
+/**
+ * @brief 设备变化消息过滤器
+ *
+ * Windows下USB串口插拔会向顶层窗口广播WM_DEVICECHANGE，收到后触发重新枚举
+ */
+class DeviceChangeFilter : public QAbstractNativeEventFilter
+{
+public:
+    explicit DeviceChangeFilter(std::function<void()> callback)
+        : m_callback(std::move(callback))
+    {
+    }
+
+    bool nativeEventFilter(const QByteArray &eventType, void *message, qintptr *result) override
+    {
+        Q_UNUSED(result);
+#ifdef Q_OS_WIN
+        if (eventType == "windows_generic_MSG" && static_cast<MSG *>(message)->message == WM_DEVICECHANGE) {
+            m_callback();
+        }
+#else
+        Q_UNUSED(eventType);
+        Q_UNUSED(message);
+#endif
+        return false;
+    }
+
+private:
+    std::function<void()> m_callback;
+};
+
+} // namespace
 
 /**
  * @brief 构造函数
  * @param parent 父对象指针
  *
- * 初始化串口管理器，设置默认参数，并连接信号槽
+ * 初始化串口管理器，设置默认参数，并连接信号槽；
+ * 串口枚举在后台线程中进行，结果通过availablePortsChanged信号异步通知；
+ * 串口本身由独立的串口线程中的SerialPortWorker读写，定时发送不受界面线程负载影响
  */
 SerialPortManager::SerialPortManager(QObject *parent)
     : QObject(parent)
-    , m_serialPort(new QSerialPort(this))
+    , m_ioThread(new QThread(this))
+    , m_worker(new SerialPortWorker)
     , m_isConnected(false)
+    , m_baudRate(9600)
+    , m_terminal(new SerialTerminalModel(this))
+    , m_sending(false)
+    , m_enumThread(new QThread(this))
+    , m_enumerator(new SerialPortEnumerator)
+    , m_rescanTimer(new QTimer(this))
+    , m_deviceWatcher(nullptr)
+    , m_deviceFilter(nullptr)
+    , m_enumerating(false)
+    , m_rescanPending(false)
+    , m_forceNotify(false)
+    , m_autoReconnect(true)
+    , m_reconnectBaudRate(9600)
 {
-    updateAvailablePorts();
+    // 串口工作对象移入串口线程
+    m_ioThread->setObjectName(QStringLiteral("SerialPortIO"));
+    m_worker->moveToThread(m_ioThread);
+    connect(m_ioThread, &QThread::finished, m_worker, &QObject::deleteLater);
+    connect(m_worker, &SerialPortWorker::dataRead, this, &SerialPortManager::onDataRead);
+    connect(m_worker, &SerialPortWorker::dataSent, this, &SerialPortManager::onDataSent);
+    connect(m_worker, &SerialPortWorker::portError, this, &SerialPortManager::onPortError);
+    connect(m_worker, &SerialPortWorker::scheduleFinished, this, &SerialPortManager::onScheduleFinished);
+    m_ioThread->start();
+
+    // 枚举工作对象移入后台线程
+    m_enumThread->setObjectName(QStringLiteral("SerialPortEnumerator"));
+    m_enumerator->moveToThread(m_enumThread);
+    connect(m_enumThread, &QThread::finished, m_enumerator, &QObject::deleteLater);
+    connect(m_enumerator, &SerialPortEnumerator::portsEnumerated, this, &SerialPortManager::onPortsEnumerated);
+    m_enumThread->start();
+
+    // 插拔时设备节点会连续变化，合并为一次枚举
+    m_rescanTimer->setSingleShot(true);
+    m_rescanTimer->setInterval(250);
+    connect(m_rescanTimer, &QTimer::timeout, this, &SerialPortManager::updateAvailablePorts);
+
+#if defined(Q_OS_UNIX)
+    // udev创建/删除设备节点时/dev目录发生变化，无需轮询
+    m_deviceWatcher = new QFileSystemWatcher(this);
+    const QStringList watchDirs = {QStringLiteral("/dev"), QStringLiteral("/dev/serial"), QStringLiteral("/dev/serial/by-id")};
+    for (const QString &dir : watchDirs) {
+        if (QDir(dir).exists()) {
+            m_deviceWatcher->addPath(dir);
+        }
+    }
+    connect(m_deviceWatcher, &QFileSystemWatcher::directoryChanged, this, &SerialPortManager::scheduleRescan);
+#endif
+    if (QCoreApplication::instance()) {
+        m_deviceFilter = new DeviceChangeFilter([this]() { scheduleRescan(); });
+        QCoreApplication::instance()->installNativeEventFilter(m_deviceFilter);
+    }
 
-    connect(m_serialPort, &QSerialPort::readyRead, this, &SerialPortManager::onReadyRead);
-    connect(m_serialPort, &QSerialPort::errorOccurred, this, &SerialPortManager::onErrorOccurred);
+    updateAvailablePorts();
 }
 
 /**
  * @brief 析构函数
  *
- * 关闭已打开的串口连接
+ * 关闭已打开的串口连接，并等待枚举线程与串口线程退出
  */
 SerialPortManager::~SerialPortManager()
 {
-    if (m_serialPort->isOpen()) {
-        m_serialPort->close();
+    if (m_deviceFilter) {
+        if (QCoreApplication::instance()) {
+            QCoreApplication::instance()->removeNativeEventFilter(m_deviceFilter);
+        }
+        delete m_deviceFilter;
+    }
+    m_enumThread->quit();
+    m_enumThread->wait();
+
+    if (m_isConnected) {
+        closeWorkerPort();
     }
+    m_ioThread->quit();
+    m_ioThread->wait();
 }
 
 /**
@@ -39,6 +182,31 @@ QStringList SerialPortManager::availablePorts() const
     return m_availablePorts;
 }
 
+/**
+ * @brief 获取可用串口详细信息
+ * @return 与availablePorts顺序一致的列表，每项包含portName、description、manufacturer、
+ *         serialNumber、vendorId、productId、systemLocation
+ */
+QVariantList SerialPortManager::portDetails() const
+{
+    QVariantList list;
+    list.reserve(m_availablePorts.size());
+    for (const QString &name : m_availablePorts) {
+        list.append(m_portInfo.value(name));
+    }
+    return list;
+}
+
+/**
+ * @brief 获取指定串口的详细信息
+ * @param portName 串口名称
+ * @return 串口信息，不存在时为空
+ */
+QVariantMap SerialPortManager::portInfo(const QString &portName) const
+{
+    return m_portInfo.value(portName);
+}
+
 /**
  * @brief 获取串口连接状态
  * @return true表示已连接，false表示未连接
@@ -57,15 +225,40 @@ QString SerialPortManager::currentPort() const
     return m_currentPort;
 }
 
+/**
+ * @brief 获取自动重连开关
+ * @return true表示已知适配器重新插入时自动重新打开
+ */
+bool SerialPortManager::autoReconnect() const
+{
+    return m_autoReconnect;
+}
+
+/**
+ * @brief 设置自动重连开关
+ * @param enabled 是否启用
+ */
+void SerialPortManager::setAutoReconnect(bool enabled)
+{
+    if (m_autoReconnect == enabled) {
+        return;
+    }
+    m_autoReconnect = enabled;
+    if (!enabled) {
+        m_reconnectIdentity.clear();
+    }
+    emit autoReconnectChanged();
+}
+
 /**
  * @brief 刷新可用串口列表
  *
- * 更新可用串口列表并发送信号通知
+ * 在后台线程重新枚举，完成后发送信号通知；不阻塞调用方
  */
 void SerialPortManager::refreshPorts()
 {
+    m_forceNotify = true;
     updateAvailablePorts();
-    emit availablePortsChanged();
 }
 
 /**
@@ -74,29 +267,36 @@ void SerialPortManager::refreshPorts()
  * @param baudRate 波特率（默认9600）
  * @return true表示打开成功，false表示打开失败
  *
+ * 在串口线程中打开并等待结果；
  * 配置串口参数：8位数据位、无校验、1位停止位、无流控制
  */
 bool SerialPortManager::openPort(const QString &portName, int baudRate)
 {
-    if (m_serialPort->isOpen()) {
-        m_serialPort->close();
-    }
+    bool opened = false;
+    QString error;
+    QMetaObject::invokeMethod(m_worker, [&]() {
+        opened = m_worker->open(portName, baudRate, error);
+    }, Qt::BlockingQueuedConnection);
 
-    m_serialPort->setPortName(portName);
-    m_serialPort->setBaudRate(baudRate);
-    m_serialPort->setDataBits(QSerialPort::Data8);
-    m_serialPort->setParity(QSerialPort::NoParity);
-    m_serialPort->setStopBits(QSerialPort::OneStop);
-    m_serialPort->setFlowControl(QSerialPort::NoFlowControl);
-
-    if (m_serialPort->open(QIODevice::ReadWrite)) {
+    if (opened) {
+        const bool wasConnected = m_isConnected;
         m_isConnected = true;
         m_currentPort = portName;
-        emit isConnectedChanged();
+        m_baudRate = baudRate;
+        m_reconnectIdentity.clear();
+        if (!wasConnected) {
+            emit isConnectedChanged();
+        }
         emit currentPortChanged();
         return true;
     } else {
-        emit errorOccurred(m_serialPort->errorString());
+        if (m_isConnected) {
+            m_isConnected = false;
+            m_currentPort.clear();
+            emit isConnectedChanged();
+            emit currentPortChanged();
+        }
+        emit errorOccurred(error);
         return false;
     }
 }
@@ -108,8 +308,10 @@ bool SerialPortManager::openPort(const QString &portName, int baudRate)
  */
 void SerialPortManager::closePort()
 {
-    if (m_serialPort->isOpen()) {
-        m_serialPort->close();
+    // 主动关闭后不再自动重连
+    m_reconnectIdentity.clear();
+    if (m_isConnected) {
+        closeWorkerPort();
         m_isConnected = false;
         m_currentPort.clear();
         emit isConnectedChanged();
@@ -124,21 +326,50 @@ void SerialPortManager::closePort()
  */
 bool SerialPortManager::sendData(const QString &data)
 {
-    if (!m_serialPort->isOpen()) {
+    return sendBytes(data.toUtf8());
+}
+
+/**
+ * @brief 向串口发送二进制数据
+ * @param data 要发送的数据
+ * @return true表示已提交到发送队列，false表示串口未打开或队列已满
+ *
+ * 数据在串口线程中写出，同一轮事件循环内的多次提交合并为一次写入
+ */
+bool SerialPortManager::sendBytes(const QByteArray &data)
+{
+    if (!m_isConnected) {
         emit errorOccurred("串口未打开");
         return false;
     }
+    if (!m_worker->enqueue(data)) {
+        emit errorOccurred("发送队列已满");
+        return false;
+    }
+    m_terminal->append(data, SerialTerminalModel::Sent);
+    return true;
+}
 
-    QByteArray byteArray = data.toUtf8();
-    qint64 bytesWritten = m_serialPort->write(byteArray);
-    return bytesWritten != -1;
+/**
+ * @brief 发送十六进制字符串表示的数据
+ * @param hex 如"01 03 00 00 00 0A"，允许空白分隔
+ * @return true表示已提交到发送队列
+ */
+bool SerialPortManager::sendHex(const QString &hex)
+{
+    QByteArray data;
+    if (!parseHex(hex, data)) {
+        emit errorOccurred("无效的十六进制数据");
+        return false;
+    }
+    return sendBytes(data);
 }
 
 /**
  * @brief 读取串口接收缓冲区数据
  * @return 读取到的数据（UTF-8编码的字符串）
  *
- * 读取后清空缓冲区
+ * 读取后清空缓冲区；缓冲区最多保留最近1MB
  */
 QString SerialPortManager::readData()
 {
@@ -148,40 +379,322 @@ QString SerialPortManager::readData()
 }
 
 /**
- * @brief 串口数据可读时的槽函数
+ * @brief 开始周期发送
+ * @param hex 十六进制数据
+ * @param periodMs 发送周期（毫秒），可小于1
+ * @param count 发送次数，0表示一直发送
+ * @return true表示已开始
+ *
+ * 在串口线程中按计划时刻发送，计划时刻按周期累加，不随单次延迟漂移；
+ * 已有定时发送时替换为新的发送
+ */
+bool SerialPortManager::startPeriodicSend(const QString &hex, double periodMs, int count)
+{
+    if (periodMs <= 0) {
+        emit errorOccurred("发送周期必须大于0");
+        return false;
+    }
+    QVariantMap step;
+    step["hex"] = hex;
+    step["delayMs"] = periodMs;
+    return startSendSequence({step}, count);
+}
+
+/**
+ * @brief 开始按序列发送
+ * @param steps 发送步骤，每项包含hex或text，以及delayMs（距上一步的间隔，毫秒）
+ * @param repeat 循环次数，0表示一直发送
+ * @return true表示已开始
  *
- * 读取所有可用数据，追加到缓冲区，并发送数据接收信号
+ * 第一轮的第一步立即发送，之后每一步在上一步计划时刻之后delayMs发送；
+ * 落后计划超过50ms的步骤被跳过并计入统计中的missed
  */
-void SerialPortManager::onReadyRead()
+bool SerialPortManager::startSendSequence(const QVariantList &steps, int repeat)
 {
-    QByteArray data = m_serialPort->readAll();
+    if (!m_isConnected) {
+        emit errorOccurred("串口未打开");
+        return false;
+    }
+
+    QVector<SerialSendStep> sequence;
+    sequence.reserve(steps.size());
+    qint64 cycleNs = 0;
+    for (const QVariant &item : steps) {
+        const QVariantMap map = item.toMap();
+        SerialSendStep step;
+        if (map.contains("hex")) {
+            if (!parseHex(map.value("hex").toString(), step.data)) {
+                emit errorOccurred("无效的十六进制数据");
+                return false;
+            }
+        } else {
+            step.data = map.value("text").toString().toUtf8();
+        }
+        step.delayNs = qMax<qint64>(0, qRound64(map.value("delayMs").toDouble() * 1e6));
+        cycleNs += step.delayNs;
+        sequence.append(step);
+    }
+    if (sequence.isEmpty()) {
+        emit errorOccurred("发送序列为空");
+        return false;
+    }
+    if (repeat <= 0 && cycleNs <= 0) {
+        emit errorOccurred("循环发送的总间隔必须大于0");
+        return false;
+    }
+
+    QMetaObject::invokeMethod(m_worker, [worker = m_worker, sequence, repeat]() {
+        worker->startSchedule(sequence, repeat);
+    }, Qt::QueuedConnection);
+    setSending(true);
+    return true;
+}
+
+/**
+ * @brief 停止定时发送
+ */
+void SerialPortManager::stopSending()
+{
+    QMetaObject::invokeMethod(m_worker, &SerialPortWorker::stopSchedule, Qt::QueuedConnection);
+}
+
+/**
+ * @brief 获取发送统计
+ * @return bytesWritten（驱动已确认写出）、bytesQueued（排队中），
+ *         以及定时发送的running、sent、missed、bytes、requestedRate、achievedRate、
+ *         avgLatenessUs、maxLatenessUs
+ */
+QVariantMap SerialPortManager::sendStatistics() const
+{
+    QVariantMap stats = m_worker->scheduleStatistics();
+    stats["bytesWritten"] = m_worker->bytesWritten();
+    stats["bytesQueued"] = m_worker->bytesQueued();
+    return stats;
+}
+
+/**
+ * @brief 串口收到数据时的槽函数
+ * @param data 数据
+ * @param timestampMs 串口线程读取时刻
+ *
+ * 写入终端模型并追加到缓冲区；
+ * 只有连接了dataReceived时才转换为字符串，高速数据下避免逐块解码
+ */
+void SerialPortManager::onDataRead(const QByteArray &data, qint64 timestampMs)
+{
+    m_terminal->append(data, SerialTerminalModel::Received, timestampMs);
+
     m_readBuffer.append(data);
-    emit dataReceived(QString::fromUtf8(data));
+    if (m_readBuffer.size() > MaxReadBuffer) {
+        m_readBuffer.remove(0, m_readBuffer.size() - MaxReadBuffer);
+    }
+
+    static const QMetaMethod dataReceivedSignal = QMetaMethod::fromSignal(&SerialPortManager::dataReceived);
+    if (isSignalConnected(dataReceivedSignal)) {
+        emit dataReceived(QString::fromUtf8(data));
+    }
+}
+
+/**
+ * @brief 定时发送的数据写出后的槽函数
+ *
+ * 串口线程约每帧合并一次，写入终端模型
+ */
+void SerialPortManager::onDataSent(const QByteArray &data, qint64 timestampMs)
+{
+    m_terminal->append(data, SerialTerminalModel::Sent, timestampMs);
 }
 
 /**
  * @brief 串口错误发生时的槽函数
- * @param error 错误类型
+ * @param error 错误类型（QSerialPort::SerialPortError）
+ * @param message 错误信息
  *
  * 发送错误信息信号
  */
-void SerialPortManager::onErrorOccurred(QSerialPort::SerialPortError error)
+void SerialPortManager::onPortError(int error, const QString &message)
 {
-    if (error != QSerialPort::NoError) {
-        emit errorOccurred(m_serialPort->errorString());
+    emit errorOccurred(message);
+    // 适配器被拔出
+    if (error == QSerialPort::ResourceError && m_isConnected) {
+        handlePortLost();
+        scheduleRescan();
+    }
+}
+
+/**
+ * @brief 定时发送结束时的槽函数
+ *
+ * 停止后立即开始新的发送时，旧发送的结束信号晚于新发送到达，以工作对象的状态为准
+ */
+void SerialPortManager::onScheduleFinished()
+{
+    setSending(m_worker->scheduleRunning());
+}
+
+/**
+ * @brief 串口枚举完成时的槽函数
+ * @param ports 枚举结果
+ *
+ * 与上一次结果比较，逐个发送portAdded/portRemoved信号并增量更新列表；
+ * 已知适配器（按VID/PID/序列号识别）重新出现时自动重新打开
+ */
+void SerialPortManager::onPortsEnumerated(const QVariantList &ports)
+{
+    m_enumerating = false;
+
+    QHash<QString, QVariantMap> current;
+    QStringList order;
+    for (const QVariant &item : ports) {
+        const QVariantMap info = item.toMap();
+        const QString name = info.value("portName").toString();
+        current.insert(name, info);
+        order.append(name);
+    }
+
+    QStringList removed;
+    for (const QString &name : std::as_const(m_availablePorts)) {
+        if (!current.contains(name)) {
+            removed.append(name);
+        }
+    }
+    QStringList added;
+    for (const QString &name : std::as_const(order)) {
+        if (!m_portInfo.contains(name)) {
+            added.append(name);
+        }
+    }
+
+    bool detailsChanged = false;
+    for (auto it = current.cbegin(); it != current.cend(); ++it) {
+        if (m_portInfo.contains(it.key()) && m_portInfo.value(it.key()) != it.value()) {
+            detailsChanged = true;
+            break;
+        }
+    }
+
+    // 当前端口已从系统中消失（在更新端口信息前记下适配器身份）
+    if (m_isConnected && removed.contains(m_currentPort)) {
+        handlePortLost();
+    }
+
+    for (const QString &name : std::as_const(removed)) {
+        m_availablePorts.removeAll(name);
+    }
+    m_availablePorts.append(added);
+    m_portInfo = current;
+
+    for (const QString &name : std::as_const(removed)) {
+        emit portRemoved(name);
+    }
+    for (const QString &name : std::as_const(added)) {
+        emit portAdded(name);
+    }
+    if (!removed.isEmpty() || !added.isEmpty() || detailsChanged || m_forceNotify) {
+        emit availablePortsChanged();
+    }
+    m_forceNotify = false;
+
+    // 已知适配器重新插入，可能分配到不同的端口名
+    if (m_autoReconnect && !m_reconnectIdentity.isEmpty() && !m_isConnected) {
+        for (const QString &name : std::as_const(added)) {
+            if (portIdentity(m_portInfo.value(name)) == m_reconnectIdentity) {
+                const int baudRate = m_reconnectBaudRate;
+                if (openPort(name, baudRate)) {
+                    LOG_INFO(Log::Serial, "串口已自动重连: {}", name);
+                    emit reconnected(name);
+                }
+                break;
+            }
+        }
+    }
+
+    if (m_rescanPending) {
+        m_rescanPending = false;
+        updateAvailablePorts();
     }
 }
 
 /**
  * @brief 更新可用串口列表
  *
- * 遍历系统所有可用串口并存储到列表中
+ * 请求后台线程枚举系统串口；枚举进行中时记下请求，完成后再补做一次
  */
 void SerialPortManager::updateAvailablePorts()
 {
-    m_availablePorts.clear();
-    const auto ports = QSerialPortInfo::availablePorts();
-    for (const QSerialPortInfo &port : ports) {
-        m_availablePorts.append(port.portName());
+    if (m_enumerating) {
+        m_rescanPending = true;
+        return;
+    }
+    m_enumerating = true;
+    QMetaObject::invokeMethod(m_enumerator, &SerialPortEnumerator::enumerate, Qt::QueuedConnection);
+}
+
+/**
+ * @brief 设备变化后延迟重新枚举
+ */
+void SerialPortManager::scheduleRescan()
+{
+    m_rescanTimer->start();
+}
+
+/**
+ * @brief 处理当前串口丢失
+ *
+ * 关闭串口并记下适配器身份，等待其重新出现
+ */
+void SerialPortManager::handlePortLost()
+{
+    const QString identity = portIdentity(m_portInfo.value(m_currentPort));
+    const QString lostPort = m_currentPort;
+    closeWorkerPort();
+    m_isConnected = false;
+    m_currentPort.clear();
+    emit isConnectedChanged();
+    emit currentPortChanged();
+
+    if (m_autoReconnect) {
+        m_reconnectIdentity = identity.isEmpty() ? lostPort : identity;
+        m_reconnectBaudRate = m_baudRate;
+    }
+    LOG_WARNING(Log::Serial, "串口已断开: {}", lostPort);
+}
+
+/**
+ * @brief 在串口线程中关闭串口并等待完成
+ *
+ * 同时停止定时发送并丢弃未写出的数据
+ */
+void SerialPortManager::closeWorkerPort()
+{
+    QMetaObject::invokeMethod(m_worker, &SerialPortWorker::close, Qt::BlockingQueuedConnection);
+}
+
+/**
+ * @brief 更新定时发送状态
+ */
+void SerialPortManager::setSending(bool sending)
+{
+    if (m_sending == sending) {
+        return;
+    }
+    m_sending = sending;
+    emit sendingChanged();
+}
+
+/**
+ * @brief 生成适配器身份标识
+ * @param info 串口信息
+ * @return 有序列号时为VID:PID:序列号，否则为端口名
+ */
+QString SerialPortManager::portIdentity(const QVariantMap &info)
+{
+    const QString serial = info.value("serialNumber").toString();
+    if (serial.isEmpty()) {
+        return info.value("portName").toString();
     }
+    return QStringLiteral("%1:%2:%3")
+            .arg(info.value("vendorId").toInt(), 4, 16, QLatin1Char('0'))
+            .arg(info.value("productId").toInt(), 4, 16, QLatin1Char('0'))
+            .arg(serial);
 }
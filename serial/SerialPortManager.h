@@ -2,51 +2,114 @@
 #define SERIALPORTMANAGER_H
 
 #include <QObject>
-#include <QSerialPort>
 #include <QSerialPortInfo>
 #include <QStringList>
 #include <QVariantList>
+#include <QVariantMap>
+#include <QHash>
+#include "SerialTerminalModel.h"
+
+class QThread;
+class QTimer;
+class QFileSystemWatcher;
+class QAbstractNativeEventFilter;
+class SerialPortEnumerator;
+class SerialPortWorker;
 
 class SerialPortManager : public QObject
 {
     Q_OBJECT
     Q_PROPERTY(QStringList availablePorts READ availablePorts NOTIFY availablePortsChanged)
+    Q_PROPERTY(QVariantList portDetails READ portDetails NOTIFY availablePortsChanged)
     Q_PROPERTY(bool isConnected READ isConnected NOTIFY isConnectedChanged)
     Q_PROPERTY(QString currentPort READ currentPort NOTIFY currentPortChanged)
+    Q_PROPERTY(bool autoReconnect READ autoReconnect WRITE setAutoReconnect NOTIFY autoReconnectChanged)
+    /**
+     * @brief 终端模型，记录收发的原始数据
+     */
+    Q_PROPERTY(SerialTerminalModel *terminal READ terminal CONSTANT)
+    /**
+     * @brief 是否正在定时发送
+     */
+    Q_PROPERTY(bool sending READ sending NOTIFY sendingChanged)
 
 public:
     explicit SerialPortManager(QObject *parent = nullptr);
     ~SerialPortManager();
 
     QStringList availablePorts() const;
+    QVariantList portDetails() const;
     bool isConnected() const;
     QString currentPort() const;
+    bool autoReconnect() const;
+    void setAutoReconnect(bool enabled);
+    SerialTerminalModel *terminal() const { return m_terminal; }
+    bool sending() const { return m_sending; }
 
     Q_INVOKABLE void refreshPorts();
+    Q_INVOKABLE QVariantMap portInfo(const QString &portName) const;
     Q_INVOKABLE bool openPort(const QString &portName, int baudRate = 9600);
     Q_INVOKABLE void closePort();
     Q_INVOKABLE bool sendData(const QString &data);
+    Q_INVOKABLE bool sendBytes(const QByteArray &data);
+    Q_INVOKABLE bool sendHex(const QString &hex);
     Q_INVOKABLE QString readData();
 
+    Q_INVOKABLE bool startPeriodicSend(const QString &hex, double periodMs, int count = 0);
+    Q_INVOKABLE bool startSendSequence(const QVariantList &steps, int repeat = 1);
+    Q_INVOKABLE void stopSending();
+    Q_INVOKABLE QVariantMap sendStatistics() const;
+
 signals:
     void availablePortsChanged();
     void isConnectedChanged();
     void currentPortChanged();
+    void autoReconnectChanged();
+    void sendingChanged();
+    void portAdded(const QString &portName);
+    void portRemoved(const QString &portName);
+    void reconnected(const QString &portName);
     void dataReceived(const QString &data);
     void errorOccurred(const QString &error);
 
 private slots:
-    void onReadyRead();
-    void onErrorOccurred(QSerialPort::SerialPortError error);
+    void onDataRead(const QByteArray &data, qint64 timestampMs);
+    void onDataSent(const QByteArray &data, qint64 timestampMs);
+    void onPortError(int error, const QString &message);
+    void onScheduleFinished();
+    void onPortsEnumerated(const QVariantList &ports);
 
 private:
-    QSerialPort *m_serialPort;
+    QThread *m_ioThread;
+    SerialPortWorker *m_worker;
     QStringList m_availablePorts;
+    QHash<QString, QVariantMap> m_portInfo;
     bool m_isConnected;
     QString m_currentPort;
     QByteArray m_readBuffer;
+    int m_baudRate;
+    SerialTerminalModel *m_terminal;
+    bool m_sending;
+
+    QThread *m_enumThread;
+    SerialPortEnumerator *m_enumerator;
+    QTimer *m_rescanTimer;
+    QFileSystemWatcher *m_deviceWatcher;
+    QAbstractNativeEventFilter *m_deviceFilter;
+    bool m_enumerating;
+    bool m_rescanPending;
+    bool m_forceNotify;
+
+    bool m_autoReconnect;
+    QString m_reconnectIdentity;
+    int m_reconnectBaudRate;
 
     void updateAvailablePorts();
+    void scheduleRescan();
+    void handlePortLost();
+    void closeWorkerPort();
+    void setSending(bool sending);
+    static QString portIdentity(const QVariantMap &info);
 };
 
 #endif
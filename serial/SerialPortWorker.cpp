@@ -0,0 +1,330 @@
+#include "SerialPortWorker.h"
+#include <QSerialPort>
+#include <QTimer>
+#include <QDateTime>
+#include <QMutexLocker>
+
+namespace {
+
+/**
+ * @brief 定时发送落后超过该值的步骤直接跳过
+ */
+constexpr qint64 MAX_LAG_NS = 50 * 1000000LL;
+
+/**
+ * @brief 距计划时刻不足该值时不再交给定时器，自旋等待
+ */
+constexpr qint64 SPIN_THRESHOLD_NS = 2 * 1000000LL;
+
+/**
+ * @brief 每轮事件循环最多执行的步骤数，保证接收与其他事件得到处理
+ */
+constexpr int MAX_STEPS_PER_TICK = 256;
+
+/**
+ * @brief 回显合并间隔（约一帧）与上限
+ */
+constexpr int ECHO_INTERVAL_MS = 16;
+constexpr int MAX_ECHO_BYTES = 64 * 1024;
+
+} // namespace
+
+SerialPortWorker::SerialPortWorker(QObject *parent)
+    : QObject(parent)
+    , m_port(new QSerialPort(this))
+    , m_flushPosted(false)
+    , m_bytesWritten(0)
+    , m_bytesQueued(0)
+    , m_scheduleTimer(new QTimer(this))
+    , m_echoTimer(new QTimer(this))
+    , m_repeat(0)
+    , m_cycle(0)
+    , m_stepIndex(0)
+    , m_deadlineNs(0)
+    , m_startNs(0)
+    , m_cycleNs(0)
+    , m_echoTimestampMs(0)
+    , m_running(false)
+    , m_requestedRate(0.0)
+    , m_sent(0)
+    , m_missed(0)
+    , m_sentBytes(0)
+    , m_latenessSumNs(0)
+    , m_latenessMaxNs(0)
+    , m_elapsedNs(0)
+{
+    m_clock.start();
+
+    connect(m_port, &QSerialPort::readyRead, this, &SerialPortWorker::onReadyRead);
+    connect(m_port, &QSerialPort::bytesWritten, this, &SerialPortWorker::onBytesWritten);
+    connect(m_port, &QSerialPort::errorOccurred, this, &SerialPortWorker::onErrorOccurred);
+
+    m_scheduleTimer->setSingleShot(true);
+    m_scheduleTimer->setTimerType(Qt::PreciseTimer);
+    connect(m_scheduleTimer, &QTimer::timeout, this, &SerialPortWorker::runSchedule);
+
+    m_echoTimer->setSingleShot(true);
+    m_echoTimer->setInterval(ECHO_INTERVAL_MS);
+    connect(m_echoTimer, &QTimer::timeout, this, &SerialPortWorker::flushEcho);
+}
+
+/**
+ * @brief 打开串口
+ *
+ * 配置串口参数：8位数据位、无校验、1位停止位、无流控制
+ */
+bool SerialPortWorker::open(const QString &portName, int baudRate, QString &error)
+{
+    if (m_port->isOpen()) {
+        close();
+    }
+
+    m_port->setPortName(portName);
+    m_port->setBaudRate(baudRate);
+    m_port->setDataBits(QSerialPort::Data8);
+    m_port->setParity(QSerialPort::NoParity);
+    m_port->setStopBits(QSerialPort::OneStop);
+    m_port->setFlowControl(QSerialPort::NoFlowControl);
+
+    if (!m_port->open(QIODevice::ReadWrite)) {
+        error = m_port->errorString();
+        return false;
+    }
+    return true;
+}
+
+void SerialPortWorker::close()
+{
+    stopSchedule();
+    if (m_port->isOpen()) {
+        m_port->close();
+    }
+    // 未写出的数据随串口一起丢弃
+    QMutexLocker locker(&m_queueMutex);
+    m_pending.clear();
+    m_bytesQueued.store(0, std::memory_order_relaxed);
+}
+
+bool SerialPortWorker::enqueue(const QByteArray &data)
+{
+    if (data.isEmpty()) {
+        return true;
+    }
+    if (m_bytesQueued.load(std::memory_order_relaxed) + data.size() > MAX_QUEUED_BYTES) {
+        return false;
+    }
+    m_bytesQueued.fetch_add(data.size(), std::memory_order_relaxed);
+
+    bool post = false;
+    {
+        QMutexLocker locker(&m_queueMutex);
+        m_pending.append(data);
+        post = !m_flushPosted;
+        m_flushPosted = true;
+    }
+    // 下一轮事件循环统一写出，期间提交的小块数据合并为一次写入
+    if (post) {
+        QMetaObject::invokeMethod(this, &SerialPortWorker::flushQueue, Qt::QueuedConnection);
+    }
+    return true;
+}
+
+/**
+ * @brief 开始定时发送
+ *
+ * 第一轮的第一步立即发送，其后每一步在上一步计划时刻之后delayNs执行；
+ * 计划时刻按累计值推进，单次唤醒的误差不会累积
+ */
+void SerialPortWorker::startSchedule(const QVector<SerialSendStep> &steps, int repeat)
+{
+    m_scheduleTimer->stop();
+    flushEcho();
+
+    m_steps = steps;
+    m_repeat = qMax(0, repeat);
+    m_cycle = 0;
+    m_stepIndex = 0;
+    m_cycleNs = 0;
+    for (const SerialSendStep &step : std::as_const(m_steps)) {
+        m_cycleNs += step.delayNs;
+    }
+    // 一直循环且总间隔为0的序列会占满串口线程，直接拒绝
+    if (m_repeat == 0 && m_cycleNs <= 0) {
+        m_steps.clear();
+    }
+    m_startNs = m_clock.nsecsElapsed();
+    m_deadlineNs = m_startNs;
+    {
+        QMutexLocker locker(&m_statsMutex);
+        m_running = !m_steps.isEmpty();
+        m_requestedRate = m_cycleNs > 0 ? m_steps.size() * 1e9 / m_cycleNs : 0.0;
+        m_sent = 0;
+        m_missed = 0;
+        m_sentBytes = 0;
+        m_latenessSumNs = 0;
+        m_latenessMaxNs = 0;
+        m_elapsedNs = 0;
+    }
+    if (m_steps.isEmpty()) {
+        emit scheduleFinished();
+        return;
+    }
+    runSchedule();
+}
+
+void SerialPortWorker::stopSchedule()
+{
+    m_scheduleTimer->stop();
+    if (scheduleRunning()) {
+        finishSchedule();
+    }
+}
+
+bool SerialPortWorker::scheduleRunning() const
+{
+    QMutexLocker locker(&m_statsMutex);
+    return m_running;
+}
+
+QVariantMap SerialPortWorker::scheduleStatistics() const
+{
+    QMutexLocker locker(&m_statsMutex);
+    const qint64 elapsedNs = m_running ? m_clock.nsecsElapsed() - m_startNs : m_elapsedNs;
+    QVariantMap stats;
+    stats["running"] = m_running;
+    stats["sent"] = m_sent;
+    stats["missed"] = m_missed;
+    stats["bytes"] = m_sentBytes;
+    stats["requestedRate"] = m_requestedRate;
+    stats["achievedRate"] = elapsedNs > 0 ? m_sent * 1e9 / elapsedNs : 0.0;
+    stats["avgLatenessUs"] = m_sent > 0 ? m_latenessSumNs / 1000.0 / m_sent : 0.0;
+    stats["maxLatenessUs"] = m_latenessMaxNs / 1000.0;
+    return stats;
+}
+
+void SerialPortWorker::onReadyRead()
+{
+    const QByteArray data = m_port->readAll();
+    if (!data.isEmpty()) {
+        emit dataRead(data, QDateTime::currentMSecsSinceEpoch());
+    }
+}
+
+void SerialPortWorker::onBytesWritten(qint64 bytes)
+{
+    m_bytesWritten.fetch_add(bytes, std::memory_order_relaxed);
+    const qint64 queued = m_bytesQueued.fetch_sub(bytes, std::memory_order_relaxed) - bytes;
+    if (queued < 0) {
+        m_bytesQueued.fetch_add(-queued, std::memory_order_relaxed);
+    }
+}
+
+void SerialPortWorker::onErrorOccurred()
+{
+    const QSerialPort::SerialPortError error = m_port->error();
+    if (error != QSerialPort::NoError) {
+        emit portError(error, m_port->errorString());
+    }
+}
+
+void SerialPortWorker::flushQueue()
+{
+    QByteArray batch;
+    {
+        QMutexLocker locker(&m_queueMutex);
+        batch.swap(m_pending);
+        m_flushPosted = false;
+    }
+    if (batch.isEmpty()) {
+        return;
+    }
+    if (!m_port->isOpen() || m_port->write(batch) != batch.size()) {
+        m_bytesQueued.fetch_sub(batch.size(), std::memory_order_relaxed);
+    }
+}
+
+/**
+ * @brief 执行到期的发送步骤
+ *
+ * 距下一步超过2ms时交给精确定时器提前约1ms唤醒，不足时自旋等待到计划时刻；
+ * 写入后立即flush，使数据在计划时刻交给驱动而不是等到下一轮事件循环
+ */
+void SerialPortWorker::runSchedule()
+{
+    int budget = MAX_STEPS_PER_TICK;
+    qint64 now = m_clock.nsecsElapsed();
+    while (true) {
+        const qint64 waitNs = m_deadlineNs - now;
+        if (waitNs > SPIN_THRESHOLD_NS) {
+            m_scheduleTimer->start(static_cast<int>((waitNs - 1000000) / 1000000));
+            return;
+        }
+        if (budget-- == 0) {
+            m_scheduleTimer->start(0);
+            return;
+        }
+        while (now < m_deadlineNs) {
+            now = m_clock.nsecsElapsed();
+        }
+
+        const SerialSendStep &step = m_steps.at(m_stepIndex);
+        const qint64 latenessNs = now - m_deadlineNs;
+        // 落后过多或驱动来不及写出时跳过，避免追赶时连续突发
+        const bool skip = latenessNs > MAX_LAG_NS
+                || m_bytesQueued.load(std::memory_order_relaxed) + step.data.size() > MAX_QUEUED_BYTES;
+        if (!skip && m_port->isOpen() && m_port->write(step.data) == step.data.size()) {
+            m_bytesQueued.fetch_add(step.data.size(), std::memory_order_relaxed);
+            m_port->flush();
+            if (m_echo.isEmpty()) {
+                m_echoTimestampMs = QDateTime::currentMSecsSinceEpoch();
+            }
+            m_echo.append(step.data);
+            if (m_echo.size() >= MAX_ECHO_BYTES) {
+                flushEcho();
+            } else if (!m_echoTimer->isActive()) {
+                m_echoTimer->start();
+            }
+
+            QMutexLocker locker(&m_statsMutex);
+            ++m_sent;
+            m_sentBytes += step.data.size();
+            m_latenessSumNs += latenessNs;
+            m_latenessMaxNs = qMax(m_latenessMaxNs, latenessNs);
+        } else {
+            QMutexLocker locker(&m_statsMutex);
+            ++m_missed;
+        }
+
+        if (++m_stepIndex == m_steps.size()) {
+            m_stepIndex = 0;
+            if (m_repeat > 0 && ++m_cycle >= m_repeat) {
+                finishSchedule();
+                return;
+            }
+        }
+        m_deadlineNs += m_steps.at(m_stepIndex).delayNs;
+        now = m_clock.nsecsElapsed();
+    }
+}
+
+void SerialPortWorker::flushEcho()
+{
+    m_echoTimer->stop();
+    if (m_echo.isEmpty()) {
+        return;
+    }
+    emit dataSent(m_echo, m_echoTimestampMs);
+    m_echo.clear();
+}
+
+void SerialPortWorker::finishSchedule()
+{
+    m_scheduleTimer->stop();
+    flushEcho();
+    {
+        QMutexLocker locker(&m_statsMutex);
+        m_running = false;
+        m_elapsedNs = m_clock.nsecsElapsed() - m_startNs;
+    }
+    emit scheduleFinished();
+}
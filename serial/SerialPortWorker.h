@@ -0,0 +1,155 @@
+#ifndef SERIALPORTWORKER_H
+#define SERIALPORTWORKER_H
+
+#include <QObject>
+#include <QByteArray>
+#include <QVector>
+#include <QVariantMap>
+#include <QElapsedTimer>
+#include <QMutex>
+#include <atomic>
+
+class QSerialPort;
+class QTimer;
+
+/**
+ * @brief 定时发送的一步
+ */
+struct SerialSendStep {
+    QByteArray data;
+    qint64 delayNs = 0;     ///< 距上一步计划时刻的间隔
+};
+
+/**
+ * @brief 串口收发工作对象
+ *
+ * 运行在SerialPortManager的串口线程中，独占QSerialPort：
+ * - 任意线程提交的数据先进入发送队列，同一轮事件循环内的小块写入合并为一次写入
+ * - 按驱动确认的bytesWritten统计已发送与排队字节数，排队超过上限时拒绝新的数据
+ * - 定时发送按计划时刻执行：精确定时器提前约1ms唤醒，剩余时间自旋等待，
+ *   不受界面线程负载影响；落后过多时跳过并计入missed
+ * - 接收数据与定时发送的回显经排队信号交给界面线程
+ */
+class SerialPortWorker : public QObject
+{
+    Q_OBJECT
+
+public:
+    /**
+     * @brief 发送队列上限（字节）
+     */
+    static constexpr qint64 MAX_QUEUED_BYTES = 1024 * 1024;
+
+    explicit SerialPortWorker(QObject *parent = nullptr);
+
+    /**
+     * @brief 打开串口（在工作线程中调用）
+     * @param error 失败原因
+     */
+    bool open(const QString &portName, int baudRate, QString &error);
+
+    /**
+     * @brief 关闭串口并清空发送队列（在工作线程中调用）
+     */
+    void close();
+
+    /**
+     * @brief 提交待发送数据（线程安全）
+     * @return 队列已满时返回false
+     */
+    bool enqueue(const QByteArray &data);
+
+    /**
+     * @brief 开始定时发送（在工作线程中调用）
+     * @param steps 发送步骤，按顺序循环执行
+     * @param repeat 循环次数，0表示一直发送（此时总间隔必须大于0）
+     */
+    void startSchedule(const QVector<SerialSendStep> &steps, int repeat);
+
+    /**
+     * @brief 停止定时发送（在工作线程中调用）
+     */
+    void stopSchedule();
+
+    /**
+     * @brief 是否正在定时发送（线程安全）
+     */
+    bool scheduleRunning() const;
+
+    qint64 bytesWritten() const { return m_bytesWritten.load(std::memory_order_relaxed); }
+    qint64 bytesQueued() const { return m_bytesQueued.load(std::memory_order_relaxed); }
+
+    /**
+     * @brief 定时发送统计（线程安全）
+     * @return 包含running、sent、missed、bytes、requestedRate、achievedRate、
+     *         avgLatenessUs、maxLatenessUs字段
+     */
+    QVariantMap scheduleStatistics() const;
+
+signals:
+    /**
+     * @brief 收到数据
+     * @param timestampMs 读取时刻
+     */
+    void dataRead(const QByteArray &data, qint64 timestampMs);
+
+    /**
+     * @brief 定时发送的数据，约每帧合并一次
+     */
+    void dataSent(const QByteArray &data, qint64 timestampMs);
+
+    /**
+     * @brief 串口错误
+     * @param error QSerialPort::SerialPortError
+     */
+    void portError(int error, const QString &message);
+
+    /**
+     * @brief 定时发送结束（完成全部循环或被停止）
+     */
+    void scheduleFinished();
+
+private slots:
+    void onReadyRead();
+    void onBytesWritten(qint64 bytes);
+    void onErrorOccurred();
+    void flushQueue();
+    void runSchedule();
+    void flushEcho();
+
+private:
+    void finishSchedule();
+
+    QSerialPort *m_port;
+
+    QMutex m_queueMutex;
+    QByteArray m_pending;
+    bool m_flushPosted;
+    std::atomic<qint64> m_bytesWritten;
+    std::atomic<qint64> m_bytesQueued;
+
+    QTimer *m_scheduleTimer;
+    QTimer *m_echoTimer;
+    QElapsedTimer m_clock;
+    QVector<SerialSendStep> m_steps;
+    int m_repeat;
+    int m_cycle;
+    int m_stepIndex;
+    qint64 m_deadlineNs;
+    qint64 m_startNs;
+    qint64 m_cycleNs;
+    QByteArray m_echo;
+    qint64 m_echoTimestampMs;
+
+    mutable QMutex m_statsMutex;
+    bool m_running;
+    double m_requestedRate;
+    qint64 m_sent;
+    qint64 m_missed;
+    qint64 m_sentBytes;
+    qint64 m_latenessSumNs;
+    qint64 m_latenessMaxNs;
+    qint64 m_elapsedNs;
+};
+
+#endif
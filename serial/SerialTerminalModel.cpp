@@ -0,0 +1,539 @@
+#include "SerialTerminalModel.h"
+#include <QDateTime>
+#include <QTimer>
+#include <QByteArrayView>
+#include <cstring>
+
+namespace {
+
+/**
+ * @brief 数据块与行索引的上限
+ * @details 与字节缓冲区一起决定模型的内存上限；超出时最早的块或行连同其字节一起淘汰
+ */
+constexpr int MaxChunks = 65536;
+constexpr int MaxRows = 131072;
+
+/**
+ * @brief 视图刷新间隔，约为一帧
+ */
+constexpr int PublishIntervalMs = 16;
+
+} // namespace
+
+SerialTerminalModel::SerialTerminalModel(QObject *parent)
+    : QAbstractListModel(parent)
+    , m_bytes(DEFAULT_CAPACITY, '\0')
+    , m_writeOffset(0)
+    , m_validStart(0)
+    , m_chunks(MaxChunks)
+    , m_chunkHead(0)
+    , m_chunkCount(0)
+    , m_rows(MaxRows)
+    , m_rowHead(0)
+    , m_rowCount(0)
+    , m_firstRowId(0)
+    , m_publishedFirstId(0)
+    , m_publishedCount(0)
+    , m_publishedLastLength(0)
+    , m_hexMode(false)
+    , m_frameGapMs(20)
+    , m_bytesReceived(0)
+    , m_bytesSent(0)
+    , m_publishTimer(new QTimer(this))
+{
+    m_publishTimer->setSingleShot(true);
+    m_publishTimer->setInterval(PublishIntervalMs);
+    connect(m_publishTimer, &QTimer::timeout, this, &SerialTerminalModel::publish);
+}
+
+void SerialTerminalModel::setHexMode(bool hexMode)
+{
+    if (m_hexMode == hexMode) {
+        return;
+    }
+    beginResetModel();
+    m_hexMode = hexMode;
+    rebuildRows();
+    endResetModel();
+    emit hexModeChanged();
+    emit countChanged();
+}
+
+void SerialTerminalModel::setCapacity(int capacity)
+{
+    capacity = qMax(capacity, 4096);
+    if (capacity == this->capacity()) {
+        return;
+    }
+    beginResetModel();
+    m_bytes = QByteArray(capacity, '\0');
+    m_validStart = m_writeOffset;
+    m_chunkCount = 0;
+    rebuildRows();
+    endResetModel();
+    emit capacityChanged();
+    emit countChanged();
+    emit statisticsChanged();
+}
+
+void SerialTerminalModel::setFrameGapMs(int ms)
+{
+    if (m_frameGapMs == ms) {
+        return;
+    }
+    m_frameGapMs = ms;
+    if (m_hexMode) {
+        beginResetModel();
+        rebuildRows();
+        endResetModel();
+        emit countChanged();
+    }
+    emit frameGapMsChanged();
+}
+
+/**
+ * @brief 追加一个数据块
+ * @details 写入缓冲区并增量建立行索引，视图通知合并到下一帧
+ */
+void SerialTerminalModel::append(const QByteArray &data, Direction direction, qint64 timestampMs)
+{
+    if (data.isEmpty()) {
+        return;
+    }
+    if (direction == Sent) {
+        m_bytesSent += data.size();
+    } else {
+        m_bytesReceived += data.size();
+    }
+
+    // 单块超过容量时只保留末尾
+    const char *bytes = data.constData();
+    int length = static_cast<int>(data.size());
+    const int capacity = this->capacity();
+    if (length > capacity) {
+        bytes += length - capacity;
+        m_writeOffset += length - capacity;
+        length = capacity;
+    }
+
+    Chunk chunk;
+    chunk.offset = m_writeOffset;
+    chunk.timestampMs = timestampMs >= 0 ? timestampMs : QDateTime::currentMSecsSinceEpoch();
+    chunk.direction = static_cast<quint8>(direction);
+
+    bool gapBreak = false;
+    if (m_chunkCount > 0) {
+        const Chunk &previous = m_chunks[(m_chunkHead + m_chunkCount - 1) % MaxChunks];
+        gapBreak = m_hexMode && m_frameGapMs > 0 && chunk.timestampMs - previous.timestampMs >= m_frameGapMs;
+    }
+    if (m_chunkCount == MaxChunks) {
+        // 最早的块失去时间戳，其字节一并视为淘汰
+        m_chunkHead = (m_chunkHead + 1) % MaxChunks;
+        --m_chunkCount;
+        m_validStart = qMax(m_validStart, m_chunks[m_chunkHead].offset);
+    }
+    m_chunks[(m_chunkHead + m_chunkCount) % MaxChunks] = chunk;
+    ++m_chunkCount;
+
+    writeBytes(bytes, length);
+    indexChunk(bytes, length, chunk.offset, chunk, gapBreak);
+    evict();
+    schedulePublish();
+}
+
+int SerialTerminalModel::rowCount(const QModelIndex &parent) const
+{
+    return parent.isValid() ? 0 : m_publishedCount;
+}
+
+QVariant SerialTerminalModel::data(const QModelIndex &index, int role) const
+{
+    if (!index.isValid() || index.row() >= m_publishedCount) {
+        return QVariant();
+    }
+    // 已通知删除前就被覆盖的行返回空值，下一次刷新时移除
+    const Row *row = rowById(m_publishedFirstId + index.row());
+    if (!row) {
+        return QVariant();
+    }
+
+    switch (role) {
+    case Qt::DisplayRole:
+    case TextRole:
+        return rowText(*row);
+    case AsciiRole:
+        return m_hexMode ? rowAscii(*row) : QString();
+    case TimeRole:
+        return QDateTime::fromMSecsSinceEpoch(row->timestampMs).toString("HH:mm:ss.zzz");
+    case TimestampRole:
+        return row->timestampMs;
+    case DirectionRole:
+        return static_cast<int>(row->direction);
+    case OffsetRole:
+        return row->offset;
+    case LengthRole:
+        return row->length;
+    default:
+        return QVariant();
+    }
+}
+
+QHash<int, QByteArray> SerialTerminalModel::roleNames() const
+{
+    return {
+        {TextRole, "text"},
+        {AsciiRole, "ascii"},
+        {TimeRole, "time"},
+        {TimestampRole, "timestamp"},
+        {DirectionRole, "direction"},
+        {OffsetRole, "offset"},
+        {LengthRole, "length"}
+    };
+}
+
+void SerialTerminalModel::clear()
+{
+    beginResetModel();
+    m_validStart = m_writeOffset;
+    m_chunkCount = 0;
+    rebuildRows();
+    endResetModel();
+    emit countChanged();
+    emit statisticsChanged();
+}
+
+int SerialTerminalModel::find(const QString &pattern, int fromRow, bool backward)
+{
+    // 先把待通知的行交给视图，返回的行号才与视图一致
+    publish();
+
+    const QByteArray needle = m_hexMode ? QByteArray::fromHex(pattern.toLatin1()) : pattern.toUtf8();
+    if (needle.isEmpty() || m_rowCount == 0) {
+        return -1;
+    }
+
+    const qint64 begin = m_rows[m_rowHead].offset;
+    const qint64 end = m_writeOffset;
+    const Row *from = (fromRow >= 0 && fromRow < m_publishedCount) ? rowById(m_publishedFirstId + fromRow) : nullptr;
+    qint64 found = -1;
+    if (!backward) {
+        const qint64 pivot = from ? from->offset + from->length : begin;
+        found = search(needle, pivot, end, false);
+        if (found < 0) {
+            found = search(needle, begin, qMin(pivot + needle.size() - 1, end), false);
+        }
+    } else {
+        const qint64 pivot = from ? from->offset : end;
+        found = search(needle, begin, qMin(pivot + needle.size() - 1, end), true);
+        if (found < 0) {
+            found = search(needle, pivot, end, true);
+        }
+    }
+    if (found < 0) {
+        return -1;
+    }
+    return static_cast<int>(rowIdAt(found) - m_publishedFirstId);
+}
+
+QString SerialTerminalModel::rowsText(int first, int last) const
+{
+    first = qMax(first, 0);
+    last = qMin(last, m_publishedCount - 1);
+    QString text;
+    for (int i = first; i <= last; ++i) {
+        const Row *row = rowById(m_publishedFirstId + i);
+        if (!row) {
+            continue;
+        }
+        text += QDateTime::fromMSecsSinceEpoch(row->timestampMs).toString("HH:mm:ss.zzz");
+        text += row->direction == Sent ? QStringLiteral(" > ") : QStringLiteral(" < ");
+        text += rowText(*row);
+        if (m_hexMode) {
+            text += QStringLiteral("  ") + rowAscii(*row);
+        }
+        text += QLatin1Char('\n');
+    }
+    return text;
+}
+
+/**
+ * @brief 通知视图
+ * @details 先移除已淘汰的行，再刷新仍在增长的末行，最后插入新行
+ */
+void SerialTerminalModel::publish()
+{
+    m_publishTimer->stop();
+
+    const int removed = static_cast<int>(qBound<qint64>(0, m_firstRowId - m_publishedFirstId, m_publishedCount));
+    if (removed > 0) {
+        beginRemoveRows(QModelIndex(), 0, removed - 1);
+        m_publishedFirstId += removed;
+        m_publishedCount -= removed;
+        endRemoveRows();
+    }
+    if (m_publishedCount == 0) {
+        m_publishedFirstId = m_firstRowId;
+    }
+
+    if (m_publishedCount > 0) {
+        const Row *last = rowById(m_publishedFirstId + m_publishedCount - 1);
+        if (last && last->length != m_publishedLastLength) {
+            const QModelIndex changed = index(m_publishedCount - 1);
+            emit dataChanged(changed, changed);
+        }
+    }
+
+    const int added = static_cast<int>(m_firstRowId + m_rowCount - (m_publishedFirstId + m_publishedCount));
+    if (added > 0) {
+        beginInsertRows(QModelIndex(), m_publishedCount, m_publishedCount + added - 1);
+        m_publishedCount += added;
+        endInsertRows();
+    }
+
+    const Row *last = m_publishedCount > 0 ? rowById(m_publishedFirstId + m_publishedCount - 1) : nullptr;
+    m_publishedLastLength = last ? last->length : 0;
+    if (removed > 0 || added > 0) {
+        emit countChanged();
+    }
+    emit statisticsChanged();
+}
+
+void SerialTerminalModel::writeBytes(const char *data, int length)
+{
+    const int capacity = this->capacity();
+    const int position = static_cast<int>(m_writeOffset % capacity);
+    const int first = qMin(length, capacity - position);
+    char *buffer = m_bytes.data();
+    std::memcpy(buffer + position, data, first);
+    std::memcpy(buffer, data + first, length - first);
+    m_writeOffset += length;
+    m_validStart = qMax(m_validStart, m_writeOffset - capacity);
+}
+
+QByteArray SerialTerminalModel::readBytes(qint64 offset, int length) const
+{
+    const int capacity = this->capacity();
+    const int position = static_cast<int>(offset % capacity);
+    const int first = qMin(length, capacity - position);
+    QByteArray result(length, Qt::Uninitialized);
+    std::memcpy(result.data(), m_bytes.constData() + position, first);
+    std::memcpy(result.data() + first, m_bytes.constData(), length - first);
+    return result;
+}
+
+/**
+ * @brief 为一段连续字节建立行索引
+ * @param gapBreak 是否因帧间隔另起一行
+ * @details 末行未结束、方向相同且与本段相接时继续填充末行
+ */
+void SerialTerminalModel::indexChunk(const char *data, int length, qint64 offset, const Chunk &chunk, bool gapBreak)
+{
+    const int rowLimit = m_hexMode ? HEX_ROW_BYTES : TEXT_ROW_BYTES;
+    Row *last = m_rowCount > 0 ? &m_rows[(m_rowHead + m_rowCount - 1) % MaxRows] : nullptr;
+    bool extend = last && !last->closed && !gapBreak && last->direction == chunk.direction
+                  && last->offset + last->length == offset;
+
+    int i = 0;
+    while (i < length) {
+        if (!extend) {
+            pushRow({offset + i, chunk.timestampMs, 0, chunk.direction, false});
+            last = &m_rows[(m_rowHead + m_rowCount - 1) % MaxRows];
+        }
+        extend = false;
+
+        int take = qMin(length - i, rowLimit - last->length);
+        if (!m_hexMode) {
+            const void *newline = std::memchr(data + i, '\n', take);
+            if (newline) {
+                take = static_cast<int>(static_cast<const char *>(newline) - (data + i)) + 1;
+                last->closed = true;
+            }
+        }
+        last->length += take;
+        if (last->length >= rowLimit) {
+            last->closed = true;
+        }
+        i += take;
+    }
+}
+
+void SerialTerminalModel::pushRow(const Row &row)
+{
+    if (m_rowCount == MaxRows) {
+        // 行数达到上限时最早的行连同其字节一起淘汰
+        m_rowHead = (m_rowHead + 1) % MaxRows;
+        --m_rowCount;
+        ++m_firstRowId;
+        m_validStart = qMax(m_validStart, m_rows[m_rowHead].offset);
+    }
+    m_rows[(m_rowHead + m_rowCount) % MaxRows] = row;
+    ++m_rowCount;
+}
+
+/**
+ * @brief 淘汰字节已被覆盖的行与数据块
+ * @details 行首字节被覆盖的行整行淘汰
+ */
+void SerialTerminalModel::evict()
+{
+    while (m_rowCount > 0 && m_rows[m_rowHead].offset < m_validStart) {
+        m_rowHead = (m_rowHead + 1) % MaxRows;
+        --m_rowCount;
+        ++m_firstRowId;
+    }
+    if (m_rowCount > 0) {
+        m_validStart = qMax(m_validStart, m_rows[m_rowHead].offset);
+    }
+    while (m_chunkCount > 1 && m_chunks[(m_chunkHead + 1) % MaxChunks].offset <= m_validStart) {
+        m_chunkHead = (m_chunkHead + 1) % MaxChunks;
+        --m_chunkCount;
+    }
+}
+
+/**
+ * @brief 按缓冲区中的数据块重新建立行索引
+ * @details 在模型重置期间调用，重建后视图与索引一致
+ */
+void SerialTerminalModel::rebuildRows()
+{
+    m_publishTimer->stop();
+    m_rowHead = 0;
+    m_rowCount = 0;
+    m_firstRowId = 0;
+
+    qint64 previousTime = 0;
+    for (int i = 0; i < m_chunkCount; ++i) {
+        const Chunk &chunk = m_chunks[(m_chunkHead + i) % MaxChunks];
+        const qint64 end = i + 1 < m_chunkCount ? m_chunks[(m_chunkHead + i + 1) % MaxChunks].offset : m_writeOffset;
+        const qint64 start = qMax(chunk.offset, m_validStart);
+        const bool gapBreak = i > 0 && m_hexMode && m_frameGapMs > 0 && chunk.timestampMs - previousTime >= m_frameGapMs;
+        previousTime = chunk.timestampMs;
+        if (end <= start) {
+            continue;
+        }
+        const QByteArray bytes = readBytes(start, static_cast<int>(end - start));
+        indexChunk(bytes.constData(), static_cast<int>(bytes.size()), start, chunk, gapBreak);
+    }
+    evict();
+
+    m_publishedFirstId = m_firstRowId;
+    m_publishedCount = m_rowCount;
+    m_publishedLastLength = m_rowCount > 0 ? m_rows[(m_rowHead + m_rowCount - 1) % MaxRows].length : 0;
+}
+
+void SerialTerminalModel::schedulePublish()
+{
+    if (!m_publishTimer->isActive()) {
+        m_publishTimer->start();
+    }
+}
+
+const SerialTerminalModel::Row *SerialTerminalModel::rowById(qint64 id) const
+{
+    if (id < m_firstRowId || id >= m_firstRowId + m_rowCount) {
+        return nullptr;
+    }
+    return &m_rows[static_cast<int>((m_rowHead + (id - m_firstRowId)) % MaxRows)];
+}
+
+/**
+ * @brief 查找包含指定字节的行
+ * @return 行的累计编号
+ */
+qint64 SerialTerminalModel::rowIdAt(qint64 offset) const
+{
+    int low = 0;
+    int high = m_rowCount - 1;
+    while (low < high) {
+        const int mid = (low + high + 1) / 2;
+        if (m_rows[(m_rowHead + mid) % MaxRows].offset <= offset) {
+            low = mid;
+        } else {
+            high = mid - 1;
+        }
+    }
+    return m_firstRowId + low;
+}
+
+/**
+ * @brief 在[from, to)范围内查找匹配的起始偏移
+ * @details 范围不超过容量，至多跨越一次回绕点：两侧连续内存直接查找，
+ *          跨越回绕点的匹配只复制回绕点前后各needle长度的字节
+ * @return 匹配的起始偏移，未找到返回-1
+ */
+qint64 SerialTerminalModel::search(const QByteArray &needle, qint64 from, qint64 to, bool backward) const
+{
+    const qint64 n = needle.size();
+    if (to - from < n) {
+        return -1;
+    }
+    const int capacity = this->capacity();
+    auto contiguous = [&](qint64 start, qint64 end) -> qint64 {
+        if (end - start < n) {
+            return -1;
+        }
+        const QByteArrayView view(m_bytes.constData() + start % capacity, end - start);
+        const qsizetype i = backward ? view.lastIndexOf(needle) : view.indexOf(needle);
+        return i < 0 ? -1 : start + i;
+    };
+
+    const qint64 wrap = (from / capacity + 1) * capacity;
+    if (wrap >= to) {
+        return contiguous(from, to);
+    }
+
+    auto straddling = [&]() -> qint64 {
+        const qint64 start = qMax(from, wrap - n + 1);
+        const qint64 end = qMin(to, wrap + n - 1);
+        if (end - start < n) {
+            return -1;
+        }
+        const QByteArray window = readBytes(start, static_cast<int>(end - start));
+        const qsizetype i = backward ? window.lastIndexOf(needle) : window.indexOf(needle);
+        return i < 0 ? -1 : start + i;
+    };
+
+    qint64 found = -1;
+    if (!backward) {
+        if ((found = contiguous(from, wrap)) < 0 && (found = straddling()) < 0) {
+            found = contiguous(wrap, to);
+        }
+    } else {
+        if ((found = contiguous(wrap, to)) < 0 && (found = straddling()) < 0) {
+            found = contiguous(from, wrap);
+        }
+    }
+    return found;
+}
+
+QString SerialTerminalModel::rowText(const Row &row) const
+{
+    const QByteArray bytes = readBytes(row.offset, row.length);
+    if (m_hexMode) {
+        return QString::fromLatin1(bytes.toHex(' ').toUpper());
+    }
+
+    qsizetype length = bytes.size();
+    while (length > 0 && (bytes.at(length - 1) == '\n' || bytes.at(length - 1) == '\r')) {
+        --length;
+    }
+    QString text = QString::fromUtf8(bytes.constData(), length);
+    // 控制字符以中点显示，避免打乱行布局
+    for (QChar &c : text) {
+        if (c.unicode() < 0x20 && c != QLatin1Char('\t')) {
+            c = QChar(0x00B7);
+        }
+    }
+    return text;
+}
+
+QString SerialTerminalModel::rowAscii(const Row &row) const
+{
+    const QByteArray bytes = readBytes(row.offset, row.length);
+    QString text(bytes.size(), Qt::Uninitialized);
+    for (qsizetype i = 0; i < bytes.size(); ++i) {
+        const uchar c = static_cast<uchar>(bytes.at(i));
+        text[i] = QLatin1Char((c >= 0x20 && c < 0x7F) ? static_cast<char>(c) : '.');
+    }
+    return text;
+}
@@ -0,0 +1,203 @@
+#ifndef SERIALTERMINALMODEL_H
+#define SERIALTERMINALMODEL_H
+
+#include <QAbstractListModel>
+#include <QByteArray>
+#include <QVector>
+
+class QTimer;
+
+/**
+ * @brief 串口终端模型
+ * @details 收发数据写入固定容量的字节环形缓冲区，旧数据被新数据覆盖，内存占用恒定：
+ *          - 每次写入记为一个数据块，带时间戳与方向
+ *          - 追加时增量建立行索引：文本模式按换行（或满256字节）分行，
+ *            十六进制模式每行16字节，收发方向变化或空闲超过frameGapMs时另起一行（按帧分行）
+ *          - 行文本只在视图请求可见行时才格式化
+ *          - 行的增删在定时器中合并，每帧最多通知视图一次
+ */
+class SerialTerminalModel : public QAbstractListModel
+{
+    Q_OBJECT
+    /**
+     * @brief 是否以十六进制显示
+     * @details 切换后按缓冲区中的数据块重新建立行索引
+     */
+    Q_PROPERTY(bool hexMode READ hexMode WRITE setHexMode NOTIFY hexModeChanged)
+
+    /**
+     * @brief 缓冲区容量（字节）
+     * @details 修改后清空缓冲区
+     */
+    Q_PROPERTY(int capacity READ capacity WRITE setCapacity NOTIFY capacityChanged)
+
+    /**
+     * @brief 十六进制模式下的帧间隔（毫秒）
+     * @details 相邻两次写入的间隔达到该值时另起一行，<=0表示不按间隔分行
+     */
+    Q_PROPERTY(int frameGapMs READ frameGapMs WRITE setFrameGapMs NOTIFY frameGapMsChanged)
+
+    /**
+     * @brief 行数（已通知视图的行）
+     */
+    Q_PROPERTY(int count READ count NOTIFY countChanged)
+
+    /**
+     * @brief 缓冲区中的字节数
+     */
+    Q_PROPERTY(int bufferedBytes READ bufferedBytes NOTIFY statisticsChanged)
+
+    /**
+     * @brief 累计接收字节数
+     */
+    Q_PROPERTY(qint64 bytesReceived READ bytesReceived NOTIFY statisticsChanged)
+
+    /**
+     * @brief 累计发送字节数
+     */
+    Q_PROPERTY(qint64 bytesSent READ bytesSent NOTIFY statisticsChanged)
+
+public:
+    /**
+     * @brief 数据方向
+     */
+    enum Direction {
+        Received,
+        Sent
+    };
+    Q_ENUM(Direction)
+
+    /**
+     * @brief 自定义角色
+     */
+    enum Roles {
+        TextRole = Qt::UserRole + 1,    ///< 文本模式为内容，十六进制模式为字节
+        AsciiRole,                      ///< 十六进制模式下的可打印字符列
+        TimeRole,                       ///< 行首字节所在数据块的时间（HH:mm:ss.zzz）
+        TimestampRole,                  ///< 同上，毫秒时间戳
+        DirectionRole,                  ///< Direction
+        OffsetRole,                     ///< 行首字节的累计偏移
+        LengthRole                      ///< 行字节数
+    };
+
+    static constexpr int DEFAULT_CAPACITY = 4 * 1024 * 1024;
+    static constexpr int HEX_ROW_BYTES = 16;
+    static constexpr int TEXT_ROW_BYTES = 256;
+
+    explicit SerialTerminalModel(QObject *parent = nullptr);
+
+    bool hexMode() const { return m_hexMode; }
+    void setHexMode(bool hexMode);
+    int capacity() const { return static_cast<int>(m_bytes.size()); }
+    void setCapacity(int capacity);
+    int frameGapMs() const { return m_frameGapMs; }
+    void setFrameGapMs(int ms);
+    int count() const { return m_publishedCount; }
+    int bufferedBytes() const { return static_cast<int>(m_writeOffset - m_validStart); }
+    qint64 bytesReceived() const { return m_bytesReceived; }
+    qint64 bytesSent() const { return m_bytesSent; }
+
+    /**
+     * @brief 追加一个数据块
+     * @param data 数据
+     * @param direction 方向
+     * @param timestampMs 毫秒时间戳，<0时取当前时间
+     */
+    void append(const QByteArray &data, Direction direction, qint64 timestampMs = -1);
+
+    int rowCount(const QModelIndex &parent = QModelIndex()) const override;
+    QVariant data(const QModelIndex &index, int role = Qt::DisplayRole) const override;
+    QHash<int, QByteArray> roleNames() const override;
+
+    /**
+     * @brief 清空缓冲区
+     */
+    Q_INVOKABLE void clear();
+
+    /**
+     * @brief 在缓冲区中查找
+     * @param pattern 文本模式下按UTF-8匹配；十六进制模式下为空格分隔的字节（如"01 03"）
+     * @param fromRow 从该行之后（向后查找时为之前）开始，到末尾后回绕
+     * @param backward 是否向前查找
+     * @return 匹配所在行，未找到返回-1
+     */
+    Q_INVOKABLE int find(const QString &pattern, int fromRow = -1, bool backward = false);
+
+    /**
+     * @brief 获取若干行的文本，供复制
+     * @param first 首行
+     * @param last 末行（含）
+     * @return 每行带时间与方向前缀
+     */
+    Q_INVOKABLE QString rowsText(int first, int last) const;
+
+signals:
+    void hexModeChanged();
+    void capacityChanged();
+    void frameGapMsChanged();
+    void countChanged();
+    void statisticsChanged();
+
+private slots:
+    void publish();
+
+private:
+    /**
+     * @brief 数据块
+     */
+    struct Chunk {
+        qint64 offset;
+        qint64 timestampMs;
+        quint8 direction;
+    };
+
+    /**
+     * @brief 行索引
+     * @details 行内字节连续存放在缓冲区中；closed表示已遇到换行或写满，后续数据另起一行
+     */
+    struct Row {
+        qint64 offset;
+        qint64 timestampMs;
+        int length;
+        quint8 direction;
+        bool closed;
+    };
+
+    void writeBytes(const char *data, int length);
+    QByteArray readBytes(qint64 offset, int length) const;
+    void indexChunk(const char *data, int length, qint64 offset, const Chunk &chunk, bool gapBreak);
+    void pushRow(const Row &row);
+    void evict();
+    void rebuildRows();
+    void schedulePublish();
+    const Row *rowById(qint64 id) const;
+    qint64 rowIdAt(qint64 offset) const;
+    qint64 search(const QByteArray &needle, qint64 from, qint64 to, bool backward) const;
+    QString rowText(const Row &row) const;
+    QString rowAscii(const Row &row) const;
+
+    QByteArray m_bytes;             ///< 环形缓冲区，偏移按累计字节数对容量取模
+    qint64 m_writeOffset;           ///< 累计写入字节数
+    qint64 m_validStart;            ///< 缓冲区中最早仍有效的字节偏移
+
+    QVector<Chunk> m_chunks;        ///< 数据块环形队列
+    int m_chunkHead;
+    int m_chunkCount;
+
+    QVector<Row> m_rows;            ///< 行环形队列
+    int m_rowHead;
+    int m_rowCount;
+    qint64 m_firstRowId;            ///< 队首行的累计编号
+
+    qint64 m_publishedFirstId;      ///< 视图中第0行的累计编号
+    int m_publishedCount;
+    int m_publishedLastLength;      ///< 视图中最后一行通知时的长度，增长后刷新该行
+
+    bool m_hexMode;
+    int m_frameGapMs;
+    qint64 m_bytesReceived;
+    qint64 m_bytesSent;
+    QTimer *m_publishTimer;
+};
+
+#endif
@@ -0,0 +1,557 @@
+#include "SessionImporter.h"
+#include "RecordTable.h"
+#include "../core/Logger.h"
+#include <QByteArrayView>
+#include <QElapsedTimer>
+#include <QFile>
+#include <QThread>
+#include <QUrl>
+#include <QVarLengthArray>
+#include <algorithm>
+#include <cstring>
+
+namespace {
+
+/**
+ * @brief 单个数据块的最小字节数
+ * @details 小文件不拆块，避免线程调度开销超过解析本身
+ */
+constexpr qint64 MIN_CHUNK_BYTES = 4 * 1024 * 1024;
+
+/**
+ * @brief 解析多少行检查一次是否已取消
+ */
+constexpr int CANCEL_CHECK_ROWS = 65536;
+
+/**
+ * @brief 时间列"yyyy-MM-dd HH:mm:ss"的固定宽度，其后可带".zzz"毫秒部分
+ */
+constexpr int TIMESTAMP_WIDTH = 19;
+
+constexpr double POW10[] = {
+    1e0, 1e1, 1e2, 1e3, 1e4, 1e5, 1e6, 1e7, 1e8, 1e9,
+    1e10, 1e11, 1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18,
+};
+
+inline int digitsAt(const char *p, int count)
+{
+    int value = 0;
+    for (int i = 0; i < count; ++i) {
+        const unsigned d = static_cast<unsigned char>(p[i]) - '0';
+        if (d > 9) {
+            return -1;
+        }
+        value = value * 10 + static_cast<int>(d);
+    }
+    return value;
+}
+
+/**
+ * @brief 按固定位置解析"yyyy-MM-dd HH:mm:ss"
+ * @return 毫秒数（与SessionReplay相同，以儒略日折算，只用于相对偏移），格式错误返回-1
+ * @details 日期换算用整数公式，不逐行构造QDate
+ */
+qint64 parseTimestamp(const char *p)
+{
+    if (p[4] != '-' || p[7] != '-' || p[10] != ' ' || p[13] != ':' || p[16] != ':') {
+        return -1;
+    }
+    const int year = digitsAt(p, 4);
+    const int month = digitsAt(p + 5, 2);
+    const int day = digitsAt(p + 8, 2);
+    const int hour = digitsAt(p + 11, 2);
+    const int minute = digitsAt(p + 14, 2);
+    const int second = digitsAt(p + 17, 2);
+    if (year < 0 || month < 1 || month > 12 || day < 1 || day > 31
+        || hour < 0 || hour > 23 || minute < 0 || minute > 59 || second < 0 || second > 60) {
+        return -1;
+    }
+    // 公历转儒略日
+    const int a = (14 - month) / 12;
+    const qint64 y = year + 4800 - a;
+    const qint64 m = month + 12 * a - 3;
+    const qint64 julianDay = day + (153 * m + 2) / 5 + 365 * y + y / 4 - y / 100 + y / 400 - 32045;
+    return julianDay * 86400000LL + ((hour * 60LL + minute) * 60LL + second) * 1000LL;
+}
+
+/**
+ * @brief 解析时间列可选的小数秒部分
+ * @param p 输入输出：秒之后的位置，成功后指向小数部分之后
+ * @return 毫秒数（不足三位按位补齐，超出部分舍去），没有小数部分时返回0
+ */
+int parseMillis(const char *&p, const char *end)
+{
+    if (p == end || *p != '.') {
+        return 0;
+    }
+    ++p;
+    int millis = 0;
+    int digits = 0;
+    while (p < end && static_cast<unsigned>(static_cast<unsigned char>(*p) - '0') <= 9) {
+        if (digits < 3) {
+            millis = millis * 10 + (*p - '0');
+            ++digits;
+        }
+        ++p;
+    }
+    for (; digits < 3; ++digits) {
+        millis *= 10;
+    }
+    return millis;
+}
+
+/**
+ * @brief 解析一个数值字段并跳过其后的分隔符
+ * @param p 输入输出：字段起点，成功后指向下一字段
+ * @param end 行尾
+ * @param last 是否为行内最后一个字段
+ * @details 定点格式（可选符号、最多18位有效数字、小数点）一次扫描完成；
+ *          "0x"开头的状态字按十六进制整数读取；遇到指数、空格等其他字符时退回通用浮点解析
+ */
+bool parseNumber(const char *&p, const char *end, bool last, double *out)
+{
+    const char *q = p;
+    if (end - q > 2 && q[0] == '0' && (q[1] == 'x' || q[1] == 'X')) {
+        const char *delimiter = last ? end : static_cast<const char *>(std::memchr(q, ',', end - q));
+        if (!delimiter) {
+            return false;
+        }
+        bool ok = false;
+        *out = static_cast<double>(QByteArrayView(q + 2, delimiter - q - 2).toULongLong(&ok, 16));
+        p = last ? end : delimiter + 1;
+        return ok;
+    }
+    bool negative = false;
+    if (q < end && (*q == '-' || *q == '+')) {
+        negative = *q == '-';
+        ++q;
+    }
+    quint64 mantissa = 0;
+    int digits = 0;
+    int fraction = -1;
+    for (; q < end; ++q) {
+        const unsigned d = static_cast<unsigned char>(*q) - '0';
+        if (d <= 9) {
+            mantissa = mantissa * 10 + d;
+            ++digits;
+            if (fraction >= 0) {
+                ++fraction;
+            }
+        } else if (*q == '.' && fraction < 0) {
+            fraction = 0;
+        } else {
+            break;
+        }
+    }
+
+    const bool atDelimiter = last ? q == end : (q < end && *q == ',');
+    if (atDelimiter && digits > 0 && digits <= 18) {
+        const double value = static_cast<double>(mantissa) / POW10[fraction > 0 ? fraction : 0];
+        *out = negative ? -value : value;
+        p = last ? end : q + 1;
+        return true;
+    }
+
+    const char *delimiter = last ? end : static_cast<const char *>(std::memchr(p, ',', end - p));
+    if (!delimiter) {
+        return false;
+    }
+    bool ok = false;
+    *out = QByteArrayView(p, delimiter - p).trimmed().toDouble(&ok);
+    p = last ? end : delimiter + 1;
+    return ok;
+}
+
+/**
+ * @brief 拆分表头行
+ * @return 时间列之后各列的名称
+ */
+QStringList parseHeader(const char *begin, const char *end)
+{
+    if (end > begin && end[-1] == '\r') {
+        --end;
+    }
+    QStringList fields = QString::fromUtf8(begin, end - begin).split(',');
+    fields.removeFirst();
+    for (QString &field : fields) {
+        field = field.trimmed();
+    }
+    return fields;
+}
+
+} // namespace
+
+const QVector<double> &SessionColumns::channel(int index) const
+{
+    static const QVector<double> empty;
+    return index >= 0 && index < channels.size() ? channels.at(index) : empty;
+}
+
+SessionImporter::SessionImporter(QObject *parent)
+    : QObject(parent)
+    , m_loading(false)
+    , m_progress(0.0)
+    , m_skipped(0)
+    , m_bytes(0)
+    , m_chunks(0)
+    , m_elapsedMs(0.0)
+    , m_generation(0)
+{
+    m_loadPool.setMaxThreadCount(1);
+    m_parsePool.setMaxThreadCount(qMax(1, QThread::idealThreadCount()));
+}
+
+SessionImporter::~SessionImporter()
+{
+    ++m_generation;
+    m_loadPool.waitForDone();
+    m_parsePool.waitForDone();
+}
+
+qint64 SessionImporter::durationMs() const
+{
+    if (m_columns.timeMs.isEmpty()) {
+        return 0;
+    }
+    return m_columns.timeMs.last() - m_columns.timeMs.first();
+}
+
+void SessionImporter::setLoading(bool loading)
+{
+    if (m_loading != loading) {
+        m_loading = loading;
+        emit loadingChanged();
+    }
+}
+
+void SessionImporter::load(const QString &filePath)
+{
+    const QString path = filePath.startsWith("file:") ? QUrl(filePath).toLocalFile() : filePath;
+    const quint64 generation = ++m_generation;
+    m_progress = 0.0;
+    emit progressChanged();
+    setLoading(true);
+    m_loadPool.start([this, path, generation]() { run(path, generation); });
+}
+
+void SessionImporter::cancel()
+{
+    ++m_generation;
+    setLoading(false);
+}
+
+void SessionImporter::clear()
+{
+    cancel();
+    m_columns = SessionColumns();
+    m_channelNames.clear();
+    m_source.clear();
+    emit loadedChanged();
+}
+
+/**
+ * @brief 后台加载流程
+ * @details 映射文件 -> 跳过BOM与表头 -> 按换行边界切块 -> 并行解析 -> 按顺序拼接
+ */
+void SessionImporter::run(const QString &filePath, quint64 generation)
+{
+    QElapsedTimer clock;
+    clock.start();
+
+    auto fail = [this, generation, filePath](const QString &error) {
+        LOG_WARNING(Log::Recorder, "会话导入失败: {} ({})", filePath, error);
+        QMetaObject::invokeMethod(this, [this, generation, error]() {
+            if (!isCurrent(generation)) {
+                return;
+            }
+            setLoading(false);
+            emit loadFinished(false, error);
+        }, Qt::QueuedConnection);
+    };
+
+    QFile file(filePath);
+    if (!file.open(QIODevice::ReadOnly)) {
+        fail(file.errorString());
+        return;
+    }
+    const qint64 size = file.size();
+    if (size <= 0) {
+        fail(QStringLiteral("文件为空"));
+        return;
+    }
+
+    // 无法映射（如网络文件系统）时退回整体读取
+    QByteArray fallback;
+    uchar *mapped = file.map(0, size);
+    const char *data = nullptr;
+    if (mapped) {
+        data = reinterpret_cast<const char *>(mapped);
+    } else {
+        fallback = file.readAll();
+        data = fallback.constData();
+    }
+    const char *begin = data;
+    const char *end = data + (mapped ? size : fallback.size());
+
+    if (end - begin >= 3 && std::memcmp(begin, "\xEF\xBB\xBF", 3) == 0) {
+        begin += 3;
+    }
+    // 表头行以非数字、非单引号开头，数值列数由表头决定；没有表头时按首行的列数，
+    // 三列时沿用默认的电压/电流/功率
+    QStringList channelNames;
+    const char *firstLineEnd = static_cast<const char *>(std::memchr(begin, '\n', end - begin));
+    if (!firstLineEnd) {
+        firstLineEnd = end;
+    }
+    if (begin < end && *begin != '\'' && (*begin < '0' || *begin > '9')) {
+        channelNames = parseHeader(begin, firstLineEnd);
+        begin = firstLineEnd < end ? firstLineEnd + 1 : end;
+    } else {
+        const int columns = static_cast<int>(std::count(begin, firstLineEnd, ','));
+        if (columns == 3) {
+            for (const RecordChannel &channel : RecordTable::defaultChannels()) {
+                channelNames.append(channel.label());
+            }
+        } else {
+            for (int i = 0; i < columns; ++i) {
+                channelNames.append(QStringLiteral("通道%1").arg(i + 1));
+            }
+        }
+    }
+    if (channelNames.isEmpty()) {
+        if (mapped) {
+            file.unmap(mapped);
+        }
+        fail(QStringLiteral("不支持的记录格式：时间列之后没有数值列"));
+        return;
+    }
+    const int channelCount = channelNames.size();
+
+    const qint64 payload = end - begin;
+    const int maxChunks = m_parsePool.maxThreadCount() * 4;
+    const int chunkCount = static_cast<int>(qBound<qint64>(1, payload / MIN_CHUNK_BYTES, maxChunks));
+    QVector<Chunk> chunks(chunkCount);
+    const char *cursor = begin;
+    for (int i = 0; i < chunkCount; ++i) {
+        const char *target = i == chunkCount - 1 ? end : qMax(cursor, begin + payload * (i + 1) / chunkCount);
+        if (target < end) {
+            const char *newline = static_cast<const char *>(std::memchr(target, '\n', end - target));
+            target = newline ? newline + 1 : end;
+        }
+        chunks[i].begin = cursor;
+        chunks[i].end = target;
+        cursor = target;
+    }
+
+    std::atomic<int> finished(0);
+    for (Chunk &chunk : chunks) {
+        m_parsePool.start([this, &chunk, &finished, generation, chunkCount, channelCount]() {
+            if (!isCurrent(generation)) {
+                return;
+            }
+            parseChunk(chunk, channelCount, generation);
+            const int done = ++finished;
+            QMetaObject::invokeMethod(this, [this, generation, done, chunkCount]() {
+                if (isCurrent(generation)) {
+                    m_progress = static_cast<double>(done) / chunkCount;
+                    emit progressChanged();
+                }
+            }, Qt::QueuedConnection);
+        });
+    }
+    m_parsePool.waitForDone();
+
+    if (!isCurrent(generation)) {
+        if (mapped) {
+            file.unmap(mapped);
+        }
+        return;
+    }
+
+    int rows = 0;
+    int skipped = 0;
+    for (const Chunk &chunk : std::as_const(chunks)) {
+        rows += chunk.columns.size();
+        skipped += chunk.skipped;
+    }
+    SessionColumns columns;
+    columns.timeMs.reserve(rows);
+    columns.channels.resize(channelCount);
+    for (QVector<double> &channel : columns.channels) {
+        channel.reserve(rows);
+    }
+    for (const Chunk &chunk : std::as_const(chunks)) {
+        columns.timeMs += chunk.columns.timeMs;
+        for (int c = 0; c < channelCount; ++c) {
+            columns.channels[c] += chunk.columns.channels.at(c);
+        }
+    }
+    chunks.clear();
+    if (mapped) {
+        file.unmap(mapped);
+    }
+
+    const double elapsedMs = clock.nsecsElapsed() / 1e6;
+    LOG_INFO(Log::Recorder, "会话导入: {}，{} 行（跳过 {}），{} 块，{:.1f} ms，{:.1f} MB/s",
+             filePath, rows, skipped, chunkCount, elapsedMs,
+             elapsedMs > 0.0 ? size / 1048576.0 / (elapsedMs / 1000.0) : 0.0);
+
+    QMetaObject::invokeMethod(this, [this, generation, filePath, columns, channelNames, skipped, size, chunkCount, elapsedMs]() {
+        if (!isCurrent(generation)) {
+            return;
+        }
+        m_columns = columns;
+        m_channelNames = channelNames;
+        m_source = filePath;
+        m_skipped = skipped;
+        m_bytes = size;
+        m_chunks = chunkCount;
+        m_elapsedMs = elapsedMs;
+        m_progress = 1.0;
+        setLoading(false);
+        emit progressChanged();
+        emit loadedChanged();
+        if (m_columns.size() > 0) {
+            emit loadFinished(true, QString());
+        } else if (skipped > 0) {
+            emit loadFinished(false, QStringLiteral("不支持的记录格式：%1 行均与表头的 %2 个数值列不符")
+                                         .arg(skipped).arg(m_channelNames.size()));
+        } else {
+            emit loadFinished(false, QStringLiteral("文件中没有可用记录"));
+        }
+    }, Qt::QueuedConnection);
+}
+
+/**
+ * @brief 解析一个数据块
+ * @details 行边界由memchr查找（C库按向量指令实现）；时间列按固定位置读取，
+ *          各数值列扫描一次直到分隔符。列数与表头不符或无法解析的行计入skipped，空行忽略
+ */
+void SessionImporter::parseChunk(Chunk &chunk, int channelCount, quint64 generation) const
+{
+    SessionColumns &columns = chunk.columns;
+    // 每行约为时间24字节加每列约8字节，预留避免反复扩容
+    const int estimate = static_cast<int>((chunk.end - chunk.begin) / (24 + 8 * channelCount));
+    columns.timeMs.reserve(estimate);
+    columns.channels.resize(channelCount);
+    for (QVector<double> &channel : columns.channels) {
+        channel.reserve(estimate);
+    }
+    QVarLengthArray<double, 16> row(channelCount);
+
+    const char *p = chunk.begin;
+    int sinceCheck = 0;
+    while (p < chunk.end) {
+        const char *newline = static_cast<const char *>(std::memchr(p, '\n', chunk.end - p));
+        const char *lineEnd = newline ? newline : chunk.end;
+        const char *next = newline ? newline + 1 : chunk.end;
+        if (lineEnd > p && lineEnd[-1] == '\r') {
+            --lineEnd;
+        }
+        const char *q = p;
+        p = next;
+        if (q == lineEnd) {
+            continue;
+        }
+        if (++sinceCheck == CANCEL_CHECK_ROWS) {
+            sinceCheck = 0;
+            if (!isCurrent(generation)) {
+                return;
+            }
+        }
+
+        if (*q == '\'') {
+            ++q;
+        }
+        if (lineEnd - q <= TIMESTAMP_WIDTH) {
+            ++chunk.skipped;
+            continue;
+        }
+        qint64 timeMs = parseTimestamp(q);
+        q += TIMESTAMP_WIDTH;
+        timeMs += parseMillis(q, lineEnd);
+        if (q == lineEnd || *q != ',') {
+            ++chunk.skipped;
+            continue;
+        }
+        ++q;
+        bool ok = timeMs >= 0;
+        for (int c = 0; c < channelCount && ok; ++c) {
+            ok = parseNumber(q, lineEnd, c == channelCount - 1, &row[c]);
+        }
+        if (!ok) {
+            ++chunk.skipped;
+            continue;
+        }
+        columns.timeMs.append(timeMs);
+        for (int c = 0; c < channelCount; ++c) {
+            columns.channels[c].append(row[c]);
+        }
+    }
+}
+
+int SessionImporter::channelIndex(const QString &name) const
+{
+    for (int i = 0; i < m_channelNames.size(); ++i) {
+        const QString &label = m_channelNames.at(i);
+        if (label == name || label.startsWith(name + QLatin1Char('('))) {
+            return i;
+        }
+    }
+    return -1;
+}
+
+QVariantList SessionImporter::values(int channel, int maxPoints) const
+{
+    const QVector<double> &source = m_columns.channel(channel);
+    const int n = source.size();
+    QVariantList result;
+    if (maxPoints <= 0 || n <= maxPoints) {
+        result.reserve(n);
+        for (double value : source) {
+            result.append(value);
+        }
+        return result;
+    }
+    result.reserve(maxPoints);
+    for (int bucket = 0; bucket < maxPoints; ++bucket) {
+        const int from = static_cast<int>(static_cast<qint64>(bucket) * n / maxPoints);
+        const int to = static_cast<int>(static_cast<qint64>(bucket + 1) * n / maxPoints);
+        double sum = 0.0;
+        for (int i = from; i < to; ++i) {
+            sum += source[i];
+        }
+        result.append(to > from ? sum / (to - from) : 0.0);
+    }
+    return result;
+}
+
+QVariantList SessionImporter::timeOffsets(int maxPoints) const
+{
+    const QVector<qint64> &times = m_columns.timeMs;
+    const int n = times.size();
+    QVariantList result;
+    if (n == 0) {
+        return result;
+    }
+    const qint64 first = times.first();
+    const int count = (maxPoints <= 0 || n <= maxPoints) ? n : maxPoints;
+    result.reserve(count);
+    for (int bucket = 0; bucket < count; ++bucket) {
+        const int from = static_cast<int>(static_cast<qint64>(bucket) * n / count);
+        result.append(times[from] - first);
+    }
+    return result;
+}
+
+QVariantMap SessionImporter::statistics() const
+{
+    QVariantMap stats;
+    stats["rows"] = m_columns.size();
+    stats["skipped"] = m_skipped;
+    stats["bytes"] = m_bytes;
+    stats["chunks"] = m_chunks;
+    stats["elapsedMs"] = m_elapsedMs;
+    stats["mbPerSecond"] = m_elapsedMs > 0.0 ? m_bytes / 1048576.0 / (m_elapsedMs / 1000.0) : 0.0;
+    return stats;
+}
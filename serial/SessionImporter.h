@@ -0,0 +1,171 @@
+#ifndef SESSIONIMPORTER_H
+#define SESSIONIMPORTER_H
+
+#include <QObject>
+#include <QVector>
+#include <QVariantList>
+#include <QVariantMap>
+#include <QStringList>
+#include <QThreadPool>
+#include <atomic>
+
+/**
+ * @brief 按列存放的会话数据
+ * @details timeMs只用于计算相对偏移（本地时间按儒略日折算），
+ *          channels与文件中时间列之后的数值列一一对应
+ */
+struct SessionColumns {
+    QVector<qint64> timeMs;
+    QVector<QVector<double>> channels;
+
+    int size() const { return timeMs.size(); }
+    int channelCount() const { return channels.size(); }
+
+    /**
+     * @brief 获取一个通道，超出范围时返回空列
+     */
+    const QVector<double> &channel(int index) const;
+};
+
+/**
+ * @brief CSV会话导入器
+ * @details 加载DataRecorder导出或流式写入的CSV，用于与实时波形叠加对比：
+ *          - 通道数由表头决定，与记录器的通道定义一致；状态字通道的"0x"十六进制值按整数读取
+ *          - 文件以内存映射方式读取，按换行边界切成若干块，在线程池中并行解析
+ *          - 时间列为固定宽度，直接按位置读取；数值列用定点解析器一次扫描到分隔符，
+ *            不构造中间字符串，格式不符时退回通用浮点解析
+ *          - 各块结果按顺序拼接为按列存储，供波形页按点数降采样后显示
+ *          加载在后台完成，期间界面不阻塞；重新加载会取消进行中的加载
+ */
+class SessionImporter : public QObject
+{
+    Q_OBJECT
+    /**
+     * @brief 已加载的文件
+     */
+    Q_PROPERTY(QString source READ source NOTIFY loadedChanged)
+
+    /**
+     * @brief 已加载的行数
+     */
+    Q_PROPERTY(int rowCount READ rowCount NOTIFY loadedChanged)
+
+    /**
+     * @brief 各数值列的表头（如"电压(V)"）
+     */
+    Q_PROPERTY(QStringList channelNames READ channelNames NOTIFY loadedChanged)
+
+    /**
+     * @brief 会话时长（毫秒）
+     */
+    Q_PROPERTY(qint64 durationMs READ durationMs NOTIFY loadedChanged)
+
+    /**
+     * @brief 是否正在加载
+     */
+    Q_PROPERTY(bool loading READ loading NOTIFY loadingChanged)
+
+    /**
+     * @brief 加载进度（0~1）
+     */
+    Q_PROPERTY(double progress READ progress NOTIFY progressChanged)
+
+public:
+    explicit SessionImporter(QObject *parent = nullptr);
+    ~SessionImporter();
+
+    QString source() const { return m_source; }
+    int rowCount() const { return m_columns.size(); }
+    QStringList channelNames() const { return m_channelNames; }
+    qint64 durationMs() const;
+    bool loading() const { return m_loading; }
+    double progress() const { return m_progress; }
+
+    /**
+     * @brief 在后台加载CSV会话
+     * @param filePath 会话文件（路径或file:// URL）
+     * @details 完成后发出loadFinished
+     */
+    Q_INVOKABLE void load(const QString &filePath);
+
+    /**
+     * @brief 取消进行中的加载
+     */
+    Q_INVOKABLE void cancel();
+
+    /**
+     * @brief 清空已加载的数据
+     */
+    Q_INVOKABLE void clear();
+
+    /**
+     * @brief 按通道名称查找数值列
+     * @param name 通道名称（不含单位，如"电压"）
+     * @return 列序号，不存在时返回-1
+     */
+    Q_INVOKABLE int channelIndex(const QString &name) const;
+
+    /**
+     * @brief 按点数降采样的通道数据
+     * @param channel 列序号（见channelNames），超出范围时返回空列表
+     * @param maxPoints 最多返回的点数，每点为所在区间的平均值；<=0时返回全部
+     */
+    Q_INVOKABLE QVariantList values(int channel, int maxPoints) const;
+
+    /**
+     * @brief 与values对应的时间偏移（毫秒，取区间起点）
+     */
+    Q_INVOKABLE QVariantList timeOffsets(int maxPoints) const;
+
+    /**
+     * @brief 获取加载统计
+     * @return 包含rows、skipped、bytes、chunks、elapsedMs、mbPerSecond字段
+     */
+    Q_INVOKABLE QVariantMap statistics() const;
+
+    const SessionColumns &columns() const { return m_columns; }
+
+signals:
+    void loadedChanged();
+    void loadingChanged();
+    void progressChanged();
+
+    /**
+     * @brief 加载结束
+     * @param success 是否至少读到一条记录
+     * @param error 失败原因
+     */
+    void loadFinished(bool success, const QString &error);
+
+private:
+    /**
+     * @brief 单个数据块的解析结果
+     */
+    struct Chunk {
+        const char *begin = nullptr;
+        const char *end = nullptr;
+        SessionColumns columns;
+        int skipped = 0;
+    };
+
+    void run(const QString &filePath, quint64 generation);
+    void parseChunk(Chunk &chunk, int channelCount, quint64 generation) const;
+    bool isCurrent(quint64 generation) const { return m_generation.load() == generation; }
+    void setLoading(bool loading);
+
+    QString m_source;
+    SessionColumns m_columns;
+    QStringList m_channelNames;
+    bool m_loading;
+    double m_progress;
+    int m_skipped;
+    qint64 m_bytes;
+    int m_chunks;
+    double m_elapsedMs;
+
+    std::atomic<quint64> m_generation;
+    QThreadPool m_loadPool;         ///< 协调加载（单线程）
+    QThreadPool m_parsePool;        ///< 并行解析数据块
+};
+
+#endif
@@ -0,0 +1,424 @@
+#include "SessionReplay.h"
+#include "RecordTable.h"
+#include "../core/Logger.h"
+#include <QFile>
+#include <QDate>
+#include <QTimer>
+#include <QByteArrayView>
+#include <algorithm>
+#include <cmath>
+
+namespace {
+
+/**
+ * @brief 最快速度回放时每次事件循环注入的样本数
+ * @details 分块注入使界面在回放期间仍能重绘与响应
+ */
+constexpr int MAX_SPEED_CHUNK = 2000;
+
+/**
+ * @brief 实时/倍速回放时位置更新的最长间隔（毫秒）
+ */
+constexpr int MAX_TICK_MS = 250;
+
+/**
+ * @brief 解析"yyyy-MM-dd HH:mm:ss"格式时间，可带".zzz"毫秒部分
+ * @return 毫秒数（只用于计算相对偏移），格式错误返回-1
+ */
+qint64 parseTimestamp(QByteArrayView text)
+{
+    if (text.size() < 19) {
+        return -1;
+    }
+    auto number = [&text](int pos, int digits) {
+        int value = 0;
+        for (int i = 0; i < digits; ++i) {
+            const char c = text[pos + i];
+            if (c < '0' || c > '9') {
+                return -1;
+            }
+            value = value * 10 + (c - '0');
+        }
+        return value;
+    };
+    const int year = number(0, 4);
+    const int month = number(5, 2);
+    const int day = number(8, 2);
+    const int hour = number(11, 2);
+    const int minute = number(14, 2);
+    const int second = number(17, 2);
+    if (year < 0 || month < 0 || day < 0 || hour < 0 || minute < 0 || second < 0) {
+        return -1;
+    }
+    const QDate date(year, month, day);
+    if (!date.isValid()) {
+        return -1;
+    }
+    int millis = 0;
+    if (text.size() > 19 && text[19] == '.') {
+        int digits = 0;
+        for (qsizetype i = 20; i < text.size() && digits < 3; ++i, ++digits) {
+            const char c = text[i];
+            if (c < '0' || c > '9') {
+                return -1;
+            }
+            millis = millis * 10 + (c - '0');
+        }
+        for (; digits < 3; ++digits) {
+            millis *= 10;
+        }
+    }
+    return date.toJulianDay() * 86400000LL + ((hour * 60LL + minute) * 60LL + second) * 1000LL + millis;
+}
+
+/**
+ * @brief 解析一个数值字段，状态字的"0x"十六进制值按整数读取
+ */
+double parseValue(QByteArrayView field, bool *ok)
+{
+    field = field.trimmed();
+    if (field.startsWith("0x") || field.startsWith("0X")) {
+        return static_cast<double>(field.sliced(2).toULongLong(ok, 16));
+    }
+    return field.toDouble(ok);
+}
+
+} // namespace
+
+SessionReplay::SessionReplay(QObject *parent)
+    : QObject(parent)
+    , m_modbusManager(nullptr)
+    , m_index(0)
+    , m_positionMs(0)
+    , m_speed(1.0)
+    , m_loop(false)
+    , m_playing(false)
+    , m_timer(nullptr)
+    , m_anchorOffsetMs(0)
+    , m_passSamples(0)
+    , m_replayedCount(0)
+    , m_lastPassSamples(0)
+    , m_lastPassMs(0.0)
+{
+    m_timer = new QTimer(this);
+    m_timer->setSingleShot(true);
+    m_timer->setTimerType(Qt::PreciseTimer);
+    connect(m_timer, &QTimer::timeout, this, &SessionReplay::onTick);
+}
+
+void SessionReplay::setModbusManager(ModbusManager *manager)
+{
+    if (m_modbusManager != manager) {
+        m_modbusManager = manager;
+        emit modbusManagerChanged();
+    }
+}
+
+void SessionReplay::setSpeed(double speed)
+{
+    speed = qMax(0.0, speed);
+    if (qFuzzyCompare(m_speed + 1.0, speed + 1.0)) {
+        return;
+    }
+    m_speed = speed;
+    if (m_playing) {
+        reanchor();
+        scheduleNext();
+    }
+    emit speedChanged();
+}
+
+void SessionReplay::setLoop(bool loop)
+{
+    if (m_loop != loop) {
+        m_loop = loop;
+        emit loopChanged();
+    }
+}
+
+/**
+ * @brief 加载DataRecorder保存的CSV会话
+ * @details 兼容导出报表与流式记录两种文件：跳过BOM与时间前的单引号，
+ *          按表头找到电压/电流/功率列（其余通道不参与回放），列数与表头不符或无法解析的行被忽略。
+ *          没有表头时按默认的三通道格式读取
+ */
+bool SessionReplay::load(const QString &filePath)
+{
+    pause();
+
+    QFile file(filePath);
+    if (!file.open(QIODevice::ReadOnly)) {
+        LOG_WARNING(Log::Recorder, "无法打开回放文件: {}", filePath);
+        emit errorOccurred(file.errorString());
+        return false;
+    }
+    const QByteArray data = file.readAll();
+    file.close();
+
+    QVector<ReplaySample> samples;
+    samples.reserve(data.count('\n') + 1);
+    qint64 firstMs = -1;
+    qsizetype pos = data.startsWith("\xEF\xBB\xBF") ? 3 : 0;
+
+    // 表头行以非数字、非单引号开头
+    int columnCount = 3;
+    int columns[3] = {0, 1, 2};     // 电压、电流、功率在数值列中的序号
+    if (pos < data.size() && data.at(pos) != '\'' && (data.at(pos) < '0' || data.at(pos) > '9')) {
+        qsizetype end = data.indexOf('\n', pos);
+        if (end < 0) {
+            end = data.size();
+        }
+        QStringList header = QString::fromUtf8(data.constData() + pos, end - pos).trimmed().split(',');
+        header.removeFirst();
+        pos = end + 1;
+
+        const QVector<RecordChannel> defaults = RecordTable::defaultChannels();
+        QStringList missing;
+        for (int i = 0; i < 3; ++i) {
+            const QString &name = defaults.at(i).name;
+            columns[i] = -1;
+            for (int c = 0; c < header.size() && columns[i] < 0; ++c) {
+                const QString label = header.at(c).trimmed();
+                if (label == name || label.startsWith(name + QLatin1Char('('))) {
+                    columns[i] = c;
+                }
+            }
+            if (columns[i] < 0) {
+                missing.append(name);
+            }
+        }
+        if (!missing.isEmpty()) {
+            const QString error = QStringLiteral("不支持的记录格式：缺少%1列").arg(missing.join(QStringLiteral("、")));
+            LOG_WARNING(Log::Recorder, "回放文件格式不支持: {} ({})", filePath, error);
+            emit errorOccurred(error);
+            return false;
+        }
+        columnCount = header.size();
+    }
+
+    QVector<QByteArrayView> fields(columnCount + 1);
+    int rejected = 0;
+    while (pos < data.size()) {
+        qsizetype end = data.indexOf('\n', pos);
+        if (end < 0) {
+            end = data.size();
+        }
+        QByteArrayView line(data.constData() + pos, end - pos);
+        pos = end + 1;
+        if (line.endsWith('\r')) {
+            line.chop(1);
+        }
+        if (line.startsWith('\'')) {
+            line = line.sliced(1);
+        }
+
+        if (line.isEmpty()) {
+            continue;
+        }
+
+        // 时间列加columnCount个数值列，多或少都视为格式不符
+        if (line.count(',') != columnCount) {
+            ++rejected;
+            continue;
+        }
+        qsizetype from = 0;
+        for (int i = 0; i <= columnCount; ++i) {
+            const qsizetype comma = i < columnCount ? line.indexOf(',', from) : line.size();
+            fields[i] = line.sliced(from, comma - from);
+            from = comma + 1;
+        }
+        const qint64 timeMs = parseTimestamp(fields[0]);
+        if (timeMs < 0) {
+            ++rejected;
+            continue;
+        }
+        ReplaySample sample;
+        bool okV = false, okC = false, okP = false;
+        sample.voltage = parseValue(fields[1 + columns[0]], &okV);
+        sample.current = parseValue(fields[1 + columns[1]], &okC);
+        sample.power = parseValue(fields[1 + columns[2]], &okP);
+        if (!okV || !okC || !okP) {
+            ++rejected;
+            continue;
+        }
+        if (firstMs < 0) {
+            firstMs = timeMs;
+        }
+        // 时间倒退（如跨夏令时或文件拼接）时按紧接上一条处理
+        sample.offsetMs = qMax(timeMs - firstMs, samples.isEmpty() ? 0 : samples.last().offsetMs);
+        samples.append(sample);
+    }
+
+    if (samples.isEmpty()) {
+        const QString error = rejected > 0
+                ? QStringLiteral("不支持的记录格式：%1 行均与表头的 %2 个数值列不符").arg(rejected).arg(columnCount)
+                : QStringLiteral("文件中没有可用记录");
+        LOG_WARNING(Log::Recorder, "回放文件中没有可用记录: {} ({})", filePath, error);
+        emit errorOccurred(error);
+        return false;
+    }
+
+    m_samples.swap(samples);
+    m_source = filePath;
+    m_index = 0;
+    m_positionMs = 0;
+    LOG_INFO(Log::Recorder, "已加载回放会话: {}，共 {} 条，时长 {} 秒", filePath, m_samples.size(), durationMs() / 1000);
+    emit loadedChanged();
+    emit positionChanged();
+    return true;
+}
+
+void SessionReplay::play()
+{
+    if (m_playing || m_samples.isEmpty()) {
+        return;
+    }
+    if (!m_modbusManager) {
+        emit errorOccurred(QStringLiteral("未设置注入目标"));
+        return;
+    }
+    if (m_index >= m_samples.size()) {
+        m_index = 0;
+        m_positionMs = 0;
+        emit positionChanged();
+    }
+
+    m_passClock.start();
+    m_passSamples = 0;
+    reanchor();
+    setPlaying(true);
+    scheduleNext();
+}
+
+void SessionReplay::pause()
+{
+    m_timer->stop();
+    setPlaying(false);
+}
+
+void SessionReplay::stop()
+{
+    pause();
+    seek(0);
+}
+
+void SessionReplay::seek(qint64 positionMs)
+{
+    positionMs = qBound<qint64>(0, positionMs, durationMs());
+    auto it = std::lower_bound(m_samples.cbegin(), m_samples.cend(), positionMs,
+                               [](const ReplaySample &sample, qint64 value) { return sample.offsetMs < value; });
+    m_index = static_cast<int>(it - m_samples.cbegin());
+    m_positionMs = positionMs;
+    emit positionChanged();
+
+    if (m_playing) {
+        reanchor();
+        scheduleNext();
+    }
+}
+
+QVariantMap SessionReplay::statistics() const
+{
+    QVariantMap stats;
+    stats["replayed"] = m_replayedCount;
+    stats["lastPassSamples"] = m_lastPassSamples;
+    stats["lastPassMs"] = m_lastPassMs;
+    stats["samplesPerSecond"] = m_lastPassMs > 0.0 ? m_lastPassSamples * 1000.0 / m_lastPassMs : 0.0;
+    return stats;
+}
+
+/**
+ * @brief 回放时钟推进
+ * @details 最快速度时每次注入一块样本后让出事件循环；
+ *          实时/倍速时注入所有已到期样本，再定时到下一条样本的到期时刻
+ */
+void SessionReplay::onTick()
+{
+    if (!m_playing || !m_modbusManager) {
+        return;
+    }
+
+    if (m_speed <= 0.0) {
+        const int end = qMin(static_cast<int>(m_samples.size()), m_index + MAX_SPEED_CHUNK);
+        m_passSamples += end - m_index;
+        for (; m_index < end; ++m_index) {
+            const ReplaySample &sample = m_samples.at(m_index);
+            m_modbusManager->injectSample(sample.voltage, sample.current, sample.power);
+        }
+        m_positionMs = m_samples.at(m_index - 1).offsetMs;
+    } else {
+        const qint64 sessionNow = m_anchorOffsetMs + static_cast<qint64>(m_anchorClock.elapsed() * m_speed);
+        while (m_index < m_samples.size() && m_samples.at(m_index).offsetMs <= sessionNow) {
+            const ReplaySample &sample = m_samples.at(m_index);
+            m_modbusManager->injectSample(sample.voltage, sample.current, sample.power);
+            ++m_index;
+            ++m_passSamples;
+        }
+        m_positionMs = qMin(sessionNow, durationMs());
+    }
+    emit positionChanged();
+
+    if (m_index >= m_samples.size()) {
+        handleEnd();
+    } else {
+        scheduleNext();
+    }
+}
+
+void SessionReplay::scheduleNext()
+{
+    if (!m_playing) {
+        return;
+    }
+    if (m_speed <= 0.0 || m_index >= m_samples.size()) {
+        m_timer->start(0);
+        return;
+    }
+    const qint64 sessionNow = m_anchorOffsetMs + static_cast<qint64>(m_anchorClock.elapsed() * m_speed);
+    const qint64 waitMs = static_cast<qint64>(std::ceil((m_samples.at(m_index).offsetMs - sessionNow) / m_speed));
+    m_timer->start(static_cast<int>(qBound<qint64>(0, waitMs, MAX_TICK_MS)));
+}
+
+/**
+ * @brief 以当前位置为起点重新对齐回放时钟
+ */
+void SessionReplay::reanchor()
+{
+    m_anchorOffsetMs = m_positionMs;
+    m_anchorClock.start();
+}
+
+void SessionReplay::handleEnd()
+{
+    const double elapsedMs = m_passClock.nsecsElapsed() / 1e6;
+    m_replayedCount += m_passSamples;
+    m_lastPassSamples = m_passSamples;
+    m_lastPassMs = elapsedMs;
+    if (m_speed <= 0.0) {
+        const double rate = elapsedMs > 0.0 ? m_passSamples * 1000.0 / elapsedMs : 0.0;
+        LOG_INFO(Log::Recorder, "最快速度回放: {} 条，耗时 {:.1f} ms，吞吐 {:.0f} 条/秒", m_passSamples, elapsedMs, rate);
+        emit benchmarkFinished(m_passSamples, elapsedMs, rate);
+    }
+
+    if (m_loop) {
+        m_index = 0;
+        m_positionMs = 0;
+        m_passSamples = 0;
+        m_passClock.start();
+        reanchor();
+        emit positionChanged();
+        scheduleNext();
+        return;
+    }
+
+    setPlaying(false);
+    emit finished();
+}
+
+void SessionReplay::setPlaying(bool playing)
+{
+    if (m_playing != playing) {
+        m_playing = playing;
+        emit playingChanged();
+    }
+}
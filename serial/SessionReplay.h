@@ -0,0 +1,175 @@
+#ifndef SESSIONREPLAY_H
+#define SESSIONREPLAY_H
+
+#include <QObject>
+#include <QVector>
+#include <QElapsedTimer>
+#include <QVariantMap>
+#include "ModbusManager.h"
+
+class QTimer;
+
+/**
+ * @brief 回放样本
+ * @details offsetMs为相对会话第一条记录的毫秒偏移
+ */
+struct ReplaySample {
+    qint64 offsetMs = 0;
+    double voltage = 0.0;
+    double current = 0.0;
+    double power = 0.0;
+};
+
+/**
+ * @brief 记录会话回放引擎
+ * @details 读取DataRecorder保存的CSV会话，经ModbusManager::injectSample按原始时间间隔
+ *          重新注入实时数据路径，波形历史、统计、报警与记录器的行为与连接真实设备时一致。
+ *          speed为0时以最快速度回放，每轮结束报告整条下游链路的吞吐量
+ */
+class SessionReplay : public QObject
+{
+    Q_OBJECT
+    /**
+     * @brief 注入目标
+     */
+    Q_PROPERTY(ModbusManager *modbusManager READ modbusManager WRITE setModbusManager NOTIFY modbusManagerChanged)
+
+    /**
+     * @brief 已加载的会话文件
+     */
+    Q_PROPERTY(QString source READ source NOTIFY loadedChanged)
+
+    /**
+     * @brief 已加载的样本数
+     */
+    Q_PROPERTY(int sampleCount READ sampleCount NOTIFY loadedChanged)
+
+    /**
+     * @brief 会话时长（毫秒）
+     */
+    Q_PROPERTY(qint64 durationMs READ durationMs NOTIFY loadedChanged)
+
+    /**
+     * @brief 当前回放位置（毫秒）
+     */
+    Q_PROPERTY(qint64 positionMs READ positionMs NOTIFY positionChanged)
+
+    /**
+     * @brief 回放倍速
+     * @details 1为实时，N为N倍速，0为最快速度
+     */
+    Q_PROPERTY(double speed READ speed WRITE setSpeed NOTIFY speedChanged)
+
+    /**
+     * @brief 到达末尾后是否从头循环
+     */
+    Q_PROPERTY(bool loop READ loop WRITE setLoop NOTIFY loopChanged)
+
+    /**
+     * @brief 是否正在回放
+     */
+    Q_PROPERTY(bool playing READ playing NOTIFY playingChanged)
+
+public:
+    explicit SessionReplay(QObject *parent = nullptr);
+
+    ModbusManager *modbusManager() const { return m_modbusManager; }
+    void setModbusManager(ModbusManager *manager);
+    QString source() const { return m_source; }
+    int sampleCount() const { return m_samples.size(); }
+    qint64 durationMs() const { return m_samples.isEmpty() ? 0 : m_samples.last().offsetMs; }
+    qint64 positionMs() const { return m_positionMs; }
+    double speed() const { return m_speed; }
+    void setSpeed(double speed);
+    bool loop() const { return m_loop; }
+    void setLoop(bool loop);
+    bool playing() const { return m_playing; }
+
+    /**
+     * @brief 加载DataRecorder保存的CSV会话
+     * @param filePath 会话文件
+     * @return 是否至少读到一条记录
+     */
+    Q_INVOKABLE bool load(const QString &filePath);
+
+    /**
+     * @brief 从当前位置开始回放，已到末尾时从头开始
+     */
+    Q_INVOKABLE void play();
+
+    /**
+     * @brief 暂停，保留当前位置
+     */
+    Q_INVOKABLE void pause();
+
+    /**
+     * @brief 停止并回到开头
+     */
+    Q_INVOKABLE void stop();
+
+    /**
+     * @brief 跳转到指定位置
+     * @param positionMs 相对会话开头的毫秒数
+     */
+    Q_INVOKABLE void seek(qint64 positionMs);
+
+    /**
+     * @brief 获取回放统计
+     * @return 包含replayed、lastPassSamples、lastPassMs、samplesPerSecond字段
+     */
+    Q_INVOKABLE QVariantMap statistics() const;
+
+signals:
+    void modbusManagerChanged();
+    void loadedChanged();
+    void positionChanged();
+    void speedChanged();
+    void loopChanged();
+    void playingChanged();
+
+    /**
+     * @brief 非循环回放到达末尾信号
+     */
+    void finished();
+
+    /**
+     * @brief 最快速度回放完成一轮信号
+     * @param samples 本轮注入的样本数
+     * @param elapsedMs 本轮耗时（含全部下游处理）
+     * @param samplesPerSecond 下游链路吞吐量
+     */
+    void benchmarkFinished(int samples, double elapsedMs, double samplesPerSecond);
+
+    /**
+     * @brief 错误信号
+     */
+    void errorOccurred(const QString &error);
+
+private slots:
+    void onTick();
+
+private:
+    void scheduleNext();
+    void reanchor();
+    void handleEnd();
+    void setPlaying(bool playing);
+
+    ModbusManager *m_modbusManager;
+    QString m_source;
+    QVector<ReplaySample> m_samples;
+    int m_index;
+    qint64 m_positionMs;
+    double m_speed;
+    bool m_loop;
+    bool m_playing;
+    QTimer *m_timer;
+    QElapsedTimer m_anchorClock;
+    qint64 m_anchorOffsetMs;
+    QElapsedTimer m_passClock;
+    int m_passSamples;
+    qint64 m_replayedCount;
+    int m_lastPassSamples;
+    double m_lastPassMs;
+};
+
+#endif
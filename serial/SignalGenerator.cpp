@@ -0,0 +1,373 @@
+#include "SignalGenerator.h"
+#include "../core/Logger.h"
+#include "../core/SampleClock.h"
+#include <QTimer>
+#include <QMutexLocker>
+#include <QMetaMethod>
+#include <QtMath>
+#include <cmath>
+
+namespace {
+
+/**
+ * @brief 生成定时器周期（毫秒）
+ * @details 每次触发补齐按采样率应生成的全部样本
+ */
+constexpr int GENERATE_TICK_MS = 1;
+
+/**
+ * @brief 单次触发最多补齐的时长（毫秒）
+ * @details 下游处理不过来时超出部分直接跳过并计入lagged，避免越积越多
+ */
+constexpr int MAX_CATCH_UP_MS = 50;
+
+constexpr int MAX_SAMPLE_RATE = 10000;
+constexpr int MAX_CHANNELS = 16;
+
+} // namespace
+
+void LatencyStats::add(qint64 ns)
+{
+    if (count == 0 || ns < minNs) {
+        minNs = ns;
+    }
+    maxNs = qMax(maxNs, ns);
+    sumNs += ns;
+    ++count;
+}
+
+QVariantMap LatencyStats::toMap() const
+{
+    QVariantMap map;
+    map["count"] = count;
+    map["avgUs"] = count > 0 ? sumNs / count / 1000 : 0;
+    map["minUs"] = minNs / 1000;
+    map["maxUs"] = maxNs / 1000;
+    return map;
+}
+
+SignalGenerator::SignalGenerator(QObject *parent)
+    : QObject(parent)
+    , m_modbusManager(nullptr)
+    , m_dataRecorder(nullptr)
+    , m_sampleRate(1000)
+    , m_burstIntervalMs(0)
+    , m_burstDurationMs(100)
+    , m_burstGain(2.0)
+    , m_running(false)
+    , m_timer(nullptr)
+    , m_runStartNs(0)
+    , m_generated(0)
+    , m_startSequence(0)
+    , m_lagged(0)
+    , m_random(std::random_device{}())
+    , m_normal(0.0, 1.0)
+    , m_lastInjectedSequence(0)
+    , m_plottedNs(0)
+    , m_lastPlottedNs(0)
+{
+    // 默认前三个通道模拟电压、电流、功率
+    m_channels.resize(3);
+    m_channels[0] = {Sine, 220.0, 10.0, 1.0, 0.5, 0.0};
+    m_channels[1] = {Sine, 10.0, 2.0, 1.0, 0.05, 0.0};
+    m_channels[2] = {Triangle, 2.2, 0.2, 0.5, 0.005, 0.0};
+
+    m_timer = new QTimer(this);
+    m_timer->setTimerType(Qt::PreciseTimer);
+    m_timer->setInterval(GENERATE_TICK_MS);
+    connect(m_timer, &QTimer::timeout, this, &SignalGenerator::generate);
+}
+
+SignalGenerator::~SignalGenerator()
+{
+    stop();
+}
+
+void SignalGenerator::setModbusManager(ModbusManager *manager)
+{
+    if (m_modbusManager != manager) {
+        m_modbusManager = manager;
+        emit modbusManagerChanged();
+    }
+}
+
+void SignalGenerator::setDataRecorder(DataRecorder *recorder)
+{
+    if (m_dataRecorder == recorder) {
+        return;
+    }
+    if (m_dataRecorder) {
+        disconnect(m_dataRecorder, &DataRecorder::rowAppended, this, &SignalGenerator::onRecordWritten);
+    }
+    m_dataRecorder = recorder;
+    if (m_dataRecorder) {
+        connect(m_dataRecorder, &DataRecorder::rowAppended, this, &SignalGenerator::onRecordWritten);
+    }
+    emit dataRecorderChanged();
+}
+
+void SignalGenerator::setSampleRate(int rate)
+{
+    rate = qBound(1, rate, MAX_SAMPLE_RATE);
+    if (m_sampleRate == rate) {
+        return;
+    }
+    m_sampleRate = rate;
+    // 以当前时刻为新起点重新计算应生成的样本数
+    if (m_running) {
+        m_clock.start();
+        m_generated = 0;
+    }
+    emit sampleRateChanged();
+}
+
+void SignalGenerator::setChannelCount(int count)
+{
+    count = qBound(1, count, MAX_CHANNELS);
+    if (m_channels.size() == count) {
+        return;
+    }
+    const int oldCount = m_channels.size();
+    m_channels.resize(count);
+    for (int i = oldCount; i < count; ++i) {
+        m_channels[i] = {Sine, 0.0, 1.0, 1.0 + i, 0.0, 0.0};
+    }
+    emit channelCountChanged();
+}
+
+void SignalGenerator::setBurstIntervalMs(int intervalMs)
+{
+    intervalMs = qMax(0, intervalMs);
+    if (m_burstIntervalMs != intervalMs) {
+        m_burstIntervalMs = intervalMs;
+        emit burstChanged();
+    }
+}
+
+void SignalGenerator::setBurstDurationMs(int durationMs)
+{
+    durationMs = qMax(1, durationMs);
+    if (m_burstDurationMs != durationMs) {
+        m_burstDurationMs = durationMs;
+        emit burstChanged();
+    }
+}
+
+void SignalGenerator::setBurstGain(double gain)
+{
+    if (!qFuzzyCompare(m_burstGain, gain)) {
+        m_burstGain = gain;
+        emit burstChanged();
+    }
+}
+
+void SignalGenerator::setChannel(int channel, int shape, double offset, double amplitude, double frequencyHz, double noise)
+{
+    if (channel < 0 || channel >= m_channels.size()) {
+        return;
+    }
+    SignalChannel &c = m_channels[channel];
+    c.shape = qBound(static_cast<int>(Sine), shape, static_cast<int>(RandomWalk));
+    c.offset = offset;
+    c.amplitude = amplitude;
+    c.frequencyHz = qMax(0.0, frequencyHz);
+    c.noise = qMax(0.0, noise);
+    c.walk = 0.0;
+}
+
+void SignalGenerator::start()
+{
+    if (m_running) {
+        return;
+    }
+    m_generated = 0;
+    m_startSequence = m_lastInjectedSequence.load(std::memory_order_relaxed);
+    m_runStartNs.store(SampleClock::nowNs(), std::memory_order_relaxed);
+    m_plottedNs.store(0, std::memory_order_relaxed);
+    m_lastPlottedNs = 0;
+    m_clock.start();
+    m_runClock.start();
+    m_timer->start();
+    m_running = true;
+    LOG_INFO(Log::General, "signal generator started: {} Hz, {} channels", m_sampleRate, m_channels.size());
+    emit runningChanged();
+}
+
+void SignalGenerator::stop()
+{
+    if (!m_running) {
+        return;
+    }
+    m_timer->stop();
+    m_running = false;
+    LOG_INFO(Log::General, "signal generator stopped, lagged {} samples", m_lagged);
+    emit runningChanged();
+}
+
+/**
+ * @brief 测量到画面的延迟
+ * @details 直接连接到窗口的frameSwapped信号，在渲染线程中计算，不受界面线程排队影响；
+ *          只依赖信号名，串口模块无需链接QtQuick
+ */
+void SignalGenerator::trackWindow(QObject *window)
+{
+    if (m_trackedWindow) {
+        disconnect(m_trackedWindow, SIGNAL(frameSwapped()), this, SLOT(onFrameSwapped()));
+    }
+    m_trackedWindow = window;
+    if (window && !connect(window, SIGNAL(frameSwapped()), this, SLOT(onFrameSwapped()), Qt::DirectConnection)) {
+        LOG_WARNING(Log::General, "signal generator: object has no frameSwapped() signal");
+        m_trackedWindow = nullptr;
+    }
+}
+
+void SignalGenerator::markPlotted(double sampleTimeUs)
+{
+    const qint64 timestampNs = SampleClock::fromOffsetUs(sampleTimeUs);
+    // 图表可能因其他原因刷新，只接受本次运行中更新的样本
+    if (!m_running || timestampNs <= m_lastPlottedNs
+            || timestampNs < m_runStartNs.load(std::memory_order_relaxed)) {
+        return;
+    }
+    m_lastPlottedNs = timestampNs;
+    m_plottedNs.store(timestampNs, std::memory_order_release);
+}
+
+QVariantMap SignalGenerator::statistics() const
+{
+    QVariantMap stats;
+    stats["generated"] = m_lastInjectedSequence.load(std::memory_order_relaxed);
+    stats["lagged"] = m_lagged;
+    const qint64 elapsedMs = m_running ? m_runClock.elapsed() : 0;
+    const qint64 emitted = m_lastInjectedSequence.load(std::memory_order_relaxed) - m_startSequence;
+    stats["actualRate"] = elapsedMs > 0 ? emitted * 1000.0 / elapsedMs : 0.0;
+    QMutexLocker locker(&m_statsMutex);
+    stats["pixelLatency"] = m_pixelLatency.toMap();
+    stats["diskLatency"] = m_diskLatency.toMap();
+    return stats;
+}
+
+void SignalGenerator::resetStatistics()
+{
+    m_lagged = 0;
+    QMutexLocker locker(&m_statsMutex);
+    m_pixelLatency = LatencyStats();
+    m_diskLatency = LatencyStats();
+}
+
+/**
+ * @brief 补齐到当前时刻应生成的样本
+ * @details 每个样本单独注入，与总线采样走完全相同的下游路径
+ */
+void SignalGenerator::generate()
+{
+    const qint64 elapsedNs = m_clock.nsecsElapsed();
+    const qint64 target = elapsedNs / 1000 * m_sampleRate / 1000000;
+    qint64 due = target - m_generated;
+    const qint64 maxDue = qMax<qint64>(1, static_cast<qint64>(m_sampleRate) * MAX_CATCH_UP_MS / 1000);
+    if (due > maxDue) {
+        m_lagged += due - maxDue;
+        m_generated += due - maxDue;
+        due = maxDue;
+    }
+
+    const bool wantFrames = isSignalConnected(QMetaMethod::fromSignal(&SignalGenerator::frameReady));
+    m_values.resize(m_channels.size());
+    for (qint64 i = 0; i < due; ++i) {
+        const double t = static_cast<double>(m_generated) / m_sampleRate;
+        const bool burst = m_burstIntervalMs > 0
+                && std::fmod(t * 1000.0, static_cast<double>(m_burstIntervalMs)) < m_burstDurationMs;
+        for (int c = 0; c < m_channels.size(); ++c) {
+            m_values[c] = channelValue(m_channels[c], t, burst);
+        }
+        ++m_generated;
+
+        const double voltage = m_values.value(0);
+        const double current = m_values.value(1);
+        const double power = m_values.value(2);
+        // 每个样本携带自己的生成时刻，延迟按实际上图/落盘的那个样本计算
+        const qint64 generatedNs = SampleClock::nowNs();
+        m_lastInjectedSequence.fetch_add(1, std::memory_order_relaxed);
+        if (m_modbusManager) {
+            m_modbusManager->injectSample(voltage, current, power, generatedNs);
+        }
+        if (m_dataRecorder) {
+            m_dataRecorder->addData(voltage, current, power, generatedNs);
+        }
+        if (wantFrames) {
+            QVariantList values;
+            values.reserve(m_values.size());
+            for (double v : std::as_const(m_values)) {
+                values.append(v);
+            }
+            emit frameReady(t * 1000.0, values);
+        }
+    }
+}
+
+double SignalGenerator::channelValue(SignalChannel &channel, double t, bool burst)
+{
+    const double phase = t * channel.frequencyHz;
+    const double frac = phase - std::floor(phase);
+    double shape = 0.0;
+    switch (channel.shape) {
+    case Sine:
+        shape = std::sin(2.0 * M_PI * phase);
+        break;
+    case Square:
+        shape = frac < 0.5 ? 1.0 : -1.0;
+        break;
+    case Triangle:
+        shape = 4.0 * std::abs(frac - 0.5) - 1.0;
+        break;
+    case Sawtooth:
+        shape = 2.0 * frac - 1.0;
+        break;
+    case RandomWalk:
+        channel.walk = qBound(-1.0, channel.walk + 0.01 * m_normal(m_random), 1.0);
+        shape = channel.walk;
+        break;
+    default:
+        break;
+    }
+
+    double value = channel.offset + channel.amplitude * shape;
+    if (burst) {
+        value += channel.amplitude * m_burstGain;
+    }
+    if (channel.noise > 0.0) {
+        value += channel.noise * m_normal(m_random);
+    }
+    return value;
+}
+
+/**
+ * @brief 窗口帧交换（渲染线程）
+ * @details markPlotted之后的第一次帧交换即为包含该样本的帧，延迟为帧交换时刻减去样本的生成时刻；
+ *          图表没有更新的帧不计入
+ */
+void SignalGenerator::onFrameSwapped()
+{
+    const qint64 plottedNs = m_plottedNs.exchange(0, std::memory_order_acquire);
+    if (plottedNs == 0) {
+        return;
+    }
+    const qint64 latency = SampleClock::nowNs() - plottedNs;
+    QMutexLocker locker(&m_statsMutex);
+    m_pixelLatency.add(latency);
+}
+
+/**
+ * @brief 记录器写入一行
+ * @param timestampNs 该行样本的生成时刻
+ * @details DataRecorder在流式写入并刷新文件后才发出rowAppended
+ */
+void SignalGenerator::onRecordWritten(qint64 timestampNs)
+{
+    if (!m_running || timestampNs < m_runStartNs.load(std::memory_order_relaxed)) {
+        return;
+    }
+    const qint64 latency = SampleClock::nowNs() - timestampNs;
+    QMutexLocker locker(&m_statsMutex);
+    m_diskLatency.add(latency);
+}
@@ -0,0 +1,229 @@
+#ifndef SIGNALGENERATOR_H
+#define SIGNALGENERATOR_H
+
+#include <QObject>
+#include <QVector>
+#include <QVariantList>
+#include <QVariantMap>
+#include <QElapsedTimer>
+#include <QMutex>
+#include <QPointer>
+#include <atomic>
+#include <random>
+#include "ModbusManager.h"
+#include "DataRecorder.h"
+
+class QTimer;
+
+/**
+ * @brief 合成信号通道配置
+ */
+struct SignalChannel {
+    int shape = 0;              ///< SignalGenerator::Shape
+    double offset = 0.0;
+    double amplitude = 1.0;
+    double frequencyHz = 1.0;
+    double noise = 0.0;         ///< 高斯噪声标准差
+    double walk = 0.0;          ///< 随机游走当前值
+};
+
+/**
+ * @brief 延迟统计
+ */
+struct LatencyStats {
+    qint64 count = 0;
+    qint64 sumNs = 0;
+    qint64 maxNs = 0;
+    qint64 minNs = 0;
+
+    void add(qint64 ns);
+    QVariantMap toMap() const;
+};
+
+/**
+ * @brief 合成高速信号源
+ * @details 以最高10kHz的采样率生成多通道合成信号，前三个通道经ModbusManager::injectSample
+ *          作为电压/电流/功率注入实时数据路径，全部通道另经frameReady输出。
+ *          每个样本在生成时以SampleClock打时间戳并随sampleReady与记录行传递，
+ *          据此测量样本从生成到出现在画面上（窗口帧交换）以及到写入记录文件的端到端延迟，
+ *          用于在总线速率之外对波形页、图表与记录器做压力测试
+ */
+class SignalGenerator : public QObject
+{
+    Q_OBJECT
+    /**
+     * @brief 注入目标（电压/电流/功率取前三个通道）
+     */
+    Q_PROPERTY(ModbusManager *modbusManager READ modbusManager WRITE setModbusManager NOTIFY modbusManagerChanged)
+
+    /**
+     * @brief 记录器，设置后生成器以样本的生成时刻直接喂数，并按记录器写出的每一行测量到文件的延迟
+     * @details 记录器interval为0并开启流式写入时每个样本一行，测得的是每个样本的落盘延迟
+     */
+    Q_PROPERTY(DataRecorder *dataRecorder READ dataRecorder WRITE setDataRecorder NOTIFY dataRecorderChanged)
+
+    /**
+     * @brief 采样率（1~10000 Hz）
+     */
+    Q_PROPERTY(int sampleRate READ sampleRate WRITE setSampleRate NOTIFY sampleRateChanged)
+
+    /**
+     * @brief 通道数（1~16）
+     */
+    Q_PROPERTY(int channelCount READ channelCount WRITE setChannelCount NOTIFY channelCountChanged)
+
+    /**
+     * @brief 突发周期（毫秒），0表示不产生突发
+     */
+    Q_PROPERTY(int burstIntervalMs READ burstIntervalMs WRITE setBurstIntervalMs NOTIFY burstChanged)
+
+    /**
+     * @brief 突发持续时间（毫秒）
+     */
+    Q_PROPERTY(int burstDurationMs READ burstDurationMs WRITE setBurstDurationMs NOTIFY burstChanged)
+
+    /**
+     * @brief 突发期间各通道叠加的幅值倍数（相对通道amplitude）
+     */
+    Q_PROPERTY(double burstGain READ burstGain WRITE setBurstGain NOTIFY burstChanged)
+
+    /**
+     * @brief 是否正在生成
+     */
+    Q_PROPERTY(bool running READ running NOTIFY runningChanged)
+
+public:
+    /**
+     * @brief 波形
+     */
+    enum Shape {
+        Sine = 0,
+        Square = 1,
+        Triangle = 2,
+        Sawtooth = 3,
+        Constant = 4,
+        RandomWalk = 5
+    };
+    Q_ENUM(Shape)
+
+    explicit SignalGenerator(QObject *parent = nullptr);
+    ~SignalGenerator();
+
+    ModbusManager *modbusManager() const { return m_modbusManager; }
+    void setModbusManager(ModbusManager *manager);
+    DataRecorder *dataRecorder() const { return m_dataRecorder; }
+    void setDataRecorder(DataRecorder *recorder);
+    int sampleRate() const { return m_sampleRate; }
+    void setSampleRate(int rate);
+    int channelCount() const { return m_channels.size(); }
+    void setChannelCount(int count);
+    int burstIntervalMs() const { return m_burstIntervalMs; }
+    void setBurstIntervalMs(int intervalMs);
+    int burstDurationMs() const { return m_burstDurationMs; }
+    void setBurstDurationMs(int durationMs);
+    double burstGain() const { return m_burstGain; }
+    void setBurstGain(double gain);
+    bool running() const { return m_running; }
+
+    /**
+     * @brief 配置通道
+     * @param channel 通道编号
+     * @param shape 波形（Shape）
+     * @param offset 直流偏置
+     * @param amplitude 幅值
+     * @param frequencyHz 频率
+     * @param noise 高斯噪声标准差
+     */
+    Q_INVOKABLE void setChannel(int channel, int shape, double offset, double amplitude, double frequencyHz, double noise = 0.0);
+
+    /**
+     * @brief 开始生成
+     */
+    Q_INVOKABLE void start();
+
+    /**
+     * @brief 停止生成
+     */
+    Q_INVOKABLE void stop();
+
+    /**
+     * @brief 测量到画面的延迟
+     * @param window 显示波形的QQuickWindow，在其渲染线程的帧交换时刻计算已上图样本的延迟
+     */
+    Q_INVOKABLE void trackWindow(QObject *window);
+
+    /**
+     * @brief 报告图表已更新到某个样本
+     * @param sampleTimeUs 图表中最新样本的生成时刻，取自ModbusManager::sampleTimeUs()
+     *                     （相对SampleClock时间原点的微秒，QML中不丢失精度）
+     * @details 由界面在图表数据更新后调用（如WaveformDataManager::dataUpdated），
+     *          其后第一次帧交换即为包含该样本的帧；界面的合并刷新等待也计入延迟
+     */
+    Q_INVOKABLE void markPlotted(double sampleTimeUs);
+
+    /**
+     * @brief 获取统计
+     * @return 包含generated、lagged、actualRate、pixelLatency、diskLatency字段，
+     *         延迟字段为包含count、avgUs、minUs、maxUs的映射；
+     *         pixelLatency为样本生成到包含它的帧交换的时间，diskLatency为样本生成到其所在行写入文件的时间
+     */
+    Q_INVOKABLE QVariantMap statistics() const;
+
+    /**
+     * @brief 清零统计
+     */
+    Q_INVOKABLE void resetStatistics();
+
+signals:
+    void modbusManagerChanged();
+    void dataRecorderChanged();
+    void sampleRateChanged();
+    void channelCountChanged();
+    void burstChanged();
+    void runningChanged();
+
+    /**
+     * @brief 全部通道的样本信号（与ModbusBusPool::frameReady格式一致）
+     * @param timeMs 样本时刻（相对开始的毫秒数）
+     * @param values 各通道值
+     * @details 仅在有连接时构造参数
+     */
+    void frameReady(double timeMs, const QVariantList &values);
+
+private slots:
+    void generate();
+    void onFrameSwapped();
+    void onRecordWritten(qint64 timestampNs);
+
+private:
+    double channelValue(SignalChannel &channel, double t, bool burst);
+
+    ModbusManager *m_modbusManager;
+    DataRecorder *m_dataRecorder;
+    QVector<SignalChannel> m_channels;
+    int m_sampleRate;
+    int m_burstIntervalMs;
+    int m_burstDurationMs;
+    double m_burstGain;
+    bool m_running;
+    QTimer *m_timer;
+    QElapsedTimer m_clock;
+    QElapsedTimer m_runClock;
+    std::atomic<qint64> m_runStartNs;       ///< 本次运行的开始时刻，早于它的样本不计入延迟
+    qint64 m_generated;
+    qint64 m_startSequence;
+    qint64 m_lagged;
+    std::mt19937 m_random;
+    std::normal_distribution<double> m_normal;
+    QVector<double> m_values;
+
+    QPointer<QObject> m_trackedWindow;
+    std::atomic<qint64> m_lastInjectedSequence;
+    std::atomic<qint64> m_plottedNs;        ///< 已上图但尚未显示的最新样本时刻，0表示没有
+    qint64 m_lastPlottedNs;
+    mutable QMutex m_statsMutex;
+    LatencyStats m_pixelLatency;
+    LatencyStats m_diskLatency;
+};
+
+#endif
@@ -0,0 +1,417 @@
+#include "TriggerCapture.h"
+#include "../core/Logger.h"
+#include <QFile>
+#include <QDataStream>
+#include <QtMath>
+
+/**
+ * @brief 构造函数
+ * @param parent 父对象
+ */
+TriggerCapture::TriggerCapture(QObject *parent)
+    : QObject(parent)
+    , m_modbusManager(nullptr)
+    , m_triggerSource(VoltageLevel)
+    , m_triggerEdge(RisingEdge)
+    , m_triggerLevel(0.0)
+    , m_captureChannels(ModbusManager::VoltageChannel | ModbusManager::CurrentChannel | ModbusManager::PowerChannel)
+    , m_preTriggerSamples(200)
+    , m_postTriggerSamples(500)
+    , m_state(Idle)
+    , m_ringHead(0)
+    , m_ringCount(0)
+    , m_triggerIndex(-1)
+    , m_previousHighTemp(0)
+    , m_hasPrevious(false)
+{
+    resetRing();
+}
+
+void TriggerCapture::setModbusManager(ModbusManager *manager)
+{
+    if (m_modbusManager == manager) {
+        return;
+    }
+
+    if (m_modbusManager) {
+        disconnect(m_modbusManager, nullptr, this, nullptr);
+        if (m_state == Armed || m_state == Triggered) {
+            m_modbusManager->stopBurstReading();
+            setState(Idle);
+        }
+    }
+
+    m_modbusManager = manager;
+    m_hasPrevious = false;
+    resetRing();
+
+    if (m_modbusManager) {
+        connect(m_modbusManager, &ModbusManager::sampleReady, this, &TriggerCapture::onSampleReady);
+        connect(m_modbusManager, &ModbusManager::burstActiveChanged, this, &TriggerCapture::onAcquisitionChanged);
+        connect(m_modbusManager, &ModbusManager::connectedChanged, this, &TriggerCapture::onAcquisitionChanged);
+    }
+    emit modbusManagerChanged();
+}
+
+void TriggerCapture::setTriggerSource(int source)
+{
+    if (m_triggerSource != source && source >= VoltageLevel && source <= HighTempEdge) {
+        m_triggerSource = source;
+        emit triggerSourceChanged();
+    }
+}
+
+void TriggerCapture::setTriggerEdge(int edge)
+{
+    if (m_triggerEdge != edge && edge >= RisingEdge && edge <= AnyEdge) {
+        m_triggerEdge = edge;
+        emit triggerEdgeChanged();
+    }
+}
+
+void TriggerCapture::setTriggerLevel(double level)
+{
+    if (!qFuzzyCompare(m_triggerLevel + 1.0, level + 1.0)) {
+        m_triggerLevel = level;
+        emit triggerLevelChanged();
+    }
+}
+
+void TriggerCapture::setCaptureChannels(int mask)
+{
+    mask &= ModbusManager::AllChannels;
+    if (m_captureChannels != mask && mask != 0) {
+        m_captureChannels = mask;
+        emit captureChannelsChanged();
+    }
+}
+
+void TriggerCapture::setPreTriggerSamples(int count)
+{
+    if (m_preTriggerSamples != count && count >= 0) {
+        m_preTriggerSamples = count;
+        resetRing();
+        emit preTriggerSamplesChanged();
+    }
+}
+
+void TriggerCapture::setPostTriggerSamples(int count)
+{
+    if (m_postTriggerSamples != count && count > 0) {
+        m_postTriggerSamples = count;
+        emit postTriggerSamplesChanged();
+    }
+}
+
+/**
+ * @brief 布防
+ * @details 预触发窗口保持不变，直接进入突发轮询等待触发
+ */
+bool TriggerCapture::arm()
+{
+    if (!m_modbusManager || m_state == Armed || m_state == Triggered) {
+        return false;
+    }
+    // 阈值为0时任意两个样本都满足阶跃条件，布防即触发
+    if (m_triggerSource == CurrentStep && m_triggerLevel <= 0.0) {
+        LOG_WARNING(Log::Recorder, "电流阶跃触发阈值必须大于0，当前为 {}", m_triggerLevel);
+        return false;
+    }
+
+    setState(Armed);
+    m_modbusManager->startBurstReading(burstMask());
+    // 未连接时突发轮询不会启动，保持布防只会永远等不到样本
+    if (!m_modbusManager->burstActive()) {
+        setState(Idle);
+        LOG_WARNING(Log::Recorder, "突发轮询未能启动，触发捕获未布防");
+        return false;
+    }
+    LOG_INFO(Log::Recorder, "触发捕获已布防，触发源: {} 电平: {}", m_triggerSource, m_triggerLevel);
+    return true;
+}
+
+/**
+ * @brief 撤防
+ */
+void TriggerCapture::disarm()
+{
+    if (m_state != Armed && m_state != Triggered) {
+        return;
+    }
+
+    // 先回到空闲，随后的burstActiveChanged不再重复撤防
+    const bool triggered = m_state == Triggered;
+    setState(Idle);
+    if (m_modbusManager) {
+        m_modbusManager->stopBurstReading();
+    }
+    // 未完成的后触发窗口丢弃
+    if (triggered) {
+        m_capture.clear();
+        m_triggerIndex = -1;
+        emit captureChanged();
+    }
+}
+
+void TriggerCapture::clearCapture()
+{
+    if (m_state == Triggered) {
+        return;
+    }
+
+    m_capture.clear();
+    m_triggerIndex = -1;
+    if (m_state == Captured) {
+        setState(Idle);
+    }
+    emit captureChanged();
+}
+
+QVariantList TriggerCapture::capturedValues(int channel) const
+{
+    QVariantList values;
+    values.reserve(m_capture.size());
+    for (const DataRecord &record : m_capture) {
+        switch (channel) {
+        case 0: values.append(record.voltage); break;
+        case 1: values.append(record.current); break;
+        case 2: values.append(record.power); break;
+        default: break;
+        }
+    }
+    return values;
+}
+
+QVariantList TriggerCapture::capturedTimeOffsets() const
+{
+    QVariantList offsets;
+    if (m_triggerIndex < 0 || m_triggerIndex >= m_capture.size()) {
+        return offsets;
+    }
+
+    const qint64 triggerNs = m_capture.at(m_triggerIndex).timestampNs;
+    offsets.reserve(m_capture.size());
+    for (const DataRecord &record : m_capture) {
+        offsets.append((record.timestampNs - triggerNs) / 1e6);
+    }
+    return offsets;
+}
+
+/**
+ * @brief 保存捕获窗口
+ * @param filePath 文件路径
+ * @return 是否保存成功
+ * @details 文件头后每个样本占10字节：相对首样本的毫秒偏移(32位) +
+ *          按寄存器原始刻度存储的电压/电流/功率(各16位)
+ */
+bool TriggerCapture::saveCapture(const QString &filePath)
+{
+    if (m_capture.isEmpty()) {
+        emit saveFinished(false, filePath);
+        return false;
+    }
+
+    QFile file(filePath);
+    if (!file.open(QIODevice::WriteOnly)) {
+        LOG_WARNING(Log::Recorder, "无法打开捕获文件: {}", filePath);
+        emit saveFinished(false, filePath);
+        return false;
+    }
+
+    QDataStream out(&file);
+    out.setByteOrder(QDataStream::LittleEndian);
+
+    const qint64 startNs = m_capture.first().timestampNs;
+    out << CAPTURE_FILE_MAGIC
+        << CAPTURE_FILE_VERSION
+        << static_cast<quint8>(m_captureChannels)
+        << static_cast<quint8>(m_triggerSource)
+        << static_cast<quint32>(m_triggerIndex)
+        << static_cast<quint32>(m_capture.size())
+        << static_cast<qint64>(startNs / 1000000);
+
+    for (const DataRecord &record : m_capture) {
+        out << static_cast<quint32>((record.timestampNs - startNs) / 1000000)
+            << static_cast<quint16>(qRound(record.voltage * 10.0))
+            << static_cast<quint16>(qRound(record.current * 10.0))
+            << static_cast<quint16>(qRound(record.power * 100.0));
+    }
+
+    file.close();
+    const bool ok = out.status() == QDataStream::Ok;
+    LOG_INFO(Log::Recorder, "触发捕获已保存到: {} 样本数: {}", filePath, m_capture.size());
+    emit saveFinished(ok, filePath);
+    return ok;
+}
+
+/**
+ * @brief 采样槽函数
+ * @param voltage 电压值
+ * @param current 电流值
+ * @param power 功率值
+ * @param timestampNs 采样到达时刻
+ */
+void TriggerCapture::onSampleReady(double voltage, double current, double power, qint64 timestampNs)
+{
+    DataRecord record;
+    record.timestampNs = timestampNs;
+    record.voltage = voltage;
+    record.current = current;
+    record.power = power;
+    const int highTemp = m_modbusManager ? m_modbusManager->highTempState() : 0;
+
+    switch (m_state) {
+    case Idle:
+        pushRing(record);
+        break;
+    case Armed:
+        if (m_hasPrevious && checkTrigger(record, highTemp)) {
+            // 按时间顺序展开预触发窗口，触发样本紧随其后
+            m_capture.clear();
+            m_capture.reserve(m_ringCount + m_postTriggerSamples);
+            const int capacity = m_ring.size();
+            const int first = capacity > 0 ? (m_ringHead - m_ringCount + capacity) % capacity : 0;
+            for (int i = 0; i < m_ringCount; ++i) {
+                m_capture.append(m_ring.at((first + i) % capacity));
+            }
+            m_triggerIndex = m_capture.size();
+            m_capture.append(record);
+            setState(Triggered);
+            if (m_capture.size() - m_triggerIndex >= m_postTriggerSamples) {
+                finishCapture();
+            }
+        } else {
+            pushRing(record);
+        }
+        break;
+    case Triggered:
+        m_capture.append(record);
+        if (m_capture.size() - m_triggerIndex >= m_postTriggerSamples) {
+            finishCapture();
+        }
+        break;
+    case Captured:
+        // 窗口已冻结，新样本只进入预触发缓冲
+        pushRing(record);
+        break;
+    }
+
+    m_previous = record;
+    m_previousHighTemp = highTemp;
+    m_hasPrevious = true;
+}
+
+/**
+ * @brief 采集状态变化槽函数
+ * @details 突发轮询结束或连接断开时若仍在布防/触发中，说明采集已被外部停止，
+ *          不会再有样本到达，撤防并丢弃未完成的窗口
+ */
+void TriggerCapture::onAcquisitionChanged()
+{
+    if (m_state != Armed && m_state != Triggered) {
+        return;
+    }
+    if (m_modbusManager && m_modbusManager->connected() && m_modbusManager->burstActive()) {
+        return;
+    }
+
+    LOG_INFO(Log::Recorder, "采集已停止，触发捕获撤防");
+    disarm();
+}
+
+void TriggerCapture::setState(int state)
+{
+    if (m_state != state) {
+        m_state = state;
+        emit stateChanged();
+    }
+}
+
+void TriggerCapture::resetRing()
+{
+    m_ring.clear();
+    m_ring.resize(m_preTriggerSamples);
+    m_ringHead = 0;
+    m_ringCount = 0;
+}
+
+void TriggerCapture::pushRing(const DataRecord &record)
+{
+    const int capacity = m_ring.size();
+    if (capacity == 0) {
+        return;
+    }
+
+    m_ring[m_ringHead] = record;
+    m_ringHead = (m_ringHead + 1) % capacity;
+    if (m_ringCount < capacity) {
+        ++m_ringCount;
+    }
+}
+
+/**
+ * @brief 判断当前样本是否满足触发条件
+ * @param record 当前样本
+ * @param highTemp 当前高温报警状态
+ * @return 是否触发
+ */
+bool TriggerCapture::checkTrigger(const DataRecord &record, int highTemp) const
+{
+    bool rising = false;
+    bool falling = false;
+
+    switch (m_triggerSource) {
+    case VoltageLevel:
+        rising = m_previous.voltage < m_triggerLevel && record.voltage >= m_triggerLevel;
+        falling = m_previous.voltage > m_triggerLevel && record.voltage <= m_triggerLevel;
+        break;
+    case CurrentStep: {
+        const double delta = record.current - m_previous.current;
+        rising = delta > m_triggerLevel;
+        falling = -delta > m_triggerLevel;
+        break;
+    }
+    case HighTempEdge:
+        rising = m_previousHighTemp == 0 && highTemp != 0;
+        falling = m_previousHighTemp != 0 && highTemp == 0;
+        break;
+    default:
+        break;
+    }
+
+    switch (m_triggerEdge) {
+    case RisingEdge: return rising;
+    case FallingEdge: return falling;
+    default: return rising || falling;
+    }
+}
+
+/**
+ * @brief 计算布防期间的突发轮询通道
+ * @return 捕获通道与触发源所需通道的并集
+ */
+int TriggerCapture::burstMask() const
+{
+    int mask = m_captureChannels;
+    switch (m_triggerSource) {
+    case VoltageLevel: mask |= ModbusManager::VoltageChannel; break;
+    case CurrentStep: mask |= ModbusManager::CurrentChannel; break;
+    case HighTempEdge: mask |= ModbusManager::HighTempChannel; break;
+    default: break;
+    }
+    return mask;
+}
+
+void TriggerCapture::finishCapture()
+{
+    // 先冻结再停止突发，burstActiveChanged到达时已不在触发状态
+    setState(Captured);
+    if (m_modbusManager) {
+        m_modbusManager->stopBurstReading();
+    }
+    // 预触发窗口从冻结后的新样本重新积累
+    resetRing();
+    LOG_INFO(Log::Recorder, "触发捕获完成，样本数: {} 触发位置: {}", m_capture.size(), m_triggerIndex);
+    emit captureChanged();
+    emit captureFinished();
+}
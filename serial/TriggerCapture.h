@@ -0,0 +1,258 @@
+#ifndef TRIGGERCAPTURE_H
+#define TRIGGERCAPTURE_H
+
+#include <QObject>
+#include <QVector>
+#include <QVariantList>
+#include "DataRecorder.h"
+#include "ModbusManager.h"
+
+/**
+ * @brief 触发捕获文件魔数（"LBCP"）
+ */
+constexpr quint32 CAPTURE_FILE_MAGIC = 0x4C424350;
+
+/**
+ * @brief 触发捕获文件版本
+ */
+constexpr quint16 CAPTURE_FILE_VERSION = 1;
+
+/**
+ * @brief 示波器式触发捕获类
+ * @details 持续在环形缓冲中保留预触发窗口，满足触发条件后以突发轮询
+ *          采集指定数量的后触发样本，捕获窗口冻结后可显示或保存为紧凑文件
+ */
+class TriggerCapture : public QObject
+{
+    Q_OBJECT
+    /**
+     * @brief 数据来源
+     * @details 订阅其sampleReady信号，并在布防期间切换为突发轮询
+     */
+    Q_PROPERTY(ModbusManager *modbusManager READ modbusManager WRITE setModbusManager NOTIFY modbusManagerChanged)
+
+    /**
+     * @brief 触发源（TriggerSource）
+     */
+    Q_PROPERTY(int triggerSource READ triggerSource WRITE setTriggerSource NOTIFY triggerSourceChanged)
+
+    /**
+     * @brief 触发边沿（TriggerEdge）
+     */
+    Q_PROPERTY(int triggerEdge READ triggerEdge WRITE setTriggerEdge NOTIFY triggerEdgeChanged)
+
+    /**
+     * @brief 触发电平
+     * @details 电压触发时为电压阈值(V)，电流阶跃触发时为相邻样本的电流变化量(A)，
+     *          须大于0，变化量严格超过该值才触发
+     */
+    Q_PROPERTY(double triggerLevel READ triggerLevel WRITE setTriggerLevel NOTIFY triggerLevelChanged)
+
+    /**
+     * @brief 捕获通道位掩码（ModbusManager::Channel组合）
+     * @details 布防期间突发轮询只读取这些通道及触发源所需通道
+     */
+    Q_PROPERTY(int captureChannels READ captureChannels WRITE setCaptureChannels NOTIFY captureChannelsChanged)
+
+    /**
+     * @brief 预触发样本数
+     */
+    Q_PROPERTY(int preTriggerSamples READ preTriggerSamples WRITE setPreTriggerSamples NOTIFY preTriggerSamplesChanged)
+
+    /**
+     * @brief 后触发样本数（含触发样本）
+     */
+    Q_PROPERTY(int postTriggerSamples READ postTriggerSamples WRITE setPostTriggerSamples NOTIFY postTriggerSamplesChanged)
+
+    /**
+     * @brief 捕获状态（CaptureState）
+     */
+    Q_PROPERTY(int state READ state NOTIFY stateChanged)
+
+    /**
+     * @brief 已冻结的捕获样本数
+     */
+    Q_PROPERTY(int captureCount READ captureCount NOTIFY captureChanged)
+
+    /**
+     * @brief 触发样本在捕获窗口中的索引
+     */
+    Q_PROPERTY(int triggerIndex READ triggerIndex NOTIFY captureChanged)
+
+public:
+    /**
+     * @brief 触发源
+     */
+    enum TriggerSource {
+        VoltageLevel,   ///< 电压穿越电平
+        CurrentStep,    ///< 电流阶跃
+        HighTempEdge    ///< 高温报警状态边沿
+    };
+    Q_ENUM(TriggerSource)
+
+    /**
+     * @brief 触发边沿
+     */
+    enum TriggerEdge {
+        RisingEdge,
+        FallingEdge,
+        AnyEdge
+    };
+    Q_ENUM(TriggerEdge)
+
+    /**
+     * @brief 捕获状态
+     */
+    enum CaptureState {
+        Idle,       ///< 空闲，仅维护预触发窗口
+        Armed,      ///< 已布防，等待触发
+        Triggered,  ///< 已触发，正在采集后触发样本
+        Captured    ///< 捕获完成，窗口已冻结
+    };
+    Q_ENUM(CaptureState)
+
+    /**
+     * @brief 构造函数
+     * @param parent 父对象
+     */
+    explicit TriggerCapture(QObject *parent = nullptr);
+
+    ModbusManager *modbusManager() const { return m_modbusManager; }
+    void setModbusManager(ModbusManager *manager);
+
+    int triggerSource() const { return m_triggerSource; }
+    void setTriggerSource(int source);
+
+    int triggerEdge() const { return m_triggerEdge; }
+    void setTriggerEdge(int edge);
+
+    double triggerLevel() const { return m_triggerLevel; }
+    void setTriggerLevel(double level);
+
+    int captureChannels() const { return m_captureChannels; }
+    void setCaptureChannels(int mask);
+
+    int preTriggerSamples() const { return m_preTriggerSamples; }
+    void setPreTriggerSamples(int count);
+
+    int postTriggerSamples() const { return m_postTriggerSamples; }
+    void setPostTriggerSamples(int count);
+
+    int state() const { return m_state; }
+    int captureCount() const { return m_capture.size(); }
+    int triggerIndex() const { return m_triggerIndex; }
+
+    /**
+     * @brief 布防
+     * @details 切换为突发轮询并等待触发条件
+     * @return 是否已布防；电流阶跃触发的阈值不大于0时拒绝布防
+     */
+    Q_INVOKABLE bool arm();
+
+    /**
+     * @brief 撤防
+     * @details 放弃正在进行的捕获并恢复正常轮询
+     */
+    Q_INVOKABLE void disarm();
+
+    /**
+     * @brief 清除已冻结的捕获窗口
+     */
+    Q_INVOKABLE void clearCapture();
+
+    /**
+     * @brief 获取捕获窗口中某一通道的数值
+     * @param channel 0：电压，1：电流，2：功率
+     * @return 数值列表
+     */
+    Q_INVOKABLE QVariantList capturedValues(int channel) const;
+
+    /**
+     * @brief 获取捕获窗口各样本相对触发时刻的时间偏移
+     * @return 毫秒偏移列表（触发前为负，保留亚毫秒部分）
+     */
+    Q_INVOKABLE QVariantList capturedTimeOffsets() const;
+
+    /**
+     * @brief 将捕获窗口保存为紧凑二进制文件
+     * @param filePath 文件路径
+     * @return 是否保存成功
+     */
+    Q_INVOKABLE bool saveCapture(const QString &filePath);
+
+signals:
+    void modbusManagerChanged();
+    void triggerSourceChanged();
+    void triggerEdgeChanged();
+    void triggerLevelChanged();
+    void captureChannelsChanged();
+    void preTriggerSamplesChanged();
+    void postTriggerSamplesChanged();
+    void stateChanged();
+    void captureChanged();
+
+    /**
+     * @brief 捕获完成信号
+     * @details 后触发样本采集完毕、窗口冻结时触发
+     */
+    void captureFinished();
+
+    /**
+     * @brief 保存完成信号
+     * @param success 是否成功
+     * @param filePath 文件路径
+     */
+    void saveFinished(bool success, const QString &filePath);
+
+private slots:
+    /**
+     * @brief 采样槽函数
+     * @details 每轮轮询完成后调用，维护预触发窗口并判断触发条件
+     */
+    void onSampleReady(double voltage, double current, double power, qint64 timestampNs);
+
+    /**
+     * @brief 采集状态变化槽函数
+     * @details 布防或触发期间突发轮询被外部停止（stopReading()、disconnectPort()）时撤防回到空闲
+     */
+    void onAcquisitionChanged();
+
+private:
+    ModbusManager *m_modbusManager;
+    int m_triggerSource;
+    int m_triggerEdge;
+    double m_triggerLevel;
+    int m_captureChannels;
+    int m_preTriggerSamples;
+    int m_postTriggerSamples;
+    int m_state;
+
+    /**
+     * @brief 预触发环形缓冲
+     */
+    QVector<DataRecord> m_ring;
+    int m_ringHead;
+    int m_ringCount;
+
+    /**
+     * @brief 冻结的捕获窗口
+     */
+    QVector<DataRecord> m_capture;
+    int m_triggerIndex;
+
+    /**
+     * @brief 上一个样本（用于边沿判断）
+     */
+    DataRecord m_previous;
+    int m_previousHighTemp;
+    bool m_hasPrevious;
+
+    void setState(int state);
+    void resetRing();
+    void pushRing(const DataRecord &record);
+    bool checkTrigger(const DataRecord &record, int highTemp) const;
+    int burstMask() const;
+    void finishCapture();
+};
+
+#endif